@@ -0,0 +1,114 @@
+/**
+ * File name: base64_benchmark.cpp
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/**
+ * Measures the base64 encoding and decoding throughput of the scalar,
+ * SSE4.1 and AVX2 code paths on a float32 sample buffer, as the samples
+ * are saved in the presets. Returns a non-zero exit code if a code path
+ * gives a different encoding than the scalar one or the decoded data
+ * differs from the original.
+ */
+
+#include "base64.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+/* 16 seconds of mono float32 samples at 48 kHz, about 3 MB. */
+constexpr size_t benchmarkSamples = 16 * 48000;
+constexpr int benchmarkRuns = 20;
+
+static double benchmarkSeconds(const std::chrono::steady_clock::time_point &start)
+{
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+        std::vector<float> samples(benchmarkSamples);
+        unsigned int seed = 1;
+        for (size_t i = 0; i < samples.size(); i++) {
+                seed = seed * 1103515245 + 12345;
+                auto noise = static_cast<float>((seed >> 16) & 0x7fff) / 0x7fff - 0.5f;
+                samples[i] = std::sin(2.0 * M_PI * 50.0 * i / 48000.0) * std::exp(-3.0 * i / samples.size())
+                        + 0.01f * noise;
+        }
+
+        auto data = reinterpret_cast<const unsigned char*>(samples.data());
+        auto dataSize = samples.size() * sizeof(float);
+        std::vector<unsigned char> encoded(base64_encoded_size(dataSize));
+        std::vector<unsigned char> decoded(base64_decoded_size(encoded.size()));
+        std::vector<unsigned char> reference;
+
+        const std::vector<std::pair<base64_simd_level, const char*>> levels = {
+                {BASE64_SIMD_NONE, "scalar"},
+                {BASE64_SIMD_SSE41, "sse4.1"},
+                {BASE64_SIMD_AVX2, "avx2"}
+        };
+
+        auto defaultLevel = base64_get_simd_level();
+        int res = 0;
+        printf("%zu bytes, %d runs\n", dataSize, benchmarkRuns);
+        for (const auto &level: levels) {
+                if (base64_set_simd_level(level.first) != 0) {
+                        printf("%-7s not supported\n", level.second);
+                        continue;
+                }
+
+                size_t encodedSize = 0;
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < benchmarkRuns; i++)
+                        encodedSize = base64_encode_to(data, dataSize, encoded.data());
+                auto encodeTime = benchmarkSeconds(start) / benchmarkRuns;
+
+                size_t decodedSize = 0;
+                bool isDecoded = true;
+                start = std::chrono::steady_clock::now();
+                for (int i = 0; i < benchmarkRuns; i++)
+                        isDecoded = base64_decode_to(encoded.data(), encodedSize,
+                                                     decoded.data(), &decodedSize) == 0 && isDecoded;
+                auto decodeTime = benchmarkSeconds(start) / benchmarkRuns;
+
+                printf("%-7s encode: %8.1f MB/s, decode: %8.1f MB/s\n",
+                       level.second,
+                       dataSize / encodeTime * 1e-6,
+                       dataSize / decodeTime * 1e-6);
+
+                if (reference.empty())
+                        reference.assign(encoded.begin(), encoded.begin() + encodedSize);
+                if (encodedSize != reference.size()
+                    || std::memcmp(encoded.data(), reference.data(), encodedSize) != 0) {
+                        printf("error: %s encoding differs from the scalar encoding\n", level.second);
+                        res = 1;
+                }
+                if (!isDecoded || decodedSize != dataSize
+                    || std::memcmp(decoded.data(), data, dataSize) != 0) {
+                        printf("error: %s decode(encode(x)) differs from x\n", level.second);
+                        res = 1;
+                }
+        }
+
+        base64_set_simd_level(defaultLevel);
+        return res;
+}
@@ -0,0 +1,144 @@
+/**
+ * File name: state_benchmark.cpp
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/**
+ * Measures the time of saving and restoring a kit with samples
+ * through the JSON state and the binary state. Returns a non-zero
+ * exit code if a restored kit differs from the saved one.
+ */
+
+#include "kit_state.h"
+#include "percussion_state.h"
+
+#include <chrono>
+#include <cmath>
+
+constexpr size_t benchmarkPercussions = 8;
+constexpr size_t benchmarkSampleRate = 48000;
+
+/* 4 seconds of mono samples per percussion. */
+constexpr size_t benchmarkSamples = 4 * benchmarkSampleRate;
+constexpr int benchmarkRuns = 5;
+
+static double benchmarkSeconds(const std::chrono::steady_clock::time_point &start)
+{
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * A decaying tone with noise, quantized to 16 bits
+ * as the samples loaded from the audio files.
+ */
+static std::vector<gkick_real> benchmarkSample(size_t index)
+{
+        std::vector<gkick_real> samples(benchmarkSamples);
+        unsigned int seed = index + 1;
+        double frequency = 40.0 + 20.0 * index;
+        for (size_t i = 0; i < samples.size(); i++) {
+                seed = seed * 1103515245 + 12345;
+                auto noise = static_cast<double>((seed >> 16) & 0x7fff) / 0x7fff - 0.5;
+                auto val = std::sin(2.0 * M_PI * frequency * i / benchmarkSampleRate)
+                        * std::exp(-2.0 * i / samples.size()) + 0.05 * noise;
+                samples[i] = std::round(0.9 * val * 32767.0) / 32768.0;
+        }
+        return samples;
+}
+
+static bool isKitEqual(KitState &kit, KitState &restoredKit)
+{
+        auto percussions = kit.percussions();
+        auto restoredPercussions = restoredKit.percussions();
+        if (percussions.size() != restoredPercussions.size())
+                return false;
+
+        for (size_t i = 0; i < percussions.size(); i++) {
+                auto sample = percussions[i]->getOscillatorSample(0).toVector();
+                auto restoredSample = restoredPercussions[i]->getOscillatorSample(0).toVector();
+                if (sample.empty() || sample != restoredSample)
+                        return false;
+        }
+        return kit.toJson() == restoredKit.toJson();
+}
+
+int main()
+{
+        KitState kit;
+        kit.setName("Benchmark");
+        for (size_t i = 0; i < benchmarkPercussions; i++) {
+                auto percussion = std::make_shared<PercussionState>();
+                percussion->setName("Percussion " + std::to_string(i + 1));
+                percussion->setId(i);
+                percussion->setCurrentLayer(GeonkickApi::Layer::Layer1);
+                percussion->setOscillatorFunction(0, GeonkickApi::FunctionType::Sample);
+                percussion->setOscillatorSample(0, SampleRef::fromData(benchmarkSample(i)));
+                kit.addPercussion(percussion);
+        }
+
+        auto samplesSize = benchmarkPercussions * benchmarkSamples * sizeof(float);
+        printf("%zu percussions, %zu bytes of samples, %d runs\n",
+               benchmarkPercussions, samplesSize, benchmarkRuns);
+
+        int res = 0;
+        std::string json;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < benchmarkRuns; i++)
+                json = kit.toJson();
+        auto saveTime = benchmarkSeconds(start) / benchmarkRuns;
+
+        KitState jsonKit;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < benchmarkRuns; i++) {
+                jsonKit = KitState();
+                jsonKit.fromJson(json);
+        }
+        auto restoreTime = benchmarkSeconds(start) / benchmarkRuns;
+        printf("json    %10zu bytes, save: %8.2f ms, restore: %8.2f ms\n",
+               json.size(), saveTime * 1e3, restoreTime * 1e3);
+        if (!isKitEqual(kit, jsonKit)) {
+                printf("error: the kit restored from JSON differs from the saved kit\n");
+                res = 1;
+        }
+
+        std::string data;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < benchmarkRuns; i++)
+                data = kit.toBinary();
+        saveTime = benchmarkSeconds(start) / benchmarkRuns;
+
+        KitState binaryKit;
+        bool isRestored = true;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < benchmarkRuns; i++) {
+                binaryKit = KitState();
+                isRestored = binaryKit.fromBinary(data) && isRestored;
+        }
+        restoreTime = benchmarkSeconds(start) / benchmarkRuns;
+        printf("binary  %10zu bytes, save: %8.2f ms, restore: %8.2f ms\n",
+               data.size(), saveTime * 1e3, restoreTime * 1e3);
+        if (!isRestored || !isKitEqual(kit, binaryKit)) {
+                printf("error: the kit restored from the binary state differs from the saved kit\n");
+                res = 1;
+        }
+
+        return res;
+}
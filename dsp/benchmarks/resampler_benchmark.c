@@ -0,0 +1,126 @@
+/**
+ * File name: resampler_benchmark.c
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/**
+ * Measures the speed and the signal to noise ratio of the resampler
+ * qualities by resampling sine waves from 44100 to 48000 Hz.
+ * The SNR of a quality is the lowest SNR over the test frequencies.
+ * Returns a non-zero exit code if a quality is not better than the lower one.
+ */
+
+#include "resampler.h"
+
+#include <time.h>
+
+#define GKICK_BENCHMARK_IN_RATE  44100.0
+#define GKICK_BENCHMARK_OUT_RATE 48000.0
+#define GKICK_BENCHMARK_RUNS     10
+
+/* The frames near the edges are not compared, the filter sees zeros there. */
+#define GKICK_BENCHMARK_EDGE     100
+
+static const double gkick_benchmark_frequencies[] = {100.0, 1000.0, 5000.0, 10000.0, 15000.0};
+
+static double
+gkick_benchmark_time(void)
+{
+        struct timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static double
+gkick_benchmark_snr(const gkick_real *out,
+                    size_t out_size,
+                    double frequency)
+{
+        if (out_size <= 2 * GKICK_BENCHMARK_EDGE)
+                return 0.0;
+
+        double error = 0.0;
+        for (size_t i = GKICK_BENCHMARK_EDGE; i < out_size - GKICK_BENCHMARK_EDGE; i++) {
+                double e = out[i] - sin(2.0 * M_PI * frequency * i / GKICK_BENCHMARK_OUT_RATE);
+                error += e * e;
+        }
+        double signal = 0.5 * (out_size - 2 * GKICK_BENCHMARK_EDGE);
+        return error > 0.0 ? 10.0 * log10(signal / error) : INFINITY;
+}
+
+int main(void)
+{
+        const char *names[] = {"linear", "low", "medium", "high"};
+        size_t in_size = (size_t)GKICK_BENCHMARK_IN_RATE;
+        size_t out_size = gkick_resampler_size(in_size, GKICK_BENCHMARK_IN_RATE / GKICK_BENCHMARK_OUT_RATE);
+        gkick_real *in = (gkick_real*)malloc(in_size * sizeof(gkick_real));
+        gkick_real *out = (gkick_real*)malloc(out_size * sizeof(gkick_real));
+        if (in == NULL || out == NULL) {
+                free(in);
+                free(out);
+                return 1;
+        }
+
+        int res = 0;
+        double previous_snr = -INFINITY;
+        size_t frequencies = sizeof(gkick_benchmark_frequencies) / sizeof(gkick_benchmark_frequencies[0]);
+        for (int q = GEONKICK_RESAMPLER_LINEAR; q <= GEONKICK_RESAMPLER_HIGH; q++) {
+                enum geonkick_resampler_quality quality = (enum geonkick_resampler_quality)q;
+                double snr = INFINITY;
+                double duration = 0.0;
+                for (size_t f = 0; f < frequencies; f++) {
+                        double frequency = gkick_benchmark_frequencies[f];
+                        for (size_t i = 0; i < in_size; i++)
+                                in[i] = sin(2.0 * M_PI * frequency * i / GKICK_BENCHMARK_IN_RATE);
+
+                        size_t size = 0;
+                        double start = gkick_benchmark_time();
+                        for (int r = 0; r < GKICK_BENCHMARK_RUNS; r++) {
+                                size = out_size;
+                                gkick_resampler_resample(quality, in, in_size,
+                                                         GKICK_BENCHMARK_IN_RATE / GKICK_BENCHMARK_OUT_RATE,
+                                                         out, &size);
+                        }
+                        duration += (gkick_benchmark_time() - start) / GKICK_BENCHMARK_RUNS;
+
+                        double val = gkick_benchmark_snr(out, size, frequency);
+                        if (val < snr)
+                                snr = val;
+                }
+
+                const struct gkick_resampler *resampler = gkick_resampler_get(quality);
+                printf("%-7s taps: %3zu, phases: %4zu, %7.2f Mframes/s, SNR: %6.1f dB\n",
+                       names[q],
+                       resampler != NULL ? resampler->taps : 0,
+                       resampler != NULL ? resampler->phases : 0,
+                       frequencies * out_size / duration * 1e-6,
+                       snr);
+                if (snr <= previous_snr) {
+                        printf("error: %s quality is not better than the lower quality\n", names[q]);
+                        res = 1;
+                }
+                previous_snr = snr;
+        }
+
+        free(in);
+        free(out);
+        return res;
+}
@@ -42,6 +42,9 @@ gkick_audio_output_create(struct gkick_audio_output **audio_output)
         (*audio_output)->muted   = false;
         (*audio_output)->solo    = false;
         (*audio_output)->channel = 0;
+        (*audio_output)->tune_factor = 1.0f;
+        (*audio_output)->rate_factor = 1.0f;
+        (*audio_output)->resampler = gkick_resampler_get(GEONKICK_RESAMPLER_MEDIUM);
 
         gkick_buffer_new((struct gkick_buffer**)&(*audio_output)->updated_buffer,
                          GEONKICK_MAX_KICK_BUFFER_SIZE);
@@ -61,6 +64,12 @@ gkick_audio_output_create(struct gkick_audio_output **audio_output)
         }
         gkick_buffer_set_size((struct gkick_buffer*)(*audio_output)->playing_buffer, 0);
 
+        if (gkick_note_cache_create(&(*audio_output)->note_cache) != GEONKICK_OK) {
+                gkick_log_error("can't create note cache");
+                gkick_audio_output_free(audio_output);
+                return GEONKICK_ERROR;
+        }
+
         if (pthread_mutex_init(&(*audio_output)->lock, NULL) != 0) {
                 gkick_log_error("error on init mutex");
                 gkick_audio_output_free(audio_output);
@@ -77,6 +86,7 @@ void gkick_audio_output_free(struct gkick_audio_output **audio_output)
                 gkick_buffer_free(&p);
                 p = (struct gkick_buffer*)((*audio_output)->updated_buffer);
                 gkick_buffer_free(&p);
+                gkick_note_cache_free(&(*audio_output)->note_cache);
                 pthread_mutex_destroy(&(*audio_output)->lock);
                 free(*audio_output);
                 *audio_output = NULL;
@@ -91,6 +101,15 @@ gkick_audio_output_key_pressed(struct gkick_audio_output *audio_output,
                 audio_output->key = *key;
                 audio_output->is_play = true;
                 gkick_audio_output_swap_buffers(audio_output);
+                audio_output->note_buffer = NULL;
+                audio_output->tune_factor = 1.0f;
+                if (audio_output->tune && key->note_number != GKICK_TUNE_CENTRAL_NOTE) {
+                        audio_output->tune_factor = gkick_audio_output_tune_factor(key->note_number);
+                        audio_output->note_buffer = gkick_note_cache_acquire(audio_output->note_cache,
+                                                                             key->note_number);
+                        if (audio_output->note_buffer != NULL)
+                                gkick_buffer_reset(audio_output->note_buffer);
+                }
         } else {
                 audio_output->decay = GEKICK_KEY_RELESE_DECAY_TIME;
                 audio_output->key.state = key->state;
@@ -109,7 +128,7 @@ gkick_audio_output_play(struct gkick_audio_output *audio_output)
 gkick_real
 gkick_audio_output_tune_factor(int note_number)
 {
-        return exp2f((gkick_real)(note_number - 69) / 12.0f);
+        return exp2f((gkick_real)(note_number - GKICK_TUNE_CENTRAL_NOTE) / 12.0f);
 }
 
 enum geonkick_error
@@ -131,17 +150,28 @@ gkick_audio_output_get_frame(struct gkick_audio_output *audio_output,
 
         *val = 0;
         if (audio_output->is_play) {
-                if (gkick_buffer_is_end((struct gkick_buffer*)audio_output->playing_buffer)) {
+                /**
+                 * A tuned note is played from its pre-rendered buffer if it is
+                 * in the note cache, otherwise the percussion buffer is interpolated.
+                 */
+                struct gkick_buffer *buff = audio_output->note_buffer;
+                if (buff == NULL)
+                        buff = (struct gkick_buffer*)audio_output->playing_buffer;
+                if (gkick_buffer_is_end(buff)) {
                         audio_output->is_play = false;
                 } else {
-                        struct gkick_buffer *buff = (struct gkick_buffer*)audio_output->playing_buffer;
-                        gkick_real factor = gkick_audio_output_tune_factor(audio_output->key.note_number);
-                        if (audio_output->tune)
-                                *val = gkick_buffer_stretch_get_next(buff, factor);
+                        gkick_real factor = audio_output->rate_factor;
+                        if (audio_output->note_buffer == NULL)
+                                factor *= audio_output->tune_factor;
+                        if (factor != 1.0f)
+                                *val = gkick_buffer_stretch_get_next(buff,
+                                                                     audio_output->resampler,
+                                                                     factor);
                         else
                                 *val = gkick_buffer_get_next(buff);
 
-                        if (gkick_buffer_size(buff) - gkick_buffer_index(buff) == GEKICK_KEY_RELESE_DECAY_TIME) {
+                        if (audio_output->key.state != GKICK_KEY_STATE_RELEASED
+                            && gkick_buffer_size(buff) - gkick_buffer_index(buff) <= GEKICK_KEY_RELESE_DECAY_TIME) {
                                 audio_output->decay     = GEKICK_KEY_RELESE_DECAY_TIME;
                                 audio_output->key.state = GKICK_KEY_STATE_RELEASED;
                         }
@@ -165,6 +195,30 @@ gkick_audio_output_get_frame(struct gkick_audio_output *audio_output,
         return GEONKICK_OK;
 }
 
+enum geonkick_error
+gkick_audio_output_process(struct gkick_audio_output *audio_output,
+                           gkick_real *buff,
+                           size_t size,
+                           gkick_real *peak)
+{
+        gkick_real max = 0.0f;
+
+        /* Nothing to add while the percussion is not playing. */
+        if (audio_output->is_play || audio_output->play) {
+                for (size_t i = 0; i < size; i++) {
+                        gkick_real val;
+                        gkick_audio_output_get_frame(audio_output, &val);
+                        buff[i] += val;
+                        if (fabs(val) > max)
+                                max = fabs(val);
+                }
+        }
+
+        if (peak != NULL)
+                *peak = max;
+        return GEONKICK_OK;
+}
+
 void gkick_audio_output_lock(struct gkick_audio_output *audio_output)
 {
         if (audio_output != NULL)
@@ -204,6 +258,13 @@ void gkick_audio_output_swap_buffers(struct gkick_audio_output *audio_output)
         }
 }
 
+void gkick_audio_output_set_sample_rate(struct gkick_audio_output *audio_output,
+                                        int sample_rate)
+{
+        if (sample_rate > 0)
+                audio_output->rate_factor = (gkick_real)GEONKICK_SAMPLE_RATE / sample_rate;
+}
+
 enum geonkick_error
 gkick_audio_output_set_playing_key(struct gkick_audio_output *audio_output, char key)
 {
@@ -231,6 +292,13 @@ bool gkick_audio_output_is_tune_output(struct gkick_audio_output *audio_output)
         return audio_output->tune;
 }
 
+void gkick_audio_output_set_resampler(struct gkick_audio_output *audio_output,
+                                      const struct gkick_resampler *resampler)
+{
+        if (resampler != NULL)
+                audio_output->resampler = resampler;
+}
+
 enum geonkick_error
 gkick_audio_output_set_channel(struct gkick_audio_output *audio_output,
                                size_t channel)
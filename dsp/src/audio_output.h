@@ -25,6 +25,8 @@
 #define GKICK_AUDO_OUTPUT_H
 
 #include "geonkick_internal.h"
+#include "note_cache.h"
+#include "resampler.h"
 
 #include <stdatomic.h>
 
@@ -39,6 +41,9 @@
 /* Decay time measured in number of audio frames. */
 #define GEKICK_KEY_RELESE_DECAY_TIME 1000
 
+/* The note that plays the percussion untuned (A4). */
+#define GKICK_TUNE_CENTRAL_NOTE 69
+
 struct gkick_note_info {
         enum gkick_key_state state;
         char channel;
@@ -80,6 +85,27 @@ struct gkick_audio_output
          */
         _Atomic bool tune;
 
+        /* Per note pre-rendered buffers for the tuned output. */
+        struct gkick_note_cache *note_cache;
+
+        /**
+         * The buffer of the pressed note from the note cache,
+         * NULL if the note is not rendered yet. Changed only by the audio thread.
+         */
+        struct gkick_buffer *note_buffer;
+
+        /* Tune factor of the pressed note. Changed only by the audio thread. */
+        gkick_real tune_factor;
+
+        /* Resampler used to play the tuned notes that are not rendered. */
+        const struct gkick_resampler * _Atomic resampler;
+
+        /**
+         * Ratio between the synthesis sample rate and
+         * the sample rate of the audio interface.
+         */
+        _Atomic gkick_real rate_factor;
+
         /**
          * decay - note release time measured in number of audio frames.
          * Relaxation curve for audio is liniear:
@@ -125,6 +151,16 @@ enum geonkick_error
 gkick_audio_output_get_frame(struct gkick_audio_output *audio_output,
                              gkick_real *val);
 
+/**
+ * Adds the next size frames of the output to the buffer.
+ * peak - the maximum absolute value of the frames, can be NULL.
+ */
+enum geonkick_error
+gkick_audio_output_process(struct gkick_audio_output *audio_output,
+                           gkick_real *buff,
+                           size_t size,
+                           gkick_real *peak);
+
 void gkick_audio_output_lock(struct gkick_audio_output *audio_output);
 
 void gkick_audio_output_unlock(struct gkick_audio_output *audio_output);
@@ -141,6 +177,12 @@ void gkick_audio_output_tune_output(struct gkick_audio_output *audio_output, boo
 
 bool gkick_audio_output_is_tune_output(struct gkick_audio_output *audio_output);
 
+void gkick_audio_output_set_resampler(struct gkick_audio_output *audio_output,
+                                      const struct gkick_resampler *resampler);
+
+void gkick_audio_output_set_sample_rate(struct gkick_audio_output *audio_output,
+                                        int sample_rate);
+
 enum geonkick_error
 gkick_audio_output_set_channel(struct gkick_audio_output *audio_output,
                                size_t channel);
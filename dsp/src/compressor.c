@@ -43,6 +43,7 @@ gkick_compressor_new(struct gkick_compressor **compressor)
         (*compressor)->ratio     = 1.0f;
         (*compressor)->knee      = 0.0f;
         (*compressor)->makeup    = 1.0f;
+        (*compressor)->rate_divider = 1;
 
         if (pthread_mutex_init(&(*compressor)->lock, NULL) != 0) {
                 gkick_log_error("error on init mutex");
@@ -117,7 +118,7 @@ gkick_compressor_val(struct gkick_compressor *compressor,
                 if (compressor->frames <= compressor->attack && compressor->attack > 0) {
                         /* Linear increase of the ratio. */
                         ratio = 1.0 + ((compressor->ratio - 1.0) / compressor->attack) * compressor->frames;
-                        compressor->frames++;
+                        compressor->frames += compressor->rate_divider;
                 }
                 gkick_real diff = (in_val - threshold) / ratio;
                 *out_val = threshold + diff;
@@ -172,6 +173,21 @@ gkick_compressor_get_release(struct gkick_compressor *compressor,
         return GEONKICK_OK;
 }
 
+enum geonkick_error
+gkick_compressor_set_rate_divider(struct gkick_compressor *compressor,
+                                  size_t divider)
+{
+        if (compressor == NULL || divider < 1) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        gkick_compressor_lock(compressor);
+        compressor->rate_divider = divider;
+        gkick_compressor_unlock(compressor);
+        return GEONKICK_OK;
+}
+
 enum geonkick_error
 gkick_compressor_set_threshold(struct gkick_compressor *compressor,
                                gkick_real threshold)
@@ -46,6 +46,8 @@ struct gkick_compressor {
         uint64_t frames;
         /* The frame at which the compressor is deactivated. */
         uint64_t deactivation;
+        /* Number of frames every processed value stands for. */
+        uint64_t rate_divider;
         pthread_mutex_t lock;
 };
 
@@ -86,6 +88,10 @@ enum geonkick_error
 gkick_compressor_set_release(struct gkick_compressor *compressor,
                              gkick_real release);
 
+enum geonkick_error
+gkick_compressor_set_rate_divider(struct gkick_compressor *compressor,
+                                  size_t divider);
+
 enum geonkick_error
 gkick_compressor_get_release(struct gkick_compressor *compressor,
                              gkick_real *release);
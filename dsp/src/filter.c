@@ -38,6 +38,7 @@ gkick_filter_new(struct gkick_filter **filter)
         }
         (*filter)->type = GEONKICK_FILTER_LOW_PASS;
         (*filter)->queue_empty = 1;
+        (*filter)->rate_divider = 1;
 
         (*filter)->cutoff_env = gkick_envelope_create();
         if ((*filter)->cutoff_env == NULL) {
@@ -109,7 +110,14 @@ gkick_filter_update_coefficents(struct gkick_filter *filter)
                 return GEONKICK_ERROR;
         }
 
-        gkick_real F = 2.0f * sin(M_PI * filter->cutoff_freq / GEONKICK_SAMPLE_RATE);
+        gkick_real rate = filter->cutoff_freq * filter->rate_divider / GEONKICK_SAMPLE_RATE;
+        /**
+         * At lower rates the cutoff is limited to keep the
+         * filter stable, the result is only an approximation.
+         */
+        if (filter->rate_divider > 1 && rate > GKICK_FILTER_MAX_DIVIDED_RATE)
+                rate = GKICK_FILTER_MAX_DIVIDED_RATE;
+        gkick_real F = 2.0f * sin(M_PI * rate);
         gkick_real Q = filter->factor;
         filter->coefficients[0] = F;
         filter->coefficients[1] = Q;
@@ -164,6 +172,24 @@ gkick_filter_set_cutoff_freq(struct gkick_filter *filter,
         return GEONKICK_OK;
 }
 
+enum geonkick_error
+gkick_filter_set_rate_divider(struct gkick_filter *filter,
+                              size_t divider)
+{
+        if (filter == NULL || divider < 1) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        gkick_filter_lock(filter);
+        if (filter->rate_divider != divider) {
+                filter->rate_divider = divider;
+                gkick_filter_update_coefficents(filter);
+        }
+        gkick_filter_unlock(filter);
+        return GEONKICK_OK;
+}
+
 enum geonkick_error
 gkick_filter_set_factor(struct gkick_filter *filter,
                         gkick_real factor)
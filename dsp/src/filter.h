@@ -29,6 +29,7 @@
 
 #define GEONKICK_DEFAULT_FILTER_CUTOFF_FREQ (350.0f)
 #define GEONKICK_DEFAULT_FILTER_FACTOR      (1.0f)
+#define GKICK_FILTER_MAX_DIVIDED_RATE       (1.0f / 6.0f)
 
 struct gkick_filter {
         enum gkick_filter_type type;
@@ -48,6 +49,12 @@ struct gkick_filter {
         /* Filter coefficients. */
         gkick_real coefficients[2];
 
+        /**
+         * The filter processes one of every rate_divider frames
+         * when the percussion is synthesised at a lower rate.
+         */
+        size_t rate_divider;
+
         /* Filter cutoff envelope. */
         struct gkick_envelope *cutoff_env;
         pthread_mutex_t lock;
@@ -80,6 +87,10 @@ enum geonkick_error
 gkick_filter_set_cutoff_freq(struct gkick_filter *filter,
                              gkick_real cutoff);
 
+enum geonkick_error
+gkick_filter_set_rate_divider(struct gkick_filter *filter,
+                              size_t divider);
+
 enum geonkick_error
 gkick_filter_set_factor(struct gkick_filter *filter,
                         gkick_real factor);
@@ -27,6 +27,12 @@
 #include "audio_output.h"
 #include "envelope.h"
 #include "mixer.h"
+#include "resampler.h"
+#include "render_pool.h"
+#include "sample_store.h"
+#include "render_context.h"
+
+#include <time.h>
 
 enum geonkick_error
 geonkick_create(struct geonkick **kick)
@@ -47,6 +53,8 @@ geonkick_create(struct geonkick **kick)
                 return GEONKICK_ERROR;
 	}
 
+        gkick_resampler_init();
+
 	if (gkick_audio_create(&(*kick)->audio) != GEONKICK_OK) {
                 gkick_log_warning("can't create audio");
 		geonkick_free(kick);
@@ -107,11 +115,23 @@ void geonkick_unlock(struct geonkick *kick)
 enum geonkick_error
 geonkick_enable_oscillator(struct geonkick* kick, size_t index)
 {
-        if (kick == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_enable_oscillator_id(kick, kick->per_index, index);
+}
+
+enum geonkick_error
+geonkick_enable_oscillator_id(struct geonkick *kick,
+                              size_t id,
+                              size_t index)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS)
                 return GEONKICK_ERROR;
         enum geonkick_error res;
-        res = gkick_synth_enable_oscillator(kick->synths[kick->per_index], index, 1);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_enable_oscillator(kick->synths[id], index, 1);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -119,11 +139,23 @@ geonkick_enable_oscillator(struct geonkick* kick, size_t index)
 enum geonkick_error
 geonkick_disable_oscillator(struct geonkick* kick, size_t index)
 {
-        if (kick == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_disable_oscillator_id(kick, kick->per_index, index);
+}
+
+enum geonkick_error
+geonkick_disable_oscillator_id(struct geonkick *kick,
+                               size_t id,
+                               size_t index)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS)
                 return GEONKICK_ERROR;
         enum geonkick_error res;
-        res = gkick_synth_enable_oscillator(kick->synths[kick->per_index], index, 0);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_enable_oscillator(kick->synths[id], index, 0);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -131,17 +163,42 @@ geonkick_disable_oscillator(struct geonkick* kick, size_t index)
 enum geonkick_error
 geonkick_is_oscillator_enabled(struct geonkick* kick, size_t index, int *enabled)
 {
-        if (kick == NULL || enabled == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_is_oscillator_enabled_id(kick, kick->per_index, index, enabled);
+}
+
+enum geonkick_error
+geonkick_is_oscillator_enabled_id(struct geonkick *kick,
+                                  size_t id,
+                                  size_t index,
+                                  int *enabled)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || enabled == NULL)
                 return GEONKICK_ERROR;
-        return gkick_synth_osc_is_enabled(kick->synths[kick->per_index], index, enabled);
+        return gkick_synth_osc_is_enabled(kick->synths[id], index, enabled);
 }
 
 enum geonkick_error
 geonkick_get_oscillators_number(struct geonkick *kick, size_t *number)
 {
-        if (kick == NULL || number == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_oscillators_number_id(kick, kick->per_index, number);
+}
+
+enum geonkick_error
+geonkick_get_oscillators_number_id(struct geonkick *kick,
+                                   size_t id,
+                                   size_t *number)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || number == NULL)
                 return GEONKICK_ERROR;
-        return gkick_synth_get_oscillators_number(kick->synths[kick->per_index], number);
+        return gkick_synth_get_oscillators_number(kick->synths[id], number);
 }
 
 enum geonkick_error
@@ -155,12 +212,27 @@ geonkick_osc_envelope_add_point(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_osc_envelope_add_point_id(kick, kick->per_index, osc_index, env_index, x, y);
+}
+
+enum geonkick_error
+geonkick_osc_envelope_add_point_id(struct geonkick *kick,
+                                   size_t id,
+                                   size_t osc_index,
+                                   size_t env_index,
+                                   gkick_real x,
+                                   gkick_real y)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
 
         enum geonkick_error res;
-        res = gkick_synth_osc_env_add_point(kick->synths[kick->per_index],
+        res = gkick_synth_osc_env_add_point(kick->synths[id],
                                             osc_index,
                                             env_index, x, y);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -178,12 +250,27 @@ geonkick_osc_envelope_get_points(struct geonkick *kick,
 				 gkick_real **buf,
 				 size_t *npoints)
 {
-        if (kick == NULL || buf == NULL || npoints == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_osc_envelope_get_points_id(kick, kick->per_index, osc_index, env_index, buf, npoints);
+}
+
+enum geonkick_error
+geonkick_osc_envelope_get_points_id(struct geonkick *kick,
+                                    size_t id,
+                                    size_t osc_index,
+                                    size_t env_index,
+                                    gkick_real **buf,
+                                    size_t *npoints)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || buf == NULL || npoints == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
 
-        return gkick_synth_osc_envelope_points(kick->synths[kick->per_index],
+        return gkick_synth_osc_envelope_points(kick->synths[id],
                                                osc_index,
                                                env_index, buf, npoints);
 }
@@ -195,12 +282,27 @@ geonkick_osc_envelope_set_points(struct geonkick *kick,
                                  const gkick_real *buff,
                                  size_t npoints)
 {
-        if (kick == NULL || buff == NULL || npoints == 0) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_osc_envelope_set_points_id(kick, kick->per_index, osc_index, env_index, buff, npoints);
+}
+
+enum geonkick_error
+geonkick_osc_envelope_set_points_id(struct geonkick *kick,
+                                    size_t id,
+                                    size_t osc_index,
+                                    size_t env_index,
+                                    const gkick_real *buff,
+                                    size_t npoints)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || buff == NULL || npoints == 0) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
 
-        return gkick_synth_osc_envelope_set_points(kick->synths[kick->per_index],
+        return gkick_synth_osc_envelope_set_points(kick->synths[id],
                                                    osc_index,
                                                    env_index,
                                                    buff,
@@ -218,12 +320,26 @@ geonkick_osc_envelope_remove_point(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_osc_envelope_remove_point_id(kick, kick->per_index, osc_index, env_index, index);
+}
+
+enum geonkick_error
+geonkick_osc_envelope_remove_point_id(struct geonkick *kick,
+                                      size_t id,
+                                      size_t osc_index,
+                                      size_t env_index,
+                                      size_t index)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_osc_env_remove_point(kick->synths[kick->per_index],
+        res = gkick_synth_osc_env_remove_point(kick->synths[id],
                                                osc_index,
                                                env_index,
                                                index);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -240,13 +356,29 @@ geonkick_osc_envelope_update_point(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_osc_envelope_update_point_id(kick, kick->per_index, osc_index, env_index, index, x, y);
+}
+
+enum geonkick_error
+geonkick_osc_envelope_update_point_id(struct geonkick *kick,
+                                      size_t id,
+                                      size_t osc_index,
+                                      size_t env_index,
+                                      size_t index,
+                                      gkick_real x,
+                                      gkick_real y)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
 
         enum geonkick_error res;
-        res = gkick_synth_osc_env_update_point(kick->synths[kick->per_index],
+        res = gkick_synth_osc_env_update_point(kick->synths[id],
                                                osc_index,
                                                env_index,
                                                index, x, y);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
 
         return res;
@@ -259,10 +391,23 @@ geonkick_osc_set_fm(struct geonkick *kick, size_t index, bool is_fm)
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_osc_set_fm_id(kick, kick->per_index, index, is_fm);
+}
+
+enum geonkick_error
+geonkick_osc_set_fm_id(struct geonkick *kick,
+                       size_t id,
+                       size_t index,
+                       bool is_fm)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
 
         enum geonkick_error res;
-        res = gkick_synth_osc_set_fm(kick->synths[kick->per_index], index, is_fm);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_osc_set_fm(kick->synths[id], index, is_fm);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -270,9 +415,22 @@ geonkick_osc_set_fm(struct geonkick *kick, size_t index, bool is_fm)
 enum geonkick_error
 geonkick_osc_is_fm(struct geonkick *kick, size_t index, bool *is_fm)
 {
-        if (kick == NULL || is_fm == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_osc_is_fm_id(kick, kick->per_index, index, is_fm);
+}
+
+enum geonkick_error
+geonkick_osc_is_fm_id(struct geonkick *kick,
+                      size_t id,
+                      size_t index,
+                      bool *is_fm)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || is_fm == NULL)
                 return GEONKICK_ERROR;
-        return gkick_synth_osc_is_fm(kick->synths[kick->per_index], index, is_fm);
+        return gkick_synth_osc_is_fm(kick->synths[id], index, is_fm);
 }
 
 enum geonkick_error
@@ -280,11 +438,24 @@ geonkick_set_osc_function(struct geonkick *kick,
 			  size_t osc_index,
 			  enum geonkick_osc_func_type type)
 {
-        if (kick == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_set_osc_function_id(kick, kick->per_index, osc_index, type);
+}
+
+enum geonkick_error
+geonkick_set_osc_function_id(struct geonkick *kick,
+                             size_t id,
+                             size_t osc_index,
+                             enum geonkick_osc_func_type type)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS)
                 return GEONKICK_ERROR;
         enum geonkick_error res;
-        res = gkick_synth_set_osc_function(kick->synths[kick->per_index], osc_index, type);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_set_osc_function(kick->synths[id], osc_index, type);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -294,9 +465,22 @@ geonkick_get_osc_function(struct geonkick *kick,
 			  size_t osc_index,
 			  enum geonkick_osc_func_type *type)
 {
-        if (kick == NULL || type == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_osc_function_id(kick, kick->per_index, osc_index, type);
+}
+
+enum geonkick_error
+geonkick_get_osc_function_id(struct geonkick *kick,
+                             size_t id,
+                             size_t osc_index,
+                             enum geonkick_osc_func_type *type)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || type == NULL)
                 return GEONKICK_ERROR;
-        return gkick_synth_get_osc_function(kick->synths[kick->per_index], osc_index, type);
+        return gkick_synth_get_osc_function(kick->synths[id], osc_index, type);
 }
 
 enum geonkick_error
@@ -304,12 +488,25 @@ geonkick_set_osc_phase(struct geonkick *kick,
                        size_t osc_index,
                        gkick_real phase)
 {
-        if (kick == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_set_osc_phase_id(kick, kick->per_index, osc_index, phase);
+}
+
+enum geonkick_error
+geonkick_set_osc_phase_id(struct geonkick *kick,
+                          size_t id,
+                          size_t osc_index,
+                          gkick_real phase)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS)
                 return GEONKICK_ERROR;
 
         enum geonkick_error res;
-        res = gkick_synth_set_osc_phase(kick->synths[kick->per_index], osc_index, phase);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_set_osc_phase(kick->synths[id], osc_index, phase);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 
@@ -320,10 +517,23 @@ geonkick_get_osc_phase(struct geonkick *kick,
                        size_t osc_index,
                        gkick_real *phase)
 {
-        if (kick == NULL || phase == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_osc_phase_id(kick, kick->per_index, osc_index, phase);
+}
+
+enum geonkick_error
+geonkick_get_osc_phase_id(struct geonkick *kick,
+                          size_t id,
+                          size_t osc_index,
+                          gkick_real *phase)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || phase == NULL)
                 return GEONKICK_ERROR;
 
-        return gkick_synth_get_osc_phase(kick->synths[kick->per_index],
+        return gkick_synth_get_osc_phase(kick->synths[id],
                                          osc_index,
                                          phase);
 }
@@ -337,13 +547,26 @@ geonkick_set_osc_seed(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_set_osc_seed_id(kick, kick->per_index, osc_index, seed);
+}
+
+enum geonkick_error
+geonkick_set_osc_seed_id(struct geonkick *kick,
+                         size_t id,
+                         size_t osc_index,
+                         unsigned int seed)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
 
 
         enum geonkick_error res;
-        res = gkick_synth_set_osc_seed(kick->synths[kick->per_index],
+        res = gkick_synth_set_osc_seed(kick->synths[id],
                                        osc_index,
                                        seed);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -357,8 +580,21 @@ geonkick_get_osc_seed(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_get_osc_seed_id(kick, kick->per_index, osc_index, seed);
+}
+
+enum geonkick_error
+geonkick_get_osc_seed_id(struct geonkick *kick,
+                         size_t id,
+                         size_t osc_index,
+                         unsigned int *seed)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
 
-        return gkick_synth_get_osc_seed(kick->synths[kick->per_index],
+        return gkick_synth_get_osc_seed(kick->synths[id],
                                         osc_index,
                                         seed);
 
@@ -371,10 +607,22 @@ geonkick_set_length(struct geonkick *kick, gkick_real len)
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_set_length_id(kick, kick->per_index, len);
+}
+
+enum geonkick_error
+geonkick_set_length_id(struct geonkick *kick,
+                       size_t id,
+                       gkick_real len)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
 
         enum geonkick_error res;
-        res = gkick_synth_set_length(kick->synths[kick->per_index], len);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_set_length(kick->synths[id], len);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -383,9 +631,21 @@ enum geonkick_error
 geonkick_get_length(struct geonkick *kick,
                     gkick_real *len)
 {
-        if (kick == NULL || len == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_length_id(kick, kick->per_index, len);
+}
+
+enum geonkick_error
+geonkick_get_length_id(struct geonkick *kick,
+                       size_t id,
+                       gkick_real *len)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || len == NULL)
                 return GEONKICK_ERROR;
-        return gkick_synth_get_length(kick->synths[kick->per_index], len);
+        return gkick_synth_get_length(kick->synths[id], len);
 }
 
 enum geonkick_error
@@ -406,13 +666,25 @@ geonkick_kick_set_amplitude(struct geonkick *kick,
                             gkick_real amplitude)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_set_amplitude_id(kick, kick->per_index, amplitude);
+}
+
+enum geonkick_error
+geonkick_kick_set_amplitude_id(struct geonkick *kick,
+                               size_t id,
+                               gkick_real amplitude)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
 
         enum geonkick_error res;
-        res = gkick_synth_kick_set_amplitude(kick->synths[kick->per_index], amplitude);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_kick_set_amplitude(kick->synths[id], amplitude);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -421,11 +693,23 @@ enum geonkick_error
 geonkick_kick_get_amplitude(struct geonkick *kick,
                             gkick_real *amplitude)
 {
-        if (kick == NULL || amplitude == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_get_amplitude_id(kick, kick->per_index, amplitude);
+}
+
+enum geonkick_error
+geonkick_kick_get_amplitude_id(struct geonkick *kick,
+                               size_t id,
+                               gkick_real *amplitude)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || amplitude == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_kick_get_amplitude(kick->synths[kick->per_index], amplitude);
+        return gkick_synth_kick_get_amplitude(kick->synths[id], amplitude);
 }
 
 enum geonkick_error
@@ -433,13 +717,25 @@ geonkick_kick_set_filter_frequency(struct geonkick *kick,
                                    gkick_real frequency)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_set_filter_frequency_id(kick, kick->per_index, frequency);
+}
+
+enum geonkick_error
+geonkick_kick_set_filter_frequency_id(struct geonkick *kick,
+                                      size_t id,
+                                      gkick_real frequency)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
 
         enum geonkick_error res;
-        res = gkick_synth_kick_set_filter_frequency(kick->synths[kick->per_index], frequency);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_kick_set_filter_frequency(kick->synths[id], frequency);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -449,13 +745,25 @@ geonkick_kick_filter_enable(struct geonkick *kick,
                             int enable)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_filter_enable_id(kick, kick->per_index, enable);
+}
+
+enum geonkick_error
+geonkick_kick_filter_enable_id(struct geonkick *kick,
+                               size_t id,
+                               int enable)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
 
         enum geonkick_error res;
-        res = geonkick_synth_kick_filter_enable(kick->synths[kick->per_index], enable);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = geonkick_synth_kick_filter_enable(kick->synths[id], enable);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -464,11 +772,23 @@ enum geonkick_error
 geonkick_kick_filter_is_enabled(struct geonkick *kick,
                                 int *enabled)
 {
-        if (kick == NULL || enabled == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_filter_is_enabled_id(kick, kick->per_index, enabled);
+}
+
+enum geonkick_error
+geonkick_kick_filter_is_enabled_id(struct geonkick *kick,
+                                   size_t id,
+                                   int *enabled)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || enabled == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return geonkick_synth_kick_filter_is_enabled(kick->synths[kick->per_index],
+        return geonkick_synth_kick_filter_is_enabled(kick->synths[id],
                                                      enabled);
 }
 
@@ -476,11 +796,23 @@ enum geonkick_error
 geonkick_kick_get_filter_frequency(struct geonkick *kick,
                                    gkick_real *frequency)
 {
-        if (kick == NULL || frequency == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_get_filter_frequency_id(kick, kick->per_index, frequency);
+}
+
+enum geonkick_error
+geonkick_kick_get_filter_frequency_id(struct geonkick *kick,
+                                      size_t id,
+                                      gkick_real *frequency)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || frequency == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_kick_get_filter_frequency(kick->synths[kick->per_index],
+        return gkick_synth_kick_get_filter_frequency(kick->synths[id],
                                                      frequency);
 }
 
@@ -489,12 +821,24 @@ geonkick_kick_set_filter_factor(struct geonkick *kick,
                                 gkick_real factor)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_set_filter_factor_id(kick, kick->per_index, factor);
+}
+
+enum geonkick_error
+geonkick_kick_set_filter_factor_id(struct geonkick *kick,
+                                   size_t id,
+                                   gkick_real factor)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
         enum geonkick_error res;
-        res = gkick_synth_kick_set_filter_factor(kick->synths[kick->per_index], factor);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_kick_set_filter_factor(kick->synths[id], factor);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -503,11 +847,23 @@ enum geonkick_error
 geonkick_kick_get_filter_factor(struct geonkick *kick,
                                 gkick_real *factor)
 {
-        if (kick == NULL || factor == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_get_filter_factor_id(kick, kick->per_index, factor);
+}
+
+enum geonkick_error
+geonkick_kick_get_filter_factor_id(struct geonkick *kick,
+                                   size_t id,
+                                   gkick_real *factor)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || factor == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_kick_get_filter_factor(kick->synths[kick->per_index], factor);
+        return gkick_synth_kick_get_filter_factor(kick->synths[id], factor);
 }
 
 enum geonkick_error
@@ -515,12 +871,24 @@ geonkick_set_kick_filter_type(struct geonkick *kick,
                               enum gkick_filter_type type)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_set_kick_filter_type_id(kick, kick->per_index, type);
+}
+
+enum geonkick_error
+geonkick_set_kick_filter_type_id(struct geonkick *kick,
+                                 size_t id,
+                                 enum gkick_filter_type type)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
         enum geonkick_error res;
-        res = gkick_synth_set_kick_filter_type(kick->synths[kick->per_index], type);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        res = gkick_synth_set_kick_filter_type(kick->synths[id], type);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -529,11 +897,23 @@ enum geonkick_error
 geonkick_get_kick_filter_type(struct geonkick *kick,
                               enum gkick_filter_type *type)
 {
-        if (kick == NULL || type == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_kick_filter_type_id(kick, kick->per_index, type);
+}
+
+enum geonkick_error
+geonkick_get_kick_filter_type_id(struct geonkick *kick,
+                                 size_t id,
+                                 enum gkick_filter_type *type)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || type == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_get_kick_filter_type(kick->synths[kick->per_index], type);
+        return gkick_synth_get_kick_filter_type(kick->synths[id], type);
 }
 
 enum geonkick_error
@@ -542,11 +922,25 @@ geonkick_kick_envelope_get_points(struct geonkick *kick,
                                   gkick_real **buf,
                                   size_t *npoints)
 {
-        if (kick == NULL || buf == NULL || npoints == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_envelope_get_points_id(kick, kick->per_index, env_type, buf, npoints);
+}
+
+enum geonkick_error
+geonkick_kick_envelope_get_points_id(struct geonkick *kick,
+                                     size_t id,
+                                     enum geonkick_envelope_type env_type,
+                                     gkick_real **buf,
+                                     size_t *npoints)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || buf == NULL || npoints == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_kick_envelope_get_points(kick->synths[kick->per_index],
+        return gkick_synth_kick_envelope_get_points(kick->synths[id],
                                                     env_type,
                                                     buf,
                                                     npoints);
@@ -558,14 +952,28 @@ geonkick_kick_envelope_set_points(struct geonkick *kick,
                                   const gkick_real *buff,
                                   size_t npoints)
 {
-        if (kick == NULL || buff == NULL || npoints == 0)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
-        enum geonkick_error res;
-        res = gkick_synth_kick_envelope_set_points(kick->synths[kick->per_index],
+        }
+        return geonkick_kick_envelope_set_points_id(kick, kick->per_index, env_type, buff, npoints);
+}
+
+enum geonkick_error
+geonkick_kick_envelope_set_points_id(struct geonkick *kick,
+                                     size_t id,
+                                     enum geonkick_envelope_type env_type,
+                                     const gkick_real *buff,
+                                     size_t npoints)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || buff == NULL || npoints == 0)
+                return GEONKICK_ERROR;
+        enum geonkick_error res;
+        res = gkick_synth_kick_envelope_set_points(kick->synths[id],
                                                    env_type,
                                                    buff,
                                                    npoints);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 
@@ -578,14 +986,28 @@ geonkick_kick_add_env_point(struct geonkick *kick,
                             gkick_real y)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_add_env_point_id(kick, kick->per_index, env_type, x, y);
+}
+
+enum geonkick_error
+geonkick_kick_add_env_point_id(struct geonkick *kick,
+                               size_t id,
+                               enum geonkick_envelope_type env_type,
+                               gkick_real x,
+                               gkick_real y)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
         enum geonkick_error res;
-        res = gkick_synth_kick_add_env_point(kick->synths[kick->per_index],
+        res = gkick_synth_kick_add_env_point(kick->synths[id],
                                              env_type,
                                              x, y);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -596,14 +1018,27 @@ geonkick_kick_remove_env_point(struct geonkick *kick,
                                size_t index)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_remove_env_point_id(kick, kick->per_index, env_type, index);
+}
+
+enum geonkick_error
+geonkick_kick_remove_env_point_id(struct geonkick *kick,
+                                  size_t id,
+                                  enum geonkick_envelope_type env_type,
+                                  size_t index)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
         enum geonkick_error res;
-        res = gkick_synth_kick_remove_env_point(kick->synths[kick->per_index],
+        res = gkick_synth_kick_remove_env_point(kick->synths[id],
                                                 env_type,
                                                 index);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -616,14 +1051,29 @@ geonkick_kick_update_env_point(struct geonkick *kick,
                                gkick_real y)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_kick_update_env_point_id(kick, kick->per_index, env_type, index, x, y);
+}
+
+enum geonkick_error
+geonkick_kick_update_env_point_id(struct geonkick *kick,
+                                  size_t id,
+                                  enum geonkick_envelope_type env_type,
+                                  size_t index,
+                                  gkick_real x,
+                                  gkick_real y)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
         enum geonkick_error res;
-        res = gkick_synth_kick_update_env_point(kick->synths[kick->per_index],
+        res = gkick_synth_kick_update_env_point(kick->synths[id],
                                                 env_type,
                                                 index, x, y);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -633,16 +1083,29 @@ geonkick_set_osc_frequency(struct geonkick *kick,
                            size_t osc_index,
                            gkick_real v)
 {
-	if (kick == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_set_osc_frequency_id(kick, kick->per_index, osc_index, v);
+}
+
+enum geonkick_error
+geonkick_set_osc_frequency_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              gkick_real v)
+{
+	if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
 		gkick_log_error("wrong arguments");
 		return GEONKICK_ERROR;
 	}
 
         enum geonkick_error res;
-        res = gkick_synth_set_osc_frequency(kick->synths[kick->per_index],
+        res = gkick_synth_set_osc_frequency(kick->synths[id],
                                             osc_index,
                                             v);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -652,16 +1115,29 @@ geonkick_set_osc_amplitude(struct geonkick *kick,
                            size_t osc_index,
                            gkick_real v)
 {
-	if (kick == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_set_osc_amplitude_id(kick, kick->per_index, osc_index, v);
+}
+
+enum geonkick_error
+geonkick_set_osc_amplitude_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              gkick_real v)
+{
+	if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
 		gkick_log_error("wrong arguments");
 		return GEONKICK_ERROR;
 	}
 
         enum geonkick_error res;
-        res = gkick_synth_set_osc_amplitude(kick->synths[kick->per_index],
+        res = gkick_synth_set_osc_amplitude(kick->synths[id],
                                             osc_index,
                                             v);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -671,9 +1147,22 @@ geonkick_get_osc_amplitude(struct geonkick *kick,
                            size_t osc_index,
                            gkick_real *v)
 {
-	if (kick == NULL || v == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_osc_amplitude_id(kick, kick->per_index, osc_index, v);
+}
+
+enum geonkick_error
+geonkick_get_osc_amplitude_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              gkick_real *v)
+{
+	if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || v == NULL)
 		return GEONKICK_ERROR;
-        return gkick_synth_get_osc_amplitude(kick->synths[kick->per_index],
+        return gkick_synth_get_osc_amplitude(kick->synths[id],
                                              osc_index,
                                              v);
 }
@@ -683,9 +1172,22 @@ geonkick_get_osc_frequency(struct geonkick *kick,
                            size_t osc_index,
                            gkick_real *v)
 {
-	if (kick == NULL || v == NULL)
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_osc_frequency_id(kick, kick->per_index, osc_index, v);
+}
+
+enum geonkick_error
+geonkick_get_osc_frequency_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              gkick_real *v)
+{
+	if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || v == NULL)
 		return GEONKICK_ERROR;
-	return gkick_synth_get_osc_frequency(kick->synths[kick->per_index],
+	return gkick_synth_get_osc_frequency(kick->synths[id],
                                              osc_index,
                                              v);
 }
@@ -700,6 +1202,21 @@ geonkick_play(struct geonkick *kick, size_t id)
         return gkick_audio_play(kick->audio, id);
 }
 
+enum geonkick_error
+geonkick_play_preview(struct geonkick *kick,
+                      struct gkick_sample *sample)
+{
+        if (kick == NULL || sample == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        geonkick_lock(kick);
+        enum geonkick_error res = gkick_audio_play_preview(kick->audio, sample);
+        geonkick_unlock(kick);
+        return res;
+}
+
 enum geonkick_error
 geonkick_key_pressed(struct geonkick *kick,
                      bool pressed,
@@ -718,13 +1235,25 @@ geonkick_key_pressed(struct geonkick *kick,
 
 enum geonkick_error
 geonkick_get_kick_buffer_size(struct geonkick *kick, size_t *size)
+{
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_kick_buffer_size_id(kick, kick->per_index, size);
+}
+
+enum geonkick_error
+geonkick_get_kick_buffer_size_id(struct geonkick *kick,
+                                 size_t id,
+                                 size_t *size)
 {
         enum geonkick_error res;
-        if (kick  == NULL || size == NULL) {
+        if (kick  == NULL || id >= GEONKICK_MAX_PERCUSSIONS || size == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        res = gkick_synth_get_buffer_size(kick->synths[kick->per_index],
+        res = gkick_synth_get_buffer_size(kick->synths[id],
                                           size);
         return res;
 }
@@ -733,13 +1262,26 @@ enum geonkick_error
 geonkick_get_kick_buffer(struct geonkick *kick,
                          gkick_real *buffer,
                          size_t size)
+{
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_kick_buffer_id(kick, kick->per_index, buffer, size);
+}
+
+enum geonkick_error
+geonkick_get_kick_buffer_id(struct geonkick *kick,
+                            size_t id,
+                            gkick_real *buffer,
+                            size_t size)
 {
         enum geonkick_error res;
-        if (kick  == NULL || buffer == NULL || size < 1) {
+        if (kick  == NULL || id >= GEONKICK_MAX_PERCUSSIONS || buffer == NULL || size < 1) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        res = gkick_synth_get_buffer(kick->synths[kick->per_index],
+        res = gkick_synth_get_buffer(kick->synths[id],
                                      buffer,
                                      size);
         return res;
@@ -814,15 +1356,28 @@ geonkick_set_osc_filter_type(struct geonkick *kick,
                              enum gkick_filter_type type)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_set_osc_filter_type_id(kick, kick->per_index, osc_index, type);
+}
+
+enum geonkick_error
+geonkick_set_osc_filter_type_id(struct geonkick *kick,
+                                size_t id,
+                                size_t osc_index,
+                                enum gkick_filter_type type)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
 
         enum geonkick_error res;
-        res = gkick_synth_set_osc_filter_type(kick->synths[kick->per_index],
+        res = gkick_synth_set_osc_filter_type(kick->synths[id],
                                               osc_index,
                                               type);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -832,11 +1387,24 @@ geonkick_get_osc_filter_type(struct geonkick *kick,
                              size_t osc_index,
                              enum gkick_filter_type *type)
 {
-        if (kick == NULL || type == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_osc_filter_type_id(kick, kick->per_index, osc_index, type);
+}
+
+enum geonkick_error
+geonkick_get_osc_filter_type_id(struct geonkick *kick,
+                                size_t id,
+                                size_t osc_index,
+                                enum gkick_filter_type *type)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || type == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_get_osc_filter_type(kick->synths[kick->per_index],
+        return gkick_synth_get_osc_filter_type(kick->synths[id],
                                                osc_index,
                                                type);
 }
@@ -847,15 +1415,28 @@ geonkick_set_osc_filter_cutoff_freq(struct geonkick *kick,
                                     gkick_real cutoff)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_set_osc_filter_cutoff_freq_id(kick, kick->per_index, osc_index, cutoff);
+}
+
+enum geonkick_error
+geonkick_set_osc_filter_cutoff_freq_id(struct geonkick *kick,
+                                       size_t id,
+                                       size_t osc_index,
+                                       gkick_real cutoff)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
 
         enum geonkick_error res;
-        res = gkick_synth_set_osc_filter_cutoff(kick->synths[kick->per_index],
+        res = gkick_synth_set_osc_filter_cutoff(kick->synths[id],
                                                 osc_index,
                                                 cutoff);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -865,11 +1446,24 @@ geonkick_get_osc_filter_cutoff_freq(struct geonkick *kick,
                                     size_t osc_index,
                                     gkick_real *cutoff)
 {
-        if (kick == NULL || cutoff == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_osc_filter_cutoff_freq_id(kick, kick->per_index, osc_index, cutoff);
+}
+
+enum geonkick_error
+geonkick_get_osc_filter_cutoff_freq_id(struct geonkick *kick,
+                                       size_t id,
+                                       size_t osc_index,
+                                       gkick_real *cutoff)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || cutoff == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_get_osc_filter_cutoff(kick->synths[kick->per_index],
+        return gkick_synth_get_osc_filter_cutoff(kick->synths[id],
                                                  osc_index,
                                                  cutoff);
 }
@@ -880,14 +1474,27 @@ geonkick_set_osc_filter_factor(struct geonkick *kick,
                                gkick_real factor)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_set_osc_filter_factor_id(kick, kick->per_index, osc_index, factor);
+}
+
+enum geonkick_error
+geonkick_set_osc_filter_factor_id(struct geonkick *kick,
+                                  size_t id,
+                                  size_t osc_index,
+                                  gkick_real factor)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
         enum geonkick_error res;
-        res = gkick_synth_set_osc_filter_factor(kick->synths[kick->per_index],
+        res = gkick_synth_set_osc_filter_factor(kick->synths[id],
                                                 osc_index,
                                                 factor);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -897,11 +1504,24 @@ geonkick_get_osc_filter_factor(struct geonkick *kick,
                                size_t osc_index,
                                gkick_real *factor)
 {
-        if (kick == NULL || factor == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_osc_filter_factor_id(kick, kick->per_index, osc_index, factor);
+}
+
+enum geonkick_error
+geonkick_get_osc_filter_factor_id(struct geonkick *kick,
+                                  size_t id,
+                                  size_t osc_index,
+                                  gkick_real *factor)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || factor == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_get_osc_filter_factor(kick->synths[kick->per_index],
+        return gkick_synth_get_osc_filter_factor(kick->synths[id],
                                                  osc_index,
                                                  factor);
 }
@@ -913,14 +1533,27 @@ geonkick_enbale_osc_filter(struct geonkick *kick,
                            int enable)
 {
         if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_enbale_osc_filter_id(kick, kick->per_index, osc_index, enable);
+}
+
+enum geonkick_error
+geonkick_enbale_osc_filter_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              int enable)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
         enum geonkick_error res;
-        res = gkick_synth_osc_enable_filter(kick->synths[kick->per_index],
+        res = gkick_synth_osc_enable_filter(kick->synths[id],
                                             osc_index,
                                             enable);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -930,11 +1563,24 @@ geonkick_osc_filter_is_enabled(struct geonkick *kick,
                                size_t osc_index,
                                int *enable)
 {
-        if (kick == NULL || enable == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_osc_filter_is_enabled_id(kick, kick->per_index, osc_index, enable);
+}
+
+enum geonkick_error
+geonkick_osc_filter_is_enabled_id(struct geonkick *kick,
+                                  size_t id,
+                                  size_t osc_index,
+                                  int *enable)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || enable == NULL) {
                 gkick_log_error("wrong arugments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_osc_is_enabled_filter(kick->synths[kick->per_index],
+        return gkick_synth_osc_is_enabled_filter(kick->synths[id],
                                                  osc_index,
                                                  enable);
 }
@@ -973,6 +1619,26 @@ geonkick_enable_synthesis(struct geonkick *kick,
         return GEONKICK_OK;
 }
 
+enum geonkick_error
+geonkick_enable_draft_synthesis(struct geonkick *kick,
+                                bool enable)
+{
+	if (kick == NULL) {
+		gkick_log_error("wrong arguments");
+		return GEONKICK_ERROR;
+	}
+
+        bool update = false;
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
+                gkick_synth_set_draft(kick->synths[i], enable);
+                if (kick->synths[i]->buffer_update)
+                        update = true;
+        }
+        if (update)
+                geonkick_worker_wakeup(kick);
+        return GEONKICK_OK;
+}
+
 enum geonkick_error
 geonkick_get_audio_frame(struct geonkick *kick,
                          int channel,
@@ -991,10 +1657,22 @@ geonkick_compressor_enable(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_compressor_enable_id(kick, kick->per_index, enable);
+}
+
+enum geonkick_error
+geonkick_compressor_enable_id(struct geonkick *kick,
+                              size_t id,
+                              int enable)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_compressor_enable(kick->synths[kick->per_index],
+        res = gkick_synth_compressor_enable(kick->synths[id],
                                             enable);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 
@@ -1004,11 +1682,23 @@ enum geonkick_error
 geonkick_compressor_is_enabled(struct geonkick *kick,
                                int *enabled)
 {
-        if (kick == NULL || enabled == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_compressor_is_enabled_id(kick, kick->per_index, enabled);
+}
+
+enum geonkick_error
+geonkick_compressor_is_enabled_id(struct geonkick *kick,
+                                  size_t id,
+                                  int *enabled)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || enabled == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_compressor_is_enabled(kick->synths[kick->per_index],
+        return gkick_synth_compressor_is_enabled(kick->synths[id],
                                                  enabled);
 }
 
@@ -1020,10 +1710,22 @@ geonkick_compressor_set_attack(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_compressor_set_attack_id(kick, kick->per_index, attack);
+}
+
+enum geonkick_error
+geonkick_compressor_set_attack_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real attack)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_compressor_set_attack(kick->synths[kick->per_index],
+        res = gkick_synth_compressor_set_attack(kick->synths[id],
                                                 attack);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1032,11 +1734,23 @@ enum geonkick_error
 geonkick_compressor_get_attack(struct geonkick *kick,
                                gkick_real *attack)
 {
-        if (kick == NULL || attack == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_compressor_get_attack_id(kick, kick->per_index, attack);
+}
+
+enum geonkick_error
+geonkick_compressor_get_attack_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real *attack)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || attack == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_compressor_get_attack(kick->synths[kick->per_index],
+        return gkick_synth_compressor_get_attack(kick->synths[id],
                                                  attack);
 }
 
@@ -1048,10 +1762,22 @@ geonkick_compressor_set_release(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_compressor_set_release_id(kick, kick->per_index, release);
+}
+
+enum geonkick_error
+geonkick_compressor_set_release_id(struct geonkick *kick,
+                                   size_t id,
+                                   gkick_real release)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_compressor_set_release(kick->synths[kick->per_index],
+        res = gkick_synth_compressor_set_release(kick->synths[id],
                                                  release);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1060,11 +1786,23 @@ enum geonkick_error
 geonkick_compressor_get_release(struct geonkick *kick,
                                 gkick_real *release)
 {
-        if (kick == NULL || release == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_compressor_get_release_id(kick, kick->per_index, release);
+}
+
+enum geonkick_error
+geonkick_compressor_get_release_id(struct geonkick *kick,
+                                   size_t id,
+                                   gkick_real *release)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || release == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_compressor_get_release(kick->synths[kick->per_index],
+        return gkick_synth_compressor_get_release(kick->synths[id],
                                                   release);
 }
 
@@ -1076,10 +1814,22 @@ geonkick_compressor_set_threshold(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_compressor_set_threshold_id(kick, kick->per_index, threshold);
+}
+
+enum geonkick_error
+geonkick_compressor_set_threshold_id(struct geonkick *kick,
+                                     size_t id,
+                                     gkick_real threshold)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_compressor_set_threshold(kick->synths[kick->per_index],
+        res = gkick_synth_compressor_set_threshold(kick->synths[id],
                                                    threshold);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1088,11 +1838,23 @@ enum geonkick_error
 geonkick_compressor_get_threshold(struct geonkick *kick,
                                   gkick_real *threshold)
 {
-        if (kick == NULL || threshold == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_compressor_get_threshold_id(kick, kick->per_index, threshold);
+}
+
+enum geonkick_error
+geonkick_compressor_get_threshold_id(struct geonkick *kick,
+                                     size_t id,
+                                     gkick_real *threshold)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || threshold == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_compressor_get_threshold(kick->synths[kick->per_index],
+        return gkick_synth_compressor_get_threshold(kick->synths[id],
                                                     threshold);
 }
 
@@ -1104,10 +1866,22 @@ geonkick_compressor_set_ratio(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_compressor_set_ratio_id(kick, kick->per_index, ratio);
+}
+
+enum geonkick_error
+geonkick_compressor_set_ratio_id(struct geonkick *kick,
+                                 size_t id,
+                                 gkick_real ratio)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_compressor_set_ratio(kick->synths[kick->per_index],
+        res = gkick_synth_compressor_set_ratio(kick->synths[id],
                                                ratio);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1116,26 +1890,50 @@ enum geonkick_error
 geonkick_compressor_get_ratio(struct geonkick *kick,
                               gkick_real *ratio)
 {
-        if (kick == NULL || ratio == NULL) {
+        if (kick == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_compressor_get_ratio(kick->synths[kick->per_index],
-                                                ratio);
+        return geonkick_compressor_get_ratio_id(kick, kick->per_index, ratio);
 }
 
 enum geonkick_error
-geonkick_compressor_set_knee(struct geonkick *kick,
-                             gkick_real knee)
+geonkick_compressor_get_ratio_id(struct geonkick *kick,
+                                 size_t id,
+                                 gkick_real *ratio)
 {
-        if (kick == NULL) {
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || ratio == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        enum geonkick_error res;
-        res = gkick_synth_compressor_set_knee(kick->synths[kick->per_index],
-                                              knee);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        return gkick_synth_compressor_get_ratio(kick->synths[id],
+                                                ratio);
+}
+
+enum geonkick_error
+geonkick_compressor_set_knee(struct geonkick *kick,
+                             gkick_real knee)
+{
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_compressor_set_knee_id(kick, kick->per_index, knee);
+}
+
+enum geonkick_error
+geonkick_compressor_set_knee_id(struct geonkick *kick,
+                                size_t id,
+                                gkick_real knee)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        enum geonkick_error res;
+        res = gkick_synth_compressor_set_knee(kick->synths[id],
+                                              knee);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1144,11 +1942,23 @@ enum geonkick_error
 geonkick_compressor_get_knee(struct geonkick *kick,
                              gkick_real *knee)
 {
-        if (kick == NULL || knee == NULL) {
+        if (kick == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_compressor_get_knee(kick->synths[kick->per_index], knee);
+        return geonkick_compressor_get_knee_id(kick, kick->per_index, knee);
+}
+
+enum geonkick_error
+geonkick_compressor_get_knee_id(struct geonkick *kick,
+                                size_t id,
+                                gkick_real *knee)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || knee == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return gkick_synth_compressor_get_knee(kick->synths[id], knee);
 }
 
 enum geonkick_error
@@ -1159,10 +1969,22 @@ geonkick_compressor_set_makeup(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_compressor_set_makeup_id(kick, kick->per_index, makeup);
+}
+
+enum geonkick_error
+geonkick_compressor_set_makeup_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real makeup)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_compressor_set_makeup(kick->synths[kick->per_index],
+        res = gkick_synth_compressor_set_makeup(kick->synths[id],
                                                 makeup);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 
@@ -1172,11 +1994,23 @@ enum geonkick_error
 geonkick_compressor_get_makeup(struct geonkick *kick,
                                gkick_real *makeup)
 {
-        if (kick == NULL || makeup == NULL) {
+        if (kick == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_compressor_get_makeup(kick->synths[kick->per_index],
+        return geonkick_compressor_get_makeup_id(kick, kick->per_index, makeup);
+}
+
+enum geonkick_error
+geonkick_compressor_get_makeup_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real *makeup)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || makeup == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return gkick_synth_compressor_get_makeup(kick->synths[id],
                                                  makeup);
 }
 
@@ -1187,10 +2021,22 @@ geonkick_distortion_enable(struct geonkick *kick, int enable)
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_distortion_enable_id(kick, kick->per_index, enable);
+}
+
+enum geonkick_error
+geonkick_distortion_enable_id(struct geonkick *kick,
+                              size_t id,
+                              int enable)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_distortion_enable(kick->synths[kick->per_index],
+        res = gkick_synth_distortion_enable(kick->synths[id],
                                             enable);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1199,11 +2045,23 @@ enum geonkick_error
 geonkick_distortion_is_enabled(struct geonkick *kick,
                                int *enabled)
 {
-        if (kick == NULL || enabled == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_distortion_is_enabled_id(kick, kick->per_index, enabled);
+}
+
+enum geonkick_error
+geonkick_distortion_is_enabled_id(struct geonkick *kick,
+                                  size_t id,
+                                  int *enabled)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || enabled == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_distortion_is_enabled(kick->synths[kick->per_index],
+        return gkick_synth_distortion_is_enabled(kick->synths[id],
                                                  enabled);
 }
 
@@ -1211,15 +2069,27 @@ enum geonkick_error
 geonkick_distortion_set_in_limiter(struct geonkick *kick,
                                    gkick_real limit)
 {
-	if (kick == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_distortion_set_in_limiter_id(kick, kick->per_index, limit);
+}
+
+enum geonkick_error
+geonkick_distortion_set_in_limiter_id(struct geonkick *kick,
+                                      size_t id,
+                                      gkick_real limit)
+{
+	if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
 		gkick_log_error("wrong arguments");
 		return GEONKICK_ERROR;
 	}
 
 	enum geonkick_error res;
-	res = gkick_synth_distortion_set_in_limiter(kick->synths[kick->per_index],
+	res = gkick_synth_distortion_set_in_limiter(kick->synths[id],
                                                     limit);
-	if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+	if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
 	return res;
 }
@@ -1228,11 +2098,23 @@ enum geonkick_error
 geonkick_distortion_get_in_limiter(struct geonkick *kick,
                                    gkick_real *limit)
 {
-	if (kick == NULL || limit == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_distortion_get_in_limiter_id(kick, kick->per_index, limit);
+}
+
+enum geonkick_error
+geonkick_distortion_get_in_limiter_id(struct geonkick *kick,
+                                      size_t id,
+                                      gkick_real *limit)
+{
+	if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || limit == NULL) {
 		gkick_log_error("wrong arguments");
 		return GEONKICK_ERROR;
 	}
-	return gkick_synth_distortion_get_in_limiter(kick->synths[kick->per_index],
+	return gkick_synth_distortion_get_in_limiter(kick->synths[id],
                                                      limit);
 }
 
@@ -1244,10 +2126,22 @@ geonkick_distortion_set_volume(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_distortion_set_volume_id(kick, kick->per_index, volume);
+}
+
+enum geonkick_error
+geonkick_distortion_set_volume_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real volume)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_distortion_set_volume(kick->synths[kick->per_index],
+        res = gkick_synth_distortion_set_volume(kick->synths[id],
                                                 volume);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1255,11 +2149,23 @@ geonkick_distortion_set_volume(struct geonkick *kick,
 enum geonkick_error
 geonkick_distortion_get_volume(struct geonkick *kick, gkick_real *volume)
 {
-        if (kick == NULL || volume == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_distortion_get_volume_id(kick, kick->per_index, volume);
+}
+
+enum geonkick_error
+geonkick_distortion_get_volume_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real *volume)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || volume == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_distortion_get_volume(kick->synths[kick->per_index],
+        return gkick_synth_distortion_get_volume(kick->synths[id],
                                                  volume);
 }
 
@@ -1271,10 +2177,22 @@ geonkick_distortion_set_drive(struct geonkick *kick,
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_distortion_set_drive_id(kick, kick->per_index, drive);
+}
+
+enum geonkick_error
+geonkick_distortion_set_drive_id(struct geonkick *kick,
+                                 size_t id,
+                                 gkick_real drive)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
         enum geonkick_error res;
-        res = gkick_synth_distortion_set_drive(kick->synths[kick->per_index],
+        res = gkick_synth_distortion_set_drive(kick->synths[id],
                                                drive);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1283,11 +2201,23 @@ enum geonkick_error
 geonkick_distortion_get_drive(struct geonkick *kick,
                               gkick_real *drive)
 {
-        if (kick == NULL || drive == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_distortion_get_drive_id(kick, kick->per_index, drive);
+}
+
+enum geonkick_error
+geonkick_distortion_get_drive_id(struct geonkick *kick,
+                                 size_t id,
+                                 gkick_real *drive)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || drive == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
-        return gkick_synth_distortion_get_drive(kick->synths[kick->per_index],
+        return gkick_synth_distortion_get_drive(kick->synths[id],
                                                 drive);
 }
 
@@ -1317,16 +2247,29 @@ geonkick_enable_group(struct geonkick *kick,
                       size_t index,
                       bool enable)
 {
-        if (kick == NULL || index >= GKICK_OSC_GROUPS_NUMBER) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_enable_group_id(kick, kick->per_index, index, enable);
+}
+
+enum geonkick_error
+geonkick_enable_group_id(struct geonkick *kick,
+                         size_t id,
+                         size_t index,
+                         bool enable)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || index >= GKICK_OSC_GROUPS_NUMBER) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
 
         enum geonkick_error res;
-        res  = gkick_synth_enable_group(kick->synths[kick->per_index],
+        res  = gkick_synth_enable_group(kick->synths[id],
                                         index,
                                         enable);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1336,13 +2279,26 @@ geonkick_group_enabled(struct geonkick *kick,
                        size_t index,
                        bool *enabled)
 {
-        if (kick == NULL || enabled == NULL
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_group_enabled_id(kick, kick->per_index, index, enabled);
+}
+
+enum geonkick_error
+geonkick_group_enabled_id(struct geonkick *kick,
+                          size_t id,
+                          size_t index,
+                          bool *enabled)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || enabled == NULL
             || index >= GKICK_OSC_GROUPS_NUMBER) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
 
-        return gkick_synth_group_enabled(kick->synths[kick->per_index],
+        return gkick_synth_group_enabled(kick->synths[id],
                                          index,
                                          enabled);
 }
@@ -1352,16 +2308,29 @@ geonkick_group_set_amplitude(struct geonkick *kick,
                              size_t index,
                              gkick_real amplitude)
 {
-        if (kick == NULL || index >= GKICK_OSC_GROUPS_NUMBER) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_group_set_amplitude_id(kick, kick->per_index, index, amplitude);
+}
+
+enum geonkick_error
+geonkick_group_set_amplitude_id(struct geonkick *kick,
+                                size_t id,
+                                size_t index,
+                                gkick_real amplitude)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || index >= GKICK_OSC_GROUPS_NUMBER) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
 
         enum geonkick_error res;
-        res  = geonkick_synth_group_set_amplitude(kick->synths[kick->per_index],
+        res  = geonkick_synth_group_set_amplitude(kick->synths[id],
                                                   index,
                                                   amplitude);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
                 geonkick_worker_wakeup(kick);
         return res;
 }
@@ -1371,14 +2340,27 @@ geonkick_group_get_amplitude(struct geonkick *kick,
                              size_t index,
                              gkick_real *amplitude)
 {
-        if (kick == NULL
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_group_get_amplitude_id(kick, kick->per_index, index, amplitude);
+}
+
+enum geonkick_error
+geonkick_group_get_amplitude_id(struct geonkick *kick,
+                                size_t id,
+                                size_t index,
+                                gkick_real *amplitude)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS
             || index >= GKICK_OSC_GROUPS_NUMBER
             || amplitude == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
 
-        return geonkick_synth_group_get_amplitude(kick->synths[kick->per_index],
+        return geonkick_synth_group_get_amplitude(kick->synths[id],
                                                   index,
                                                   amplitude);
 }
@@ -1420,17 +2402,35 @@ geonkick_set_osc_sample(struct geonkick *kick,
                         const gkick_real *data,
                         size_t size)
 {
-        if (kick == NULL || data == NULL || size < 1) {
+        if (kick == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
+        return geonkick_set_osc_sample_id(kick, kick->per_index, osc_index, data, size);
+}
 
-        enum geonkick_error res;
-        res  = geonkick_synth_set_osc_sample(kick->synths[kick->per_index],
-                                             osc_index,
-                                             data, size);
-        if (res == GEONKICK_OK && kick->synths[kick->per_index]->buffer_update)
-                geonkick_worker_wakeup(kick);
+enum geonkick_error
+geonkick_set_osc_sample_id(struct geonkick *kick,
+                           size_t id,
+                           size_t osc_index,
+                           const gkick_real *data,
+                           size_t size)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || data == NULL || size < 1) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        if (size > GEONKICK_MAX_KICK_BUFFER_SIZE)
+                size = GEONKICK_MAX_KICK_BUFFER_SIZE;
+
+        struct gkick_sample *sample = NULL;
+        enum geonkick_error res = geonkick_sample_new(data, size, &sample);
+        if (res != GEONKICK_OK)
+                return res;
+
+        res = geonkick_set_osc_sample_ref_id(kick, id, osc_index, sample);
+        gkick_sample_unref(sample);
         return res;
 }
 
@@ -1440,15 +2440,227 @@ geonkick_get_osc_sample(struct geonkick *kick,
                         gkick_real **data,
                         size_t *size)
 {
-        if (kick == NULL || data == NULL || size == NULL) {
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_osc_sample_id(kick, kick->per_index, osc_index, data, size);
+}
+
+enum geonkick_error
+geonkick_get_osc_sample_id(struct geonkick *kick,
+                           size_t id,
+                           size_t osc_index,
+                           gkick_real **data,
+                           size_t *size)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || data == NULL || size == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        *data = NULL;
+        *size = 0;
+        struct gkick_sample *sample = NULL;
+        enum geonkick_error res;
+        res = geonkick_synth_get_osc_sample(kick->synths[id], osc_index, &sample);
+        if (res != GEONKICK_OK || sample == NULL)
+                return res;
+
+        *data = (gkick_real*)malloc(sizeof(gkick_real) * sample->size);
+        if (*data == NULL) {
+                gkick_log_error("can't allocate memory");
+                gkick_sample_unref(sample);
+                return GEONKICK_ERROR_MEM_ALLOC;
+        }
+        memcpy(*data, sample->data, sizeof(gkick_real) * sample->size);
+        *size = sample->size;
+        gkick_sample_unref(sample);
+        return GEONKICK_OK;
+}
+
+enum geonkick_error
+geonkick_sample_new(const gkick_real *data,
+                    size_t size,
+                    struct gkick_sample **sample)
+{
+        if (data == NULL || size < 1 || sample == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        enum geonkick_error res = gkick_sample_create(size, sample);
+        if (res != GEONKICK_OK)
+                return res;
+        memcpy((*sample)->data, data, sizeof(gkick_real) * size);
+        return gkick_sample_publish(sample);
+}
+
+enum geonkick_error
+geonkick_sample_create(size_t size,
+                       struct gkick_sample **sample)
+{
+        return gkick_sample_create(size, sample);
+}
+
+gkick_real*
+geonkick_sample_buffer(struct gkick_sample *sample)
+{
+        if (sample == NULL || sample->published)
+                return NULL;
+        return sample->data;
+}
+
+enum geonkick_error
+geonkick_sample_shrink(struct gkick_sample *sample,
+                       size_t size)
+{
+        if (sample == NULL || sample->published || size < 1 || size > sample->size) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        sample->size = size;
+        return GEONKICK_OK;
+}
+
+enum geonkick_error
+geonkick_sample_publish(struct gkick_sample **sample)
+{
+        return gkick_sample_publish(sample);
+}
+
+struct gkick_sample*
+geonkick_sample_ref(struct gkick_sample *sample)
+{
+        return gkick_sample_ref(sample);
+}
+
+void
+geonkick_sample_unref(struct gkick_sample *sample)
+{
+        gkick_sample_unref(sample);
+}
+
+const gkick_real*
+geonkick_sample_data(const struct gkick_sample *sample)
+{
+        return sample != NULL ? sample->data : NULL;
+}
+
+size_t
+geonkick_sample_size(const struct gkick_sample *sample)
+{
+        return sample != NULL ? sample->size : 0;
+}
+
+uint64_t
+geonkick_sample_hash(const struct gkick_sample *sample)
+{
+        return sample != NULL ? sample->hash : 0;
+}
+
+void
+geonkick_sample_store_usage(size_t *number,
+                            size_t *size)
+{
+        gkick_sample_store_usage(number, size);
+}
+
+enum geonkick_error
+geonkick_sample_store_set_cache_path(const char *path)
+{
+        return gkick_sample_store_set_cache_path(path);
+}
+
+size_t
+geonkick_sample_store_mapped_size(void)
+{
+        return gkick_sample_store_mapped_size();
+}
+
+enum geonkick_error
+geonkick_get_samples_usage(struct geonkick *kick,
+                           size_t *number,
+                           size_t *size)
+{
+        if (kick == NULL || number == NULL || size == NULL) {
                 gkick_log_error("wrong arguments");
                 return GEONKICK_ERROR;
         }
 
-        return geonkick_synth_get_osc_sample(kick->synths[kick->per_index],
+        /* The samples are distinct by content, so they are compared by address. */
+        struct gkick_sample *samples[GEONKICK_MAX_PERCUSSIONS * GKICK_OSC_NUMBER];
+        *number = 0;
+        *size = 0;
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
+                gkick_synth_get_samples(kick->synths[i], samples, number,
+                                        GEONKICK_MAX_PERCUSSIONS * GKICK_OSC_NUMBER);
+        }
+        for (size_t i = 0; i < *number; i++) {
+                *size += gkick_sample_memory_size(samples[i]);
+                gkick_sample_unref(samples[i]);
+        }
+        return GEONKICK_OK;
+}
+
+enum geonkick_error
+geonkick_set_osc_sample_ref(struct geonkick *kick,
+                            size_t osc_index,
+                            struct gkick_sample *sample)
+{
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_set_osc_sample_ref_id(kick, kick->per_index, osc_index, sample);
+}
+
+enum geonkick_error
+geonkick_set_osc_sample_ref_id(struct geonkick *kick,
+                               size_t id,
+                               size_t osc_index,
+                               struct gkick_sample *sample)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        enum geonkick_error res;
+        res  = geonkick_synth_set_osc_sample(kick->synths[id],
                                              osc_index,
-                                             data,
-                                             size);
+                                             sample);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
+                geonkick_worker_wakeup(kick);
+        return res;
+}
+
+enum geonkick_error
+geonkick_get_osc_sample_ref(struct geonkick *kick,
+                            size_t osc_index,
+                            struct gkick_sample **sample)
+{
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+        return geonkick_get_osc_sample_ref_id(kick, kick->per_index, osc_index, sample);
+}
+
+enum geonkick_error
+geonkick_get_osc_sample_ref_id(struct geonkick *kick,
+                               size_t id,
+                               size_t osc_index,
+                               struct gkick_sample **sample)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS || sample == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        return geonkick_synth_get_osc_sample(kick->synths[id],
+                                             osc_index,
+                                             sample);
 }
 
 enum geonkick_error
@@ -1487,12 +2699,12 @@ geonkick_worker_init(struct geonkick *kick)
 	geonkick_lock(kick);
 	struct gkick_worker *worker = &kick->worker;
 	worker->running = false;
-        if (pthread_cond_init(&worker->condition_var, NULL) != 0) {
-                gkick_log_error("can't init worker condition variable");
+        if (pthread_cond_init(&worker->render_cond, NULL) != 0) {
+                gkick_log_error("can't init worker render condition variable");
 		geonkick_unlock(kick);
 		return GEONKICK_ERROR;
 	}
-	worker->cond_var_initilized = true;
+	worker->render_cond_initilized = true;
 	geonkick_unlock(kick);
 	return GEONKICK_OK;
 }
@@ -1500,81 +2712,116 @@ geonkick_worker_init(struct geonkick *kick)
 enum geonkick_error
 geonkick_worker_start(struct geonkick *kick)
 {
-        kick->worker.running = true;
-        if (pthread_create(&kick->worker.thread, NULL,
-                           geonkick_worker_thread, kick) != 0) {
-                gkick_log_error("can't create worker thread");
-                kick->worker.running = false;
-                return GEONKICK_ERROR;
-        }
-        return GEONKICK_OK;
+        return gkick_render_pool_register(kick);
 }
 
 void geonkick_worker_destroy(struct geonkick *kick)
 {
 	struct gkick_worker *worker = &kick->worker;
-	if (worker->running)
-		worker->running = false;
-        geonkick_lock(kick);
-        pthread_cond_signal(&kick->worker.condition_var);
-        geonkick_unlock(kick);
-	pthread_join(worker->thread, NULL);
+        gkick_render_pool_unregister(kick);
 
 	geonkick_lock(kick);
-	if (worker->cond_var_initilized)
-		pthread_cond_destroy(&worker->condition_var);
-	worker->cond_var_initilized = false;
+	if (worker->render_cond_initilized)
+		pthread_cond_destroy(&worker->render_cond);
+	worker->render_cond_initilized = false;
 	geonkick_unlock(kick);
 }
 
-void *geonkick_worker_thread(void *arg)
+/**
+ * The percussions with update transactions in progress
+ * are synthesised after the transactions are committed.
+ */
+static bool
+geonkick_worker_needs_update(struct gkick_synth *synth)
 {
-	if (arg == NULL) {
-		gkick_log_error("wrong arugments");
-		return NULL;
-	}
+        return synth != NULL && synth->is_active
+                && synth->buffer_update && synth->update_depth == 0;
+}
 
-	struct geonkick *kick = (struct geonkick*)arg;
-	struct gkick_worker *worker = &kick->worker;
-	while (worker->running) {
-		/**
-                 * Ignore too many updates.
-                 * The last udpates will be processed.
-                 */
-                usleep(40000);
-                bool update_buffers = false;
-                for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
-                        struct gkick_synth *synth = kick->synths[i];
-                        if (synth != NULL && synth->is_active && synth->buffer_update) {
-                                update_buffers = true;
-                                break;
-                        }
-                }
+/**
+ * The notes are not rendered while the draft synthesis is enabled,
+ * every draft buffer invalidates them. The requests are kept and
+ * rendered after the full rate synthesis.
+ */
+static bool
+geonkick_worker_renders_notes(struct gkick_synth *synth)
+{
+        return synth != NULL && synth->is_active && !synth->draft
+                && gkick_audio_output_is_tune_output(synth->output);
+}
 
-		if (!update_buffers) {
-		        pthread_cond_wait(&worker->condition_var, &kick->lock);
-                        geonkick_unlock(kick);
-                        if (!worker->running)
-                                break;
+void
+geonkick_worker_render(struct geonkick *kick)
+{
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
+                struct gkick_synth *synth = kick->synths[i];
+                if (geonkick_worker_needs_update(synth)) {
+                        gkick_synth_process(synth);
+                        return;
                 }
+        }
 
-                for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
-                        struct gkick_synth *synth = kick->synths[i];
-                        if (synth != NULL && synth->is_active && synth->buffer_update)
-                                gkick_synth_process(synth);
+        /* The percussions synthesis has priority over the notes rendering. */
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
+                struct gkick_synth *synth = kick->synths[i];
+                if (!geonkick_worker_renders_notes(synth))
+                        continue;
+
+                int note = gkick_note_cache_next_request(synth->output->note_cache);
+                if (note > -1) {
+                        gkick_synth_render_note(synth, note);
+                        return;
                 }
-	}
+        }
+}
 
-        return NULL;
+bool
+geonkick_worker_has_updates(struct geonkick *kick)
+{
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
+                if (geonkick_worker_needs_update(kick->synths[i]))
+                        return true;
+        }
+        return false;
 }
 
-void geonkick_worker_wakeup(struct geonkick *kick)
+bool
+geonkick_worker_is_rendering(struct geonkick *kick)
 {
-        if (kick->synthesis_on) {
-                geonkick_lock(kick);
-                pthread_cond_signal(&kick->worker.condition_var);
-                geonkick_unlock(kick);
+        return kick->worker.rendering
+                || geonkick_worker_has_updates(kick)
+                || geonkick_worker_has_note_requests(kick);
+}
+
+bool
+geonkick_worker_has_tuned_outputs(struct geonkick *kick)
+{
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
+                struct gkick_synth *synth = kick->synths[i];
+                if (synth != NULL && synth->is_active
+                    && gkick_audio_output_is_tune_output(synth->output))
+                        return true;
+        }
+        return false;
+}
+
+bool
+geonkick_worker_has_note_requests(struct geonkick *kick)
+{
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
+                struct gkick_synth *synth = kick->synths[i];
+                if (geonkick_worker_renders_notes(synth)
+                    && gkick_note_cache_is_pending(synth->output->note_cache))
+                        return true;
         }
+        return false;
+}
+
+void geonkick_worker_wakeup(struct geonkick *kick)
+{
+        /* The changes inside update transactions don't schedule the rendering. */
+        if (kick->synthesis_on && geonkick_worker_has_updates(kick))
+                gkick_render_pool_schedule(kick);
 }
 
 enum geonkick_error
@@ -1808,3 +3055,228 @@ geonkick_percussion_is_solo(struct geonkick *kick,
         }
         return gkick_mixer_is_solo(kick->audio->mixer, id, b);
 }
+
+enum geonkick_error
+geonkick_set_percussion_params(struct geonkick *kick,
+                               size_t id,
+                               const struct gkick_synth_params *params)
+{
+        if (kick == NULL || params == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        enum geonkick_error res;
+        res = gkick_synth_set_params(kick->synths[id], params);
+        if (res == GEONKICK_OK && kick->synths[id]->buffer_update)
+                geonkick_worker_wakeup(kick);
+        return res;
+}
+
+enum geonkick_error
+geonkick_get_percussion_params(struct geonkick *kick,
+                               size_t id,
+                               struct gkick_synth_params *params)
+{
+        if (kick == NULL || params == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        return gkick_synth_get_params(kick->synths[id], params);
+}
+
+void
+geonkick_synth_params_free(struct gkick_synth_params *params)
+{
+        if (params == NULL)
+                return;
+
+        for (size_t i = 0; i < GKICK_SYNTH_ENVELOPES_NUMBER; i++) {
+                free(params->envelopes[i].points);
+                params->envelopes[i].points = NULL;
+                params->envelopes[i].npoints = 0;
+        }
+
+        for (size_t i = 0; i < GKICK_OSC_NUMBER; i++) {
+                struct gkick_osc_params *osc = &params->oscillators[i];
+                for (size_t j = 0; j < GKICK_OSC_ENVELOPES_NUMBER; j++) {
+                        free(osc->envelopes[j].points);
+                        osc->envelopes[j].points = NULL;
+                        osc->envelopes[j].npoints = 0;
+                }
+                gkick_sample_unref(osc->sample);
+                osc->sample = NULL;
+        }
+}
+
+enum geonkick_error
+geonkick_render_context_new(struct gkick_render_context **context)
+{
+        return gkick_render_context_new(context);
+}
+
+void
+geonkick_render_context_free(struct gkick_render_context **context)
+{
+        gkick_render_context_free(context);
+}
+
+enum geonkick_error
+geonkick_render_context_set_params(struct gkick_render_context *context,
+                                   const struct gkick_synth_params *params)
+{
+        return gkick_render_context_set_params(context, params);
+}
+
+enum geonkick_error
+geonkick_render_context_get_length(struct gkick_render_context *context,
+                                   size_t *length)
+{
+        return gkick_render_context_get_length(context, length);
+}
+
+enum geonkick_error
+geonkick_render_context_render(struct gkick_render_context *context,
+                               gkick_real *data,
+                               size_t size,
+                               size_t *length)
+{
+        return gkick_render_context_render(context, data, size, length);
+}
+
+enum geonkick_error
+geonkick_begin_update(struct geonkick *kick,
+                      size_t id)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        kick->synths[id]->update_depth++;
+        return GEONKICK_OK;
+}
+
+enum geonkick_error
+geonkick_commit_update(struct geonkick *kick,
+                       size_t id)
+{
+        if (kick == NULL || id >= GEONKICK_MAX_PERCUSSIONS) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        struct gkick_synth *synth = kick->synths[id];
+        size_t depth = synth->update_depth;
+        do {
+                if (depth == 0) {
+                        gkick_log_error("no update in progress");
+                        return GEONKICK_ERROR;
+                }
+        } while (!atomic_compare_exchange_weak(&synth->update_depth, &depth, depth - 1));
+
+        if (depth == 1 && synth->buffer_update)
+                geonkick_worker_wakeup(kick);
+        return GEONKICK_OK;
+}
+
+enum geonkick_error
+geonkick_set_resampler_quality(struct geonkick *kick,
+                               enum geonkick_resampler_quality quality)
+{
+        if (kick == NULL || quality < GEONKICK_RESAMPLER_LINEAR
+            || quality > GEONKICK_RESAMPLER_HIGH) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++)
+                gkick_audio_output_set_resampler(kick->audio->audio_outputs[i],
+                                                 gkick_resampler_get(quality));
+        return GEONKICK_OK;
+}
+
+enum geonkick_error
+geonkick_get_resampler_quality(struct geonkick *kick,
+                               enum geonkick_resampler_quality *quality)
+{
+        if (kick == NULL || quality == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        const struct gkick_resampler *resampler = kick->audio->audio_outputs[0]->resampler;
+        *quality = resampler != NULL ? resampler->quality : GEONKICK_RESAMPLER_LINEAR;
+        return GEONKICK_OK;
+}
+
+size_t
+geonkick_resample_size(size_t in_size,
+                       int in_rate,
+                       int out_rate)
+{
+        if (in_rate < 1 || out_rate < 1)
+                return 0;
+        return gkick_resampler_size(in_size, (double)in_rate / out_rate);
+}
+
+enum geonkick_error
+geonkick_resample(const gkick_real *in,
+                  size_t in_size,
+                  int in_rate,
+                  gkick_real *out,
+                  size_t *out_size,
+                  int out_rate,
+                  enum geonkick_resampler_quality quality)
+{
+        if (in == NULL || out == NULL || out_size == NULL
+            || in_rate < 1 || out_rate < 1) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        return gkick_resampler_resample(quality, in, in_size,
+                                        (double)in_rate / out_rate,
+                                        out, out_size);
+}
+
+enum geonkick_error
+geonkick_wait_render(struct geonkick *kick,
+                     int timeout)
+{
+        if (kick == NULL || timeout < 0) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        /* The updates are not rendered while the synthesis is off. */
+        if (!kick->synthesis_on || !geonkick_worker_is_rendering(kick))
+                return GEONKICK_OK;
+
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec  += timeout / 1000;
+        ts.tv_nsec += (long)(timeout % 1000) * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000;
+        }
+
+        enum geonkick_error res = GEONKICK_OK;
+        geonkick_lock(kick);
+        while (geonkick_worker_is_rendering(kick)) {
+                /* Don't wait for the updates debouncing. */
+                kick->worker.flush = true;
+                gkick_render_pool_schedule(kick);
+                if (pthread_cond_timedwait(&kick->worker.render_cond,
+                                           &kick->lock, &ts) == ETIMEDOUT) {
+                        if (geonkick_worker_is_rendering(kick))
+                                res = GEONKICK_ERROR;
+                        break;
+                }
+        }
+        geonkick_unlock(kick);
+
+        return res;
+}
@@ -102,6 +102,17 @@ enum geonkick_osc_func_type {
         GEONKICK_OSC_FUNC_SAMPLE         = 7
 };
 
+/**
+ * Resampler quality, from the plain linear
+ * interpolation to windowed-sinc filters with more taps.
+ */
+enum geonkick_resampler_quality {
+        GEONKICK_RESAMPLER_LINEAR = 0,
+        GEONKICK_RESAMPLER_LOW    = 1,
+        GEONKICK_RESAMPLER_MEDIUM = 2,
+        GEONKICK_RESAMPLER_HIGH   = 3
+};
+
 enum GEONKICK_MODULE {
         GEONKICK_MODULE_UNKNOWN = 0,
         GEONKICK_MODULE_JACK    = 1
@@ -128,8 +139,88 @@ enum geonkick_channel_type {
 */
 #define GEONKICK_MAX_CHANNELS GEONKICK_MAX_PERCUSSIONS
 
+/* Number of oscillators of a percussion. */
+#define GKICK_OSC_NUMBER (GKICK_OSC_GROUPS_NUMBER * GKICK_OSC_GROUP_SIZE)
+
+/* Envelopes of the percussion and oscillators indexed by geonkick_envelope_type. */
+#define GKICK_SYNTH_ENVELOPES_NUMBER (GEONKICK_DISTORTION_VOLUME_ENVELOPE + 1)
+#define GKICK_OSC_ENVELOPES_NUMBER (GEONKICK_FILTER_CUTOFF_ENVELOPE + 1)
+
 struct geonkick;
 
+/**
+ * Envelope points, the x and y coordinates interleaved.
+ * An envelope without points is left unchanged when applied.
+ */
+struct gkick_envelope_params {
+        gkick_real *points;
+        size_t npoints;
+};
+
+/**
+ * Immutable reference counted sample data shared between
+ * the oscillators, percussions and instances of the process.
+ */
+struct gkick_sample;
+
+struct gkick_osc_params {
+        bool enabled;
+        enum geonkick_osc_func_type function;
+        gkick_real phase;
+        unsigned int seed;
+        gkick_real amplitude;
+        gkick_real frequency;
+        bool is_fm;
+        bool filter_enabled;
+        enum gkick_filter_type filter_type;
+        gkick_real filter_cutoff;
+        gkick_real filter_factor;
+        struct gkick_envelope_params envelopes[GKICK_OSC_ENVELOPES_NUMBER];
+
+        /**
+         * Sample of the oscillator, the sample is removed if NULL.
+         * A reference is taken when the parameters are set and
+         * is owned by the parameters when got.
+         */
+        struct gkick_sample *sample;
+};
+
+/**
+ * Snapshot of all the synthesis parameters of a percussion.
+ * The audio output settings (key, channel, limiter, etc.) are not included.
+ */
+struct gkick_synth_params {
+        char name[30];
+
+        /* Length in seconds. */
+        gkick_real length;
+        gkick_real amplitude;
+        bool layers[GKICK_OSC_GROUPS_NUMBER];
+        gkick_real layers_amplitude[GKICK_OSC_GROUPS_NUMBER];
+
+        bool filter_enabled;
+        enum gkick_filter_type filter_type;
+        gkick_real filter_cutoff;
+        gkick_real filter_factor;
+        struct gkick_envelope_params envelopes[GKICK_SYNTH_ENVELOPES_NUMBER];
+
+        bool compressor_enabled;
+        /* Attack and release in seconds. */
+        gkick_real compressor_attack;
+        gkick_real compressor_release;
+        gkick_real compressor_threshold;
+        gkick_real compressor_ratio;
+        gkick_real compressor_knee;
+        gkick_real compressor_makeup;
+
+        bool distortion_enabled;
+        gkick_real distortion_in_limiter;
+        gkick_real distortion_volume;
+        gkick_real distortion_drive;
+
+        struct gkick_osc_params oscillators[GKICK_OSC_NUMBER];
+};
+
 enum geonkick_error
 geonkick_create(struct geonkick **kick);
 
@@ -148,19 +239,45 @@ enum geonkick_error
 geonkick_enable_oscillator(struct geonkick* kick,
                            size_t index);
 
+/**
+ * The functions with the _id suffix address the percussion by its id
+ * instead of the current percussion. They lock only the synthesizer of
+ * the percussion, so different percussions can be accessed concurrently.
+ */
+enum geonkick_error
+geonkick_enable_oscillator_id(struct geonkick *kick,
+                              size_t id,
+                              size_t index);
+
 enum geonkick_error
 geonkick_disable_oscillator(struct geonkick* kick,
                             size_t index);
 
+enum geonkick_error
+geonkick_disable_oscillator_id(struct geonkick *kick,
+                               size_t id,
+                               size_t index);
+
 enum geonkick_error
 geonkick_is_oscillator_enabled(struct geonkick* kick,
                                size_t index,
                                int *enabled);
 
+enum geonkick_error
+geonkick_is_oscillator_enabled_id(struct geonkick *kick,
+                                  size_t id,
+                                  size_t index,
+                                  int *enabled);
+
 enum geonkick_error
 geonkick_get_oscillators_number(struct geonkick* kick,
                                 size_t *number);
 
+enum geonkick_error
+geonkick_get_oscillators_number_id(struct geonkick *kick,
+                                   size_t id,
+                                   size_t *number);
+
 enum geonkick_error
 geonkick_osc_envelope_get_points(struct geonkick *kick,
 				 size_t osc_index,
@@ -168,6 +285,14 @@ geonkick_osc_envelope_get_points(struct geonkick *kick,
 				 gkick_real **buf,
 				 size_t *npoints);
 
+enum geonkick_error
+geonkick_osc_envelope_get_points_id(struct geonkick *kick,
+                                    size_t id,
+                                    size_t osc_index,
+                                    size_t env_index,
+                                    gkick_real **buf,
+                                    size_t *npoints);
+
 enum geonkick_error
 geonkick_osc_envelope_set_points(struct geonkick *kick,
                                  size_t osc_index,
@@ -175,6 +300,14 @@ geonkick_osc_envelope_set_points(struct geonkick *kick,
                                  const gkick_real *buff,
                                  size_t npoints);
 
+enum geonkick_error
+geonkick_osc_envelope_set_points_id(struct geonkick *kick,
+                                    size_t id,
+                                    size_t osc_index,
+                                    size_t env_index,
+                                    const gkick_real *buff,
+                                    size_t npoints);
+
 enum geonkick_error
 geonkick_osc_envelope_add_point(struct geonkick *kick,
 				size_t osc_index,
@@ -182,11 +315,26 @@ geonkick_osc_envelope_add_point(struct geonkick *kick,
 				gkick_real x,
 				gkick_real y);
 
+enum geonkick_error
+geonkick_osc_envelope_add_point_id(struct geonkick *kick,
+                                   size_t id,
+                                   size_t osc_index,
+                                   size_t env_index,
+                                   gkick_real x,
+                                   gkick_real y);
+
 enum geonkick_error
 geonkick_osc_envelope_remove_point(struct geonkick *kick,
 				   size_t osc_index,
 				   size_t env_index,
 				   size_t index);
+
+enum geonkick_error
+geonkick_osc_envelope_remove_point_id(struct geonkick *kick,
+                                      size_t id,
+                                      size_t osc_index,
+                                      size_t env_index,
+                                      size_t index);
 enum geonkick_error
 geonkick_osc_envelope_update_point(struct geonkick *kick,
 				   size_t osc_index,
@@ -195,54 +343,121 @@ geonkick_osc_envelope_update_point(struct geonkick *kick,
 				   gkick_real x,
 				   gkick_real y);
 
+enum geonkick_error
+geonkick_osc_envelope_update_point_id(struct geonkick *kick,
+                                      size_t id,
+                                      size_t osc_index,
+                                      size_t env_index,
+                                      size_t index,
+                                      gkick_real x,
+                                      gkick_real y);
+
 enum geonkick_error
 geonkick_osc_set_fm(struct geonkick *kick,
                     size_t index,
                     bool is_fm);
 
+enum geonkick_error
+geonkick_osc_set_fm_id(struct geonkick *kick,
+                       size_t id,
+                       size_t index,
+                       bool is_fm);
+
 enum geonkick_error
 geonkick_osc_is_fm(struct geonkick *kick,
                    size_t index,
                    bool *is_fm);
 
+enum geonkick_error
+geonkick_osc_is_fm_id(struct geonkick *kick,
+                      size_t id,
+                      size_t index,
+                      bool *is_fm);
+
 enum geonkick_error
 geonkick_set_osc_function(struct geonkick *kick,
 			  size_t osc_index,
 			  enum geonkick_osc_func_type type);
 
+enum geonkick_error
+geonkick_set_osc_function_id(struct geonkick *kick,
+                             size_t id,
+                             size_t osc_index,
+                             enum geonkick_osc_func_type type);
+
 enum geonkick_error
 geonkick_get_osc_function(struct geonkick *kick,
 			  size_t osc_index,
 			  enum geonkick_osc_func_type *type);
 
+enum geonkick_error
+geonkick_get_osc_function_id(struct geonkick *kick,
+                             size_t id,
+                             size_t osc_index,
+                             enum geonkick_osc_func_type *type);
+
 enum geonkick_error
 geonkick_set_osc_phase(struct geonkick *kick,
                        size_t osc_index,
                        gkick_real phase);
 
+enum geonkick_error
+geonkick_set_osc_phase_id(struct geonkick *kick,
+                          size_t id,
+                          size_t osc_index,
+                          gkick_real phase);
+
 enum geonkick_error
 geonkick_get_osc_phase(struct geonkick *kick,
                        size_t osc_index,
                        gkick_real *phase);
 
+enum geonkick_error
+geonkick_get_osc_phase_id(struct geonkick *kick,
+                          size_t id,
+                          size_t osc_index,
+                          gkick_real *phase);
+
 enum geonkick_error
 geonkick_set_osc_seed(struct geonkick *kick,
                       size_t osc_index,
                       unsigned int seed);
 
+enum geonkick_error
+geonkick_set_osc_seed_id(struct geonkick *kick,
+                         size_t id,
+                         size_t osc_index,
+                         unsigned int seed);
+
 enum geonkick_error
 geonkick_get_osc_seed(struct geonkick *kick,
                       size_t osc_index,
                       unsigned int *seed);
 
+enum geonkick_error
+geonkick_get_osc_seed_id(struct geonkick *kick,
+                         size_t id,
+                         size_t osc_index,
+                         unsigned int *seed);
+
 enum geonkick_error
 geonkick_set_length(struct geonkick *kick,
                     gkick_real len);
 
+enum geonkick_error
+geonkick_set_length_id(struct geonkick *kick,
+                       size_t id,
+                       gkick_real len);
+
 enum geonkick_error
 geonkick_get_length(struct geonkick *kick,
                     gkick_real *len);
 
+enum geonkick_error
+geonkick_get_length_id(struct geonkick *kick,
+                       size_t id,
+                       gkick_real *len);
+
 enum geonkick_error
 geonkick_get_max_length(struct geonkick *kick,
                         gkick_real *len);
@@ -251,64 +466,141 @@ enum geonkick_error
 geonkick_kick_set_amplitude(struct geonkick *kick,
                             gkick_real amplitude);
 
+enum geonkick_error
+geonkick_kick_set_amplitude_id(struct geonkick *kick,
+                               size_t id,
+                               gkick_real amplitude);
+
 enum geonkick_error
 geonkick_kick_get_amplitude(struct geonkick *kick,
                             gkick_real *amplitude);
 
+enum geonkick_error
+geonkick_kick_get_amplitude_id(struct geonkick *kick,
+                               size_t id,
+                               gkick_real *amplitude);
+
 enum geonkick_error
 geonkick_kick_filter_enable(struct geonkick *kick,
                             int enable);
 
+enum geonkick_error
+geonkick_kick_filter_enable_id(struct geonkick *kick,
+                               size_t id,
+                               int enable);
+
 enum geonkick_error
 geonkick_kick_filter_is_enabled(struct geonkick *kick,
                                 int *enabled);
 
+enum geonkick_error
+geonkick_kick_filter_is_enabled_id(struct geonkick *kick,
+                                   size_t id,
+                                   int *enabled);
+
 enum geonkick_error
 geonkick_kick_set_filter_frequency(struct geonkick *kick,
                                    gkick_real frequency);
 
+enum geonkick_error
+geonkick_kick_set_filter_frequency_id(struct geonkick *kick,
+                                      size_t id,
+                                      gkick_real frequency);
+
 enum geonkick_error
 geonkick_kick_get_filter_frequency(struct geonkick *kick,
                                    gkick_real *frequency);
 
+enum geonkick_error
+geonkick_kick_get_filter_frequency_id(struct geonkick *kick,
+                                      size_t id,
+                                      gkick_real *frequency);
+
 enum geonkick_error
 geonkick_kick_set_filter_factor(struct geonkick *kick,
                                 gkick_real factor);
 
+enum geonkick_error
+geonkick_kick_set_filter_factor_id(struct geonkick *kick,
+                                   size_t id,
+                                   gkick_real factor);
+
 enum geonkick_error
 geonkick_kick_get_filter_factor(struct geonkick *kick,
                                 gkick_real *factor);
 
+enum geonkick_error
+geonkick_kick_get_filter_factor_id(struct geonkick *kick,
+                                   size_t id,
+                                   gkick_real *factor);
+
 enum geonkick_error
 geonkick_set_kick_filter_type(struct geonkick *kick,
                               enum gkick_filter_type type);
 
+enum geonkick_error
+geonkick_set_kick_filter_type_id(struct geonkick *kick,
+                                 size_t id,
+                                 enum gkick_filter_type type);
+
 enum geonkick_error
 geonkick_get_kick_filter_type(struct geonkick *kick,
                               enum gkick_filter_type *type);
 
+enum geonkick_error
+geonkick_get_kick_filter_type_id(struct geonkick *kick,
+                                 size_t id,
+                                 enum gkick_filter_type *type);
+
 enum geonkick_error
 geonkick_kick_envelope_get_points(struct geonkick *kick,
                                   enum geonkick_envelope_type env_type,
                                   gkick_real **buf,
                                   size_t *npoints);
 
+enum geonkick_error
+geonkick_kick_envelope_get_points_id(struct geonkick *kick,
+                                     size_t id,
+                                     enum geonkick_envelope_type env_type,
+                                     gkick_real **buf,
+                                     size_t *npoints);
+
 enum geonkick_error
 geonkick_kick_envelope_set_points(struct geonkick *kick,
                                   enum geonkick_envelope_type env_type,
                                   const gkick_real *buff,
                                   size_t npoints);
 
+enum geonkick_error
+geonkick_kick_envelope_set_points_id(struct geonkick *kick,
+                                     size_t id,
+                                     enum geonkick_envelope_type env_type,
+                                     const gkick_real *buff,
+                                     size_t npoints);
+
 enum geonkick_error
 geonkick_kick_add_env_point(struct geonkick *kick,
                             enum geonkick_envelope_type env_type,
                             gkick_real x, gkick_real y);
 
+enum geonkick_error
+geonkick_kick_add_env_point_id(struct geonkick *kick,
+                               size_t id,
+                               enum geonkick_envelope_type env_type,
+                               gkick_real x,
+                               gkick_real y);
+
 enum geonkick_error
 geonkick_kick_remove_env_point(struct geonkick *kick,
                                enum geonkick_envelope_type env_type,
                                size_t index);
 
+enum geonkick_error
+geonkick_kick_remove_env_point_id(struct geonkick *kick,
+                                  size_t id,
+                                  enum geonkick_envelope_type env_type,
+                                  size_t index);
+
 enum geonkick_error
 geonkick_kick_update_env_point(struct geonkick *kick,
                                enum geonkick_envelope_type env_type,
@@ -316,27 +608,68 @@ geonkick_kick_update_env_point(struct geonkick *kick,
                                gkick_real x,
                                gkick_real y);
 
+enum geonkick_error
+geonkick_kick_update_env_point_id(struct geonkick *kick,
+                                  size_t id,
+                                  enum geonkick_envelope_type env_type,
+                                  size_t index,
+                                  gkick_real x,
+                                  gkick_real y);
+
 enum geonkick_error
 geonkick_set_osc_amplitude(struct geonkick *kick,
                            size_t osc_index,
                            gkick_real v);
+
+enum geonkick_error
+geonkick_set_osc_amplitude_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              gkick_real v);
 enum geonkick_error
 geonkick_set_osc_frequency(struct geonkick *kick,
                            size_t osc_index,
                            gkick_real v);
 
+enum geonkick_error
+geonkick_set_osc_frequency_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              gkick_real v);
+
 enum geonkick_error
 geonkick_get_osc_amplitude(struct geonkick *kick,
                            size_t osc_index,
                            gkick_real *v);
+
+enum geonkick_error
+geonkick_get_osc_amplitude_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              gkick_real *v);
 enum geonkick_error
 geonkick_get_osc_frequency(struct geonkick *kick,
                            size_t osc_index,
                            gkick_real *v);
 
+enum geonkick_error
+geonkick_get_osc_frequency_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              gkick_real *v);
+
 enum geonkick_error
 geonkick_play(struct geonkick *kick, size_t id);
 
+/**
+ * Plays the sample on the first channel through the preview voice,
+ * without changing the percussions. The sample must have the
+ * Geonkick sample rate, the playing preview is replaced.
+ */
+enum geonkick_error
+geonkick_play_preview(struct geonkick *kick,
+                      struct gkick_sample *sample);
+
 /**
  * This function must be called
  * only from the audio thread.
@@ -351,11 +684,22 @@ enum geonkick_error
 geonkick_get_kick_buffer_size(struct geonkick *kick,
                               size_t *size);
 
+enum geonkick_error
+geonkick_get_kick_buffer_size_id(struct geonkick *kick,
+                                 size_t id,
+                                 size_t *size);
+
 enum geonkick_error
 geonkick_get_kick_buffer(struct geonkick *kick,
                          gkick_real *buffer,
                          size_t size);
 
+enum geonkick_error
+geonkick_get_kick_buffer_id(struct geonkick *kick,
+                            size_t id,
+                            gkick_real *buffer,
+                            size_t size);
+
 enum geonkick_error
 geonkick_set_kick_buffer_callback(struct geonkick *kick,
                                   void (*callback)(void*,
@@ -382,40 +726,88 @@ enum geonkick_error
 geonkick_set_osc_filter_type(struct geonkick *kick,
                              size_t osc_index,
                              enum gkick_filter_type type);
+
+enum geonkick_error
+geonkick_set_osc_filter_type_id(struct geonkick *kick,
+                                size_t id,
+                                size_t osc_index,
+                                enum gkick_filter_type type);
 enum geonkick_error
 geonkick_get_osc_filter_type(struct geonkick *kick,
                              size_t osc_index,
                              enum gkick_filter_type *type);
 
+enum geonkick_error
+geonkick_get_osc_filter_type_id(struct geonkick *kick,
+                                size_t id,
+                                size_t osc_index,
+                                enum gkick_filter_type *type);
+
 enum geonkick_error
 geonkick_set_osc_filter_cutoff_freq(struct geonkick *kick,
                                     size_t osc_index,
                                     gkick_real cutoff);
+
+enum geonkick_error
+geonkick_set_osc_filter_cutoff_freq_id(struct geonkick *kick,
+                                       size_t id,
+                                       size_t osc_index,
+                                       gkick_real cutoff);
 enum geonkick_error
 geonkick_get_osc_filter_cutoff_freq(struct geonkick *kick,
                                     size_t osc_index,
                                     gkick_real *cutoff);
 
+enum geonkick_error
+geonkick_get_osc_filter_cutoff_freq_id(struct geonkick *kick,
+                                       size_t id,
+                                       size_t osc_index,
+                                       gkick_real *cutoff);
+
 enum geonkick_error
 geonkick_set_osc_filter_factor(struct geonkick *kick,
                                size_t osc_index,
                                gkick_real factor);
 
+enum geonkick_error
+geonkick_set_osc_filter_factor_id(struct geonkick *kick,
+                                  size_t id,
+                                  size_t osc_index,
+                                  gkick_real factor);
+
 enum geonkick_error
 geonkick_get_osc_filter_factor(struct geonkick *kick,
                                size_t osc_index,
                                gkick_real *factor);
 
+enum geonkick_error
+geonkick_get_osc_filter_factor_id(struct geonkick *kick,
+                                  size_t id,
+                                  size_t osc_index,
+                                  gkick_real *factor);
+
 enum geonkick_error
 geonkick_enbale_osc_filter(struct geonkick *kick,
                            size_t osc_index,
                            int enable);
 
+enum geonkick_error
+geonkick_enbale_osc_filter_id(struct geonkick *kick,
+                              size_t id,
+                              size_t osc_index,
+                              int enable);
+
 enum geonkick_error
 geonkick_osc_filter_is_enabled(struct geonkick *kick,
                                size_t osc_index,
                                int *enable);
 
+enum geonkick_error
+geonkick_osc_filter_is_enabled_id(struct geonkick *kick,
+                                  size_t id,
+                                  size_t osc_index,
+                                  int *enable);
+
 enum geonkick_error
 geonkick_get_sample_rate(struct geonkick *kick,
                          int *sample_rate);
@@ -424,6 +816,16 @@ enum geonkick_error
 geonkick_enable_synthesis(struct geonkick *kick,
                           bool enable);
 
+/**
+ * Enables the draft synthesis for faster updates while the
+ * parameters are edited. The percussions are synthesised at a
+ * lower sample rate until the draft is disabled, and then
+ * synthesised again at the full rate.
+ */
+enum geonkick_error
+geonkick_enable_draft_synthesis(struct geonkick *kick,
+                                bool enable);
+
 enum geonkick_error
 geonkick_get_audio_frame(struct geonkick *kick,
                          int channel,
@@ -433,90 +835,200 @@ enum geonkick_error
 geonkick_compressor_enable(struct geonkick *kick,
                            int enable);
 
+enum geonkick_error
+geonkick_compressor_enable_id(struct geonkick *kick,
+                              size_t id,
+                              int enable);
+
 enum geonkick_error
 geonkick_compressor_is_enabled(struct geonkick *kick,
                                int *enabled);
 
+enum geonkick_error
+geonkick_compressor_is_enabled_id(struct geonkick *kick,
+                                  size_t id,
+                                  int *enabled);
+
 enum geonkick_error
 geonkick_compressor_set_attack(struct geonkick *kick,
                                gkick_real attack);
 
+enum geonkick_error
+geonkick_compressor_set_attack_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real attack);
+
 enum geonkick_error
 geonkick_compressor_get_attack(struct geonkick *kick,
                                gkick_real *attack);
 
+enum geonkick_error
+geonkick_compressor_get_attack_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real *attack);
+
 enum geonkick_error
 geonkick_compressor_set_release(struct geonkick *kick,
                                 gkick_real release);
 
+enum geonkick_error
+geonkick_compressor_set_release_id(struct geonkick *kick,
+                                   size_t id,
+                                   gkick_real release);
+
 enum geonkick_error
 geonkick_compressor_get_release(struct geonkick *kick,
                                 gkick_real *release);
 
+enum geonkick_error
+geonkick_compressor_get_release_id(struct geonkick *kick,
+                                   size_t id,
+                                   gkick_real *release);
+
 enum geonkick_error
 geonkick_compressor_set_threshold(struct geonkick *kick,
                                   gkick_real threshold);
 
+enum geonkick_error
+geonkick_compressor_set_threshold_id(struct geonkick *kick,
+                                     size_t id,
+                                     gkick_real threshold);
+
 enum geonkick_error
 geonkick_compressor_get_threshold(struct geonkick *kick,
                                   gkick_real *threshold);
 
+enum geonkick_error
+geonkick_compressor_get_threshold_id(struct geonkick *kick,
+                                     size_t id,
+                                     gkick_real *threshold);
+
 enum geonkick_error
 geonkick_compressor_set_ratio(struct geonkick *kick,
                               gkick_real ratio);
 
+enum geonkick_error
+geonkick_compressor_set_ratio_id(struct geonkick *kick,
+                                 size_t id,
+                                 gkick_real ratio);
+
 enum geonkick_error
 geonkick_compressor_get_ratio(struct geonkick *kick,
                               gkick_real *ratio);
 
+enum geonkick_error
+geonkick_compressor_get_ratio_id(struct geonkick *kick,
+                                 size_t id,
+                                 gkick_real *ratio);
+
 enum geonkick_error
 geonkick_compressor_set_knee(struct geonkick *kick,
                              gkick_real knee);
 
+enum geonkick_error
+geonkick_compressor_set_knee_id(struct geonkick *kick,
+                                size_t id,
+                                gkick_real knee);
+
 enum geonkick_error
 geonkick_compressor_get_knee(struct geonkick *kick,
                              gkick_real *knee);
 
+enum geonkick_error
+geonkick_compressor_get_knee_id(struct geonkick *kick,
+                                size_t id,
+                                gkick_real *knee);
+
 enum geonkick_error
 geonkick_compressor_set_makeup(struct geonkick *kick,
                                gkick_real makeup);
 
+enum geonkick_error
+geonkick_compressor_set_makeup_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real makeup);
+
 enum geonkick_error
 geonkick_compressor_get_makeup(struct geonkick *kick,
                                gkick_real *makeup);
 
+enum geonkick_error
+geonkick_compressor_get_makeup_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real *makeup);
+
 enum geonkick_error
 geonkick_distortion_enable(struct geonkick *kick,
                            int enable);
 
+enum geonkick_error
+geonkick_distortion_enable_id(struct geonkick *kick,
+                              size_t id,
+                              int enable);
+
 enum geonkick_error
 geonkick_distortion_is_enabled(struct geonkick *kick,
                                int *enabled);
 
+enum geonkick_error
+geonkick_distortion_is_enabled_id(struct geonkick *kick,
+                                  size_t id,
+                                  int *enabled);
+
 enum geonkick_error
 geonkick_distortion_set_in_limiter(struct geonkick *kick,
                                    gkick_real limit);
 
+enum geonkick_error
+geonkick_distortion_set_in_limiter_id(struct geonkick *kick,
+                                      size_t id,
+                                      gkick_real limit);
+
 enum geonkick_error
 geonkick_distortion_get_in_limiter(struct geonkick *kick,
                                    gkick_real *limit);
 
+enum geonkick_error
+geonkick_distortion_get_in_limiter_id(struct geonkick *kick,
+                                      size_t id,
+                                      gkick_real *limit);
+
 enum geonkick_error
 geonkick_distortion_set_volume(struct geonkick *kick,
                                gkick_real volume);
 
+enum geonkick_error
+geonkick_distortion_set_volume_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real volume);
+
 enum geonkick_error
 geonkick_distortion_get_volume(struct geonkick *kick,
                                gkick_real *volume);
 
+enum geonkick_error
+geonkick_distortion_get_volume_id(struct geonkick *kick,
+                                  size_t id,
+                                  gkick_real *volume);
+
 enum geonkick_error
 geonkick_distortion_set_drive(struct geonkick *kick,
                               gkick_real drive);
 
+enum geonkick_error
+geonkick_distortion_set_drive_id(struct geonkick *kick,
+                                 size_t id,
+                                 gkick_real drive);
+
 enum geonkick_error
 geonkick_distortion_get_drive(struct geonkick *kick,
                               gkick_real *drive);
 
+enum geonkick_error
+geonkick_distortion_get_drive_id(struct geonkick *kick,
+                                 size_t id,
+                                 gkick_real *drive);
+
 int geonkick_is_module_enabed(struct geonkick *kick,
                               enum GEONKICK_MODULE module);
 
@@ -525,21 +1037,45 @@ geonkick_enable_group(struct geonkick *kick,
                       size_t index,
                       bool enable);
 
+enum geonkick_error
+geonkick_enable_group_id(struct geonkick *kick,
+                         size_t id,
+                         size_t index,
+                         bool enable);
+
 enum geonkick_error
 geonkick_group_enabled(struct geonkick *kick,
                        size_t index,
                        bool *enabled);
 
+enum geonkick_error
+geonkick_group_enabled_id(struct geonkick *kick,
+                          size_t id,
+                          size_t index,
+                          bool *enabled);
+
 enum geonkick_error
 geonkick_group_set_amplitude(struct geonkick *kick,
                              size_t index,
                              gkick_real amplitude);
 
+enum geonkick_error
+geonkick_group_set_amplitude_id(struct geonkick *kick,
+                                size_t id,
+                                size_t index,
+                                gkick_real amplitude);
+
 enum geonkick_error
 geonkick_group_get_amplitude(struct geonkick *kick,
                              size_t index,
                              gkick_real *amplitude);
 
+enum geonkick_error
+geonkick_group_get_amplitude_id(struct geonkick *kick,
+                                size_t id,
+                                size_t index,
+                                gkick_real *amplitude);
+
 enum geonkick_error
 geonkick_tune_audio_output(struct geonkick *kick,
                            size_t index,
@@ -556,12 +1092,137 @@ geonkick_set_osc_sample(struct geonkick *kick,
                         const gkick_real *data,
                         size_t size);
 
+enum geonkick_error
+geonkick_set_osc_sample_id(struct geonkick *kick,
+                           size_t id,
+                           size_t osc_index,
+                           const gkick_real *data,
+                           size_t size);
+
 enum geonkick_error
 geonkick_get_osc_sample(struct geonkick *kick,
                         size_t osc_index,
                         gkick_real **data,
                         size_t *size);
 
+enum geonkick_error
+geonkick_get_osc_sample_id(struct geonkick *kick,
+                           size_t id,
+                           size_t osc_index,
+                           gkick_real **data,
+                           size_t *size);
+
+/**
+ * Creates a sample from the data. If a sample with the same content
+ * already exists a new reference to it is returned instead.
+ */
+enum geonkick_error
+geonkick_sample_new(const gkick_real *data,
+                    size_t size,
+                    struct gkick_sample **sample);
+
+/**
+ * Creates a sample to be filled by the caller before it is
+ * published with geonkick_sample_publish.
+ */
+enum geonkick_error
+geonkick_sample_create(size_t size,
+                       struct gkick_sample **sample);
+
+/**
+ * Returns the buffer of the created sample or NULL
+ * if the sample is already published.
+ */
+gkick_real*
+geonkick_sample_buffer(struct gkick_sample *sample);
+
+/**
+ * Reduces the size of the created sample when less data
+ * than expected was written into the buffer.
+ */
+enum geonkick_error
+geonkick_sample_shrink(struct gkick_sample *sample,
+                       size_t size);
+
+enum geonkick_error
+geonkick_sample_publish(struct gkick_sample **sample);
+
+struct gkick_sample*
+geonkick_sample_ref(struct gkick_sample *sample);
+
+void
+geonkick_sample_unref(struct gkick_sample *sample);
+
+const gkick_real*
+geonkick_sample_data(const struct gkick_sample *sample);
+
+size_t
+geonkick_sample_size(const struct gkick_sample *sample);
+
+uint64_t
+geonkick_sample_hash(const struct gkick_sample *sample);
+
+/**
+ * Returns the number of samples and the memory used
+ * by the samples of the process.
+ */
+void
+geonkick_sample_store_usage(size_t *number,
+                            size_t *size);
+
+/**
+ * Sets the directory of the samples cache. The large samples are
+ * saved there as raw PCM files and memory mapped read-only, so the
+ * processes using the same samples share the memory.
+ * The samples are kept in the process memory if the path is NULL.
+ */
+enum geonkick_error
+geonkick_sample_store_set_cache_path(const char *path);
+
+/* Returns the size of the memory mapped samples data. */
+size_t
+geonkick_sample_store_mapped_size(void);
+
+/**
+ * Returns the number of distinct samples and the memory used by
+ * the samples of the instance. A sample shared by many percussions
+ * is counted once.
+ */
+enum geonkick_error
+geonkick_get_samples_usage(struct geonkick *kick,
+                           size_t *number,
+                           size_t *size);
+
+/**
+ * Sets the sample of the oscillator without copying the data.
+ * The sample is removed if NULL.
+ */
+enum geonkick_error
+geonkick_set_osc_sample_ref(struct geonkick *kick,
+                            size_t osc_index,
+                            struct gkick_sample *sample);
+
+enum geonkick_error
+geonkick_set_osc_sample_ref_id(struct geonkick *kick,
+                               size_t id,
+                               size_t osc_index,
+                               struct gkick_sample *sample);
+
+/**
+ * Returns a new reference to the sample of the oscillator
+ * or NULL if there is no sample.
+ */
+enum geonkick_error
+geonkick_get_osc_sample_ref(struct geonkick *kick,
+                            size_t osc_index,
+                            struct gkick_sample **sample);
+
+enum geonkick_error
+geonkick_get_osc_sample_ref_id(struct geonkick *kick,
+                               size_t id,
+                               size_t osc_index,
+                               struct gkick_sample **sample);
+
 enum geonkick_error
 geonkick_set_current_percussion(struct geonkick *kick,
                                 size_t index);
@@ -653,6 +1314,124 @@ geonkick_percussion_is_solo(struct geonkick *kick,
                             size_t id,
                             bool *b);
 
+/**
+ * Blocks until the pending updates of the percussions are
+ * rendered and available for playing, or the timeout
+ * (in milliseconds) expires. Returns GEONKICK_ERROR on timeout.
+ * Intended for offline rendering, must not be used in real-time mode.
+ */
+enum geonkick_error
+geonkick_wait_render(struct geonkick *kick,
+                     int timeout);
+
+/**
+ * Applies all the synthesis parameters to the percussion at once.
+ * The percussion is synthesised again only once. The parameters
+ * data is copied, the envelopes and samples are prepared before
+ * the percussion is locked.
+ */
+enum geonkick_error
+geonkick_set_percussion_params(struct geonkick *kick,
+                               size_t id,
+                               const struct gkick_synth_params *params);
+
+/**
+ * Reads all the synthesis parameters of the percussion.
+ * The envelopes points and samples are allocated and must be
+ * released with geonkick_synth_params_free.
+ */
+enum geonkick_error
+geonkick_get_percussion_params(struct geonkick *kick,
+                               size_t id,
+                               struct gkick_synth_params *params);
+
+void
+geonkick_synth_params_free(struct gkick_synth_params *params);
+
+/**
+ * Render context synthesizes percussions offline, independently
+ * of the instances and without audio output. A context must be
+ * used by one thread at a time, many contexts can render in
+ * parallel from different threads.
+ */
+struct gkick_render_context;
+
+enum geonkick_error
+geonkick_render_context_new(struct gkick_render_context **context);
+
+void
+geonkick_render_context_free(struct gkick_render_context **context);
+
+enum geonkick_error
+geonkick_render_context_set_params(struct gkick_render_context *context,
+                                   const struct gkick_synth_params *params);
+
+/* Returns the number of frames of the percussion. */
+enum geonkick_error
+geonkick_render_context_get_length(struct gkick_render_context *context,
+                                   size_t *length);
+
+/**
+ * Renders the percussion into the data buffer. At most size frames
+ * are written, the number of written frames is returned in length.
+ */
+enum geonkick_error
+geonkick_render_context_render(struct gkick_render_context *context,
+                               gkick_real *data,
+                               size_t size,
+                               size_t *length);
+
+/**
+ * Starts an update transaction for the percussion. The changes
+ * made until the transaction is committed only mark the percussion
+ * for update, the percussion is synthesised after the commit.
+ * The transactions can be nested.
+ */
+enum geonkick_error
+geonkick_begin_update(struct geonkick *kick,
+                      size_t id);
+
+/**
+ * Commits the update transaction. When the last transaction
+ * is committed the percussion is synthesised once if it was changed.
+ */
+enum geonkick_error
+geonkick_commit_update(struct geonkick *kick,
+                       size_t id);
+
+/**
+ * Sets the resampler quality used for playing the tuned percussions.
+ */
+enum geonkick_error
+geonkick_set_resampler_quality(struct geonkick *kick,
+                               enum geonkick_resampler_quality quality);
+
+enum geonkick_error
+geonkick_get_resampler_quality(struct geonkick *kick,
+                               enum geonkick_resampler_quality *quality);
+
+/**
+ * Returns the number of frames needed for resampling
+ * the input of in_size frames from in_rate to out_rate.
+ */
+size_t
+geonkick_resample_size(size_t in_size,
+                       int in_rate,
+                       int out_rate);
+
+/**
+ * Resamples the input from in_rate to out_rate.
+ * out_size - the output capacity on input, the number of frames on output.
+ */
+enum geonkick_error
+geonkick_resample(const gkick_real *in,
+                  size_t in_size,
+                  int in_rate,
+                  gkick_real *out,
+                  size_t *out_size,
+                  int out_rate,
+                  enum geonkick_resampler_quality quality);
+
 
 
 
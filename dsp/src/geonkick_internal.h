@@ -31,6 +31,7 @@
 
 #include <pthread.h>
 #include <stdatomic.h>
+#include <stdint.h>
 
 #define GEONKICK_SAMPLE_RATE 48000
 
@@ -39,15 +40,33 @@
 #define GEONKICK_MAX_KICK_BUFFER_SIZE  (4 * GEONKICK_SAMPLE_RATE)
 
 struct gkick_worker {
-	/* The worker thread. */
-        pthread_t thread;
+        /* Next instance in the render pool queue. */
+        struct geonkick *next;
 
-	/* Condition variable used for the worker thread. */
-        pthread_cond_t condition_var;
-	bool cond_var_initilized;
+        /* Next instance registered to the render pool. */
+        struct geonkick *next_registered;
 
-	/* Specifies if the worker is running. */
+        /* Specifies if the instance is in the render pool queue. */
+        bool queued;
+
+        /* Specifies if a render pool thread has the turn of the instance. */
+        bool turn;
+
+        /* Time in milliseconds after which the queued updates are rendered. */
+        uint64_t due;
+
+	/* Specifies if the instance is registered to the render pool. */
 	atomic_bool running;
+
+        /* Specifies if the worker is synthesising the percussions. */
+        atomic_bool rendering;
+
+        /* Skip the updates debouncing for the next wakeup. */
+        atomic_bool flush;
+
+        /* Signaled every time the worker finished the rendering. */
+        pthread_cond_t render_cond;
+        bool render_cond_initilized;
 };
 
 struct geonkick {
@@ -66,7 +85,7 @@ struct geonkick {
          */
         atomic_bool synthesis_on;
 
-	/* Global worker for all synths. */
+	/* Worker state of the instance in the shared render pool. */
 	struct gkick_worker worker;
         pthread_mutex_t lock;
 };
@@ -86,10 +105,30 @@ geonkick_worker_start(struct geonkick *kick);
 void
 geonkick_worker_destroy(struct geonkick *kick);
 
-void*
-geonkick_worker_thread(void *arg);
+/**
+ * Renders one updated percussion or, if there are no updates,
+ * one requested note. Called by the render pool.
+ */
+void
+geonkick_worker_render(struct geonkick *kick);
 
 void
 geonkick_worker_wakeup(struct geonkick *kick);
 
+bool
+geonkick_worker_has_updates(struct geonkick *kick);
+
+/**
+ * Returns true if there are percussions or
+ * requested notes to be rendered, or the rendering is in progress.
+ */
+bool
+geonkick_worker_is_rendering(struct geonkick *kick);
+
+bool
+geonkick_worker_has_tuned_outputs(struct geonkick *kick);
+
+bool
+geonkick_worker_has_note_requests(struct geonkick *kick);
+
 #endif // GEONKICK_INTERNAL_H
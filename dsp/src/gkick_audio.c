@@ -118,6 +118,18 @@ gkick_audio_play(struct gkick_audio *audio,
         return GEONKICK_OK;
 }
 
+enum geonkick_error
+gkick_audio_play_preview(struct gkick_audio *audio,
+                         struct gkick_sample *sample)
+{
+        if (audio == NULL || sample == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        return gkick_mixer_play_preview(audio->mixer, sample);
+}
+
 enum geonkick_error
 gkick_audio_key_pressed(struct gkick_audio *audio,
                         bool pressed,
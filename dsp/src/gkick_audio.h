@@ -55,6 +55,10 @@ enum geonkick_error
 gkick_audio_play(struct gkick_audio *audio,
                  size_t id);
 
+enum geonkick_error
+gkick_audio_play_preview(struct gkick_audio *audio,
+                         struct gkick_sample *sample);
+
 enum geonkick_error
 gkick_audio_key_pressed(struct gkick_audio *audio,
                         bool pressed,
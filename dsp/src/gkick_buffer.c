@@ -22,6 +22,7 @@
  */
 
 #include "gkick_buffer.h"
+#include "resampler.h"
 
 void
 gkick_buffer_new(struct gkick_buffer **buffer, int size)
@@ -60,6 +61,18 @@ gkick_buffer_free(struct gkick_buffer **buffer)
         *buffer = NULL;
 }
 
+void
+gkick_buffer_init(struct gkick_buffer *buffer,
+                  gkick_real *data,
+                  size_t size)
+{
+        buffer->buff = data;
+        buffer->max_size = size;
+        buffer->size = size;
+        buffer->currentIndex = 0;
+        buffer->floatIndex = 0.0f;
+}
+
 void
 gkick_buffer_reset(struct gkick_buffer *buffer)
 {
@@ -117,21 +130,17 @@ gkick_buffer_get_next(struct gkick_buffer *buffer)
 
 gkick_real
 gkick_buffer_stretch_get_next(struct gkick_buffer *buffer,
+                              const struct gkick_resampler *resampler,
                               gkick_real factor)
 {
-        if (buffer->currentIndex < buffer->size - 2) {
-                /* Do linear interpolation. */
-                gkick_real d = buffer->floatIndex - buffer->currentIndex;
-                gkick_real val = buffer->buff[buffer->currentIndex] * (1.0f - d)
-                        + buffer->buff[buffer->currentIndex + 1] * d;
-                buffer->floatIndex += factor;
-                buffer->currentIndex = buffer->floatIndex;
-                return val;
-        } else if (buffer->currentIndex < buffer->size - 1) {
-                return buffer->buff[buffer->currentIndex];
-        }
+        if (buffer->size < 1 || buffer->currentIndex > buffer->size - 1)
+                return 0.0f;
 
-        return 0.0f;
+        gkick_real val = gkick_resampler_value(resampler, buffer->buff,
+                                               buffer->size, buffer->floatIndex);
+        buffer->floatIndex += factor;
+        buffer->currentIndex = buffer->floatIndex;
+        return val;
 }
 
 void
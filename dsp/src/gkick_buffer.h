@@ -39,7 +39,7 @@ struct gkick_buffer {
          * Current position in the buffer.
          */
         size_t currentIndex;
-        gkick_real floatIndex;
+        double floatIndex;
 
         /**
          * Current size of the buffer. Can change during
@@ -54,6 +54,15 @@ gkick_buffer_new(struct gkick_buffer **buffer, int size);
 void
 gkick_buffer_free(struct gkick_buffer **buffer);
 
+/**
+ * Initializes the buffer to use the memory of the caller,
+ * the buffer must not be freed with gkick_buffer_free.
+ */
+void
+gkick_buffer_init(struct gkick_buffer *buffer,
+                  gkick_real *data,
+                  size_t size);
+
 void
 gkick_buffer_reset(struct gkick_buffer *buffer);
 
@@ -74,9 +83,16 @@ gkick_buffer_get_at(struct gkick_buffer *buffer,
 gkick_real
 gkick_buffer_get_next(struct gkick_buffer *buffer);
 
+struct gkick_resampler;
+
+/**
+ * Returns the next value of the buffer played
+ * faster (factor > 1) or slower with the resampler.
+ */
 gkick_real
 gkick_buffer_stretch_get_next(struct gkick_buffer *buffer,
-                                         gkick_real factor);
+                              const struct gkick_resampler *resampler,
+                              gkick_real factor);
 
 void
 gkick_buffer_set_size(struct gkick_buffer *buffer,
@@ -29,39 +29,52 @@ gkick_jack_process_callback(jack_nframes_t nframes,
 			    void *arg)
 {
         struct gkick_jack *jack = (struct gkick_jack*)arg;
-	jack_default_audio_sample_t *buffer;
-        if (gkick_jack_get_output_buffers(jack, &buffer, nframes) != GEONKICK_OK) {
+	jack_default_audio_sample_t *buffers[GEONKICK_MAX_CHANNELS];
+        if (gkick_jack_get_output_buffers(jack, buffers, nframes) != GEONKICK_OK) {
                 gkick_log_error("can't get output jack buffers");
                 return 0;
         }
-        void* port_buf = jack_port_get_buffer(jack->midi_in_port, nframes);
 
-	jack_midi_event_t event;
+        if (nframes > jack->buffer_size) {
+                for (size_t ch = 0; ch < GEONKICK_MAX_CHANNELS; ch++)
+                        memset(buffers[ch], 0, nframes * sizeof(jack_default_audio_sample_t));
+                return 0;
+        }
+
+        void* port_buf = jack_port_get_buffer(jack->midi_in_port, nframes);
 	jack_nframes_t events_count = jack_midi_get_event_count(port_buf);
-        jack_nframes_t event_index  = 0;
-        if (events_count > 0)
-                jack_midi_event_get(&event, port_buf, event_index);
-
-        for (size_t i = 0; i < nframes; i++) {
-                while (event.time == i && event_index < events_count) {
-			struct gkick_note_info note;
-                        memset(&note, 0, sizeof(struct gkick_note_info));
-                        gkick_jack_get_note_info(&event, &note);
-                        if (note.state == GKICK_KEY_STATE_PRESSED
-                            || note.state == GKICK_KEY_STATE_RELEASED) {
-                                gkick_mixer_key_pressed(jack->mixer, &note);
-                        }
-                        event_index++;
-                        if (event_index < events_count)
-                                jack_midi_event_get(&event, port_buf, event_index);
+
+        /* Render in blocks the frames between the MIDI events. */
+        jack_nframes_t offset = 0;
+        for (jack_nframes_t i = 0; i < events_count; i++) {
+                jack_midi_event_t event;
+                if (jack_midi_event_get(&event, port_buf, i) != 0)
+                        continue;
+
+                jack_nframes_t time = event.time < nframes ? event.time : nframes - 1;
+                if (time > offset) {
+                        gkick_mixer_process(jack->mixer, jack->channels,
+                                            offset, time - offset);
+                        offset = time;
                 }
 
-		gkick_real val;
-                gkick_mixer_get_frame(jack->mixer, 0, &val);
-                val *= 0.1f;
-                if (val > 0.1f)
-                        val = 0.1f;
-                buffer[i] = (jack_default_audio_sample_t)val;
+                struct gkick_note_info note;
+                memset(&note, 0, sizeof(struct gkick_note_info));
+                gkick_jack_get_note_info(&event, &note);
+                if (note.state == GKICK_KEY_STATE_PRESSED
+                    || note.state == GKICK_KEY_STATE_RELEASED) {
+                        gkick_mixer_key_pressed(jack->mixer, &note);
+                }
+        }
+
+        if (offset < nframes)
+                gkick_mixer_process(jack->mixer, jack->channels,
+                                    offset, nframes - offset);
+
+        for (size_t ch = 0; ch < GEONKICK_MAX_CHANNELS; ch++) {
+                const gkick_real *channel = jack->channels[ch];
+                for (jack_nframes_t i = 0; i < nframes; i++)
+                        buffers[ch][i] = (jack_default_audio_sample_t)channel[i];
         }
 
         return 0;
@@ -85,17 +98,18 @@ gkick_jack_sample_rate(struct gkick_jack *jack)
 
 enum geonkick_error
 gkick_jack_get_output_buffers(struct gkick_jack *jack,
-                              jack_default_audio_sample_t **channel_buf,
+                              jack_default_audio_sample_t **channels_bufs,
                               jack_nframes_t nframes)
 {
-        if (jack->output_port == NULL) {
-                gkick_log_error("output ports are undefined");
-                *channel_buf = NULL;
-                return GEONKICK_ERROR;
-        } else {
-                *channel_buf = (jack_default_audio_sample_t*)jack_port_get_buffer(jack->output_port,
-                                                                                  nframes);
-                if (*channel_buf == NULL)
+        for (size_t i = 0; i < GEONKICK_MAX_CHANNELS; i++) {
+                if (jack->output_ports[i] == NULL) {
+                        gkick_log_error("output ports are undefined");
+                        return GEONKICK_ERROR;
+                }
+
+                channels_bufs[i] = (jack_default_audio_sample_t*)jack_port_get_buffer(jack->output_ports[i],
+                                                                                      nframes);
+                if (channels_bufs[i] == NULL)
                         return GEONKICK_ERROR;
         }
 
@@ -143,9 +157,36 @@ gkick_jack_get_midi_in_port(struct gkick_jack *jack)
 int gkick_jack_srate_callback(jack_nframes_t nframes,
                               void *arg)
 {
+        struct gkick_jack *jack = (struct gkick_jack*)arg;
+        gkick_jack_lock(jack);
+        jack->sample_rate = nframes;
+        gkick_jack_unlock(jack);
+
+        /* The percussions are synthesised at GEONKICK_SAMPLE_RATE. */
+        gkick_mixer_set_sample_rate(jack->mixer, nframes);
 	return 0;
 }
 
+int gkick_jack_buffer_size_callback(jack_nframes_t nframes,
+                                    void *arg)
+{
+        struct gkick_jack *jack = (struct gkick_jack*)arg;
+        if (nframes <= jack->buffer_size)
+                return 0;
+
+        for (size_t i = 0; i < GEONKICK_MAX_CHANNELS; i++) {
+                gkick_real *buff = (gkick_real*)realloc(jack->channels[i],
+                                                        nframes * sizeof(gkick_real));
+                if (buff == NULL) {
+                        gkick_log_error("can't allocate memory");
+                        return 1;
+                }
+                jack->channels[i] = buff;
+        }
+        jack->buffer_size = nframes;
+        return 0;
+}
+
 enum geonkick_error
 gkick_jack_enable_midi_in(struct gkick_jack *jack,
                           const char *name)
@@ -192,16 +233,22 @@ gkick_jack_create_output_ports(struct gkick_jack *jack)
 
         error = GEONKICK_OK;
         gkick_jack_lock(jack);
-        if (jack->output_port == NULL) {
-                jack->output_port = jack_port_register(jack->client, "audio_out",
-                                                       JACK_DEFAULT_AUDIO_TYPE,
-                                                       JackPortIsOutput, 0);
-                if (jack->output_port == NULL) {
-                        gkick_log_error("can't register output ports");
+        for (size_t i = 0; i < GEONKICK_MAX_CHANNELS; i++) {
+                if (jack->output_ports[i] != NULL) {
+                        gkick_log_warning("output ports already created");
+                        break;
+                }
+
+                char name[30];
+                snprintf(name, sizeof(name), "audio_out_%u", (unsigned int)(i + 1));
+                jack->output_ports[i] = jack_port_register(jack->client, name,
+                                                           JACK_DEFAULT_AUDIO_TYPE,
+                                                           JackPortIsOutput, 0);
+                if (jack->output_ports[i] == NULL) {
+                        gkick_log_error("can't register output port %s", name);
                         error = GEONKICK_ERROR;
+                        break;
                 }
-        } else {
-                gkick_log_warning("output ports already created");
         }
         gkick_jack_unlock(jack);
         return error;
@@ -236,16 +283,28 @@ gkick_create_jack(struct gkick_jack **jack,
                 return GEONKICK_ERROR;
         }
 
+        (*jack)->mixer = mixer;
         jack_set_process_callback((*jack)->client,
                                   gkick_jack_process_callback,
                                   (void*)(*jack));
+        jack_set_sample_rate_callback((*jack)->client,
+                                      gkick_jack_srate_callback,
+                                      (void*)(*jack));
+        jack_set_buffer_size_callback((*jack)->client,
+                                      gkick_jack_buffer_size_callback,
+                                      (void*)(*jack));
+        gkick_jack_srate_callback(jack_get_sample_rate((*jack)->client), *jack);
+        if (gkick_jack_buffer_size_callback(jack_get_buffer_size((*jack)->client), *jack) != 0) {
+                gkick_log_error("can't create channels buffers");
+                gkick_jack_free(jack);
+                return GEONKICK_ERROR;
+        }
 
         if (gkick_jack_create_output_ports(*jack) != GEONKICK_OK) {
                 gkick_log_error("can't create output ports");
                 gkick_jack_free(jack);
                 return GEONKICK_ERROR;
         }
-        (*jack)->mixer = mixer;
 
         gkick_jack_enable_midi_in(*jack, "midi_in");
                 if (jack_activate((*jack)->client) != 0) {
@@ -280,15 +339,22 @@ gkick_jack_free(struct gkick_jack **jack)
         if (jack != NULL && *jack != NULL) {
                 if ((*jack)->client != NULL) {
                         jack_deactivate((*jack)->client);
-                        if ((*jack)->output_port != NULL) {
+                        for (size_t i = 0; i < GEONKICK_MAX_CHANNELS; i++) {
+                                if ((*jack)->output_ports[i] != NULL) {
+                                        jack_port_unregister((*jack)->client,
+                                                             (*jack)->output_ports[i]);
+                                }
+                        }
+                        if ((*jack)->midi_in_port != NULL) {
                                 jack_port_unregister((*jack)->client,
-                                                     (*jack)->output_port);
+                                                     (*jack)->midi_in_port);
                         }
-                        jack_port_unregister((*jack)->client,
-                                             (*jack)->output_port);
                         jack_client_close((*jack)->client);
                 }
 
+                for (size_t i = 0; i < GEONKICK_MAX_CHANNELS; i++)
+                        free((*jack)->channels[i]);
+
                 free(*jack);
                 *jack = NULL;
         }
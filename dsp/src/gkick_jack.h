@@ -31,10 +31,17 @@
 #include <jack/midiport.h>
 
 struct gkick_jack {
-        jack_port_t *output_port;
+        /* An output port for every mixer channel. */
+        jack_port_t *output_ports[GEONKICK_MAX_CHANNELS];
         jack_port_t *midi_in_port;
         jack_client_t *client;
         jack_nframes_t sample_rate;
+
+        /* Maximum number of frames in a process cycle. */
+        jack_nframes_t buffer_size;
+
+        /* Buffers of buffer_size frames the mixer is rendering into. */
+        gkick_real *channels[GEONKICK_MAX_CHANNELS];
         struct gkick_mixer *mixer;
         pthread_mutex_t lock;
 };
@@ -48,7 +55,7 @@ gkick_jack_sample_rate(struct gkick_jack *jack);
 
 enum geonkick_error
 gkick_jack_get_output_buffers(struct gkick_jack *jack,
-                              jack_default_audio_sample_t **channel_buf,
+                              jack_default_audio_sample_t **channels_bufs,
                               jack_nframes_t nframes);
 
 void gkick_jack_get_note_info(jack_midi_event_t *event,
@@ -60,6 +67,9 @@ gkick_jack_get_midi_in_port(struct gkick_jack *jack);
 int gkick_jack_srate_callback(jack_nframes_t nframes,
                               void *arg);
 
+int gkick_jack_buffer_size_callback(jack_nframes_t nframes,
+                                    void *arg);
+
 enum geonkick_error
 gkick_jack_enable_midi_in(struct gkick_jack *jack,
                           const char *name);
@@ -22,16 +22,18 @@
  */
 
 #include "mixer.h"
+#include "sample_store.h"
 
 enum geonkick_error
 gkick_mixer_create(struct gkick_mixer **mixer)
 {
 	*mixer = (struct gkick_mixer*)calloc(1, sizeof(struct gkick_mixer));
-        (*mixer)->solo = false;
 	if (*mixer == NULL) {
 		gkick_log_error("can't allocate memory");
 		return GEONKICK_ERROR_MEM_ALLOC;
 	}
+        (*mixer)->solo = false;
+        (*mixer)->preview.rate_factor = 1.0f;
 
 	return GEONKICK_OK;
 }
@@ -75,6 +77,50 @@ gkick_mixer_is_output_tuned(struct gkick_mixer *mixer,
 	return GEONKICK_OK;
 }
 
+/**
+ * Takes the pending preview sample if there is a free retired slot
+ * where to return the playing one. Called only by the audio thread.
+ */
+static void
+gkick_mixer_update_preview(struct gkick_preview_voice *preview)
+{
+        if (atomic_load_explicit(&preview->pending, memory_order_relaxed) == NULL)
+                return;
+
+        for (size_t i = 0; i < 2; i++) {
+                if (atomic_load_explicit(&preview->retired[i], memory_order_acquire) != NULL)
+                        continue;
+                struct gkick_sample *sample = atomic_exchange_explicit(&preview->pending,
+                                                                       NULL,
+                                                                       memory_order_acq_rel);
+                if (sample != NULL) {
+                        atomic_store_explicit(&preview->retired[i],
+                                              preview->playing,
+                                              memory_order_release);
+                        preview->playing = sample;
+                        preview->position = 0.0f;
+                }
+                return;
+        }
+}
+
+static gkick_real
+gkick_mixer_preview_frame(struct gkick_preview_voice *preview)
+{
+        struct gkick_sample *sample = preview->playing;
+        if (sample == NULL)
+                return 0.0f;
+
+        size_t index = (size_t)preview->position;
+        if (index + 1 >= sample->size)
+                return 0.0f;
+
+        gkick_real t = preview->position - index;
+        gkick_real val = (1.0f - t) * sample->data[index] + t * sample->data[index + 1];
+        preview->position += preview->rate_factor;
+        return val;
+}
+
 enum geonkick_error
 gkick_mixer_get_frame(struct gkick_mixer *mixer,
 		      int channel,
@@ -83,7 +129,7 @@ gkick_mixer_get_frame(struct gkick_mixer *mixer,
         *val = 0.0f;
         for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
                 struct gkick_audio_output *out = mixer->audio_outputs[i];
-                if (out->enabled  && !out->muted && (mixer->solo == out->solo) && (out->channel == channel || GKICK_IS_STANDALONE)) {
+                if (out->enabled  && !out->muted && (mixer->solo == out->solo) && out->channel == channel) {
                         gkick_real v = 0.0f;
                         gkick_audio_output_get_frame(out, &v);
                         if (i == mixer->limiter_callback_index)
@@ -92,6 +138,43 @@ gkick_mixer_get_frame(struct gkick_mixer *mixer,
                 }
         }
 
+        if (channel == 0) {
+                gkick_mixer_update_preview(&mixer->preview);
+                *val += gkick_mixer_preview_frame(&mixer->preview);
+        }
+
+        return GEONKICK_OK;
+}
+
+enum geonkick_error
+gkick_mixer_process(struct gkick_mixer *mixer,
+                    gkick_real **channels,
+                    size_t offset,
+                    size_t size)
+{
+        for (size_t i = 0; i < GEONKICK_MAX_CHANNELS; i++)
+                memset(channels[i] + offset, 0, size * sizeof(gkick_real));
+
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++) {
+                struct gkick_audio_output *out = mixer->audio_outputs[i];
+                size_t channel = out->channel;
+                if (out->enabled  && !out->muted && (mixer->solo == out->solo)
+                    && channel < GEONKICK_MAX_CHANNELS) {
+                        gkick_real peak = 0.0f;
+                        gkick_audio_output_process(out, channels[channel] + offset,
+                                                   size, &peak);
+                        if (i == mixer->limiter_callback_index)
+                                gkick_mixer_set_leveler(mixer, peak);
+                }
+        }
+
+        gkick_mixer_update_preview(&mixer->preview);
+        if (mixer->preview.playing != NULL) {
+                gkick_real *out = channels[0] + offset;
+                for (size_t i = 0; i < size; i++)
+                        out[i] += gkick_mixer_preview_frame(&mixer->preview);
+        }
+
         return GEONKICK_OK;
 }
 
@@ -103,10 +186,25 @@ gkick_mixer_set_leveler(struct gkick_mixer *mixer,
                 mixer->limiter_callback(mixer->limiter_callback_arg, val);
 }
 
+void
+gkick_mixer_set_sample_rate(struct gkick_mixer *mixer,
+                            int sample_rate)
+{
+        for (size_t i = 0; i < GEONKICK_MAX_PERCUSSIONS; i++)
+                gkick_audio_output_set_sample_rate(mixer->audio_outputs[i], sample_rate);
+        if (sample_rate > 0)
+                mixer->preview.rate_factor = (gkick_real)GEONKICK_SAMPLE_RATE / sample_rate;
+}
+
 void
 gkick_mixer_free(struct gkick_mixer **mixer)
 {
 	if (mixer != NULL && *mixer != NULL) {
+                struct gkick_preview_voice *preview = &(*mixer)->preview;
+                gkick_sample_unref(preview->pending);
+                gkick_sample_unref(preview->retired[0]);
+                gkick_sample_unref(preview->retired[1]);
+                gkick_sample_unref(preview->playing);
 		free(*mixer);
 		*mixer = NULL;
 	}
@@ -177,3 +275,27 @@ gkick_mixer_set_limiter_callback(struct gkick_mixer *mixer,
         mixer->limiter_callback_arg = arg;
         return GEONKICK_OK;
 }
+
+enum geonkick_error
+gkick_mixer_play_preview(struct gkick_mixer *mixer,
+                         struct gkick_sample *sample)
+{
+        if (mixer == NULL || sample == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        struct gkick_preview_voice *preview = &mixer->preview;
+        for (size_t i = 0; i < 2; i++) {
+                struct gkick_sample *retired = atomic_exchange_explicit(&preview->retired[i],
+                                                                        NULL,
+                                                                        memory_order_acq_rel);
+                gkick_sample_unref(retired);
+        }
+
+        struct gkick_sample *old = atomic_exchange_explicit(&preview->pending,
+                                                            gkick_sample_ref(sample),
+                                                            memory_order_acq_rel);
+        gkick_sample_unref(old);
+        return GEONKICK_OK;
+}
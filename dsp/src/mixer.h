@@ -26,6 +26,24 @@
 
 #include "audio_output.h"
 
+struct gkick_sample;
+
+/**
+ * Preview voice plays a rendered sample on the first channel,
+ * apart from the percussions outputs. The new sample is passed
+ * to the audio thread in the pending slot and the replaced one
+ * is returned in a retired slot, so the audio thread never
+ * releases the samples memory.
+ */
+struct gkick_preview_voice {
+        struct gkick_sample * _Atomic pending;
+        struct gkick_sample * _Atomic retired[2];
+        /* Used only by the audio thread. */
+        struct gkick_sample *playing;
+        gkick_real position;
+        _Atomic gkick_real rate_factor;
+};
+
 struct gkick_mixer {
 	struct gkick_audio_output **audio_outputs;
 	size_t connection_matrix[127];
@@ -34,6 +52,7 @@ struct gkick_mixer {
         void (*limiter_callback) (void*, gkick_real val);
         void *limiter_callback_arg;
         _Atomic size_t limiter_callback_index;
+        struct gkick_preview_voice preview;
 };
 
 enum geonkick_error
@@ -58,10 +77,24 @@ gkick_mixer_get_frame(struct gkick_mixer *mixer,
 		      int channel,
 		      gkick_real *val);
 
+/**
+ * Renders size frames of every channel into the channels buffers
+ * starting from the offset. The channels buffers are overwritten.
+ */
+enum geonkick_error
+gkick_mixer_process(struct gkick_mixer *mixer,
+                    gkick_real **channels,
+                    size_t offset,
+                    size_t size);
+
 void
 gkick_mixer_set_leveler(struct gkick_mixer *mixer,
                              gkick_real val);
 
+void
+gkick_mixer_set_sample_rate(struct gkick_mixer *mixer,
+                            int sample_rate);
+
 
 void
 gkick_mixer_free(struct gkick_mixer **mixer);
@@ -93,4 +126,12 @@ gkick_mixer_set_limiter_callback(struct gkick_mixer *mixer,
 				 void (*callback)(void*, gkick_real val),
 				 void *arg);
 
+/**
+ * Plays the sample through the preview voice, the playing preview
+ * is replaced. Must not be called concurrently for the same mixer.
+ */
+enum geonkick_error
+gkick_mixer_play_preview(struct gkick_mixer *mixer,
+                         struct gkick_sample *sample);
+
 #endif // GKICK_MIXER_H
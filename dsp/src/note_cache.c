@@ -0,0 +1,219 @@
+/**
+ * File name: note_cache.c
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "note_cache.h"
+
+static size_t
+gkick_note_cache_buffer_bytes(struct gkick_buffer *buffer)
+{
+        return sizeof(struct gkick_buffer) + buffer->max_size * sizeof(gkick_real);
+}
+
+static void
+gkick_note_cache_remove(struct gkick_note_cache *cache,
+                        struct gkick_note_cache_entry *entry)
+{
+        cache->size -= gkick_note_cache_buffer_bytes(entry->buffer);
+        gkick_buffer_free(&entry->buffer);
+        entry->generation = 0;
+}
+
+/**
+ * Evicts one entry, stale entries first, then
+ * the least recently used one. Must be called with the lock held.
+ */
+static bool
+gkick_note_cache_evict(struct gkick_note_cache *cache)
+{
+        struct gkick_note_cache_entry *victim = NULL;
+        for (size_t i = 0; i < GKICK_NOTE_CACHE_NOTES; i++) {
+                struct gkick_note_cache_entry *entry = &cache->entries[i];
+                if (entry->buffer == NULL || entry->buffer == cache->pinned)
+                        continue;
+                if (entry->generation != cache->generation) {
+                        victim = entry;
+                        break;
+                }
+                if (victim == NULL || entry->last_used < victim->last_used)
+                        victim = entry;
+        }
+
+        if (victim == NULL)
+                return false;
+        gkick_note_cache_remove(cache, victim);
+        return true;
+}
+
+enum geonkick_error
+gkick_note_cache_create(struct gkick_note_cache **cache)
+{
+        if (cache == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        *cache = (struct gkick_note_cache*)calloc(1, sizeof(struct gkick_note_cache));
+        if (*cache == NULL) {
+                gkick_log_error("can't allocate memory");
+                return GEONKICK_ERROR_MEM_ALLOC;
+        }
+        (*cache)->generation = 1;
+        (*cache)->budget = GKICK_NOTE_CACHE_BUDGET;
+
+        if (pthread_mutex_init(&(*cache)->lock, NULL) != 0) {
+                gkick_log_error("error on init mutex");
+                free(*cache);
+                *cache = NULL;
+                return GEONKICK_ERROR;
+	}
+
+        return GEONKICK_OK;
+}
+
+void
+gkick_note_cache_free(struct gkick_note_cache **cache)
+{
+        if (cache != NULL && *cache != NULL) {
+                for (size_t i = 0; i < GKICK_NOTE_CACHE_NOTES; i++)
+                        gkick_buffer_free(&(*cache)->entries[i].buffer);
+                pthread_mutex_destroy(&(*cache)->lock);
+                free(*cache);
+                *cache = NULL;
+        }
+}
+
+void
+gkick_note_cache_invalidate(struct gkick_note_cache *cache)
+{
+        cache->generation++;
+}
+
+size_t
+gkick_note_cache_generation(struct gkick_note_cache *cache)
+{
+        return cache->generation;
+}
+
+struct gkick_buffer*
+gkick_note_cache_acquire(struct gkick_note_cache *cache,
+                         int note)
+{
+        if (note < 0 || note >= GKICK_NOTE_CACHE_NOTES)
+                return NULL;
+
+        struct gkick_note_cache_entry *entry = &cache->entries[note];
+        struct gkick_buffer *buffer = NULL;
+
+        /**
+         * Don't block the audio thread. If the worker holds the lock
+         * the note is played interpolated this time.
+         */
+        if (pthread_mutex_trylock(&cache->lock) == 0) {
+                if (entry->buffer != NULL && entry->generation == cache->generation) {
+                        buffer = entry->buffer;
+                        entry->last_used = ++cache->clock;
+                }
+                cache->pinned = buffer;
+                pthread_mutex_unlock(&cache->lock);
+        }
+
+        if (buffer == NULL) {
+                entry->requested = true;
+                cache->pending = true;
+        }
+
+        return buffer;
+}
+
+bool
+gkick_note_cache_is_pending(struct gkick_note_cache *cache)
+{
+        return cache->pending;
+}
+
+int
+gkick_note_cache_next_request(struct gkick_note_cache *cache)
+{
+        cache->pending = false;
+        for (int i = 0; i < GKICK_NOTE_CACHE_NOTES; i++) {
+                if (atomic_exchange(&cache->entries[i].requested, false)) {
+                        cache->pending = true;
+                        return i;
+                }
+        }
+        return -1;
+}
+
+enum geonkick_error
+gkick_note_cache_insert(struct gkick_note_cache *cache,
+                        int note,
+                        struct gkick_buffer *buffer,
+                        size_t generation)
+{
+        if (cache == NULL || buffer == NULL
+            || note < 0 || note >= GKICK_NOTE_CACHE_NOTES) {
+                gkick_log_error("wrong arguments");
+                gkick_buffer_free(&buffer);
+                return GEONKICK_ERROR;
+        }
+
+        struct gkick_note_cache_entry *entry = &cache->entries[note];
+        size_t bytes = gkick_note_cache_buffer_bytes(buffer);
+
+        pthread_mutex_lock(&cache->lock);
+        /* The percussion was synthesised again during rendering. */
+        if (generation != cache->generation) {
+                pthread_mutex_unlock(&cache->lock);
+                gkick_buffer_free(&buffer);
+                return GEONKICK_OK;
+        }
+
+        /**
+         * The old buffer is still played. The note will be
+         * requested again on the next key press.
+         */
+        if (entry->buffer != NULL && entry->buffer == cache->pinned) {
+                pthread_mutex_unlock(&cache->lock);
+                gkick_buffer_free(&buffer);
+                return GEONKICK_OK;
+        }
+
+        if (entry->buffer != NULL)
+                gkick_note_cache_remove(cache, entry);
+
+        while (cache->size + bytes > cache->budget) {
+                if (!gkick_note_cache_evict(cache)) {
+                        pthread_mutex_unlock(&cache->lock);
+                        gkick_buffer_free(&buffer);
+                        return GEONKICK_ERROR;
+                }
+        }
+
+        entry->buffer = buffer;
+        entry->generation = generation;
+        entry->last_used = ++cache->clock;
+        cache->size += bytes;
+        pthread_mutex_unlock(&cache->lock);
+
+        return GEONKICK_OK;
+}
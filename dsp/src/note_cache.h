@@ -0,0 +1,119 @@
+/**
+ * File name: note_cache.h
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef GKICK_NOTE_CACHE_H
+#define GKICK_NOTE_CACHE_H
+
+#include "geonkick_internal.h"
+
+#include <stdatomic.h>
+
+/**
+ * Note cache holds for a tuned audio output a percussion
+ * buffer per MIDI note, synthesized with the oscillators frequencies
+ * scaled to the note. The buffers are rendered lazily by the worker
+ * when the audio thread requests a note that is not in the cache,
+ * and evicted in the least recently used order when the memory
+ * budget is exceeded.
+ */
+
+#define GKICK_NOTE_CACHE_NOTES 128
+
+/* Memory budget of the note cache in bytes. */
+#define GKICK_NOTE_CACHE_BUDGET (8 * 1024 * 1024)
+
+struct gkick_note_cache_entry {
+        struct gkick_buffer *buffer;
+
+        /* The cache generation the buffer was rendered for. */
+        size_t generation;
+
+        /* Cache clock value of the last usage of the entry. */
+        atomic_size_t last_used;
+
+        /* Set by the audio thread when the note needs to be rendered. */
+        atomic_bool requested;
+};
+
+struct gkick_note_cache {
+        struct gkick_note_cache_entry entries[GKICK_NOTE_CACHE_NOTES];
+
+        /**
+         * Incremented every time the percussion is synthesised again.
+         * Entries with an older generation are stale.
+         */
+        atomic_size_t generation;
+        atomic_size_t clock;
+
+        /* Specifies if there are requested notes to be rendered. */
+        atomic_bool pending;
+
+        /* Memory used by the cached buffers in bytes. */
+        size_t size;
+        size_t budget;
+
+        /* The buffer played by the audio thread, never evicted. */
+        struct gkick_buffer *pinned;
+        pthread_mutex_t lock;
+};
+
+enum geonkick_error
+gkick_note_cache_create(struct gkick_note_cache **cache);
+
+void
+gkick_note_cache_free(struct gkick_note_cache **cache);
+
+void
+gkick_note_cache_invalidate(struct gkick_note_cache *cache);
+
+size_t
+gkick_note_cache_generation(struct gkick_note_cache *cache);
+
+/**
+ * Called from the audio thread. Returns the cached buffer for the note
+ * or NULL, in which case the note is requested to be rendered.
+ * The returned buffer stays valid until the next call.
+ */
+struct gkick_buffer*
+gkick_note_cache_acquire(struct gkick_note_cache *cache,
+                         int note);
+
+bool
+gkick_note_cache_is_pending(struct gkick_note_cache *cache);
+
+/**
+ * Returns the next requested note to be rendered or -1.
+ */
+int
+gkick_note_cache_next_request(struct gkick_note_cache *cache);
+
+/**
+ * Takes the ownership of the buffer.
+ */
+enum geonkick_error
+gkick_note_cache_insert(struct gkick_note_cache *cache,
+                        int note,
+                        struct gkick_buffer *buffer,
+                        size_t generation);
+
+#endif // GKICK_NOTE_CACHE_H
@@ -22,6 +22,7 @@
  */
 
 #include "oscillator.h"
+#include "resampler.h"
 #include <math.h>
 
 struct gkick_oscillator
@@ -39,6 +40,7 @@ struct gkick_oscillator
         osc->sample_rate = GEONKICK_SAMPLE_RATE;
         osc->amplitude = GKICK_OSC_DEFAULT_AMPLITUDE;
         osc->frequency = GKICK_OSC_DEFAULT_FREQUENCY;
+        osc->pitch_factor = 1.0f;
         osc->env_number = 2;
         osc->brownian = 0;
         osc->is_fm = false;
@@ -72,7 +74,7 @@ gkick_osc_free(struct gkick_oscillator **osc)
                         gkick_envelope_destroy((*osc)->envelopes[i]);
                 free((*osc)->envelopes);
                 gkick_filter_free(&(*osc)->filter);
-                gkick_buffer_free(&(*osc)->sample);
+                gkick_sample_unref((*osc)->sample);
         }
 
         free(*osc);
@@ -129,7 +131,8 @@ void gkick_osc_increment_phase(struct gkick_oscillator *osc,
 			       gkick_real kick_len)
 {
         gkick_real f;
-        f = osc->frequency * gkick_envelope_get_value(osc->envelopes[1], t / kick_len);
+        f = osc->frequency * osc->pitch_factor
+                * gkick_envelope_get_value(osc->envelopes[1], t / kick_len);
         f += f * osc->fm_input;
         osc->phase += (2.0f * M_PI * f) / (osc->sample_rate);
         if (osc->phase > 2.0f * M_PI)
@@ -173,7 +176,11 @@ gkick_real gkick_osc_value(struct gkick_oscillator *osc,
         case GEONKICK_OSC_FUNC_SAMPLE:
                 if (osc->sample != NULL) {
                         if (t > (0.5f * osc->initial_phase / (2.0f * M_PI)) * kick_len)
-                                v = amp * gkick_osc_func_sample(osc->sample);
+                                v = amp * gkick_osc_func_sample(osc->sample,
+                                                                osc->resampler,
+                                                                &osc->sample_position,
+                                                                osc->pitch_factor
+                                                                * (GEONKICK_SAMPLE_RATE / osc->sample_rate));
                         else
                                 v = 0.0f;
                 }
@@ -249,9 +256,24 @@ gkick_osc_func_noise_brownian(gkick_real *previous,
 }
 
 gkick_real
-gkick_osc_func_sample(struct gkick_buffer *sample)
+gkick_osc_func_sample(const struct gkick_sample *sample,
+                      const struct gkick_resampler *resampler,
+                      double *position,
+                      gkick_real pitch_factor)
 {
-        return gkick_buffer_get_next(sample);
+        if (*position >= sample->size)
+                return 0.0f;
+
+        gkick_real val;
+        if (pitch_factor != 1.0f) {
+                val = gkick_resampler_value(resampler, sample->data,
+                                            sample->size, *position);
+                *position += pitch_factor;
+        } else {
+                val = sample->data[(size_t)*position];
+                *position += 1.0;
+        }
+        return val;
 }
 
 void
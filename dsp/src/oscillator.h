@@ -27,6 +27,9 @@
 #include "geonkick_internal.h"
 #include "envelope.h"
 #include "filter.h"
+#include "sample_store.h"
+
+struct gkick_resampler;
 
 #define GKICK_OSC_DEFAULT_AMPLITUDE   1.0f
 #define GKICK_OSC_DEFAULT_FREQUENCY   150.0f
@@ -50,7 +53,15 @@ struct gkick_oscillator {
 	gkick_real frequency;
 	gkick_real amplitude;
 
-        struct gkick_buffer *sample;
+        /* Frequency scale factor used when rendering tuned notes. */
+        gkick_real pitch_factor;
+
+        /* Shared sample and its playing position. */
+        struct gkick_sample *sample;
+        double sample_position;
+
+        /* Resampler of the tuned sample, set for each render. */
+        const struct gkick_resampler *resampler;
 
         /* FM input value for this OSC. */
         gkick_real fm_input;
@@ -114,7 +125,10 @@ gkick_osc_func_noise_brownian(gkick_real *previous,
                               unsigned int *seed);
 
 gkick_real
-gkick_osc_func_sample(struct gkick_buffer *sample);
+gkick_osc_func_sample(const struct gkick_sample *sample,
+                      const struct gkick_resampler *resampler,
+                      double *position,
+                      gkick_real pitch_factor);
 
 void gkick_osc_get_envelope_points(struct gkick_oscillator *osc,
                                    size_t env_index,
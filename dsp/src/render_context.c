@@ -0,0 +1,113 @@
+/**
+ * File name: render_context.c
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "render_context.h"
+#include "synthesizer.h"
+
+enum geonkick_error
+gkick_render_context_new(struct gkick_render_context **context)
+{
+        if (context == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        *context = (struct gkick_render_context*)calloc(1, sizeof(struct gkick_render_context));
+        if (*context == NULL) {
+                gkick_log_error("can't allocate memory");
+                return GEONKICK_ERROR_MEM_ALLOC;
+        }
+
+        gkick_resampler_init();
+
+        if (gkick_synth_new(&(*context)->synth) != GEONKICK_OK) {
+                gkick_log_error("can't create synthesizer");
+                gkick_render_context_free(context);
+                return GEONKICK_ERROR;
+        }
+
+        return GEONKICK_OK;
+}
+
+void
+gkick_render_context_free(struct gkick_render_context **context)
+{
+        if (context != NULL && *context != NULL) {
+                gkick_synth_free(&(*context)->synth);
+                free(*context);
+                *context = NULL;
+        }
+}
+
+enum geonkick_error
+gkick_render_context_set_params(struct gkick_render_context *context,
+                                const struct gkick_synth_params *params)
+{
+        if (context == NULL || params == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        return gkick_synth_set_params(context->synth, params);
+}
+
+enum geonkick_error
+gkick_render_context_get_length(struct gkick_render_context *context,
+                                size_t *length)
+{
+        if (context == NULL || length == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        return gkick_synth_get_buffer_size(context->synth, length);
+}
+
+enum geonkick_error
+gkick_render_context_render(struct gkick_render_context *context,
+                            gkick_real *data,
+                            size_t size,
+                            size_t *length)
+{
+        if (context == NULL || data == NULL || length == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        /* The percussion is truncated to the size of the data. */
+        struct gkick_buffer buffer;
+        gkick_buffer_init(&buffer, data, size);
+        size_t buffer_size = 0;
+        gkick_synth_get_buffer_size(context->synth, &buffer_size);
+        gkick_buffer_set_size(&buffer, buffer_size);
+        enum geonkick_error res = gkick_synth_render(context->synth,
+                                                     &buffer,
+                                                     1.0f,
+                                                     1);
+        if (res != GEONKICK_OK)
+                return res;
+
+        *length = gkick_buffer_size(&buffer);
+        return GEONKICK_OK;
+}
@@ -0,0 +1,62 @@
+/**
+ * File name: render_context.h
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GKICK_RENDER_CONTEXT_H
+#define GKICK_RENDER_CONTEXT_H
+
+#include "geonkick_internal.h"
+
+/**
+ * Render context owns a synthesizer without audio output used
+ * to render percussions offline, independently of the instances.
+ * A context must be used by one thread at a time. The contexts don't
+ * share any state except the immutable resamplers and the samples,
+ * so many contexts can render in parallel. The percussion is
+ * rendered directly into the memory of the caller.
+ */
+struct gkick_render_context {
+        struct gkick_synth *synth;
+};
+
+enum geonkick_error
+gkick_render_context_new(struct gkick_render_context **context);
+
+void
+gkick_render_context_free(struct gkick_render_context **context);
+
+enum geonkick_error
+gkick_render_context_set_params(struct gkick_render_context *context,
+                                const struct gkick_synth_params *params);
+
+enum geonkick_error
+gkick_render_context_get_length(struct gkick_render_context *context,
+                                size_t *length);
+
+enum geonkick_error
+gkick_render_context_render(struct gkick_render_context *context,
+                            gkick_real *data,
+                            size_t size,
+                            size_t *length);
+
+#endif // GKICK_RENDER_CONTEXT_H
@@ -0,0 +1,329 @@
+/**
+ * File name: render_pool.c
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "render_pool.h"
+
+#include <time.h>
+
+static struct gkick_render_pool gkick_render_pool = {
+        .lock = PTHREAD_MUTEX_INITIALIZER
+};
+
+/* Serializes the creation and destruction of the pool. */
+static pthread_mutex_t gkick_render_pool_lifecycle = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t
+gkick_render_pool_time(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void
+gkick_render_pool_wait(struct gkick_render_pool *pool, uint64_t until)
+{
+        struct timespec ts;
+        ts.tv_sec  = until / 1000;
+        ts.tv_nsec = (long)(until % 1000) * 1000000;
+        pthread_cond_timedwait(&pool->cond, &pool->lock, &ts);
+}
+
+/**
+ * Adds the instance to the end of the queue. Must be called with the lock held.
+ */
+static void
+gkick_render_pool_enqueue(struct gkick_render_pool *pool,
+                          struct geonkick *kick,
+                          uint64_t due)
+{
+        struct gkick_worker *worker = &kick->worker;
+        if (worker->queued)
+                return;
+
+        worker->queued = true;
+        worker->due = due;
+        worker->next = NULL;
+        if (pool->queue_tail != NULL)
+                pool->queue_tail->worker.next = kick;
+        else
+                pool->queue_head = kick;
+        pool->queue_tail = kick;
+}
+
+static void
+gkick_render_pool_remove(struct gkick_render_pool *pool,
+                         struct geonkick *kick)
+{
+        struct geonkick *prev = NULL;
+        for (struct geonkick *k = pool->queue_head; k != NULL; k = k->worker.next) {
+                if (k == kick) {
+                        if (prev != NULL)
+                                prev->worker.next = k->worker.next;
+                        else
+                                pool->queue_head = k->worker.next;
+                        if (pool->queue_tail == k)
+                                pool->queue_tail = prev;
+                        break;
+                }
+                prev = k;
+        }
+        kick->worker.queued = false;
+        kick->worker.next = NULL;
+}
+
+/**
+ * Note requests come from the audio thread that can't signal the pool.
+ * The instances with tuned outputs are polled periodically.
+ * Returns the next polling time or 0 if there are no tuned outputs.
+ */
+static uint64_t
+gkick_render_pool_poll(struct gkick_render_pool *pool, uint64_t now)
+{
+        bool tuned = false;
+        for (struct geonkick *k = pool->instances; k != NULL; k = k->worker.next_registered) {
+                if (!k->synthesis_on || !geonkick_worker_has_tuned_outputs(k))
+                        continue;
+                tuned = true;
+                if (now >= pool->poll_time && geonkick_worker_has_note_requests(k))
+                        gkick_render_pool_enqueue(pool, k, now);
+        }
+
+        if (!tuned)
+                return 0;
+        if (now >= pool->poll_time)
+                pool->poll_time = now + GKICK_RENDER_POOL_POLL;
+        return pool->poll_time;
+}
+
+/**
+ * Takes the first instance from the queue that is ready to be rendered.
+ * Returns NULL and the time until there is nothing to do otherwise.
+ */
+static struct geonkick*
+gkick_render_pool_next(struct gkick_render_pool *pool, uint64_t *until)
+{
+        uint64_t now = gkick_render_pool_time();
+        *until = gkick_render_pool_poll(pool, now);
+        for (struct geonkick *k = pool->queue_head; k != NULL; k = k->worker.next) {
+                /* An instance is rendered by a single thread at a time. */
+                if (k->worker.turn)
+                        continue;
+                if (k->worker.flush || now >= k->worker.due) {
+                        gkick_render_pool_remove(pool, k);
+                        k->worker.flush = false;
+                        return k;
+                }
+                if (*until == 0 || k->worker.due < *until)
+                        *until = k->worker.due;
+        }
+        return NULL;
+}
+
+static void*
+gkick_render_pool_thread(void *arg)
+{
+        struct gkick_render_pool *pool = (struct gkick_render_pool*)arg;
+        pthread_mutex_lock(&pool->lock);
+        while (pool->running) {
+                uint64_t until;
+                struct geonkick *kick = gkick_render_pool_next(pool, &until);
+                if (kick == NULL) {
+                        if (until > 0)
+                                gkick_render_pool_wait(pool, until);
+                        else
+                                pthread_cond_wait(&pool->cond, &pool->lock);
+                        continue;
+                }
+
+                kick->worker.turn = true;
+                kick->worker.rendering = true;
+                pthread_mutex_unlock(&pool->lock);
+                geonkick_worker_render(kick);
+
+                /* Wakeup the threads waiting for the rendering. */
+                geonkick_lock(kick);
+                kick->worker.rendering = false;
+                pthread_cond_broadcast(&kick->worker.render_cond);
+                geonkick_unlock(kick);
+
+                /**
+                 * The updates arrived during the turn are already queued,
+                 * the remaining ones are rendered after the other queued instances.
+                 */
+                pthread_mutex_lock(&pool->lock);
+                if (geonkick_worker_has_updates(kick)
+                    || geonkick_worker_has_note_requests(kick)) {
+                        gkick_render_pool_enqueue(pool, kick, gkick_render_pool_time());
+                        pthread_cond_signal(&pool->cond);
+                }
+                kick->worker.turn = false;
+                pthread_cond_broadcast(&pool->turn_cond);
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        return NULL;
+}
+
+static enum geonkick_error
+gkick_render_pool_init(struct gkick_render_pool *pool)
+{
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        if (pthread_cond_init(&pool->cond, &attr) != 0) {
+                gkick_log_error("can't init render pool condition variable");
+                pthread_condattr_destroy(&attr);
+                return GEONKICK_ERROR;
+        }
+        pthread_condattr_destroy(&attr);
+
+        if (pthread_cond_init(&pool->turn_cond, NULL) != 0) {
+                gkick_log_error("can't init render pool condition variable");
+                pthread_cond_destroy(&pool->cond);
+                return GEONKICK_ERROR;
+        }
+
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        if (cores < 1)
+                cores = 1;
+        else if (cores > GKICK_RENDER_POOL_MAX_THREADS)
+                cores = GKICK_RENDER_POOL_MAX_THREADS;
+        pool->max_threads = (size_t)cores;
+        pool->threads_number = 0;
+        pool->instances = NULL;
+        pool->queue_head = NULL;
+        pool->queue_tail = NULL;
+        pool->poll_time = 0;
+        pool->running = true;
+        return GEONKICK_OK;
+}
+
+/**
+ * Stops and joins the threads. Must be called
+ * with the lifecycle lock held and the pool lock released.
+ */
+static void
+gkick_render_pool_destroy(struct gkick_render_pool *pool)
+{
+        pthread_mutex_lock(&pool->lock);
+        pool->running = false;
+        pthread_cond_broadcast(&pool->cond);
+        pthread_mutex_unlock(&pool->lock);
+
+        for (size_t i = 0; i < pool->threads_number; i++)
+                pthread_join(pool->threads[i], NULL);
+        pool->threads_number = 0;
+        pthread_cond_destroy(&pool->cond);
+        pthread_cond_destroy(&pool->turn_cond);
+}
+
+enum geonkick_error
+gkick_render_pool_register(struct geonkick *kick)
+{
+        if (kick == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        struct gkick_render_pool *pool = &gkick_render_pool;
+        pthread_mutex_lock(&gkick_render_pool_lifecycle);
+        if (pool->refcount == 0 && gkick_render_pool_init(pool) != GEONKICK_OK) {
+                pthread_mutex_unlock(&gkick_render_pool_lifecycle);
+                return GEONKICK_ERROR;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        /* One more thread for every new instance until there are as many as the cores. */
+        if (pool->threads_number < pool->max_threads) {
+                if (pthread_create(&pool->threads[pool->threads_number], NULL,
+                                   gkick_render_pool_thread, pool) != 0) {
+                        gkick_log_error("can't create render pool thread");
+                        if (pool->threads_number == 0) {
+                                pthread_mutex_unlock(&pool->lock);
+                                if (pool->refcount == 0)
+                                        gkick_render_pool_destroy(pool);
+                                pthread_mutex_unlock(&gkick_render_pool_lifecycle);
+                                return GEONKICK_ERROR;
+                        }
+                } else {
+                        pool->threads_number++;
+                }
+        }
+
+        kick->worker.queued = false;
+        kick->worker.turn = false;
+        kick->worker.next = NULL;
+        kick->worker.next_registered = pool->instances;
+        pool->instances = kick;
+        pool->refcount++;
+        kick->worker.running = true;
+        pthread_mutex_unlock(&pool->lock);
+        pthread_mutex_unlock(&gkick_render_pool_lifecycle);
+
+        return GEONKICK_OK;
+}
+
+void
+gkick_render_pool_unregister(struct geonkick *kick)
+{
+        if (kick == NULL || !kick->worker.running)
+                return;
+
+        struct gkick_render_pool *pool = &gkick_render_pool;
+        pthread_mutex_lock(&gkick_render_pool_lifecycle);
+        pthread_mutex_lock(&pool->lock);
+        kick->worker.running = false;
+        gkick_render_pool_remove(pool, kick);
+        struct geonkick **k = &pool->instances;
+        while (*k != NULL && *k != kick)
+                k = &(*k)->worker.next_registered;
+        if (*k != NULL)
+                *k = kick->worker.next_registered;
+        kick->worker.next_registered = NULL;
+
+        while (kick->worker.turn)
+                pthread_cond_wait(&pool->turn_cond, &pool->lock);
+
+        /* Queued again by the finished turn. */
+        gkick_render_pool_remove(pool, kick);
+        bool last = --pool->refcount == 0;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (last)
+                gkick_render_pool_destroy(pool);
+        pthread_mutex_unlock(&gkick_render_pool_lifecycle);
+}
+
+void
+gkick_render_pool_schedule(struct geonkick *kick)
+{
+        struct gkick_render_pool *pool = &gkick_render_pool;
+        pthread_mutex_lock(&pool->lock);
+        if (kick->worker.running) {
+                gkick_render_pool_enqueue(pool, kick, gkick_render_pool_time()
+                                          + GKICK_RENDER_POOL_DEBOUNCE);
+                pthread_cond_signal(&pool->cond);
+        }
+        pthread_mutex_unlock(&pool->lock);
+}
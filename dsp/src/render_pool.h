@@ -0,0 +1,91 @@
+/**
+ * File name: render_pool.h
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef GKICK_RENDER_POOL_H
+#define GKICK_RENDER_POOL_H
+
+#include "geonkick_internal.h"
+
+/**
+ * Render pool is shared by all Geonkick instances of the process.
+ * The pool is created when the first instance is registered and
+ * destroyed when the last one is unregistered. The number of threads
+ * grows with the number of instances up to the number of cores.
+ *
+ * The instances with pending updates are rendered in the round-robin
+ * order, one percussion or one note per turn, so an instance with many
+ * updated percussions doesn't delay the other instances.
+ */
+
+#define GKICK_RENDER_POOL_MAX_THREADS 16
+
+/* Updates debouncing time in milliseconds. */
+#define GKICK_RENDER_POOL_DEBOUNCE 40
+
+/* Polling interval of the tuned outputs note requests in milliseconds. */
+#define GKICK_RENDER_POOL_POLL 40
+
+struct gkick_render_pool {
+        pthread_t threads[GKICK_RENDER_POOL_MAX_THREADS];
+        size_t threads_number;
+        size_t max_threads;
+
+        /* Number of registered instances. */
+        size_t refcount;
+        struct geonkick *instances;
+
+        /* Queue of the instances with pending updates. */
+        struct geonkick *queue_head;
+        struct geonkick *queue_tail;
+
+        /* Next time of polling the note requests. */
+        uint64_t poll_time;
+
+        bool running;
+        pthread_mutex_t lock;
+
+        /* Signaled when there is work to be done. */
+        pthread_cond_t cond;
+
+        /* Signaled every time a thread finished a turn. */
+        pthread_cond_t turn_cond;
+};
+
+enum geonkick_error
+gkick_render_pool_register(struct geonkick *kick);
+
+/**
+ * Removes the instance from the pool. Waits for the turn in progress
+ * of the instance to finish.
+ */
+void
+gkick_render_pool_unregister(struct geonkick *kick);
+
+/**
+ * Queues the instance for rendering. The updates are debounced
+ * unless the worker flush flag is set.
+ */
+void
+gkick_render_pool_schedule(struct geonkick *kick);
+
+#endif // GKICK_RENDER_POOL_H
@@ -0,0 +1,348 @@
+/**
+ * File name: resampler.c
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "resampler.h"
+
+#include <stddef.h>
+
+#if defined(__SSE__) && !defined(GEONKICK_DOUBLE_PRECISION)
+#define GKICK_RESAMPLER_SSE
+#include <xmmintrin.h>
+#endif
+
+#define GKICK_RESAMPLER_QUALITIES (GEONKICK_RESAMPLER_HIGH + 1)
+
+static struct gkick_resampler *gkick_resamplers[GKICK_RESAMPLER_QUALITIES];
+static pthread_once_t gkick_resamplers_once = PTHREAD_ONCE_INIT;
+
+static size_t
+gkick_resampler_quality_taps(enum geonkick_resampler_quality quality)
+{
+        switch (quality) {
+        case GEONKICK_RESAMPLER_LINEAR:
+                return 2;
+        case GEONKICK_RESAMPLER_LOW:
+                return 8;
+        case GEONKICK_RESAMPLER_MEDIUM:
+                return 16;
+        case GEONKICK_RESAMPLER_HIGH:
+        default:
+                return 32;
+        }
+}
+
+/**
+ * Kaiser window beta parameter. The stronger window of the high quality
+ * lowers the passband ripple, the longer filter keeps the transition band narrow.
+ */
+static double
+gkick_resampler_quality_beta(enum geonkick_resampler_quality quality)
+{
+        return quality == GEONKICK_RESAMPLER_HIGH ? 12.0 : 8.0;
+}
+
+static size_t
+gkick_resampler_quality_phases(enum geonkick_resampler_quality quality)
+{
+        return quality == GEONKICK_RESAMPLER_HIGH ? GKICK_RESAMPLER_HIGH_PHASES : GKICK_RESAMPLER_PHASES;
+}
+
+/* Zero order modified Bessel function of the first kind. */
+static double
+gkick_resampler_bessel_i0(double x)
+{
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; k++) {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+                if (term < 1e-12 * sum)
+                        break;
+        }
+        return sum;
+}
+
+static double
+gkick_resampler_kernel(double x, double cutoff, double half_width, double beta)
+{
+        if (fabs(x) >= half_width)
+                return 0.0;
+        double r = x / half_width;
+        double window = gkick_resampler_bessel_i0(beta * sqrt(1.0 - r * r))
+                / gkick_resampler_bessel_i0(beta);
+        double arg = M_PI * cutoff * x;
+        double sinc = fabs(arg) < 1e-9 ? 1.0 : sin(arg) / arg;
+        return cutoff * sinc * window;
+}
+
+static void
+gkick_resampler_fill_table(struct gkick_resampler *resampler)
+{
+        size_t taps = resampler->taps;
+        size_t phases = resampler->phases;
+        double beta = gkick_resampler_quality_beta(resampler->quality);
+        for (size_t p = 0; p <= phases; p++) {
+                gkick_real *row = resampler->table + p * taps;
+                double d = (double)p / phases;
+                if (resampler->quality == GEONKICK_RESAMPLER_LINEAR) {
+                        row[0] = 1.0 - d;
+                        row[1] = d;
+                        continue;
+                }
+
+                /**
+                 * The tap k multiplies the input frame at the offset
+                 * k - taps / 2 + 1 from the integer part of the position.
+                 */
+                double sum = 0.0;
+                for (size_t k = 0; k < taps; k++) {
+                        double x = (double)k - (double)(taps / 2 - 1) - d;
+                        row[k] = gkick_resampler_kernel(x, resampler->cutoff, taps / 2.0, beta);
+                        sum += row[k];
+                }
+
+                /* Unity gain at DC. */
+                if (sum > 0.0) {
+                        for (size_t k = 0; k < taps; k++)
+                                row[k] /= sum;
+                }
+        }
+}
+
+enum geonkick_error
+gkick_resampler_new(struct gkick_resampler **resampler,
+                    enum geonkick_resampler_quality quality,
+                    gkick_real cutoff)
+{
+        if (resampler == NULL || cutoff <= 0.0f
+            || quality < GEONKICK_RESAMPLER_LINEAR
+            || quality > GEONKICK_RESAMPLER_HIGH) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        *resampler = (struct gkick_resampler*)calloc(1, sizeof(struct gkick_resampler));
+        if (*resampler == NULL) {
+                gkick_log_error("can't allocate memory");
+                return GEONKICK_ERROR_MEM_ALLOC;
+        }
+
+        if (cutoff > 1.0f || quality == GEONKICK_RESAMPLER_LINEAR)
+                cutoff = 1.0f;
+        (*resampler)->quality = quality;
+        (*resampler)->cutoff = cutoff;
+
+        /* Keep the transition band the same when the cutoff is lowered. */
+        size_t taps = (size_t)(gkick_resampler_quality_taps(quality) / cutoff);
+        taps += taps % 2;
+        if (taps > GKICK_RESAMPLER_MAX_TAPS)
+                taps = GKICK_RESAMPLER_MAX_TAPS;
+        (*resampler)->taps = taps;
+
+        /**
+         * The kernel is smoother in frames when the cutoff is lowered,
+         * fewer phases give the same interpolation error.
+         */
+        size_t phases = (size_t)(gkick_resampler_quality_phases(quality) * cutoff);
+        if (phases < GKICK_RESAMPLER_PHASES)
+                phases = GKICK_RESAMPLER_PHASES;
+        (*resampler)->phases = phases;
+
+        (*resampler)->table = (gkick_real*)malloc(sizeof(gkick_real) * taps
+                                                  * (phases + 1));
+        if ((*resampler)->table == NULL) {
+                gkick_log_error("can't allocate memory");
+                gkick_resampler_free(resampler);
+                return GEONKICK_ERROR_MEM_ALLOC;
+        }
+        gkick_resampler_fill_table(*resampler);
+
+        return GEONKICK_OK;
+}
+
+void
+gkick_resampler_free(struct gkick_resampler **resampler)
+{
+        if (resampler != NULL && *resampler != NULL) {
+                free((*resampler)->table);
+                free(*resampler);
+                *resampler = NULL;
+        }
+}
+
+static void
+gkick_resampler_create_shared(void)
+{
+        for (size_t i = 0; i < GKICK_RESAMPLER_QUALITIES; i++) {
+                if (gkick_resampler_new(&gkick_resamplers[i],
+                                        (enum geonkick_resampler_quality)i,
+                                        1.0f) != GEONKICK_OK) {
+                        gkick_log_error("can't create resampler");
+                }
+        }
+}
+
+void
+gkick_resampler_init(void)
+{
+        pthread_once(&gkick_resamplers_once, gkick_resampler_create_shared);
+}
+
+const struct gkick_resampler*
+gkick_resampler_get(enum geonkick_resampler_quality quality)
+{
+        if (quality < GEONKICK_RESAMPLER_LINEAR || quality > GEONKICK_RESAMPLER_HIGH)
+                quality = GEONKICK_RESAMPLER_MEDIUM;
+        gkick_resampler_init();
+        return gkick_resamplers[quality];
+}
+
+/**
+ * Dot product of the input frames with the coefficients
+ * interpolated between two adjacent phases.
+ */
+static inline gkick_real
+gkick_resampler_dot(const gkick_real *x,
+                    const gkick_real *c0,
+                    const gkick_real *c1,
+                    gkick_real a,
+                    size_t n)
+{
+        size_t i = 0;
+        gkick_real sum = 0.0f;
+#ifdef GKICK_RESAMPLER_SSE
+        __m128 s  = _mm_setzero_ps();
+        __m128 va = _mm_set1_ps(a);
+        for (; i + 4 <= n; i += 4) {
+                __m128 k0 = _mm_loadu_ps(c0 + i);
+                __m128 k1 = _mm_loadu_ps(c1 + i);
+                __m128 k  = _mm_add_ps(k0, _mm_mul_ps(va, _mm_sub_ps(k1, k0)));
+                s = _mm_add_ps(s, _mm_mul_ps(k, _mm_loadu_ps(x + i)));
+        }
+        float v[4];
+        _mm_storeu_ps(v, s);
+        sum = (v[0] + v[1]) + (v[2] + v[3]);
+#endif
+        for (; i < n; i++)
+                sum += x[i] * (c0[i] + a * (c1[i] - c0[i]));
+        return sum;
+}
+
+gkick_real
+gkick_resampler_value(const struct gkick_resampler *resampler,
+                      const gkick_real *in,
+                      size_t in_size,
+                      double position)
+{
+        if (position < 0.0 || position >= in_size)
+                return 0.0f;
+
+        size_t index = (size_t)position;
+        if (resampler == NULL) {
+                gkick_real a = position - index;
+                gkick_real next = index + 1 < in_size ? in[index + 1] : 0.0f;
+                return in[index] + a * (next - in[index]);
+        }
+
+        double p = (position - index) * resampler->phases;
+        size_t phase = (size_t)p;
+        gkick_real a = p - phase;
+        size_t taps = resampler->taps;
+        const gkick_real *c0 = resampler->table + phase * taps;
+        const gkick_real *c1 = c0 + taps;
+
+        /* The first input frame covered by the filter. */
+        ptrdiff_t start = (ptrdiff_t)index - (ptrdiff_t)(taps / 2 - 1);
+        if (start >= 0 && (size_t)start + taps <= in_size)
+                return gkick_resampler_dot(in + start, c0, c1, a, taps);
+
+        /* Near the edges the frames outside the input are zero. */
+        gkick_real sum = 0.0f;
+        for (size_t k = 0; k < taps; k++) {
+                ptrdiff_t j = start + (ptrdiff_t)k;
+                if (j >= 0 && (size_t)j < in_size)
+                        sum += in[j] * (c0[k] + a * (c1[k] - c0[k]));
+        }
+        return sum;
+}
+
+size_t
+gkick_resampler_process(const struct gkick_resampler *resampler,
+                        const gkick_real *in,
+                        size_t in_size,
+                        double *position,
+                        double step,
+                        gkick_real *out,
+                        size_t out_size)
+{
+        size_t n = 0;
+        double pos = *position;
+        while (n < out_size && pos < in_size) {
+                out[n++] = gkick_resampler_value(resampler, in, in_size, pos);
+                pos += step;
+        }
+        *position = pos;
+        return n;
+}
+
+size_t
+gkick_resampler_size(size_t in_size, double step)
+{
+        if (in_size < 1 || step <= 0.0)
+                return 0;
+        return (size_t)((in_size - 1) / step) + 1;
+}
+
+enum geonkick_error
+gkick_resampler_resample(enum geonkick_resampler_quality quality,
+                         const gkick_real *in,
+                         size_t in_size,
+                         double step,
+                         gkick_real *out,
+                         size_t *out_size)
+{
+        if (in == NULL || out == NULL || out_size == NULL || step <= 0.0) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        struct gkick_resampler *band_limited = NULL;
+        const struct gkick_resampler *resampler;
+        if (step > 1.0 && quality != GEONKICK_RESAMPLER_LINEAR) {
+                /* Downsampling, cut the frequencies above the output Nyquist frequency. */
+                if (gkick_resampler_new(&band_limited, quality, 1.0 / step) != GEONKICK_OK) {
+                        gkick_log_error("can't create resampler");
+                        return GEONKICK_ERROR;
+                }
+                resampler = band_limited;
+        } else {
+                resampler = gkick_resampler_get(quality);
+        }
+
+        double position = 0.0;
+        *out_size = gkick_resampler_process(resampler, in, in_size,
+                                            &position, step,
+                                            out, *out_size);
+        gkick_resampler_free(&band_limited);
+        return GEONKICK_OK;
+}
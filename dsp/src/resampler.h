@@ -0,0 +1,131 @@
+/**
+ * File name: resampler.h
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef GKICK_RESAMPLER_H
+#define GKICK_RESAMPLER_H
+
+#include "geonkick_internal.h"
+
+/**
+ * Polyphase windowed-sinc resampler.
+ *
+ * The filter is precomputed for a number of fractional positions (phases)
+ * and the coefficients for a position between two phases are linearly
+ * interpolated. The linear quality is a two taps filter that
+ * does plain linear interpolation. The higher qualities have more taps,
+ * a stronger window and more phases, so that the error of the
+ * coefficients interpolation is below the filter error.
+ */
+
+/* Number of precomputed fractional positions. */
+#define GKICK_RESAMPLER_PHASES 256
+
+/* Number of precomputed fractional positions for the high quality. */
+#define GKICK_RESAMPLER_HIGH_PHASES 1024
+
+/* Maximum number of taps for the downsampling filters. */
+#define GKICK_RESAMPLER_MAX_TAPS 512
+
+struct gkick_resampler {
+        enum geonkick_resampler_quality quality;
+
+        /* Number of filter taps, always even. */
+        size_t taps;
+
+        /* Number of precomputed fractional positions. */
+        size_t phases;
+
+        /* Normalized cutoff frequency, 1.0 is the input Nyquist frequency. */
+        gkick_real cutoff;
+
+        /* (phases + 1) rows of taps coefficients. */
+        gkick_real *table;
+};
+
+enum geonkick_error
+gkick_resampler_new(struct gkick_resampler **resampler,
+                    enum geonkick_resampler_quality quality,
+                    gkick_real cutoff);
+
+void
+gkick_resampler_free(struct gkick_resampler **resampler);
+
+/**
+ * Creates the shared full band resamplers. Called when the Geonkick instance
+ * is created in order not to allocate memory in the audio thread.
+ */
+void
+gkick_resampler_init(void);
+
+/**
+ * Returns the shared full band resampler for the quality
+ * or NULL if it couldn't be created.
+ */
+const struct gkick_resampler*
+gkick_resampler_get(enum geonkick_resampler_quality quality);
+
+/**
+ * Returns the interpolated value of the input at the fractional position.
+ * If the resampler is NULL the value is linearly interpolated.
+ */
+gkick_real
+gkick_resampler_value(const struct gkick_resampler *resampler,
+                      const gkick_real *in,
+                      size_t in_size,
+                      double position);
+
+/**
+ * Streaming block API. Resamples the input starting from the position
+ * with the step (input frames per output frame) until the output is full
+ * or the position passes the end of the input. Updates the position.
+ * Returns the number of output frames.
+ */
+size_t
+gkick_resampler_process(const struct gkick_resampler *resampler,
+                        const gkick_real *in,
+                        size_t in_size,
+                        double *position,
+                        double step,
+                        gkick_real *out,
+                        size_t out_size);
+
+/**
+ * Returns the number of output frames for resampling the input with the step.
+ */
+size_t
+gkick_resampler_size(size_t in_size, double step);
+
+/**
+ * Bulk API. Resamples the whole input with the step.
+ * When downsampling a dedicated band limited filter is created.
+ * out_size - the output capacity on input, the number of frames on output.
+ */
+enum geonkick_error
+gkick_resampler_resample(enum geonkick_resampler_quality quality,
+                         const gkick_real *in,
+                         size_t in_size,
+                         double step,
+                         gkick_real *out,
+                         size_t *out_size);
+
+#endif // GKICK_RESAMPLER_H
@@ -0,0 +1,470 @@
+/**
+ * File name: sample_store.c
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "sample_store.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static struct gkick_sample_store gkick_sample_store = {
+        .lock = PTHREAD_MUTEX_INITIALIZER
+};
+
+/**
+ * Hashes the sample data by 64-bit words, the content is
+ * compared anyway when a sample with the same hash is found.
+ */
+static uint64_t
+gkick_sample_hash(const gkick_real *data, size_t size)
+{
+        const unsigned char *bytes = (const unsigned char*)data;
+        size_t n = size * sizeof(gkick_real);
+        uint64_t hash = 0xcbf29ce484222325ULL ^ (uint64_t)n;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= n; i += sizeof(uint64_t)) {
+                uint64_t word;
+                memcpy(&word, bytes + i, sizeof(word));
+                hash = (hash ^ word) * 0x100000001b3ULL;
+                hash ^= hash >> 29;
+        }
+        for (; i < n; i++)
+                hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+        hash ^= hash >> 32;
+        return hash;
+}
+
+size_t
+gkick_sample_memory_size(const struct gkick_sample *sample)
+{
+        if (sample == NULL)
+                return 0;
+        return sizeof(struct gkick_sample) + sample->size * sizeof(gkick_real);
+}
+
+enum geonkick_error
+gkick_sample_create(size_t size,
+                    struct gkick_sample **sample)
+{
+        if (sample == NULL || size < 1) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        *sample = (struct gkick_sample*)malloc(sizeof(struct gkick_sample)
+                                               + size * sizeof(gkick_real));
+        if (*sample == NULL) {
+                gkick_log_error("can't allocate memory");
+                return GEONKICK_ERROR_MEM_ALLOC;
+        }
+
+        atomic_init(&(*sample)->refcount, 1);
+        (*sample)->hash = 0;
+        (*sample)->published = false;
+        (*sample)->mapped = false;
+        (*sample)->next = NULL;
+        (*sample)->size = size;
+        (*sample)->data = (gkick_real*)(*sample + 1);
+        return GEONKICK_OK;
+}
+
+static enum geonkick_error
+gkick_sample_write_file(const char *path,
+                        const gkick_real *data,
+                        size_t size)
+{
+        /* Write into a temporary file first, other processes may map the file. */
+        char tmp_path[PATH_MAX];
+        if (snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", path, (int)getpid())
+            >= (int)sizeof(tmp_path))
+                return GEONKICK_ERROR;
+
+        int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+                gkick_log_error("can't create sample cache file %s", tmp_path);
+                return GEONKICK_ERROR;
+        }
+
+        const char *bytes = (const char*)data;
+        size_t n = size * sizeof(gkick_real);
+        while (n > 0) {
+                ssize_t written = write(fd, bytes, n);
+                if (written < 0 && errno == EINTR)
+                        continue;
+                if (written <= 0) {
+                        gkick_log_error("can't write sample cache file %s", tmp_path);
+                        close(fd);
+                        unlink(tmp_path);
+                        return GEONKICK_ERROR;
+                }
+                bytes += written;
+                n -= written;
+        }
+        close(fd);
+
+        if (rename(tmp_path, path) != 0) {
+                unlink(tmp_path);
+                return GEONKICK_ERROR;
+        }
+        return GEONKICK_OK;
+}
+
+struct gkick_cache_file {
+        struct timespec time;
+        off_t size;
+        char *name;
+};
+
+static int
+gkick_cache_file_compare(const void *a, const void *b)
+{
+        const struct gkick_cache_file *f1 = (const struct gkick_cache_file*)a;
+        const struct gkick_cache_file *f2 = (const struct gkick_cache_file*)b;
+        if (f1->time.tv_sec != f2->time.tv_sec)
+                return f1->time.tv_sec < f2->time.tv_sec ? -1 : 1;
+        if (f1->time.tv_nsec != f2->time.tv_nsec)
+                return f1->time.tv_nsec < f2->time.tv_nsec ? -1 : 1;
+        return 0;
+}
+
+/**
+ * Removes the least recently used cache files while the cache
+ * is bigger than GKICK_SAMPLE_STORE_CACHE_MAX_SIZE. The modification
+ * time is the time of the last use, it is updated when a file is mapped.
+ * The files still mapped by other samples stay valid after unlink.
+ */
+static void
+gkick_sample_cache_cleanup(const char *cache_path)
+{
+        DIR *dir = opendir(cache_path);
+        if (dir == NULL)
+                return;
+
+        struct gkick_cache_file *files = NULL;
+        size_t files_number = 0;
+        size_t capacity = 0;
+        size_t cache_size = 0;
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+                size_t len = strlen(entry->d_name);
+                if (len < 5 || strcmp(entry->d_name + len - 4, ".pcm"))
+                        continue;
+
+                struct stat st;
+                if (fstatat(dirfd(dir), entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0
+                    || !S_ISREG(st.st_mode))
+                        continue;
+
+                if (files_number == capacity) {
+                        capacity = capacity ? 2 * capacity : 64;
+                        struct gkick_cache_file *tmp = realloc(files, capacity * sizeof(*files));
+                        if (tmp == NULL)
+                                break;
+                        files = tmp;
+                }
+
+                files[files_number].name = strdup(entry->d_name);
+                if (files[files_number].name == NULL)
+                        break;
+                files[files_number].time = st.st_mtim;
+                files[files_number].size = st.st_size;
+                cache_size += st.st_size;
+                files_number++;
+        }
+
+        if (cache_size > GKICK_SAMPLE_STORE_CACHE_MAX_SIZE) {
+                qsort(files, files_number, sizeof(*files), gkick_cache_file_compare);
+                for (size_t i = 0; i < files_number
+                             && cache_size > GKICK_SAMPLE_STORE_CACHE_MAX_SIZE; i++) {
+                        if (unlinkat(dirfd(dir), files[i].name, 0) == 0 || errno == ENOENT)
+                                cache_size -= files[i].size;
+                }
+        }
+
+        for (size_t i = 0; i < files_number; i++)
+                free(files[i].name);
+        free(files);
+        closedir(dir);
+}
+
+/**
+ * Returns a copy of the sample with the data mapped from the cache
+ * file or NULL if the sample can't be mapped. The cache file is
+ * created if it doesn't exist. Called without the store lock held,
+ * the sample is not published yet.
+ */
+static struct gkick_sample*
+gkick_sample_map(const char *cache_path,
+                 const struct gkick_sample *sample)
+{
+        size_t n = sample->size * sizeof(gkick_real);
+        char path[PATH_MAX];
+        if (snprintf(path, sizeof(path), "%s/%016" PRIx64 "-%zu-%zu.pcm",
+                     cache_path, sample->hash, sample->size, sizeof(gkick_real))
+            >= (int)sizeof(path))
+                return NULL;
+
+        bool created = false;
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+                if (gkick_sample_write_file(path, sample->data, sample->size) != GEONKICK_OK)
+                        return NULL;
+                created = true;
+                fd = open(path, O_RDONLY);
+                if (fd < 0)
+                        return NULL;
+        } else {
+                /* Mark the file as recently used for the cache cleanup. */
+                futimens(fd, NULL);
+        }
+
+        /**
+         * The cache files are replaced only by rename and removed only
+         * by unlink, never truncated. Check the size anyway, the mapping
+         * beyond the end of the file would fault on access.
+         */
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (size_t)st.st_size != n) {
+                close(fd);
+                return NULL;
+        }
+
+        void *data = mmap(NULL, n, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+                return NULL;
+
+        /* The file may belong to a different sample with the same hash. */
+        if (memcmp(data, sample->data, n)) {
+                munmap(data, n);
+                return NULL;
+        }
+
+        if (created)
+                gkick_sample_cache_cleanup(cache_path);
+
+        struct gkick_sample *mapped = (struct gkick_sample*)malloc(sizeof(struct gkick_sample));
+        if (mapped == NULL) {
+                munmap(data, n);
+                return NULL;
+        }
+
+        atomic_init(&mapped->refcount, atomic_load(&sample->refcount));
+        mapped->hash = sample->hash;
+        mapped->published = false;
+        mapped->mapped = true;
+        mapped->next = NULL;
+        mapped->size = sample->size;
+        mapped->data = (gkick_real*)data;
+        return mapped;
+}
+
+static void
+gkick_sample_destroy(struct gkick_sample *sample)
+{
+        if (sample->mapped)
+                munmap(sample->data, sample->size * sizeof(gkick_real));
+        free(sample);
+}
+
+/**
+ * Takes a reference to the stored sample unless it is being
+ * released by the last owner.
+ */
+static bool
+gkick_sample_try_ref(struct gkick_sample *sample)
+{
+        size_t refcount = atomic_load(&sample->refcount);
+        while (refcount > 0) {
+                if (atomic_compare_exchange_weak(&sample->refcount,
+                                                 &refcount,
+                                                 refcount + 1))
+                        return true;
+        }
+        return false;
+}
+
+/**
+ * Returns a reference to the stored sample with the same content
+ * or NULL if there is no such sample. Must be called with the store lock held.
+ */
+static struct gkick_sample*
+gkick_sample_find(struct gkick_sample_store *store,
+                  const struct gkick_sample *sample)
+{
+        size_t bucket = sample->hash % GKICK_SAMPLE_STORE_BUCKETS;
+        for (struct gkick_sample *s = store->buckets[bucket]; s != NULL; s = s->next) {
+                if (s->hash == sample->hash
+                    && s->size == sample->size
+                    && !memcmp(s->data, sample->data, s->size * sizeof(gkick_real))
+                    && gkick_sample_try_ref(s))
+                        return s;
+        }
+        return NULL;
+}
+
+enum geonkick_error
+gkick_sample_publish(struct gkick_sample **sample)
+{
+        if (sample == NULL || *sample == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        struct gkick_sample *new_sample = *sample;
+        if (new_sample->published)
+                return GEONKICK_OK;
+
+        new_sample->hash = gkick_sample_hash(new_sample->data, new_sample->size);
+        struct gkick_sample_store *store = &gkick_sample_store;
+        char *cache_path = NULL;
+        pthread_mutex_lock(&store->lock);
+        struct gkick_sample *s = gkick_sample_find(store, new_sample);
+        if (s == NULL && store->cache_path != NULL
+            && new_sample->size * sizeof(gkick_real) >= GKICK_SAMPLE_STORE_MAP_MIN_SIZE)
+                cache_path = strdup(store->cache_path);
+        pthread_mutex_unlock(&store->lock);
+        if (s != NULL) {
+                free(new_sample);
+                *sample = s;
+                return GEONKICK_OK;
+        }
+
+        /* The file operations are done without holding the store lock. */
+        struct gkick_sample *mapped = NULL;
+        if (cache_path != NULL) {
+                mapped = gkick_sample_map(cache_path, new_sample);
+                free(cache_path);
+        }
+
+        /* The same sample may have been published in the meantime. */
+        pthread_mutex_lock(&store->lock);
+        s = gkick_sample_find(store, new_sample);
+        if (s != NULL) {
+                pthread_mutex_unlock(&store->lock);
+                if (mapped != NULL)
+                        gkick_sample_destroy(mapped);
+                free(new_sample);
+                *sample = s;
+                return GEONKICK_OK;
+        }
+
+        if (mapped != NULL) {
+                free(new_sample);
+                new_sample = mapped;
+                *sample = mapped;
+                store->mapped_size += new_sample->size * sizeof(gkick_real);
+        }
+
+        size_t bucket = new_sample->hash % GKICK_SAMPLE_STORE_BUCKETS;
+        new_sample->published = true;
+        new_sample->next = store->buckets[bucket];
+        store->buckets[bucket] = new_sample;
+        store->samples_number++;
+        store->memory_size += gkick_sample_memory_size(new_sample);
+        pthread_mutex_unlock(&store->lock);
+        return GEONKICK_OK;
+}
+
+struct gkick_sample*
+gkick_sample_ref(struct gkick_sample *sample)
+{
+        if (sample != NULL)
+                atomic_fetch_add(&sample->refcount, 1);
+        return sample;
+}
+
+void
+gkick_sample_unref(struct gkick_sample *sample)
+{
+        if (sample == NULL || atomic_fetch_sub(&sample->refcount, 1) != 1)
+                return;
+
+        if (sample->published) {
+                struct gkick_sample_store *store = &gkick_sample_store;
+                pthread_mutex_lock(&store->lock);
+                struct gkick_sample **s = &store->buckets[sample->hash % GKICK_SAMPLE_STORE_BUCKETS];
+                for (; *s != NULL; s = &(*s)->next) {
+                        if (*s == sample) {
+                                *s = sample->next;
+                                store->samples_number--;
+                                store->memory_size -= gkick_sample_memory_size(sample);
+                                if (sample->mapped)
+                                        store->mapped_size -= sample->size * sizeof(gkick_real);
+                                break;
+                        }
+                }
+                pthread_mutex_unlock(&store->lock);
+        }
+        gkick_sample_destroy(sample);
+}
+
+void
+gkick_sample_store_usage(size_t *number,
+                         size_t *size)
+{
+        struct gkick_sample_store *store = &gkick_sample_store;
+        pthread_mutex_lock(&store->lock);
+        if (number != NULL)
+                *number = store->samples_number;
+        if (size != NULL)
+                *size = store->memory_size;
+        pthread_mutex_unlock(&store->lock);
+}
+
+enum geonkick_error
+gkick_sample_store_set_cache_path(const char *path)
+{
+        char *cache_path = NULL;
+        if (path != NULL) {
+                cache_path = strdup(path);
+                if (cache_path == NULL) {
+                        gkick_log_error("can't allocate memory");
+                        return GEONKICK_ERROR_MEM_ALLOC;
+                }
+        }
+
+        struct gkick_sample_store *store = &gkick_sample_store;
+        pthread_mutex_lock(&store->lock);
+        free(store->cache_path);
+        store->cache_path = cache_path;
+        pthread_mutex_unlock(&store->lock);
+
+        /* The cache may have grown over the budget by other processes. */
+        if (path != NULL)
+                gkick_sample_cache_cleanup(path);
+        return GEONKICK_OK;
+}
+
+size_t
+gkick_sample_store_mapped_size(void)
+{
+        struct gkick_sample_store *store = &gkick_sample_store;
+        pthread_mutex_lock(&store->lock);
+        size_t size = store->mapped_size;
+        pthread_mutex_unlock(&store->lock);
+        return size;
+}
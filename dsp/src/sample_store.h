@@ -0,0 +1,119 @@
+/**
+ * File name: sample_store.h
+ * Project: Geonkick (A kick synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://geontime.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GKICK_SAMPLE_STORE_H
+#define GKICK_SAMPLE_STORE_H
+
+#include "geonkick.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+/**
+ * Sample store is shared by all Geonkick instances of the process.
+ * The samples are immutable once published and addressed by the hash
+ * of their content, so the same sample data loaded by many percussions,
+ * kits or instances is kept in memory only once. The samples are
+ * reference counted and removed from the store by the last owner.
+ *
+ * If the cache path is set, the published samples are written once into
+ * raw PCM files of the cache directory and memory mapped read-only,
+ * so the processes using the same samples share the page cache memory.
+ * The cache is kept under GKICK_SAMPLE_STORE_CACHE_MAX_SIZE by removing
+ * the least recently used files.
+ */
+
+#define GKICK_SAMPLE_STORE_BUCKETS 256
+
+/* Minimum size in bytes of the memory mapped samples. */
+#define GKICK_SAMPLE_STORE_MAP_MIN_SIZE (64 * 1024)
+
+/**
+ * Maximum size in bytes of the cache directory files,
+ * the least recently used files are removed above it.
+ */
+#ifndef GKICK_SAMPLE_STORE_CACHE_MAX_SIZE
+#define GKICK_SAMPLE_STORE_CACHE_MAX_SIZE ((size_t)512 * 1024 * 1024)
+#endif
+
+struct gkick_sample {
+        atomic_size_t refcount;
+        uint64_t hash;
+        bool published;
+        /* The data is memory mapped from the cache file. */
+        bool mapped;
+        struct gkick_sample *next;
+        size_t size;
+        gkick_real *data;
+};
+
+struct gkick_sample_store {
+        struct gkick_sample *buckets[GKICK_SAMPLE_STORE_BUCKETS];
+        size_t samples_number;
+        size_t memory_size;
+        size_t mapped_size;
+        char *cache_path;
+        pthread_mutex_t lock;
+};
+
+/**
+ * Creates a sample not published yet, the data can be written
+ * until the sample is published.
+ */
+enum geonkick_error
+gkick_sample_create(size_t size,
+                    struct gkick_sample **sample);
+
+/**
+ * Publishes the sample into the store. If the store contains a sample
+ * with the same content, the new sample is released and replaced by
+ * a reference to the stored one.
+ */
+enum geonkick_error
+gkick_sample_publish(struct gkick_sample **sample);
+
+struct gkick_sample*
+gkick_sample_ref(struct gkick_sample *sample);
+
+void
+gkick_sample_unref(struct gkick_sample *sample);
+
+size_t
+gkick_sample_memory_size(const struct gkick_sample *sample);
+
+void
+gkick_sample_store_usage(size_t *number,
+                         size_t *size);
+
+/**
+ * Sets the directory of the samples cache files.
+ * The samples are not mapped if the path is NULL.
+ */
+enum geonkick_error
+gkick_sample_store_set_cache_path(const char *path);
+
+size_t
+gkick_sample_store_mapped_size(void);
+
+#endif // GKICK_SAMPLE_STORE_H
@@ -23,6 +23,7 @@
 
 #include "synthesizer.h"
 #include "oscillator.h"
+#include "resampler.h"
 
 enum geonkick_error
 gkick_synth_new(struct gkick_synth **synth)
@@ -95,6 +96,14 @@ gkick_synth_new(struct gkick_synth **synth)
         gkick_buffer_set_size(buff, (*synth)->buffer_size);
         (*synth)->buffer = (char*)buff;
 
+        gkick_buffer_new(&(*synth)->draft_buffer,
+                         GEONKICK_MAX_KICK_BUFFER_SIZE / GKICK_SYNTH_DRAFT_RATE_DIVIDER + 1);
+        if ((*synth)->draft_buffer == NULL) {
+                gkick_log_error("can't create synthesizer draft buffer");
+                gkick_synth_free(synth);
+                return GEONKICK_ERROR;
+        }
+
         if (gkick_synth_create_oscillators(*synth) != GEONKICK_OK) {
                 gkick_log_error("can't create oscillators");
                 gkick_synth_free(synth);
@@ -118,6 +127,9 @@ void gkick_synth_free(struct gkick_synth **synth)
                                 (*synth)->buffer = NULL;
                         }
 
+                        if ((*synth)->draft_buffer)
+                                gkick_buffer_free(&(*synth)->draft_buffer);
+
                         if ((*synth)->filter)
                                 gkick_filter_free(&(*synth)->filter);
 
@@ -1213,6 +1225,30 @@ gkick_synth_set_output(struct gkick_synth *synth,
         synth->output = output;
 }
 
+/**
+ * Fills the kick buffer with the draft values linearly
+ * interpolated between the rendered frames.
+ */
+static void
+gkick_synth_interpolate_draft(struct gkick_buffer *draft,
+                              struct gkick_buffer *buffer,
+                              size_t divider)
+{
+        size_t n = gkick_buffer_size(draft);
+        gkick_buffer_reset(buffer);
+        if (n < 1)
+                return;
+
+        gkick_real k = 1.0f / divider;
+        while (!gkick_buffer_is_end(buffer)) {
+                size_t i = gkick_buffer_index(buffer);
+                size_t j = i / divider;
+                gkick_real a = draft->buff[j < n ? j : n - 1];
+                gkick_real b = draft->buff[j + 1 < n ? j + 1 : n - 1];
+                gkick_buffer_push_back(buffer, a + (b - a) * k * (i % divider));
+        }
+}
+
 enum geonkick_error
 gkick_synth_process(struct gkick_synth *synth)
 {
@@ -1221,14 +1257,76 @@ gkick_synth_process(struct gkick_synth *synth)
 
 	gkick_synth_lock(synth);
 	synth->buffer_update = false;
-	gkick_buffer_set_size((struct gkick_buffer*)synth->buffer,
-                              synth->buffer_size);
-	gkick_real dt = synth->length / synth->buffer_size;
+        struct gkick_buffer *buffer = (struct gkick_buffer*)synth->buffer;
+        size_t size = synth->buffer_size;
+        size_t divider = synth->draft ? GKICK_SYNTH_DRAFT_RATE_DIVIDER : 1;
+	gkick_buffer_set_size(buffer, size);
+        if (divider > 1)
+                gkick_buffer_set_size(synth->draft_buffer, (size + divider - 1) / divider);
+	gkick_synth_unlock(synth);
+
+	/* Synthesize the percussion into the synthesizer buffer. */
+        if (divider > 1) {
+                gkick_synth_render(synth, synth->draft_buffer, 1.0f, divider);
+                gkick_synth_interpolate_draft(synth->draft_buffer, buffer, divider);
+        } else {
+                gkick_synth_render(synth, buffer, 1.0f, 1);
+        }
+
+	gkick_synth_lock(synth);
+        synth->is_draft_buffer = divider > 1;
+        /* The draft was disabled during the synthesis. */
+        if (synth->is_draft_buffer && !synth->draft)
+                synth->buffer_update = true;
+
+        if (synth->buffer_callback != NULL && synth->callback_args != NULL) {
+                synth->buffer_callback(synth->callback_args,
+                                       ((struct gkick_buffer*)synth->buffer)->buff,
+                                       synth->buffer_size,
+                                       synth->id);
+        }
+
+        /**
+         * Don't update the output audio buffer if
+         * the synthesizer parameters
+         * were updated during the synthesis.
+         */
+        if (!synth->buffer_update) {
+                gkick_audio_output_lock(synth->output);
+                char* buff = synth->output->updated_buffer;
+                synth->output->updated_buffer = synth->buffer;
+                synth->buffer = buff;
+                gkick_audio_output_unlock(synth->output);
+                gkick_note_cache_invalidate(synth->output->note_cache);
+        }
+	gkick_synth_unlock(synth);
+
+	return GEONKICK_OK;
+}
+
+enum geonkick_error
+gkick_synth_render(struct gkick_synth *synth,
+                   struct gkick_buffer *buffer,
+                   gkick_real pitch_factor,
+                   size_t rate_divider)
+{
+	gkick_synth_lock(synth);
+	gkick_buffer_reset(buffer);
+	gkick_real dt = rate_divider * synth->length / synth->buffer_size;
 	gkick_synth_reset_oscillators(synth);
+        const struct gkick_resampler *resampler = gkick_resampler_get(GEONKICK_RESAMPLER_HIGH);
+        for (size_t i = 0; i < synth->oscillators_number; i++) {
+                struct gkick_oscillator *osc = synth->oscillators[i];
+                osc->pitch_factor = pitch_factor;
+                osc->resampler = resampler;
+                osc->sample_rate = (gkick_real)GEONKICK_SAMPLE_RATE / rate_divider;
+                gkick_filter_set_rate_divider(osc->filter, rate_divider);
+        }
+        gkick_filter_set_rate_divider(synth->filter, rate_divider);
+        gkick_compressor_set_rate_divider(synth->compressor, rate_divider);
 	gkick_filter_init(synth->filter);
 	gkick_synth_unlock(synth);
 
-	/* Synthesize the percussion into the synthesizer buffer. */
 	size_t i = 0;
         size_t tries = 0;
 	while (1) {
@@ -1243,12 +1341,12 @@ gkick_synth_process(struct gkick_synth *synth)
                          * It should be maximum around 30ms.
                          */
                         if (++tries > 600)
-                                break;
+                                return GEONKICK_ERROR;
                         else
                                 continue;
                 }
 
-		if (gkick_buffer_is_end((struct gkick_buffer*)synth->buffer)) {
+		if (gkick_buffer_is_end(buffer)) {
 			gkick_synth_unlock(synth);
 			break;
 		} else {
@@ -1259,35 +1357,42 @@ gkick_synth_process(struct gkick_synth *synth)
 				val = 1.0f;
 			else if (val < -1.0f)
 				val = -1.0f;
-			gkick_buffer_push_back((struct gkick_buffer*)synth->buffer, val);
+			gkick_buffer_push_back(buffer, val);
 			i++;
 		}
                 gkick_synth_unlock(synth);
 	}
 
-	gkick_synth_lock(synth);
-        if (synth->buffer_callback != NULL && synth->callback_args != NULL) {
-                synth->buffer_callback(synth->callback_args,
-                                       ((struct gkick_buffer*)synth->buffer)->buff,
-                                       synth->buffer_size,
-                                       synth->id);
+	return GEONKICK_OK;
+}
+
+enum geonkick_error
+gkick_synth_render_note(struct gkick_synth *synth,
+                        int note)
+{
+        if (synth == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
         }
 
-        /**
-         * Don't update the output audio buffer if
-         * the synthesizer parameters
-         * were updated during the synthesis.
-         */
-        if (!synth->buffer_update) {
-                gkick_audio_output_lock(synth->output);
-                char* buff = synth->output->updated_buffer;
-                synth->output->updated_buffer = synth->buffer;
-                synth->buffer = buff;
-                gkick_audio_output_unlock(synth->output);
+        struct gkick_note_cache *cache = synth->output->note_cache;
+        size_t generation = gkick_note_cache_generation(cache);
+
+        struct gkick_buffer *buffer = NULL;
+        gkick_buffer_new(&buffer, synth->buffer_size);
+        if (buffer == NULL) {
+                gkick_log_error("can't create note buffer");
+                return GEONKICK_ERROR;
         }
-	gkick_synth_unlock(synth);
 
-	return GEONKICK_OK;
+        if (gkick_synth_render(synth, buffer, gkick_audio_output_tune_factor(note), 1) != GEONKICK_OK
+            || synth->buffer_update) {
+                /* The rendered note is already outdated. */
+                gkick_buffer_free(&buffer);
+                return GEONKICK_OK;
+        }
+
+        return gkick_note_cache_insert(cache, note, buffer, generation);
 }
 
 gkick_real
@@ -1347,11 +1452,27 @@ gkick_synth_reset_oscillators(struct gkick_synth *synth)
                 osc->fm_input = 0.0f;
                 osc->seedp = osc->seed;
                 gkick_filter_init(osc->filter);
-                if (osc->sample != NULL)
-                        gkick_buffer_reset(osc->sample);
+                osc->sample_position = 0.0;
         }
 }
 
+enum geonkick_error
+gkick_synth_set_draft(struct gkick_synth *synth,
+                      bool draft)
+{
+        if (synth == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        gkick_synth_lock(synth);
+        synth->draft = draft;
+        if (!draft && synth->is_draft_buffer)
+                synth->buffer_update = true;
+        gkick_synth_unlock(synth);
+        return GEONKICK_OK;
+}
+
 int
 gkick_synth_is_update_buffer(struct gkick_synth *synth)
 {
@@ -1857,36 +1978,38 @@ geonkick_synth_group_get_amplitude(struct gkick_synth *synth,
 enum geonkick_error
 geonkick_synth_set_osc_sample(struct gkick_synth *synth,
                               size_t osc_index,
-                              const gkick_real *data,
-                              size_t size)
+                              struct gkick_sample *sample)
 {
+        gkick_sample_ref(sample);
         gkick_synth_lock(synth);
         struct gkick_oscillator *osc;
         osc = gkick_synth_get_oscillator(synth, osc_index);
 	if (osc == NULL) {
 		gkick_log_error("can't get oscillator");
 		gkick_synth_unlock(synth);
+                gkick_sample_unref(sample);
 		return GEONKICK_ERROR;
 	}
 
-        if (osc->sample == NULL)
-                gkick_buffer_new(&osc->sample, GEONKICK_MAX_KICK_BUFFER_SIZE);
-        gkick_buffer_set_data(osc->sample, data, size);
-        if (synth->osc_groups[osc_index / GKICK_OSC_GROUP_SIZE]
+        /* The old sample is released after unlocking. */
+        struct gkick_sample *old_sample = osc->sample;
+        osc->sample = sample;
+        osc->sample_position = 0.0;
+        if (old_sample != sample
+            && synth->osc_groups[osc_index / GKICK_OSC_GROUP_SIZE]
             && osc->state == GEONKICK_OSC_STATE_ENABLED)
                 synth->buffer_update = true;
         gkick_synth_unlock(synth);
+        gkick_sample_unref(old_sample);
         return GEONKICK_OK;
 }
 
 enum geonkick_error
 geonkick_synth_get_osc_sample(struct gkick_synth *synth,
                               size_t osc_index,
-                              gkick_real **data,
-                              size_t *size)
+                              struct gkick_sample **sample)
 {
-        *data = NULL;
-        *size = 0;
+        *sample = NULL;
         gkick_synth_lock(synth);
         struct gkick_oscillator *osc;
         osc = gkick_synth_get_oscillator(synth, osc_index);
@@ -1896,22 +2019,243 @@ geonkick_synth_get_osc_sample(struct gkick_synth *synth,
 		return GEONKICK_ERROR;
 	}
 
-        if (osc->sample == NULL) {
-                gkick_synth_unlock(synth);
-                return GEONKICK_OK;
+        *sample = gkick_sample_ref(osc->sample);
+        gkick_synth_unlock(synth);
+        return GEONKICK_OK;
+}
+
+void
+gkick_synth_get_samples(struct gkick_synth *synth,
+                        struct gkick_sample **samples,
+                        size_t *number,
+                        size_t max_number)
+{
+        gkick_synth_lock(synth);
+        for (size_t i = 0; i < synth->oscillators_number; i++) {
+                struct gkick_sample *sample = synth->oscillators[i]->sample;
+                if (sample == NULL)
+                        continue;
+
+                size_t j = 0;
+                while (j < *number && samples[j] != sample)
+                        j++;
+                if (j == *number && *number < max_number)
+                        samples[(*number)++] = gkick_sample_ref(sample);
         }
+        gkick_synth_unlock(synth);
+}
 
-        *size = gkick_buffer_size(osc->sample);
-        if (*size > 0) {
-                *data = (gkick_real*)malloc(sizeof(gkick_real) * (*size));
-                if (*data == NULL) {
-                        gkick_log_error("can't allocate memory");
-                        *size = 0;
-                        gkick_synth_unlock(synth);
-                        return GEONKICK_ERROR;
+static struct gkick_envelope*
+gkick_synth_params_envelope(const struct gkick_envelope_params *params)
+{
+        if (params->points == NULL || params->npoints == 0)
+                return NULL;
+
+        struct gkick_envelope *env = gkick_envelope_create();
+        if (env != NULL)
+                gkick_envelope_set_points(env, params->points, params->npoints);
+        return env;
+}
+
+/**
+ * Swaps the envelope with the new one if there is one.
+ * The old envelope is returned in the new envelope pointer.
+ */
+static void
+gkick_synth_swap_envelope(struct gkick_envelope **env,
+                          struct gkick_envelope **new_env)
+{
+        if (*new_env != NULL) {
+                struct gkick_envelope *old_env = *env;
+                *env = *new_env;
+                *new_env = old_env;
+        }
+}
+
+enum geonkick_error
+gkick_synth_set_params(struct gkick_synth *synth,
+                       const struct gkick_synth_params *params)
+{
+        if (synth == NULL || params == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        /* Prepare the envelopes without holding the lock. */
+        struct gkick_envelope *envelopes[GKICK_SYNTH_ENVELOPES_NUMBER];
+        for (size_t i = 0; i < GKICK_SYNTH_ENVELOPES_NUMBER; i++)
+                envelopes[i] = gkick_synth_params_envelope(&params->envelopes[i]);
+
+        struct gkick_envelope *osc_envelopes[GKICK_OSC_NUMBER][GKICK_OSC_ENVELOPES_NUMBER];
+        struct gkick_sample *samples[GKICK_OSC_NUMBER];
+        for (size_t i = 0; i < GKICK_OSC_NUMBER; i++) {
+                const struct gkick_osc_params *osc = &params->oscillators[i];
+                for (size_t j = 0; j < GKICK_OSC_ENVELOPES_NUMBER; j++)
+                        osc_envelopes[i][j] = gkick_synth_params_envelope(&osc->envelopes[j]);
+                samples[i] = gkick_sample_ref(osc->sample);
+        }
+
+        gkick_synth_lock(synth);
+        memset(synth->name, '\0', sizeof(synth->name));
+        snprintf(synth->name, sizeof(synth->name), "%s", params->name);
+        synth->length = params->length;
+        synth->buffer_size = synth->length * GEONKICK_SAMPLE_RATE;
+        synth->amplitude = params->amplitude;
+        for (size_t i = 0; i < GKICK_OSC_GROUPS_NUMBER; i++) {
+                synth->osc_groups[i] = params->layers[i];
+                synth->osc_groups_amplitude[i] = params->layers_amplitude[i];
+        }
+
+        synth->filter_enabled = params->filter_enabled;
+        gkick_filter_set_type(synth->filter, params->filter_type);
+        gkick_filter_set_cutoff_freq(synth->filter, params->filter_cutoff);
+        gkick_filter_set_factor(synth->filter, params->filter_factor);
+        gkick_synth_swap_envelope(&synth->envelope,
+                                  &envelopes[GEONKICK_AMPLITUDE_ENVELOPE]);
+        gkick_synth_swap_envelope(&synth->filter->cutoff_env,
+                                  &envelopes[GEONKICK_FILTER_CUTOFF_ENVELOPE]);
+        gkick_synth_swap_envelope(&synth->distortion->drive_env,
+                                  &envelopes[GEONKICK_DISTORTION_DRIVE_ENVELOPE]);
+        gkick_synth_swap_envelope(&synth->distortion->volume_env,
+                                  &envelopes[GEONKICK_DISTORTION_VOLUME_ENVELOPE]);
+
+        gkick_compressor_enable(synth->compressor, params->compressor_enabled);
+        gkick_compressor_set_attack(synth->compressor, params->compressor_attack);
+        gkick_compressor_set_release(synth->compressor, params->compressor_release);
+        gkick_compressor_set_threshold(synth->compressor, params->compressor_threshold);
+        gkick_compressor_set_ratio(synth->compressor, params->compressor_ratio);
+        gkick_compressor_set_knee(synth->compressor, params->compressor_knee);
+        gkick_compressor_set_makeup(synth->compressor, params->compressor_makeup);
+
+        gkick_distortion_enable(synth->distortion, params->distortion_enabled);
+        gkick_distortion_set_in_limiter(synth->distortion, params->distortion_in_limiter);
+        gkick_distortion_set_volume(synth->distortion, params->distortion_volume);
+        gkick_distortion_set_drive(synth->distortion, params->distortion_drive);
+
+        for (size_t i = 0; i < GKICK_OSC_NUMBER && i < synth->oscillators_number; i++) {
+                struct gkick_oscillator *osc = synth->oscillators[i];
+                const struct gkick_osc_params *osc_params = &params->oscillators[i];
+                gkick_osc_set_state(osc, osc_params->enabled ? GEONKICK_OSC_STATE_ENABLED
+                                    : GEONKICK_OSC_STATE_DISABLED);
+                osc->func = osc_params->function;
+                osc->initial_phase = osc_params->phase;
+                osc->seed = osc_params->seed;
+                osc->amplitude = osc_params->amplitude;
+                osc->frequency = osc_params->frequency;
+                osc->is_fm = osc_params->is_fm;
+                osc->filter_enabled = osc_params->filter_enabled;
+                gkick_filter_set_type(osc->filter, osc_params->filter_type);
+                gkick_filter_set_cutoff_freq(osc->filter, osc_params->filter_cutoff);
+                gkick_filter_set_factor(osc->filter, osc_params->filter_factor);
+                for (size_t j = 0; j < GKICK_OSC_ENVELOPES_NUMBER; j++) {
+                        struct gkick_envelope **env;
+                        if (j == GEONKICK_FILTER_CUTOFF_ENVELOPE)
+                                env = &osc->filter->cutoff_env;
+                        else if (j < osc->env_number)
+                                env = &osc->envelopes[j];
+                        else
+                                continue;
+                        gkick_synth_swap_envelope(env, &osc_envelopes[i][j]);
+                }
+
+                /* The old sample is released after unlocking. */
+                struct gkick_sample *sample = osc->sample;
+                osc->sample = samples[i];
+                osc->sample_position = 0.0;
+                samples[i] = sample;
+        }
+        synth->buffer_update = true;
+        gkick_synth_unlock(synth);
+
+        for (size_t i = 0; i < GKICK_SYNTH_ENVELOPES_NUMBER; i++) {
+                if (envelopes[i] != NULL)
+                        gkick_envelope_destroy(envelopes[i]);
+        }
+
+        for (size_t i = 0; i < GKICK_OSC_NUMBER; i++) {
+                for (size_t j = 0; j < GKICK_OSC_ENVELOPES_NUMBER; j++) {
+                        if (osc_envelopes[i][j] != NULL)
+                                gkick_envelope_destroy(osc_envelopes[i][j]);
+                }
+                gkick_sample_unref(samples[i]);
+        }
+
+        return GEONKICK_OK;
+}
+
+enum geonkick_error
+gkick_synth_get_params(struct gkick_synth *synth,
+                       struct gkick_synth_params *params)
+{
+        if (synth == NULL || params == NULL) {
+                gkick_log_error("wrong arguments");
+                return GEONKICK_ERROR;
+        }
+
+        memset(params, 0, sizeof(struct gkick_synth_params));
+        gkick_synth_lock(synth);
+        snprintf(params->name, sizeof(params->name), "%s", synth->name);
+        params->length = synth->length;
+        params->amplitude = synth->amplitude;
+        for (size_t i = 0; i < GKICK_OSC_GROUPS_NUMBER; i++) {
+                params->layers[i] = synth->osc_groups[i];
+                params->layers_amplitude[i] = synth->osc_groups_amplitude[i];
+        }
+
+        params->filter_enabled = synth->filter_enabled;
+        gkick_filter_get_type(synth->filter, &params->filter_type);
+        gkick_filter_get_cutoff_freq(synth->filter, &params->filter_cutoff);
+        gkick_filter_get_factor(synth->filter, &params->filter_factor);
+        for (size_t i = 0; i < GKICK_SYNTH_ENVELOPES_NUMBER; i++) {
+                struct gkick_envelope_params *env = &params->envelopes[i];
+                if (i == GEONKICK_AMPLITUDE_ENVELOPE)
+                        gkick_envelope_get_points(synth->envelope, &env->points, &env->npoints);
+                else if (i == GEONKICK_FILTER_CUTOFF_ENVELOPE)
+                        gkick_envelope_get_points(synth->filter->cutoff_env, &env->points, &env->npoints);
+                else if (i == GEONKICK_DISTORTION_DRIVE_ENVELOPE)
+                        gkick_envelope_get_points(synth->distortion->drive_env, &env->points, &env->npoints);
+                else if (i == GEONKICK_DISTORTION_VOLUME_ENVELOPE)
+                        gkick_envelope_get_points(synth->distortion->volume_env, &env->points, &env->npoints);
+        }
+
+        int enabled = 0;
+        gkick_compressor_is_enabled(synth->compressor, &enabled);
+        params->compressor_enabled = enabled;
+        gkick_compressor_get_attack(synth->compressor, &params->compressor_attack);
+        gkick_compressor_get_release(synth->compressor, &params->compressor_release);
+        gkick_compressor_get_threshold(synth->compressor, &params->compressor_threshold);
+        gkick_compressor_get_ratio(synth->compressor, &params->compressor_ratio);
+        gkick_compressor_get_knee(synth->compressor, &params->compressor_knee);
+        gkick_compressor_get_makeup(synth->compressor, &params->compressor_makeup);
+
+        gkick_distortion_is_enabled(synth->distortion, &enabled);
+        params->distortion_enabled = enabled;
+        gkick_distortion_get_in_limiter(synth->distortion, &params->distortion_in_limiter);
+        gkick_distortion_get_volume(synth->distortion, &params->distortion_volume);
+        gkick_distortion_get_drive(synth->distortion, &params->distortion_drive);
+
+        for (size_t i = 0; i < GKICK_OSC_NUMBER && i < synth->oscillators_number; i++) {
+                struct gkick_oscillator *osc = synth->oscillators[i];
+                struct gkick_osc_params *osc_params = &params->oscillators[i];
+                osc_params->enabled = osc->state == GEONKICK_OSC_STATE_ENABLED;
+                osc_params->function = osc->func;
+                osc_params->phase = osc->initial_phase;
+                osc_params->seed = osc->seed;
+                osc_params->amplitude = osc->amplitude;
+                osc_params->frequency = osc->frequency;
+                osc_params->is_fm = osc->is_fm;
+                osc_params->filter_enabled = osc->filter_enabled;
+                gkick_filter_get_type(osc->filter, &osc_params->filter_type);
+                gkick_filter_get_cutoff_freq(osc->filter, &osc_params->filter_cutoff);
+                gkick_filter_get_factor(osc->filter, &osc_params->filter_factor);
+                for (size_t j = 0; j < GKICK_OSC_ENVELOPES_NUMBER; j++) {
+                        struct gkick_envelope_params *env = &osc_params->envelopes[j];
+                        gkick_osc_get_envelope_points(osc, j, &env->points, &env->npoints);
                 }
-                memcpy(*data, osc->sample->buff, sizeof(gkick_real) * (*size));
+
+                osc_params->sample = gkick_sample_ref(osc->sample);
         }
         gkick_synth_unlock(synth);
+
         return GEONKICK_OK;
 }
@@ -28,9 +28,16 @@
 #include "compressor.h"
 #include "distortion.h"
 #include "audio_output.h"
+#include "gkick_buffer.h"
 
 #include <stdatomic.h>
 
+/**
+ * The draft synthesis renders one of every
+ * GKICK_SYNTH_DRAFT_RATE_DIVIDER frames.
+ */
+#define GKICK_SYNTH_DRAFT_RATE_DIVIDER 4
+
 struct gkick_synth {
       	atomic_size_t id;
         char name[30];
@@ -70,6 +77,12 @@ struct gkick_synth {
         /* To update or not the buffer. */
         atomic_bool buffer_update;
 
+        /**
+         * Number of the update transactions in progress.
+         * The buffer is not updated until all are committed.
+         */
+        atomic_size_t update_depth;
+
         /**
          * Kick smaples buffer where the synthesizer is doing the synthesis.
          * It is swaped with one of the oudio output buffers atomically.
@@ -78,6 +91,16 @@ struct gkick_synth {
         /* Kick buffer size. */
         _Atomic size_t buffer_size;
 
+        /**
+         * While the draft is enabled the percussion is synthesised
+         * at a lower rate into the draft buffer, and interpolated
+         * into the kick buffer. It is synthesised again at the full
+         * rate when the draft is disabled.
+         */
+        atomic_bool draft;
+        bool is_draft_buffer;
+        struct gkick_buffer *draft_buffer;
+
         /**
          * Audio output that is shared with audio thread
          */
@@ -319,6 +342,26 @@ void gkick_synth_set_output(struct gkick_synth *synth,
 enum geonkick_error
 gkick_synth_process(struct gkick_synth *synth);
 
+/**
+ * Renders the percussion into the buffer with the
+ * oscillators frequencies scaled by the pitch factor.
+ * One of every rate_divider frames is rendered.
+ */
+enum geonkick_error
+gkick_synth_render(struct gkick_synth *synth,
+                   struct gkick_buffer *buffer,
+                   gkick_real pitch_factor,
+                   size_t rate_divider);
+
+enum geonkick_error
+gkick_synth_set_draft(struct gkick_synth *synth,
+                      bool draft);
+
+/* Renders the percussion tuned to the note into the note cache. */
+enum geonkick_error
+gkick_synth_render_note(struct gkick_synth *synth,
+                        int note);
+
 gkick_real
 gkick_synth_get_value(struct gkick_synth *synth,
                       gkick_real t);
@@ -476,18 +519,44 @@ geonkick_synth_group_get_amplitude(struct gkick_synth *synth,
 				   size_t index,
 				   gkick_real *amplitude);
 
+/**
+ * Sets the sample of the oscillator taking a reference to it.
+ * The sample is removed if NULL.
+ */
 enum geonkick_error
 geonkick_synth_set_osc_sample(struct gkick_synth *synth,
                               size_t osc_index,
-                              const gkick_real *data,
-                              size_t size);
+                              struct gkick_sample *sample);
 
+/**
+ * Returns a new reference to the sample of the oscillator.
+ */
 enum geonkick_error
 geonkick_synth_get_osc_sample(struct gkick_synth *synth,
                               size_t osc_index,
-                              gkick_real **data,
-                              size_t *size);
+                              struct gkick_sample **sample);
+
+/**
+ * Adds the distinct samples of the synthesizer to the samples list.
+ * A reference is taken to every added sample.
+ */
+void
+gkick_synth_get_samples(struct gkick_synth *synth,
+                        struct gkick_sample **samples,
+                        size_t *number,
+                        size_t max_number);
 
+/**
+ * Applies all the synthesis parameters within a single lock
+ * of the synthesizer. The envelopes are created before locking
+ * and swapped with the current ones.
+ */
+enum geonkick_error
+gkick_synth_set_params(struct gkick_synth *synth,
+                       const struct gkick_synth_params *params);
 
+enum geonkick_error
+gkick_synth_get_params(struct gkick_synth *synth,
+                       struct gkick_synth_params *params);
 
 #endif // SYNTHESIZER_H
@@ -53,12 +53,14 @@ class GeonkickLv2Plugin : public RkObject
                 : geonkickApi{new GeonkickApi}
                 , midiIn{nullptr}
                 , notifyHostChannel{nullptr}
+                , freeWheeling{nullptr}
                 , outputChannels{std::vector<float*>(geonkickApi->getPercussionsNumber(), nullptr)}
                 , atomInfo{0}
                 , kickIsUpdated{false}
         {
                 RK_ACT_BIND(geonkickApi, kickUpdated, RK_ACT_ARGS(), this, kickUpdated());
-                RK_ACT_BIND(geonkickApi, stateChanged, RK_ACT_ARGS(), this, kickUpdated());
+                RK_ACT_BIND(geonkickApi, stateUpdated,
+                            RK_ACT_ARGS(const StateChanges &changes), this, kickUpdated());
         }
 
         ~GeonkickLv2Plugin()
@@ -93,6 +95,16 @@ class GeonkickLv2Plugin : public RkObject
                 notifyHostChannel = data;
         }
 
+        void setFreeWheeling(const float *data)
+        {
+                freeWheeling = data;
+        }
+
+        bool isFreeWheeling() const
+        {
+                return freeWheeling && *freeWheeling > 0.5f;
+        }
+
         void setStateId(LV2_URID id)
         {
                 atomInfo.stateId = id;
@@ -147,12 +159,12 @@ class GeonkickLv2Plugin : public RkObject
         {
                 RK_UNUSED(flags);
                 geonkickApi->setKitState(data);
-                geonkickApi->notifyUpdateGui();
+                geonkickApi->notifyStateChanges(StateChanges::kitChanges());
         }
 
         std::string getStateData()
         {
-                return geonkickApi->getKitState()->toJson();
+                return geonkickApi->getKitState()->toBinary();
         }
 
         GeonkickApi* getApi() const
@@ -164,6 +176,11 @@ class GeonkickLv2Plugin : public RkObject
         {
                 if (!midiIn)
                         return;
+
+                // In offline mode play the latest updates of the percussions.
+                if (isFreeWheeling() && !geonkickApi->waitRender())
+                        GEONKICK_LOG_ERROR("timeout on waiting for rendering");
+
                 auto it = lv2_atom_sequence_begin(&midiIn->body);
                 for (auto i = 0; i < nsamples; i++) {
                         while (it->time.frames == i
@@ -239,6 +256,7 @@ private:
         GeonkickApi *geonkickApi;
         LV2_Atom_Sequence *midiIn;
         LV2_Atom_Sequence *notifyHostChannel;
+        const float *freeWheeling;
         std::vector<float*> outputChannels;
 
         struct AtomInfo {
@@ -396,6 +414,8 @@ static void gkick_connect_port(LV2_Handle instance,
                 geonkickLv2PLugin->setMidiIn(static_cast<LV2_Atom_Sequence*>(data));
         else if (portNumber == 1)
                 geonkickLv2PLugin->setNotifyHostChannel(static_cast<LV2_Atom_Sequence*>(data));
+        else if (portNumber == nChannels + 2)
+                geonkickLv2PLugin->setFreeWheeling(static_cast<const float*>(data));
         else if (portNumber > 1)
                 geonkickLv2PLugin->setAudioChannel(static_cast<float*>(data), portNumber - 2);
 }
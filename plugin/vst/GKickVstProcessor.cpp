@@ -95,6 +95,10 @@ GKickVstProcessor::setActive(TBool state)
 tresult PLUGIN_API
 GKickVstProcessor::process(Vst::ProcessData& data)
 {
+        // In offline mode play the latest updates of the percussions.
+        if (data.processMode == Vst::kOffline && !geonkickApi->waitRender())
+                GEONKICK_LOG_ERROR("timeout on waiting for rendering");
+
         if (data.numSamples > 0) {
                 auto events = data.inputEvents;
                 auto nEvents = events->getEventCount();
@@ -177,7 +181,7 @@ GKickVstProcessor::setState(IBStream* state)
                 return kResultFalse;
         }
         geonkickApi->setKitState(data);
-        geonkickApi->notifyUpdateGui();
+        geonkickApi->notifyStateChanges(StateChanges::kitChanges());
         return kResultOk;
 }
 
@@ -190,7 +194,7 @@ GKickVstProcessor::getState(IBStream* state)
         }
 
         int32 nBytes = 0;
-        auto data = geonkickApi->getKitState()->toJson();
+        auto data = geonkickApi->getKitState()->toBinary();
         if (state->write(data.data(), data.size(), &nBytes) == kResultFalse) {
                 GEONKICK_LOG_ERROR("error on saving the state");
                 return kResultFalse;
@@ -0,0 +1,490 @@
+/**
+ * File name: binary_state.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "binary_state.h"
+
+#include <cstring>
+
+#ifdef GEONKICK_STATE_ZLIB
+#include <zlib.h>
+#endif // GEONKICK_STATE_ZLIB
+
+static constexpr char binaryStateMagic[] = {'G', 'K', 'S', 'T'};
+static constexpr uint32_t binaryStateVersion = 2;
+
+/* Magic, format version. */
+static constexpr size_t binaryStateHeaderSize = 8;
+
+/* Tag, payload size. */
+static constexpr size_t binaryStateChunkHeaderSize = 8;
+
+BinaryStateWriter::BinaryStateWriter()
+        : isSamplesShared{false}
+        , isSamplesCompressed{false}
+{
+        stateData.append(binaryStateMagic, sizeof(binaryStateMagic));
+        writeUInt32(binaryStateVersion);
+}
+
+void BinaryStateWriter::beginChunk(const char *tag)
+{
+        stateData.append(tag, 4);
+        openChunks.push_back(stateData.size());
+        writeUInt32(0);
+}
+
+void BinaryStateWriter::endChunk()
+{
+        if (openChunks.empty())
+                return;
+
+        auto position = openChunks.back();
+        openChunks.pop_back();
+        auto size = static_cast<uint32_t>(stateData.size() - position - 4);
+        for (size_t i = 0; i < 4; i++)
+                stateData[position + i] = static_cast<char>((size >> (8 * i)) & 0xff);
+}
+
+void BinaryStateWriter::writeUInt8(uint8_t val)
+{
+        stateData.push_back(static_cast<char>(val));
+}
+
+void BinaryStateWriter::writeBool(bool b)
+{
+        writeUInt8(b ? 1 : 0);
+}
+
+void BinaryStateWriter::writeUInt32(uint32_t val)
+{
+        char bytes[4];
+        for (size_t i = 0; i < sizeof(bytes); i++)
+                bytes[i] = static_cast<char>((val >> (8 * i)) & 0xff);
+        stateData.append(bytes, sizeof(bytes));
+}
+
+void BinaryStateWriter::writeInt32(int32_t val)
+{
+        writeUInt32(static_cast<uint32_t>(val));
+}
+
+void BinaryStateWriter::writeUInt64(uint64_t val)
+{
+        char bytes[8];
+        for (size_t i = 0; i < sizeof(bytes); i++)
+                bytes[i] = static_cast<char>((val >> (8 * i)) & 0xff);
+        stateData.append(bytes, sizeof(bytes));
+}
+
+void BinaryStateWriter::writeDouble(double val)
+{
+        uint64_t bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        writeUInt64(bits);
+}
+
+void BinaryStateWriter::writeString(const std::string &str)
+{
+        writeUInt32(str.size());
+        stateData.append(str);
+}
+
+void BinaryStateWriter::writePoints(const std::vector<RkRealPoint> &points)
+{
+        writeUInt32(points.size());
+        for (const auto &point: points) {
+                writeDouble(point.x());
+                writeDouble(point.y());
+        }
+}
+
+void BinaryStateWriter::writeSamples(const SampleRef &sample)
+{
+        if (isSamplesShared && !sample.empty()) {
+                auto res = sharedSamples.insert({sample.hash(), sample});
+                /* A different sample with the same hash is written inline. */
+                if (res.first->second == sample) {
+                        if (res.second)
+                                sharedSamplesOrder.push_back(sample.hash());
+                        writeUInt8(static_cast<uint8_t>(SampleCodec::Shared));
+                        writeUInt64(sample.hash());
+                        return;
+                }
+        }
+
+        auto deflated = deflateSamples(sample);
+        if (!deflated.empty()) {
+                writeUInt8(static_cast<uint8_t>(SampleCodec::Deflate));
+                writeDeflatedSamples(sample, deflated);
+                return;
+        }
+
+        writeUInt8(static_cast<uint8_t>(SampleCodec::Raw));
+        writeRawSamples(sample);
+}
+
+std::string BinaryStateWriter::deflateSamples(const SampleRef &sample) const
+{
+#ifdef GEONKICK_STATE_ZLIB
+        if (!isSamplesCompressed || sample.empty())
+                return {};
+
+        // The bytes of the same significance are grouped,
+        // the exponent and high mantissa bytes compress well.
+        auto n = sample.size();
+        std::vector<unsigned char> values(n * sizeof(float));
+        sample.toFloat32(values.data());
+        std::vector<unsigned char> planes(values.size());
+        for (size_t i = 0; i < n; i++) {
+                for (size_t k = 0; k < sizeof(float); k++)
+                        planes[k * n + i] = values[i * sizeof(float) + k];
+        }
+
+        auto size = compressBound(planes.size());
+        std::string data(size, '\0');
+        if (compress2(reinterpret_cast<Bytef*>(&data[0]), &size,
+                      planes.data(), planes.size(), Z_BEST_SPEED) != Z_OK
+            || size >= planes.size()) {
+                return {};
+        }
+        data.resize(size);
+        return data;
+#else
+        RK_UNUSED(sample);
+        return {};
+#endif // GEONKICK_STATE_ZLIB
+}
+
+void BinaryStateWriter::writeDeflatedSamples(const SampleRef &sample, const std::string &data)
+{
+        writeUInt32(sample.size());
+        writeUInt32(data.size());
+        stateData.append(data);
+}
+
+void BinaryStateWriter::writeRawSamples(const SampleRef &sample)
+{
+        writeUInt32(sample.size());
+        if (sample.empty())
+                return;
+#ifdef GEONKICK_RAW_SAMPLES_COPY
+        stateData.append(reinterpret_cast<const char*>(sample.data()),
+                         sample.size() * sizeof(float));
+#else
+        for (size_t i = 0; i < sample.size(); i++) {
+                auto val = static_cast<float>(sample.data()[i]);
+                uint32_t bits;
+                std::memcpy(&bits, &val, sizeof(bits));
+                writeUInt32(bits);
+        }
+#endif // GEONKICK_RAW_SAMPLES_COPY
+}
+
+void BinaryStateWriter::shareSamples(bool b)
+{
+        isSamplesShared = b;
+}
+
+void BinaryStateWriter::compressSamples(bool b)
+{
+        isSamplesCompressed = b;
+}
+
+void BinaryStateWriter::writeSharedSamples()
+{
+        for (const auto &hash: sharedSamplesOrder) {
+                const auto &sample = sharedSamples[hash];
+                auto deflated = deflateSamples(sample);
+                beginChunk(deflated.empty() ? "SMPL" : "SMPZ");
+                writeUInt64(hash);
+                if (deflated.empty())
+                        writeRawSamples(sample);
+                else
+                        writeDeflatedSamples(sample, deflated);
+                endChunk();
+        }
+        sharedSamples.clear();
+        sharedSamplesOrder.clear();
+}
+
+std::string BinaryStateWriter::takeData()
+{
+        while (!openChunks.empty())
+                endChunk();
+        writeSharedSamples();
+        return std::move(stateData);
+}
+
+BinaryStateReader::BinaryStateReader(const char *data, size_t size)
+        : stateData{data}
+        , dataSize{size}
+        , readPosition{0}
+        , isError{false}
+{
+}
+
+bool BinaryStateReader::isBinaryState(const std::string &data)
+{
+        return data.size() >= binaryStateHeaderSize
+                && data.compare(0, sizeof(binaryStateMagic), binaryStateMagic,
+                                sizeof(binaryStateMagic)) == 0;
+}
+
+bool BinaryStateReader::readHeader()
+{
+        if (!canRead(binaryStateHeaderSize)
+            || std::memcmp(stateData, binaryStateMagic, sizeof(binaryStateMagic))) {
+                GEONKICK_LOG_ERROR("wrong binary state format");
+                isError = true;
+                return false;
+        }
+
+        readPosition += sizeof(binaryStateMagic);
+        auto version = readUInt32();
+        if (version > binaryStateVersion) {
+                GEONKICK_LOG_ERROR("unsupported binary state version " << version);
+                isError = true;
+                return false;
+        }
+        return true;
+}
+
+bool BinaryStateReader::nextChunk(std::string &tag, BinaryStateReader &chunk)
+{
+        if (atEnd() || !canRead(binaryStateChunkHeaderSize))
+                return false;
+
+        tag.assign(stateData + readPosition, 4);
+        readPosition += 4;
+        auto size = readUInt32();
+        if (!canRead(size))
+                return false;
+
+        chunk = BinaryStateReader(stateData + readPosition, size);
+        chunk.sharedSamples = sharedSamples;
+        readPosition += size;
+        return true;
+}
+
+bool BinaryStateReader::readSharedSamples()
+{
+        auto position = readPosition;
+        auto samples = std::make_shared<SharedSamples>();
+        std::string tag;
+        BinaryStateReader chunk(nullptr, 0);
+        while (nextChunk(tag, chunk)) {
+                if (tag != "SMPL" && tag != "SMPZ")
+                        continue;
+                auto hash = chunk.readUInt64();
+                auto sample = tag == "SMPL" ? chunk.readRawSamples(chunk.readUInt32())
+                        : chunk.readDeflatedSamples();
+                if (!chunk.isValid()) {
+                        isError = true;
+                        return false;
+                }
+                samples->insert({hash, std::move(sample)});
+        }
+
+        if (!isValid())
+                return false;
+        readPosition = position;
+        sharedSamples = samples;
+        return true;
+}
+
+bool BinaryStateReader::atEnd() const
+{
+        return isError || readPosition >= dataSize;
+}
+
+bool BinaryStateReader::isValid() const
+{
+        return !isError;
+}
+
+bool BinaryStateReader::canRead(size_t n)
+{
+        if (isError || dataSize - readPosition < n) {
+                isError = true;
+                return false;
+        }
+        return true;
+}
+
+uint8_t BinaryStateReader::readUInt8()
+{
+        if (!canRead(1))
+                return 0;
+        return static_cast<uint8_t>(stateData[readPosition++]);
+}
+
+bool BinaryStateReader::readBool()
+{
+        return readUInt8() != 0;
+}
+
+uint32_t BinaryStateReader::readUInt32()
+{
+        if (!canRead(4))
+                return 0;
+
+        uint32_t val = 0;
+        for (size_t i = 0; i < 4; i++)
+                val |= static_cast<uint32_t>(static_cast<uint8_t>(stateData[readPosition++])) << (8 * i);
+        return val;
+}
+
+int32_t BinaryStateReader::readInt32()
+{
+        return static_cast<int32_t>(readUInt32());
+}
+
+uint64_t BinaryStateReader::readUInt64()
+{
+        if (!canRead(8))
+                return 0;
+
+        uint64_t val = 0;
+        for (size_t i = 0; i < 8; i++)
+                val |= static_cast<uint64_t>(static_cast<uint8_t>(stateData[readPosition++])) << (8 * i);
+        return val;
+}
+
+double BinaryStateReader::readDouble()
+{
+        auto bits = readUInt64();
+        double val;
+        std::memcpy(&val, &bits, sizeof(val));
+        return val;
+}
+
+std::string BinaryStateReader::readString()
+{
+        auto size = readUInt32();
+        if (!canRead(size))
+                return {};
+        std::string str(stateData + readPosition, size);
+        readPosition += size;
+        return str;
+}
+
+std::vector<RkRealPoint> BinaryStateReader::readPoints()
+{
+        auto n = readUInt32();
+        if (!canRead(static_cast<size_t>(n) * 2 * sizeof(double)))
+                return {};
+
+        std::vector<RkRealPoint> points;
+        points.reserve(n);
+        for (decltype(n) i = 0; i < n; i++) {
+                auto x = readDouble();
+                auto y = readDouble();
+                points.push_back(RkRealPoint(x, y));
+        }
+        return points;
+}
+
+SampleRef BinaryStateReader::readSamples()
+{
+        auto codec = readUInt8();
+        if (codec == static_cast<uint8_t>(BinaryStateWriter::SampleCodec::Shared)) {
+                auto hash = readUInt64();
+                if (!isValid())
+                        return SampleRef();
+                if (sharedSamples) {
+                        auto res = sharedSamples->find(hash);
+                        if (res != sharedSamples->end())
+                                return res->second;
+                }
+                GEONKICK_LOG_ERROR("shared sample not found");
+                isError = true;
+                return SampleRef();
+        } else if (codec == static_cast<uint8_t>(BinaryStateWriter::SampleCodec::Deflate)) {
+                return readDeflatedSamples();
+        } else if (codec != static_cast<uint8_t>(BinaryStateWriter::SampleCodec::Raw)) {
+                GEONKICK_LOG_ERROR("unsupported sample codec " << static_cast<int>(codec));
+                isError = true;
+                return SampleRef();
+        }
+        return readRawSamples(readUInt32());
+}
+
+SampleRef BinaryStateReader::readRawSamples(uint32_t n)
+{
+        if (n == 0 || !canRead(static_cast<size_t>(n) * sizeof(float)))
+                return SampleRef();
+
+        auto sample = SampleRef::create(n, [this](gkick_real *data, size_t size) {
+#ifdef GEONKICK_RAW_SAMPLES_COPY
+                        std::memcpy(data, stateData + readPosition, size * sizeof(float));
+                        readPosition += size * sizeof(float);
+#else
+                        for (size_t i = 0; i < size; i++) {
+                                auto bits = readUInt32();
+                                float val;
+                                std::memcpy(&val, &bits, sizeof(val));
+                                data[i] = val;
+                        }
+#endif // GEONKICK_RAW_SAMPLES_COPY
+                        return size;
+                });
+        if (sample.empty())
+                isError = true;
+        return sample;
+}
+
+SampleRef BinaryStateReader::readDeflatedSamples()
+{
+        auto n = readUInt32();
+        auto size = readUInt32();
+        if (n == 0 || !canRead(size))
+                return SampleRef();
+
+#ifdef GEONKICK_STATE_ZLIB
+        std::vector<unsigned char> planes(static_cast<size_t>(n) * sizeof(float));
+        uLongf planesSize = planes.size();
+        if (uncompress(planes.data(), &planesSize,
+                       reinterpret_cast<const Bytef*>(stateData + readPosition), size) != Z_OK
+            || planesSize != planes.size()) {
+                GEONKICK_LOG_ERROR("can't inflate the sample");
+                isError = true;
+                return SampleRef();
+        }
+        readPosition += size;
+
+        std::vector<unsigned char> values(planes.size());
+        for (size_t i = 0; i < n; i++) {
+                for (size_t k = 0; k < sizeof(float); k++)
+                        values[i * sizeof(float) + k] = planes[k * n + i];
+        }
+
+        auto sample = SampleRef::fromFloat32(values.data(), n);
+        if (sample.empty())
+                isError = true;
+        return sample;
+#else
+        GEONKICK_LOG_ERROR("the compressed samples are not supported");
+        isError = true;
+        return SampleRef();
+#endif // GEONKICK_STATE_ZLIB
+}
@@ -0,0 +1,127 @@
+/**
+ * File name: binary_state.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef GEONKICK_BINARY_STATE_H
+#define GEONKICK_BINARY_STATE_H
+
+#include "globals.h"
+#include "sample_ref.h"
+
+#include <RkRealPoint.h>
+
+#include <cstdint>
+
+/**
+ * Binary state format used by the plugins for saving the session.
+ *
+ * The data starts with the magic "GKST" and the format version,
+ * followed by chunks. A chunk is a four characters tag, the payload
+ * size and the payload. All the values are little-endian.
+ * The readers skip the unknown chunks and ignore the payload
+ * bytes after the known fields, so new fields are added at
+ * the end of the chunks without changing the format version.
+ *
+ * The samples are written inline or, when sharing is enabled, once in
+ * the "SMPL" chunks at the end of the data and referenced by their hash,
+ * so a sample used by many percussions is saved only once.
+ *
+ * The samples are little-endian float32 values. When built with
+ * GEONKICK_STATE_ZLIB and the compression is enabled, the bytes of the
+ * values are grouped by significance and deflated. The compressed samples
+ * are written with the Deflate codec or in "SMPZ" chunks, only if they
+ * are smaller than the raw samples.
+ */
+class BinaryStateWriter {
+ public:
+        enum class SampleCodec : uint8_t {
+                Raw     = 0,
+                Shared  = 1,
+                Deflate = 2
+        };
+
+        BinaryStateWriter();
+        void beginChunk(const char *tag);
+        void endChunk();
+        void writeUInt8(uint8_t val);
+        void writeBool(bool b);
+        void writeUInt32(uint32_t val);
+        void writeInt32(int32_t val);
+        void writeUInt64(uint64_t val);
+        void writeDouble(double val);
+        void writeString(const std::string &str);
+        void writePoints(const std::vector<RkRealPoint> &points);
+        void writeSamples(const SampleRef &sample);
+        void shareSamples(bool b);
+        void compressSamples(bool b);
+        std::string takeData();
+
+ private:
+        void writeRawSamples(const SampleRef &sample);
+        void writeDeflatedSamples(const SampleRef &sample, const std::string &data);
+        std::string deflateSamples(const SampleRef &sample) const;
+        void writeSharedSamples();
+        std::string stateData;
+        std::vector<size_t> openChunks;
+        bool isSamplesShared;
+        bool isSamplesCompressed;
+        std::unordered_map<uint64_t, SampleRef> sharedSamples;
+        std::vector<uint64_t> sharedSamplesOrder;
+};
+
+class BinaryStateReader {
+ public:
+        BinaryStateReader(const char *data, size_t size);
+        static bool isBinaryState(const std::string &data);
+        bool readHeader();
+        bool nextChunk(std::string &tag, BinaryStateReader &chunk);
+        bool atEnd() const;
+        bool isValid() const;
+        uint8_t readUInt8();
+        bool readBool();
+        uint32_t readUInt32();
+        int32_t readInt32();
+        uint64_t readUInt64();
+        double readDouble();
+        std::string readString();
+        std::vector<RkRealPoint> readPoints();
+        SampleRef readSamples();
+
+        /**
+         * Loads the shared samples from the "SMPL" chunks
+         * without changing the reading position.
+         */
+        bool readSharedSamples();
+
+ private:
+        using SharedSamples = std::unordered_map<uint64_t, SampleRef>;
+        SampleRef readRawSamples(uint32_t n);
+        SampleRef readDeflatedSamples();
+        bool canRead(size_t n);
+        const char *stateData;
+        size_t dataSize;
+        size_t readPosition;
+        bool isError;
+        std::shared_ptr<SharedSamples> sharedSamples;
+};
+
+#endif // GEONKICK_BINARY_STATE_H
@@ -25,6 +25,7 @@
 #include "geonkick_slider.h"
 #include "geonkick_button.h"
 #include "geonkick_api.h"
+#include "percussion_state.h"
 
 #include <RkLabel.h>
 
@@ -100,6 +101,9 @@ CompressorGroupBox::CompressorGroupBox(GeonkickApi *api, GeonkickWidget *parent)
         makeupLabel->setPosition(makeupSlider->x() - makeupLabel->width() - labelD, makeupSlider->y());
         show();
         updateGui();
+        RK_ACT_BIND(geonkickApi, stateUpdated,
+                    RK_ACT_ARGS(const StateChanges &changes),
+                    this, updateGui(changes));
 }
 
 void CompressorGroupBox::setAttack(int val)
@@ -130,22 +134,23 @@ void CompressorGroupBox::setMakeup(int val)
 
 void CompressorGroupBox::updateGui()
 {
-        compressorCheckbox->setPressed(geonkickApi->isCompressorEnabled());
+        auto state = geonkickApi->percussionSnapshot();
+        compressorCheckbox->setPressed(state->isCompressorEnabled());
 
         // Attack
-        attackSlider->onSetValue(100 * (log10(1000 * geonkickApi->getCompressorAttack()) / log10(2000)));
+        attackSlider->onSetValue(100 * (log10(1000 * state->getCompressorAttack()) / log10(2000)));
 
         // Threshold
-        auto threshold = geonkickApi->getCompressorThreshold();
+        auto threshold = state->getCompressorThreshold();
         double db = 0;
-        if (threshold < std::numeric_limits<decltype(geonkickApi->getCompressorThreshold())>::min())
+        if (threshold < std::numeric_limits<decltype(state->getCompressorThreshold())>::min())
                 db = -60;
         else
                 db = 20.0 * log10(threshold);
         thresholdSlider->onSetValue(100 - 100 * (db / -60));
 
         // Ratio
-        double ratio = geonkickApi->getCompressorRatio();
+        double ratio = state->getCompressorRatio();
         if (ratio < 1.0)
                 ratio = 0;
         else
@@ -153,9 +158,16 @@ void CompressorGroupBox::updateGui()
         ratioSlider->onSetValue(100 * ratio / log2(19));
 
         // Makeup
-        double makeup = geonkickApi->getCompressorMakeup();
+        double makeup = state->getCompressorMakeup();
         if (makeup < 1.0)
                 makeup = 1.0;
         db = 20 * log10(makeup);
         makeupSlider->onSetValue(100 * (db / 36));
 }
+
+void CompressorGroupBox::updateGui(const StateChanges &changes)
+{
+        auto id = geonkickApi->percussionSnapshot()->getId();
+        if (changes.contains(id, StateChanges::Parameter::Compressor))
+                updateGui();
+}
@@ -30,12 +30,14 @@ class GeonkickSlider;
 class GeonkickCheckbox;
 class GeonkickApi;
 class GeonkickButton;
+class StateChanges;
 
 class CompressorGroupBox: public GeonkickGroupBox
 {
  public:
         CompressorGroupBox(GeonkickApi *api, GeonkickWidget* parent);
         void updateGui();
+        void updateGui(const StateChanges &changes);
         void setAttack(int val);
         void setThreshold(int val);
         void setRatio(int val);
@@ -50,7 +50,6 @@ void ControlArea::showControls()
                         delete currentWidget;
                 auto controlsWidget = new ControlsWidget(this, geonkickApi, oscillators);
                 controlsWidget->setEnvelopeWidget(envelopeWidget);
-                RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), controlsWidget, updateGui());
                 controlsWidget->setSize({width(), height()});
                 currentWidget = controlsWidget;
                 currentWidget->show();
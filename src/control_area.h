@@ -43,7 +43,6 @@ class ControlArea: public GeonkickWidget
                     GeonkickApi* api,
                     const std::vector<std::unique_ptr<Oscillator>> &oscillators);
         ~ControlArea() = default;
-        RK_DECL_ACT(updateGui, updateGui(), RK_ARG_TYPE(), RK_ARG_VAL());
         void showControls();
         void showKit();
         void showPresets();
@@ -36,32 +36,27 @@ ControlsWidget::ControlsWidget(GeonkickWidget *parent,
         , effectsWidget{nullptr}
 {
         auto oscillator = oscillators[static_cast<int>(Oscillator::Type::Oscillator1)].get();
-        auto widget = new OscillatorGroupBox(this, oscillator);
+        auto widget = new OscillatorGroupBox(this, geonkickApi, oscillator);
         widget->setPosition(0, 0);
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), widget, updateGui());
         widget->show();
 
         oscillator = oscillators[static_cast<int>(Oscillator::Type::Oscillator2)].get();
-        widget = new OscillatorGroupBox(this, oscillator);
+        widget = new OscillatorGroupBox(this, geonkickApi, oscillator);
         widget->setPosition(8 + 224, 0);
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), widget, updateGui());
         widget->show();
 
         oscillator = oscillators[static_cast<int>(Oscillator::Type::Noise)].get();
-        widget = new OscillatorGroupBox(this, oscillator);
+        widget = new OscillatorGroupBox(this, geonkickApi, oscillator);
         widget->setPosition(2 * (8 + 224), 0);
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), widget, updateGui());
         widget->show();
 
         auto generalWidget = new GeneralGroupBox(this, geonkickApi);
         generalWidget->setPosition(3 * (8 + 224), 0);
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), generalWidget, updateGui());
         generalWidget->show();
 
         effectsWidget = new EffectsGroupBox(geonkickApi, this);
         effectsWidget->setFixedSize(500, 82);
         effectsWidget->setPosition(2 * (8 + 224), 285);
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), effectsWidget, updateGui());
         effectsWidget->show();
 }
 
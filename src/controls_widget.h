@@ -38,7 +38,6 @@ class ControlsWidget: public GeonkickWidget
                        GeonkickApi* api,
                        const std::vector<std::unique_ptr<Oscillator>> &oscillators);
         ~ControlsWidget() = default;
-        RK_DECL_ACT(updateGui, updateGui(), RK_ARG_TYPE(), RK_ARG_VAL());
         void setEnvelopeWidget(EnvelopeWidget* widget);
 
  private:
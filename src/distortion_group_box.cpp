@@ -25,6 +25,7 @@
 #include "geonkick_slider.h"
 #include "geonkick_button.h"
 #include "geonkick_api.h"
+#include "percussion_state.h"
 #include "envelope_widget.h"
 
 #include <RkLabel.h>
@@ -134,6 +135,9 @@ DistortionGroupBox::DistortionGroupBox(GeonkickApi *api, GeonkickWidget *parent)
                     RK_ACT_ARGS(bool b), this, showEnvelope(Envelope::Type::DistortionDrive));
         show();
         updateGui();
+        RK_ACT_BIND(geonkickApi, stateUpdated,
+                    RK_ACT_ARGS(const StateChanges &changes),
+                    this, updateGui(changes));
 }
 
 void DistortionGroupBox::setInLimiter(int val)
@@ -158,10 +162,11 @@ void DistortionGroupBox::setDrive(int val)
 
 void DistortionGroupBox::updateGui()
 {
-        distortionCheckbox->setPressed(geonkickApi->isDistortionEnabled());
+        auto state = geonkickApi->percussionSnapshot();
+        distortionCheckbox->setPressed(state->isDistortionEnabled());
 
         // In Limiter
-        double limit = geonkickApi->getDistortionInLimiter();
+        double limit = state->getDistortionInLimiter();
         double logVal;
         if (limit > 0)
                 logVal = 20 * log10(limit);
@@ -171,7 +176,7 @@ void DistortionGroupBox::updateGui()
 
 
         // Volume
-        double volume = geonkickApi->getDistortionVolume();
+        double volume = state->getDistortionVolume();
         if (volume > 0)
                 logVal = 20 * log10(volume);
         else
@@ -179,7 +184,7 @@ void DistortionGroupBox::updateGui()
         volumeSlider->onSetValue(100 * (60 - fabs(logVal)) / 60);
 
         // Drive
-        auto distortion = geonkickApi->getDistortionDrive();
+        auto distortion = state->getDistortionDrive();
         if (distortion < std::numeric_limits<decltype(distortion)>::min())
                 distortion = 0;
         else
@@ -187,6 +192,13 @@ void DistortionGroupBox::updateGui()
         driveSlider->onSetValue(100 * distortion / 36);
 }
 
+void DistortionGroupBox::updateGui(const StateChanges &changes)
+{
+        auto id = geonkickApi->percussionSnapshot()->getId();
+        if (changes.contains(id, StateChanges::Parameter::Distortion))
+                updateGui();
+}
+
 void DistortionGroupBox::updateButtons(Envelope::Type type)
 {
         volumeEnvelopeButton->setPressed(type == Envelope::Type::DistortionVolume);
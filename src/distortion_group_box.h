@@ -31,6 +31,7 @@ class GeonkickSlider;
 class GeonkickCheckbox;
 class GeonkickApi;
 class GeonkickButton;
+class StateChanges;
 class EnvelopeWidget;
 
 class DistortionGroupBox: public GeonkickGroupBox
@@ -40,6 +41,7 @@ class DistortionGroupBox: public GeonkickGroupBox
         ~DistortionGroupBox() = default;
 
         void updateGui();
+        void updateGui(const StateChanges &changes);
         void setVolume(int val);
         void setDrive(int val);
         void setInLimiter(int val);
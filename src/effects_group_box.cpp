@@ -34,16 +34,13 @@ EffectsGroupBox::EffectsGroupBox(GeonkickApi *api, GeonkickWidget *parent)
 {
         auto compressor = new CompressorGroupBox(geonkickApi, this);
         compressor->setPosition(0, 10);
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), compressor, updateGui());
 
         distortionGroupBox = new DistortionGroupBox(geonkickApi, this);
         distortionGroupBox->setPosition(compressor->width(), 10);
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), distortionGroupBox, updateGui());
 
         auto layers = new LayersGroupBox(geonkickApi, this);
         layers->setBackgroundColor({100, 100, 100});
         layers->setPosition(distortionGroupBox->x() + distortionGroupBox->width() + 8, 10);
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), layers, updateGui());
 }
 
 void EffectsGroupBox::setEnvelopeWidget(EnvelopeWidget *widget)
@@ -35,7 +35,6 @@ class EffectsGroupBox: public GeonkickGroupBox
  public:
         EffectsGroupBox(GeonkickApi *api, GeonkickWidget *parent);
         ~EffectsGroupBox() = default;
-        RK_DECL_ACT(updateGui, updateGui(), RK_ARG_TYPE(), RK_ARG_VAL());
         void setEnvelopeWidget(EnvelopeWidget* widget);
 
  private:
@@ -35,6 +35,11 @@ EnvelopeWidgetDrawingArea::EnvelopeWidgetDrawingArea(GeonkickWidget *parent, Geo
           , hideEnvelope{false}
           , kickGraphImage{nullptr}
           , kickGraphics{nullptr}
+          , axesEnvelope{nullptr}
+          , axesEnvelopeType{0}
+          , axesOscillatorsLayer{0}
+          , axesEnvelopeLength{0}
+          , axesEnvelopeAmplitude{0}
 {
         setFixedSize(850, 300);
         int padding = 50;
@@ -68,29 +73,63 @@ void EnvelopeWidgetDrawingArea::paintWidget(RkPaintEvent *event)
                 envelopeImage = im;
         }
 
+        if (!isAxesLayerValid())
+                updateAxesLayer();
+
         RkPainter painter(&envelopeImage);
-        painter.fillRect(rect(), background());
+        painter.drawImage(axesImage, 0, 0);
 
         if (kickGraphImage && !kickGraphImage->isNull())
                 painter.drawImage(*kickGraphImage.get(), drawingArea.topLeft().x(), drawingArea.topLeft().y());
         else
                 kickGraphics->updateGraphBuffer();
 
-        if (currentEnvelope)
-                currentEnvelope->draw(painter, Envelope::DrawLayer::Axies);
-
         if (currentEnvelope && !isHideEnvelope())
                 currentEnvelope->draw(painter, Envelope::DrawLayer::Envelope);
 
-        painter.drawText(55, height() - 12, getEnvStateText());
+        RkPainter paint(this);
+        paint.drawImage(envelopeImage, 0, 0);
+}
+
+bool EnvelopeWidgetDrawingArea::isAxesLayerValid() const
+{
+        if (axesImage.width() != width() || axesImage.height() != height()
+            || axesEnvelope != currentEnvelope)
+                return false;
+
+        if (!currentEnvelope)
+                return true;
+
+        return axesEnvelopeType == static_cast<int>(currentEnvelope->type())
+                && axesOscillatorsLayer == static_cast<int>(geonkickApi->layer())
+                && axesEnvelopeLength == currentEnvelope->envelopeLengh()
+                && axesEnvelopeAmplitude == currentEnvelope->envelopeAmplitude();
+}
+
+void EnvelopeWidgetDrawingArea::updateAxesLayer()
+{
+        if (axesImage.width() != width() || axesImage.height() != height()) {
+                RkImage im(size());
+                axesImage = im;
+        }
+
+        RkPainter painter(&axesImage);
+        painter.fillRect(rect(), background());
+        axesEnvelope = currentEnvelope;
+        if (currentEnvelope) {
+                axesEnvelopeType = static_cast<int>(currentEnvelope->type());
+                axesOscillatorsLayer = static_cast<int>(geonkickApi->layer());
+                axesEnvelopeLength = currentEnvelope->envelopeLengh();
+                axesEnvelopeAmplitude = currentEnvelope->envelopeAmplitude();
+                currentEnvelope->draw(painter, Envelope::DrawLayer::Axies);
+                painter.drawText(55, height() - 12, getEnvStateText());
+        }
+
         auto pen = painter.pen();
         pen.setWidth(1);
         pen.setColor({20, 20, 20, 255});
         painter.setPen(pen);
         painter.drawRect({0, 0, width() - 1, height() - 1});
-
-        RkPainter paint(this);
-        paint.drawImage(envelopeImage, 0, 0);
 }
 
 std::string EnvelopeWidgetDrawingArea::getEnvStateText() const
@@ -138,8 +177,10 @@ void EnvelopeWidgetDrawingArea::mouseButtonPressEvent(RkMouseEvent *event)
                 mousePoint.setY(event->y());
                 if (currentEnvelope) {
                         currentEnvelope->selectPoint(point);
-                        if (currentEnvelope->hasSelected())
+                        if (currentEnvelope->hasSelected()) {
+                                geonkickApi->enableDraftSynthesis(true);
                                 update();
+                        }
                 }
         }
         setFocus(true);
@@ -153,6 +194,7 @@ void EnvelopeWidgetDrawingArea::mouseButtonReleaseEvent(RkMouseEvent *event)
         auto toUpdate = false;
         if (currentEnvelope->hasSelected()) {
                 currentEnvelope->unselectPoint();
+                geonkickApi->enableDraftSynthesis(false);
                 toUpdate = true;
         }
 
@@ -57,6 +57,8 @@ class EnvelopeWidgetDrawingArea : public GeonkickWidget
    void mouseButtonReleaseEvent(RkMouseEvent *event) final;
    void mouseDoubleClickEvent(RkMouseEvent *event) final;
    std::string getEnvStateText() const;
+   bool isAxesLayerValid() const;
+   void updateAxesLayer();
 
  private:
    GeonkickApi* geonkickApi;
@@ -66,6 +68,19 @@ class EnvelopeWidgetDrawingArea : public GeonkickWidget
    bool hideEnvelope;
    std::shared_ptr<RkImage> kickGraphImage;
    RkImage envelopeImage;
+
+   /**
+    * The background, axes and scales are rendered once into the axes
+    * layer and only the graph and the envelope are drawn over it on
+    * every paint. The layer is rendered again when the envelope, its
+    * type, length or amplitude, or the current layer change.
+    */
+   RkImage axesImage;
+   Envelope *axesEnvelope;
+   int axesEnvelopeType;
+   int axesOscillatorsLayer;
+   double axesEnvelopeLength;
+   double axesEnvelopeAmplitude;
    KickGraph *kickGraphics;
 };
 
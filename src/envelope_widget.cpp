@@ -97,6 +97,9 @@ EnvelopeWidget::EnvelopeWidget(GeonkickWidget *parent,
         envelope->setCategory(Envelope::Category::General);
         createButtomMenu();
         showEnvelope(Envelope::Category::General);
+        RK_ACT_BIND(geonkickApi, stateUpdated,
+                    RK_ACT_ARGS(const StateChanges &changes),
+                    this, updateGui(changes));
 }
 
 void EnvelopeWidget::createButtomMenu()
@@ -294,7 +297,6 @@ void EnvelopeWidget::setLayer(GeonkickApi::Layer layer)
         layer2Button->setPressed(GeonkickApi::Layer::Layer2 == layer);
         layer3Button->setPressed(GeonkickApi::Layer::Layer3 == layer);
         geonkickApi->setLayer(layer);
-        action requestUpdateGui();
 }
 
 void EnvelopeWidget::updateGui()
@@ -309,3 +311,12 @@ void EnvelopeWidget::updateGui()
         }
         drawArea->update();
 }
+
+void EnvelopeWidget::updateGui(const StateChanges &changes)
+{
+        auto id = geonkickApi->percussionSnapshot()->getId();
+        if (changes.contains(id, StateChanges::Parameter::Kick
+                             | StateChanges::Parameter::KickEnvelopes
+                             | StateChanges::Parameter::Oscillators))
+                updateGui();
+}
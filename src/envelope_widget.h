@@ -43,7 +43,7 @@ public:
      void hideEnvelope(bool b);
      void showEnvelopeType(Envelope::Type type);
      void updateGui();
-     RK_DECL_ACT(requestUpdateGui, requestUpdateGui(), RK_ARG_TYPE(), RK_ARG_VAL());
+     void updateGui(const StateChanges &changes);
      RK_DECL_ACT(envelopeTypeSelected,
                  envelopeTypeSelected(Envelope::Type type),
                  RK_ARG_TYPE(Envelope::Type),
@@ -305,21 +305,23 @@ void ExportWidget::exportKick()
         sndinfo.channels   = channelsType == ChannelsType::Mono ? 1 : 2;
         sndinfo.format     = exportFormat();
 
-        auto tempBuffer = geonkickApi->getKickBuffer();
-        sndinfo.frames = tempBuffer.size();
-        std::vector<gkick_real> kickBuffer;
+        auto kickSample = geonkickApi->getKickBuffer();
+        sndinfo.frames = kickSample.size();
+        const gkick_real *kickBuffer = kickSample.data();
+        size_t kickBufferSize = kickSample.size();
+        std::vector<gkick_real> stereoBuffer;
         if (sndinfo.channels == 2) {
-                kickBuffer.resize(2 * tempBuffer.size());
+                stereoBuffer.resize(2 * kickSample.size());
                 size_t k = 0;
-                while (k < tempBuffer.size()) {
-                        kickBuffer[2 * k] = kickBuffer[2 * k + 1] = tempBuffer[k];
+                while (k < kickSample.size()) {
+                        stereoBuffer[2 * k] = stereoBuffer[2 * k + 1] = kickBuffer[k];
                         k++;
                 }
-        } else {
-                kickBuffer = std::move(tempBuffer);
+                kickBuffer = stereoBuffer.data();
+                kickBufferSize = stereoBuffer.size();
         }
 
-        if (kickBuffer.empty() || !sf_format_check(&sndinfo)) {
+        if (kickBufferSize == 0 || !sf_format_check(&sndinfo)) {
                 showError("Error: error on exporting kick33");
                 return;
         }
@@ -338,11 +340,11 @@ void ExportWidget::exportKick()
 
         size_t n;
 #ifdef GEONKICK_DOUBLE_PRECISION
-        n = sf_write_double(sndFile, kickBuffer.data(), kickBuffer.size());
+        n = sf_write_double(sndFile, kickBuffer, kickBufferSize);
 #else
-        n = sf_write_float(sndFile, kickBuffer.data(), kickBuffer.size());
+        n = sf_write_float(sndFile, kickBuffer, kickBufferSize);
 #endif
-        if (n != kickBuffer.size())
+        if (n != kickBufferSize)
                 showError("Error on exporting");
         else
                 progressBar->setValue(100);
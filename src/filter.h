@@ -49,6 +49,7 @@ class Filter: public GeonkickWidget
         RK_DECL_ACT(enabled, enabled(bool b), RK_ARG_TYPE(bool), RK_ARG_VAL(b));
         RK_DECL_ACT(cutOffChanged, cutOffChanged(double val), RK_ARG_TYPE(double), RK_ARG_VAL(val));
         RK_DECL_ACT(resonanceChanged, resonanceChanged(double val), RK_ARG_TYPE(double), RK_ARG_VAL(val));
+        RK_DECL_ACT(draggingChanged, draggingChanged(bool b), RK_ARG_TYPE(bool), RK_ARG_VAL(b));
         RK_DECL_ACT(typeChanged, typeChanged(GeonkickApi::FilterType type),
                     RK_ARG_TYPE(GeonkickApi::FilterType),
                     RK_ARG_VAL(type));
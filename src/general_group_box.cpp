@@ -22,6 +22,7 @@
  */
 
 #include "geonkick_api.h"
+#include "percussion_state.h"
 #include "general_group_box.h"
 #include "knob.h"
 #include "geonkick_button.h"
@@ -54,6 +55,9 @@ GeneralGroupBox::GeneralGroupBox(GeonkickWidget *parent, GeonkickApi *api)
         createAplitudeEnvelopeHBox();
         createFilterHBox();
         updateGui();
+        RK_ACT_BIND(geonkickApi, stateUpdated,
+                    RK_ACT_ARGS(const StateChanges &changes),
+                    this, updateGui(changes));
 }
 
 void GeneralGroupBox::createAplitudeEnvelopeHBox()
@@ -76,6 +80,8 @@ void GeneralGroupBox::createAplitudeEnvelopeHBox()
                     RK_ACT_ARGS(double val),
                     geonkickApi,
                     setKickAmplitude(val));
+        RK_ACT_BIND(kickAmplitudeKnob, draggingChanged, RK_ACT_ARGS(bool b),
+                    geonkickApi, enableDraftSynthesis(b));
 
         kickLengthKnob = new Knob(amplitudeEnvelopeBox);
         kickLengthKnob->setFixedSize(80, 80);
@@ -89,6 +95,8 @@ void GeneralGroupBox::createAplitudeEnvelopeHBox()
                     RK_ACT_ARGS(double val),
                     geonkickApi,
                     setKickLength(val));
+        RK_ACT_BIND(kickLengthKnob, draggingChanged, RK_ACT_ARGS(bool b),
+                    geonkickApi, enableDraftSynthesis(b));
 }
 
 void GeneralGroupBox::createFilterHBox()
@@ -103,6 +111,8 @@ void GeneralGroupBox::createFilterHBox()
                     geonkickApi, setKickFilterFrequency(val));
         RK_ACT_BIND(filterBox, resonanceChanged, RK_ACT_ARGS(double val),
                     geonkickApi, setKickFilterQFactor(val));
+        RK_ACT_BIND(filterBox, draggingChanged, RK_ACT_ARGS(bool b),
+                    geonkickApi, enableDraftSynthesis(b));
         RK_ACT_BIND(filterBox, typeChanged,
                     RK_ACT_ARGS(GeonkickApi::FilterType type),
                     geonkickApi, setKickFilterType(type));
@@ -110,11 +120,19 @@ void GeneralGroupBox::createFilterHBox()
 
 void GeneralGroupBox::updateGui()
 {
-        kickAmplitudeKnob->setCurrentValue(geonkickApi->kickAmplitude());
-        kickLengthKnob->setCurrentValue(geonkickApi->kickLength());
-        filterBox->enable(geonkickApi->isKickFilterEnabled());
-        filterBox->setCutOff(geonkickApi->kickFilterFrequency());
-        filterBox->setResonance(geonkickApi->kickFilterQFactor());
-        filterBox->setType(geonkickApi->kickFilterType());
+        auto state = geonkickApi->percussionSnapshot();
+        kickAmplitudeKnob->setCurrentValue(state->getKickAmplitude());
+        kickLengthKnob->setCurrentValue(state->getKickLength());
+        filterBox->enable(state->isKickFilterEnabled());
+        filterBox->setCutOff(state->getKickFilterFrequency());
+        filterBox->setResonance(state->getKickFilterQFactor());
+        filterBox->setType(state->getKickFilterType());
+}
+
+void GeneralGroupBox::updateGui(const StateChanges &changes)
+{
+        auto id = geonkickApi->percussionSnapshot()->getId();
+        if (changes.contains(id, StateChanges::Parameter::Kick))
+                updateGui();
 }
 
@@ -33,12 +33,14 @@ class GeonkickCheckbox;
 class Knob;
 class GeonkickButton;
 class Filter;
+class StateChanges;
 
 class GeneralGroupBox: public GeonkickGroupBox
 {
  public:
         GeneralGroupBox(GeonkickWidget *parent, GeonkickApi *api);
         void updateGui();
+        void updateGui(const StateChanges &changes);
 
  protected:
         void createAplitudeEnvelopeHBox();
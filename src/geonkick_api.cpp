@@ -26,13 +26,16 @@
 #include "globals.h"
 #include "percussion_state.h"
 #include "kit_state.h"
+#include "percussion_params.h"
 #include "preset.h"
 #include "preset_folder.h"
+#include "preset_registry.h"
+#include "preset_audition.h"
+#include "sample_loader.h"
 
 #include <RkEventQueue.h>
 
 #include <geonkick.h>
-#include <sndfile.h>
 
 GeonkickApi::GeonkickApi()
         :geonkickApi{nullptr}
@@ -45,12 +48,27 @@ GeonkickApi::GeonkickApi()
         , kitName{"Unknown"}
         , kitAuthor{"Author"}
         , clipboardPercussion{nullptr}
+        , presetRegistry{PresetRegistry::instance()}
 {
         setupDataPaths();
+        setupCachePath();
+        sampleLoader = std::make_unique<SampleLoader>(presetRegistry,
+                                                      [this](const SampleLoader::Request &request,
+                                                             const SampleRef &sample) {
+                                                              sampleLoaded(request, sample);
+                                                      });
+        presetAudition = std::make_unique<PresetAudition>(presetRegistry,
+                                                          [this](const SampleRef &sample) {
+                                                                  playPreview(sample);
+                                                          });
+        presetRegistry->addListener(this, [this](void){ notifyPresetsUpdated(); });
 }
 
 GeonkickApi::~GeonkickApi()
 {
+        presetRegistry->removeListener(this);
+        sampleLoader = nullptr;
+        presetAudition = nullptr;
   	if (geonkickApi)
                 geonkick_free(&geonkickApi);
 }
@@ -59,11 +77,12 @@ void GeonkickApi::setEventQueue(RkEventQueue *queue)
 {
         std::lock_guard<std::mutex> lock(apiMutex);
         eventQueue = queue;
+        // The changes posted to the previous queue are dropped with it.
+        pendingChanges.clear();
 }
 
 bool GeonkickApi::init()
 {
-        loadPresets();
   	if (geonkick_create(&geonkickApi) != GEONKICK_OK) {
 	        GEONKICK_LOG_ERROR("can't create geonkick API");
                 return false;
@@ -72,7 +91,7 @@ bool GeonkickApi::init()
 	geonkick_enable_synthesis(geonkickApi, false);
 
 	auto n = getPercussionsNumber();
-        kickBuffers = std::vector<std::vector<gkick_real>>(n);
+        kickBuffers = std::vector<SampleRef>(n);
 	for (decltype(n) i = 0; i < n; i++) {
                 auto state = getDefaultPercussionState();
                 state->setId(i);
@@ -87,6 +106,9 @@ bool GeonkickApi::init()
         // Set the first the percussion by default to be controllable.
 	geonkick_set_current_percussion(geonkickApi, 0);
 	geonkick_enable_synthesis(geonkickApi, true);
+
+        // The presets are loaded in background after the synthesizer is ready.
+        loadPresets();
         return true;
 }
 
@@ -183,55 +205,21 @@ void GeonkickApi::setPercussionState(const std::shared_ptr<PercussionState> &sta
         if (!state)
                 return;
 
-        geonkick_enable_synthesis(geonkickApi, false);
-        geonkick_enable_percussion(geonkickApi, state->getId(), state->isEnabled());
-        auto currentId = currentPercussion();
-        geonkick_set_current_percussion(geonkickApi, state->getId());
-        setPercussionName(state->getId(), state->getName());
-        setPercussionPlayingKey(state->getId(), state->getPlayingKey());
-        setPercussionChannel(state->getId(), state->getChannel());
-        mutePercussion(state->getId(), state->isMuted());
-        soloPercussion(state->getId(), state->isSolo());
-        for (auto i = 0; i < 3; i++) {
-                enbaleLayer(static_cast<Layer>(i), state->isLayerEnabled(static_cast<Layer>(i)));
-                setLayerAmplitude(static_cast<Layer>(i), state->getLayerAmplitude(static_cast<Layer>(i)));
-        }
-        setLimiterValue(state->getLimiterValue());
-        tuneAudioOutput(state->getId(), state->isOutputTuned());
-        setKickLength(state->getKickLength());
-        setKickAmplitude(state->getKickAmplitude());
-        enableKickFilter(state->isKickFilterEnabled());
-        setKickFilterFrequency(state->getKickFilterFrequency());
-        setKickFilterQFactor(state->getKickFilterQFactor());
-        setKickFilterType(state->getKickFilterType());
-        setKickEnvelopePoints(GeonkickApi::EnvelopeType::Amplitude,
-                              state->getKickEnvelopePoints(GeonkickApi::EnvelopeType::Amplitude));
-        setKickEnvelopePoints(GeonkickApi::EnvelopeType::FilterCutOff,
-                              state->getKickEnvelopePoints(GeonkickApi::EnvelopeType::FilterCutOff));
-	setKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionDrive,
-                              state->getKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionDrive));
-        setKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionVolume,
-                              state->getKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionVolume));
-
-        for (auto i = 0; i < 3; i++) {
-                setOscillatorState(static_cast<Layer>(i), OscillatorType::Oscillator1, state);
-                setOscillatorState(static_cast<Layer>(i), OscillatorType::Oscillator2, state);
-                setOscillatorState(static_cast<Layer>(i), OscillatorType::Noise, state);
-        }
-        enableCompressor(state->isCompressorEnabled());
-        setCompressorAttack(state->getCompressorAttack());
-        setCompressorRelease(state->getCompressorRelease());
-        setCompressorThreshold(state->getCompressorThreshold());
-        setCompressorRatio(state->getCompressorRatio());
-        setCompressorKnee(state->getCompressorKnee());
-        setCompressorMakeup(state->getCompressorMakeup());
-        enableDistortion(state->isDistortionEnabled());
-        setDistortionInLimiter(state->getDistortionInLimiter());
-        setDistortionVolume(state->getDistortionVolume());
-        setDistortionDrive(state->getDistortionDrive());
-
-        geonkick_set_current_percussion(geonkickApi, currentId);
-        geonkick_enable_synthesis(geonkickApi, true);
+        auto id = state->getId();
+        geonkick_begin_update(geonkickApi, id);
+        geonkick_enable_percussion(geonkickApi, id, state->isEnabled());
+        setPercussionPlayingKey(id, state->getPlayingKey());
+        setPercussionChannel(id, state->getChannel());
+        mutePercussion(id, state->isMuted());
+        soloPercussion(id, state->isSolo());
+        setPercussionLimiter(id, state->getLimiterValue());
+        tuneAudioOutput(id, state->isOutputTuned());
+
+        PercussionParams params(*state);
+
+        /* All the parameters are applied at once and the percussion is rendered one time. */
+        geonkick_set_percussion_params(geonkickApi, id, params.get());
+        geonkick_commit_update(geonkickApi, id);
 }
 
 void GeonkickApi::setPercussionState(const std::string &data)
@@ -243,139 +231,94 @@ void GeonkickApi::setPercussionState(const std::string &data)
 
 std::shared_ptr<PercussionState> GeonkickApi::getPercussionState(size_t id) const
 {
-        if (id == currentPercussion()) {
-                return getPercussionState();
-        } else {
-                auto tmpId = currentPercussion();
-                auto res = geonkick_set_current_percussion(geonkickApi, id);
-                if (res != GEONKICK_OK) {
-                        geonkick_set_current_percussion(geonkickApi, tmpId);
-                        return nullptr;
-                }
-                auto state = getPercussionState();
-                geonkick_set_current_percussion(geonkickApi, tmpId);
-                return state;
-        }
-}
+        struct gkick_synth_params params;
+        if (geonkick_get_percussion_params(geonkickApi, id, &params) != GEONKICK_OK)
+                return nullptr;
+
+        auto getEnvelope = [](const struct gkick_envelope_params &envelope) {
+                std::vector<RkRealPoint> points;
+                for (decltype(envelope.npoints) i = 0; i < envelope.npoints; i++)
+                        points.push_back(RkRealPoint(envelope.points[2 * i],
+                                                     envelope.points[2 * i + 1]));
+                return points;
+        };
 
-std::shared_ptr<PercussionState> GeonkickApi::getPercussionState() const
-{
         auto state = std::make_shared<PercussionState>();
-        state->setId(currentPercussion());
-        state->setName(getPercussionName(state->getId()));
-        state->setLimiterValue(limiterValue());
-        state->tuneOutput(isAudioOutputTuned(state->getId()));
-        state->setPlayingKey(getPercussionPlayingKey(state->getId()));
-        state->setChannel(getPercussionChannel(state->getId()));
-        state->setMute(isPercussionMuted(state->getId()));
-        state->setSolo(isPercussionSolo(state->getId()));
-        for (int i = 0; i < 3; i++) {
-                state->setLayerEnabled(static_cast<Layer>(i), isLayerEnabled(static_cast<Layer>(i)));
-                state->setLayerAmplitude(static_cast<Layer>(i), getLayerAmplitude(static_cast<Layer>(i)));
+        state->setId(id);
+        state->setName(params.name);
+        state->setLimiterValue(percussionLimiter(id));
+        state->tuneOutput(isAudioOutputTuned(id));
+        state->setPlayingKey(getPercussionPlayingKey(id));
+        state->setChannel(getPercussionChannel(id));
+        state->setMute(isPercussionMuted(id));
+        state->setSolo(isPercussionSolo(id));
+        for (int i = 0; i < GKICK_OSC_GROUPS_NUMBER; i++) {
+                state->setLayerEnabled(static_cast<Layer>(i), params.layers[i]);
+                state->setLayerAmplitude(static_cast<Layer>(i), params.layers_amplitude[i]);
         }
-        state->setKickLength(kickLength());
-        state->setKickAmplitude(kickAmplitude());
-        state->enableKickFilter(isKickFilterEnabled());
-        state->setKickFilterFrequency(kickFilterFrequency());
-        state->setKickFilterQFactor(kickFilterQFactor());
-        state->setKickFilterType(kickFilterType());
-        state->setKickEnvelopePoints(GeonkickApi::EnvelopeType::Amplitude,
-                                     getKickEnvelopePoints(GeonkickApi::EnvelopeType::Amplitude));
-        state->setKickEnvelopePoints(GeonkickApi::EnvelopeType::FilterCutOff,
-                                     getKickEnvelopePoints(GeonkickApi::EnvelopeType::FilterCutOff));
-	state->setKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionDrive,
-                                     getKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionDrive));
-        state->setKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionVolume,
-                                     getKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionVolume));
-
-
-        for (int i = 0; i < 3; i++) {
-                getOscillatorState(static_cast<Layer>(i), OscillatorType::Oscillator1, state);
-                getOscillatorState(static_cast<Layer>(i), OscillatorType::Oscillator2, state);
-                getOscillatorState(static_cast<Layer>(i), OscillatorType::Noise, state);
+        state->setKickLength(1000 * params.length);
+        state->setKickAmplitude(params.amplitude);
+        state->enableKickFilter(params.filter_enabled);
+        state->setKickFilterFrequency(params.filter_cutoff);
+        state->setKickFilterQFactor(params.filter_factor);
+        state->setKickFilterType(static_cast<FilterType>(params.filter_type));
+        for (auto envelope : {EnvelopeType::Amplitude, EnvelopeType::FilterCutOff,
+                              EnvelopeType::DistortionDrive, EnvelopeType::DistortionVolume}) {
+                state->setKickEnvelopePoints(envelope,
+                                             getEnvelope(params.envelopes[static_cast<int>(envelope)]));
         }
-        state->enableCompressor(isCompressorEnabled());
-        state->setCompressorAttack(getCompressorAttack());
-        state->setCompressorRelease(getCompressorRelease());
-        state->setCompressorThreshold(getCompressorThreshold());
-        state->setCompressorRatio(getCompressorRatio());
-        state->setCompressorKnee(getCompressorKnee());
-        state->setCompressorMakeup(getCompressorMakeup());
-        state->enableDistortion(isDistortionEnabled());
-        state->setDistortionInLimiter(getDistortionInLimiter());
-        state->setDistortionVolume(getDistortionVolume());
-        state->setDistortionDrive(getDistortionDrive());
 
-        return state;
-}
-
-void GeonkickApi::getOscillatorState(GeonkickApi::Layer layer,
-                                     OscillatorType osc,
-                                     const std::shared_ptr<PercussionState> &state) const
-{
-        auto temp = currentLayer;
-        currentLayer = layer;
-        auto index = static_cast<int>(osc);
-        state->setCurrentLayer(layer);
-        state->setOscillatorEnabled(index, isOscillatorEnabled(index));
-        state->setOscillatorFunction(index, oscillatorFunction(index));
-        state->setOscillatorSample(index, getOscillatorSample(index));
-        if (osc != OscillatorType::Noise)
-                state->setOscillatorPhase(index, oscillatorPhase(index));
-        if (osc == OscillatorType::Noise)
-                state->setOscillatorSeed(index, oscillatorSeed(index));
-        state->setOscillatorAmplitue(index, oscillatorAmplitude(index));
-        state->setOscillatorFrequency(index, oscillatorFrequency(index));
-        state->setOscillatorFilterEnabled(index, isOscillatorFilterEnabled(index));
-        state->setOscillatorFilterType(index, getOscillatorFilterType(index));
-        state->setOscillatorFilterCutOffFreq(index, getOscillatorFilterCutOffFreq(index));
-        state->setOscillatorFilterFactor(index, getOscillatorFilterFactor(index));
-        auto points = oscillatorEvelopePoints(index, GeonkickApi::EnvelopeType::Amplitude);
-        state->setOscillatorEnvelopePoints(index, points, GeonkickApi::EnvelopeType::Amplitude);
-        if (osc != OscillatorType::Noise) {
-                points = oscillatorEvelopePoints(index, GeonkickApi::EnvelopeType::Frequency);
-                state->setOscillatorEnvelopePoints(index, points, GeonkickApi::EnvelopeType::Frequency);
+        for (int i = 0; i < GKICK_OSC_GROUPS_NUMBER; i++) {
+                state->setCurrentLayer(static_cast<Layer>(i));
+                for (int osc = 0; osc < GKICK_OSC_GROUP_SIZE; osc++) {
+                        const auto &oscParams = params.oscillators[i * GKICK_OSC_GROUP_SIZE + osc];
+                        bool isNoise = osc == static_cast<int>(OscillatorType::Noise);
+                        state->setOscillatorEnabled(osc, oscParams.enabled);
+                        state->setOscillatorFunction(osc, static_cast<FunctionType>(oscParams.function));
+                        state->setOscillatorSample(osc, SampleRef::adopt(geonkick_sample_ref(oscParams.sample)));
+                        if (!isNoise)
+                                state->setOscillatorPhase(osc, oscParams.phase);
+                        else
+                                state->setOscillatorSeed(osc, oscParams.seed);
+                        state->setOscillatorAmplitue(osc, oscParams.amplitude);
+                        state->setOscillatorFrequency(osc, oscParams.frequency);
+                        state->setOscillatorFilterEnabled(osc, oscParams.filter_enabled);
+                        state->setOscillatorFilterType(osc, static_cast<FilterType>(oscParams.filter_type));
+                        state->setOscillatorFilterCutOffFreq(osc, oscParams.filter_cutoff);
+                        state->setOscillatorFilterFactor(osc, oscParams.filter_factor);
+                        state->setOscillatorEnvelopePoints(osc,
+                                                           getEnvelope(oscParams.envelopes[static_cast<int>(EnvelopeType::Amplitude)]),
+                                                           EnvelopeType::Amplitude);
+                        if (!isNoise) {
+                                state->setOscillatorEnvelopePoints(osc,
+                                                                   getEnvelope(oscParams.envelopes[static_cast<int>(EnvelopeType::Frequency)]),
+                                                                   EnvelopeType::Frequency);
+                        }
+                        state->setOscillatorEnvelopePoints(osc,
+                                                           getEnvelope(oscParams.envelopes[static_cast<int>(EnvelopeType::FilterCutOff)]),
+                                                           EnvelopeType::FilterCutOff);
+                        state->setOscillatorAsFm(osc, oscParams.is_fm);
+                }
         }
-        points = oscillatorEvelopePoints(index, GeonkickApi::EnvelopeType::FilterCutOff);
-        state->setOscillatorEnvelopePoints(index, points, GeonkickApi::EnvelopeType::FilterCutOff);
-        state->setOscillatorAsFm(index, isOscillatorAsFm(index));
-        currentLayer = temp;
+        state->enableCompressor(params.compressor_enabled);
+        state->setCompressorAttack(params.compressor_attack);
+        state->setCompressorRelease(params.compressor_release);
+        state->setCompressorThreshold(params.compressor_threshold);
+        state->setCompressorRatio(params.compressor_ratio);
+        state->setCompressorKnee(params.compressor_knee);
+        state->setCompressorMakeup(params.compressor_makeup);
+        state->enableDistortion(params.distortion_enabled);
+        state->setDistortionInLimiter(params.distortion_in_limiter);
+        state->setDistortionVolume(params.distortion_volume);
+        state->setDistortionDrive(params.distortion_drive);
+        geonkick_synth_params_free(&params);
+
+        return state;
 }
 
-void GeonkickApi::setOscillatorState(GeonkickApi::Layer layer,
-                                     OscillatorType oscillator,
-                                     const std::shared_ptr<PercussionState> &state)
+std::shared_ptr<PercussionState> GeonkickApi::getPercussionState() const
 {
-        auto temp = currentLayer;
-        currentLayer = layer;
-        auto osc = static_cast<int>(oscillator);
-        state->setCurrentLayer(layer);
-        enableOscillator(osc, state->isOscillatorEnabled(osc));
-        setOscillatorFunction(osc, state->oscillatorFunction(osc));
-        setOscillatorSample(state->getOscillatorSample(osc), osc);
-        if (oscillator != OscillatorType::Noise)
-                setOscillatorPhase(osc, state->oscillatorPhase(osc));
-        if (oscillator == OscillatorType::Noise)
-                setOscillatorSeed(osc, state->oscillatorSeed(osc));
-        setOscillatorAmplitude(osc, state->oscillatorAmplitue(osc));
-        if (oscillator != OscillatorType::Noise)
-                setOscillatorFrequency(osc, state->oscillatorFrequency(osc));
-        enableOscillatorFilter(osc, state->isOscillatorFilterEnabled(osc));
-        setOscillatorFilterType(osc, state->oscillatorFilterType(osc));
-        setOscillatorFilterCutOffFreq(osc, state->oscillatorFilterCutOffFreq(osc));
-        setOscillatorFilterFactor(osc, state->oscillatorFilterFactor(osc));
-        setOscillatorEvelopePoints(osc, EnvelopeType::Amplitude,
-                                   state->oscillatorEnvelopePoints(osc, EnvelopeType::Amplitude));
-        if (oscillator != OscillatorType::Noise) {
-                setOscillatorEvelopePoints(osc, EnvelopeType::Frequency,
-                                           state->oscillatorEnvelopePoints(osc,
-                                           EnvelopeType::Frequency));
-        }
-        setOscillatorEvelopePoints(osc, EnvelopeType::FilterCutOff,
-                                   state->oscillatorEnvelopePoints(osc, EnvelopeType::FilterCutOff));
-        setOscillatorAsFm(osc, state->isOscillatorAsFm(osc));
-
-        currentLayer = temp;
+        return getPercussionState(currentPercussion());
 }
 
 std::unique_ptr<KitState> GeonkickApi::getKitState() const
@@ -398,15 +341,19 @@ std::unique_ptr<KitState> GeonkickApi::getKitState() const
 bool GeonkickApi::setKitState(const std::string &data)
 {
         auto state = std::make_unique<KitState>();
-        state->fromJson(data);
+        if (!state->fromData(data))
+                return false;
         return setKitState(state);
 }
 
 bool GeonkickApi::setKitState(const std::unique_ptr<KitState> &state)
 {
+        /* The percussions are synthesised after the whole kit is loaded. */
         auto n = getPercussionsNumber();
-        for (decltype(n) i = 0; i < n; i++)
+        for (decltype(n) i = 0; i < n; i++) {
+                geonkick_begin_update(geonkickApi, i);
                 enablePercussion(i, false);
+        }
         setKitName(state->getName());
         setKitAuthor(state->getAuthor());
         setKitUrl(state->getUrl());
@@ -416,6 +363,8 @@ bool GeonkickApi::setKitState(const std::unique_ptr<KitState> &state)
                 setPercussionState(per);
                 addOrderedPercussionId(per->getId());
         }
+        for (decltype(n) i = 0; i < n; i++)
+                geonkick_commit_update(geonkickApi, i);
 
         if (!percussionIdList.empty())
                 setCurrentPercussion(percussionIdList.front());
@@ -849,11 +798,19 @@ void GeonkickApi::kickUpdatedCallback(void *arg,
                                       size_t size,
                                       size_t id)
 {
-        std::vector<gkick_real> buffer(size, 0);
-        std::memcpy(buffer.data(), buff, size * sizeof(gkick_real));
         GeonkickApi *obj = static_cast<GeonkickApi*>(arg);
-        if (obj)
-                obj->updateKickBuffer(std::move(buffer), id);
+        if (!obj)
+                return;
+
+        /**
+         * The synthesizer reuses its buffer, so the rendered kick is
+         * copied once into an unpublished sample that is shared
+         * by all the readers.
+         */
+        struct gkick_sample *sample = nullptr;
+        if (size > 0 && geonkick_sample_create(size, &sample) == GEONKICK_OK)
+                std::memcpy(geonkick_sample_buffer(sample), buff, size * sizeof(gkick_real));
+        obj->updateKickBuffer(SampleRef::adopt(sample), id);
 }
 
 void GeonkickApi::limiterCallback(void *arg, gkick_real val)
@@ -873,12 +830,11 @@ double GeonkickApi::getLimiterLevelerValue() const
         return limiterLevelerVal;
 }
 
-void GeonkickApi::updateKickBuffer(const std::vector<gkick_real> &&buffer,
-                                   size_t id)
+void GeonkickApi::updateKickBuffer(SampleRef buffer, size_t id)
 {
         std::lock_guard<std::mutex> lock(apiMutex);
         if (id < getPercussionsNumber())
-                kickBuffers[id] = buffer;
+                std::swap(kickBuffers[id], buffer);
         if (eventQueue && id == currentPercussion()) {
                 auto act = std::make_unique<RkAction>();
                 act->setCallback([&](void){ kickUpdated(); });
@@ -886,7 +842,7 @@ void GeonkickApi::updateKickBuffer(const std::vector<gkick_real> &&buffer,
         }
 }
 
-std::vector<gkick_real> GeonkickApi::getKickBuffer() const
+SampleRef GeonkickApi::getKickBuffer() const
 {
         std::lock_guard<std::mutex> lock(apiMutex);
         return kickBuffers[currentPercussion()];
@@ -914,6 +870,19 @@ void GeonkickApi::playKick(int id)
         geonkick_play(geonkickApi, id);
 }
 
+void GeonkickApi::auditionPreset(const Preset *preset)
+{
+        if (preset)
+                presetAudition->audition(preset->path(), preset->type());
+}
+
+// This function is called from the GUI or the audition thread.
+void GeonkickApi::playPreview(const SampleRef &sample)
+{
+        if (geonkickApi && !sample.empty())
+                geonkick_play_preview(geonkickApi, sample.get());
+}
+
 // This function is called only from the audio thread.
 gkick_real GeonkickApi::getAudioFrame(int channel) const
 {
@@ -922,6 +891,11 @@ gkick_real GeonkickApi::getAudioFrame(int channel) const
         return val;
 }
 
+bool GeonkickApi::waitRender(int timeout) const
+{
+        return geonkick_wait_render(geonkickApi, timeout) == GEONKICK_OK;
+}
+
 void GeonkickApi::enableCompressor(bool enable)
 {
         geonkick_compressor_enable(geonkickApi, enable);
@@ -1089,9 +1063,17 @@ void GeonkickApi::triggerSynthesis()
         geonkick_enable_synthesis(geonkickApi, true);
 }
 
+void GeonkickApi::enableDraftSynthesis(bool b)
+{
+        geonkick_enable_draft_synthesis(geonkickApi, b);
+}
+
 void GeonkickApi::setLayer(Layer layer)
 {
         currentLayer = layer;
+        // The oscillators are shown for the current layer.
+        notifyStateChanges(StateChanges(currentPercussion(),
+                                        StateChanges::Parameter::Oscillators));
 }
 
 GeonkickApi::Layer GeonkickApi::layer() const
@@ -1336,107 +1318,66 @@ void GeonkickApi::setOscillatorSample(const std::string &file,
 {
         int rateRate = 48000;
         geonkick_get_sample_rate(geonkickApi, &rateRate);
-        std::vector<gkick_real> sampleData = loadSample(file,
-                                                        kickMaxLength() / 1000,
-                                                        rateRate,
-                                                        1);
-        if (!sampleData.empty()) {
-                geonkick_set_osc_sample(geonkickApi,
-                                        getOscIndex(oscillatorIndex),
-                                        sampleData.data(),
-                                        sampleData.size());
+        SampleLoader::Request request;
+        request.file = file;
+        request.percussionId = currentPercussion();
+        request.oscillatorIndex = getOscIndex(oscillatorIndex);
+        request.sampleRate = rateRate;
+        request.length = kickMaxLength() / 1000;
+        request.serial = 0;
+        sampleLoader->load(request);
+}
+
+/**
+ * Sets the loaded sample from the GUI thread, the sample
+ * is set to the percussion it was loaded for.
+ */
+void GeonkickApi::sampleLoaded(const SampleLoader::Request &request,
+                               const SampleRef &sample)
+{
+        std::lock_guard<std::mutex> lock(apiMutex);
+        if (eventQueue) {
+                auto act = std::make_unique<RkAction>();
+                act->setCallback([this, request, sample](void){
+                                geonkick_set_osc_sample_ref_id(geonkickApi,
+                                                               request.percussionId,
+                                                               request.oscillatorIndex,
+                                                               sample.get());
+                        });
+                eventQueue->postAction(std::move(act));
+        } else {
+                geonkick_set_osc_sample_ref_id(geonkickApi,
+                                               request.percussionId,
+                                               request.oscillatorIndex,
+                                               sample.get());
         }
 }
 
-void GeonkickApi::setOscillatorSample(const std::vector<float> &sample,
+void GeonkickApi::setOscillatorSample(const SampleRef &sample,
                                       int oscillatorIndex)
 {
         if (!sample.empty()) {
-                geonkick_set_osc_sample(geonkickApi,
-                                        getOscIndex(oscillatorIndex),
-                                        sample.data(),
-                                        sample.size());
+                geonkick_set_osc_sample_ref(geonkickApi,
+                                            getOscIndex(oscillatorIndex),
+                                            sample.get());
         }
 }
 
-std::vector<float>
-GeonkickApi::getOscillatorSample(int oscillatorIndex) const
+SampleRef GeonkickApi::getOscillatorSample(int oscillatorIndex) const
 {
-        gkick_real *data = nullptr;
-        size_t size = 0;
-        geonkick_get_osc_sample(geonkickApi,
-                                getOscIndex(oscillatorIndex),
-                                &data,
-                                &size);
-        if (data)
-                return std::vector<float>(data, data + size);
-        return {};
-}
-
-std::vector<gkick_real> GeonkickApi::loadSample(const std::string &file,
-                                                double length,
-                                                int sampleRate,
-                                                int channels)
-{
-        GEONKICK_UNUSED(channels);
-
-        SF_INFO sndinfo;
-        memset(&sndinfo, 0, sizeof(sndinfo));
-        SNDFILE *sndFile = sf_open(file.c_str(), SFM_READ, &sndinfo);
-        if (!sndFile) {
-                GEONKICK_LOG_ERROR("can't open sample file");
-                return std::vector<gkick_real>();
-        }
-
-        if (sndinfo.format != (SF_FORMAT_FLAC | SF_FORMAT_PCM_16)
-            && sndinfo.format != (SF_FORMAT_FLAC | SF_FORMAT_PCM_24)
-            && sndinfo.format != (SF_FORMAT_WAV | SF_FORMAT_PCM_16)
-            && sndinfo.format != (SF_FORMAT_WAV | SF_FORMAT_PCM_24)
-            && sndinfo.format != (SF_FORMAT_WAV | SF_FORMAT_PCM_32)
-            && sndinfo.format != (SF_FORMAT_WAVEX | SF_FORMAT_PCM_16)
-            && sndinfo.format != (SF_FORMAT_WAVEX | SF_FORMAT_PCM_24)
-            && sndinfo.format != (SF_FORMAT_WAVEX | SF_FORMAT_PCM_32)
-            && sndinfo.format != (SF_FORMAT_OGG | SF_FORMAT_VORBIS)) {
-                GEONKICK_LOG_ERROR("unsupported audio format");
-                sf_close(sndFile);
-                return std::vector<gkick_real>();
-        }
-
-        std::vector<float> data(sndinfo.samplerate * length * sndinfo.channels, 0.0f);
-        auto n = sf_read_float(sndFile, data.data(), data.size());
-        sf_close(sndFile);
-        if (static_cast<decltype(data.size())>(n) < 1) {
-                GEONKICK_LOG_ERROR("error on reading samples");
-                return std::vector<gkick_real>();
-        } else if (static_cast<decltype(data.size())>(n) < data.size()) {
-                GEONKICK_LOG_DEBUG("read less then data, resize to " << n);
-                data.resize(n);
-        }
-
-        if (sndinfo.channels > 1) {
-                GEONKICK_LOG_DEBUG("multichannel file, get only the first channel");
-                for (decltype(data.size()) i = 0; i < data.size(); i += sndinfo.channels)
-                        data[i / sndinfo.channels] = data[i];
-                data.resize(data.size() / sndinfo.channels);
-        }
-
-        if (sampleRate != sndinfo.samplerate) {
-                GEONKICK_LOG_DEBUG("different sample rate " << sndinfo.samplerate
-                                   << ", resample to " << sampleRate);
-                float f = static_cast<float>(sndinfo.samplerate) / sampleRate;
-                float x = 0.0f;
-                std::vector<float> out_data;
-                for (decltype(data.size()) i = 0; i < data.size() - 1;) {
-                        float d = x - i;
-                        float val = data[i] * (1.0f - d) + data[i + 1] * d;
-                        x += f;
-                        i = x;
-                        out_data.push_back(val);
-                }
-                return out_data;
-        }
+        struct gkick_sample *sample = nullptr;
+        geonkick_get_osc_sample_ref(geonkickApi,
+                                    getOscIndex(oscillatorIndex),
+                                    &sample);
+        return SampleRef::adopt(sample);
+}
 
-        return data;
+size_t GeonkickApi::samplesMemoryUsage() const
+{
+        size_t number = 0;
+        size_t size = 0;
+        geonkick_get_samples_usage(geonkickApi, &number, &size);
+        return size;
 }
 
 void GeonkickApi::setKitName(const std::string &name)
@@ -1496,45 +1437,61 @@ void GeonkickApi::notifyUpdateGraph()
         }
 }
 
-void GeonkickApi::notifyUpdateParameters()
+void GeonkickApi::notifyStateChanges(const StateChanges &changes)
 {
-        if (eventQueue) {
+        std::lock_guard<std::mutex> lock(apiMutex);
+        if (!eventQueue || changes.empty())
+                return;
+
+        bool isPosted = !pendingChanges.empty();
+        pendingChanges.merge(changes);
+        if (!isPosted) {
                 auto act = std::make_unique<RkAction>();
-                act->setCallback([&](void){ action stateChanged(); });
+                act->setCallback([this](void){ applyStateChanges(); });
                 eventQueue->postAction(std::move(act));
         }
 }
 
-void GeonkickApi::notifyUpdateGui()
+void GeonkickApi::applyStateChanges()
 {
-        if (eventQueue) {
-                auto act = std::make_unique<RkAction>();
-                act->setCallback([&](void){
-                                action kickUpdated();
-                                action stateChanged();
-                        });
-                eventQueue->postAction(std::move(act));
+        StateChanges changes;
+        {
+                std::lock_guard<std::mutex> lock(apiMutex);
+                std::swap(changes, pendingChanges);
         }
+
+        if (changes.empty())
+                return;
+
+        stateSnapshot = percussionSnapshot();
+        if (changes.contains(stateSnapshot->getId(), StateChanges::Parameter::All))
+                action kickUpdated();
+        action stateUpdated(changes);
+        stateSnapshot = nullptr;
 }
 
-void GeonkickApi::notifyPercussionUpdated(int id)
+std::shared_ptr<const PercussionState> GeonkickApi::percussionSnapshot() const
 {
-        if (eventQueue) {
-                auto act = std::make_unique<RkAction>();
-                act->setCallback([this, id](void){
-                                GEONKICK_LOG_DEBUG("update percussion :" << id);
-                                action percussionUpdated(id);
-                        });
-                eventQueue->postAction(std::move(act));
+        if (stateSnapshot)
+                return stateSnapshot;
+
+        auto id = currentPercussion();
+        auto state = getPercussionState(id);
+        if (!state) {
+                state = getDefaultPercussionState();
+                state->setId(id);
         }
+        state->setCurrentLayer(currentLayer);
+        return state;
 }
 
-void GeonkickApi::notifyKitUpdated()
+void GeonkickApi::notifyPresetsUpdated()
 {
+        std::lock_guard<std::mutex> lock(apiMutex);
         if (eventQueue) {
                 auto act = std::make_unique<RkAction>();
                 act->setCallback([&](void){
-                                action kitUpdated();
+                                action presetsUpdated();
                         });
                 eventQueue->postAction(std::move(act));
         }
@@ -1606,33 +1563,13 @@ void GeonkickApi::loadPresets()
                         prestsPaths.insert(std::filesystem::path(path) / presetsPathSufix);
         }
 
-        for (const auto &path: prestsPaths) {
-                try {
-                        if (std::filesystem::exists(path))
-                                loadPresetsFolders(path);
-                } catch(const std::exception& e) {
-                        GEONKICK_LOG_ERROR("error on reading path: " << path << ": " << e.what());
-                }
-        }
-}
-
-void GeonkickApi::loadPresetsFolders(const std::filesystem::path &path)
-{
-        try {
-                for (const auto &entry : std::filesystem::directory_iterator(path)) {
-                        if (!entry.path().empty() && std::filesystem::is_directory(entry.path())) {
-                                auto presetFolder = std::make_unique<PresetFolder>(entry.path());
-                                GEONKICK_LOG_DEBUG("preset folder " << presetFolder->path());
-                                if (!presetFolder->loadPresets()) {
-                                        GEONKICK_LOG_ERROR("can't load preset from folder " << presetFolder->path());
-                                } else {
-                                        presetsFoldersList.push_back(std::move(presetFolder));
-                                }
-                        }
-                }
-        } catch(...) {
-                GEONKICK_LOG_ERROR("error on reading path: " << path);
-        }
+        std::filesystem::path indexFile;
+        std::filesystem::path cachePath = getSettings("GEONKICK_CONFIG/USER_CACHE_PATH");
+        if (!cachePath.empty())
+                indexFile = cachePath / "presets.index";
+        presetRegistry->loadPresets(std::vector<std::filesystem::path>(prestsPaths.begin(),
+                                                                      prestsPaths.end()),
+                                    indexFile);
 }
 
 void GeonkickApi::setupDataPaths()
@@ -1673,14 +1610,49 @@ void GeonkickApi::setupDataPaths()
         }
 }
 
-PresetFolder* GeonkickApi::getPresetFolder(size_t index) const
+void GeonkickApi::setupCachePath()
 {
-        if (index < presetsFoldersList.size())
-                return presetsFoldersList[index].get();
-        return nullptr;
+        std::filesystem::path cachePath;
+        const char *cacheHome = std::getenv("XDG_CACHE_HOME");
+        if (cacheHome == nullptr || *cacheHome == '\0') {
+                const char *homeDir = std::getenv("HOME");
+                if (homeDir == nullptr || *homeDir == '\0') {
+                        GEONKICK_LOG_ERROR("can't get home directory");
+                        return;
+                }
+                cachePath = homeDir / std::filesystem::path(".cache");
+        } else {
+                cachePath = cacheHome;
+        }
+        cachePath /= std::filesystem::path(GEONKICK_APP_NAME);
+        auto samplesPath = cachePath / std::filesystem::path("samples");
+
+        try {
+                if (!std::filesystem::exists(samplesPath)) {
+                        if (!std::filesystem::create_directories(samplesPath)) {
+                                GEONKICK_LOG_ERROR("can't create path " << samplesPath);
+                                return;
+                        }
+                }
+                setSettings("GEONKICK_CONFIG/USER_CACHE_PATH", cachePath);
+                /* The samples are shared through the cache files with other processes. */
+                geonkick_sample_store_set_cache_path(samplesPath.c_str());
+        } catch(const std::exception& e) {
+                GEONKICK_LOG_ERROR("error on setup cache path: " << e.what());
+        }
+}
+
+std::shared_ptr<PresetFolder> GeonkickApi::getPresetFolder(size_t index) const
+{
+        return presetRegistry->getPresetFolder(index);
 }
 
 size_t GeonkickApi::numberOfPresetFolders() const
 {
-        return presetsFoldersList.size();
+        return presetRegistry->numberOfPresetFolders();
+}
+
+std::vector<std::shared_ptr<Preset>> GeonkickApi::searchPresets(const std::string &query, size_t maxResults) const
+{
+        return presetRegistry->searchPresets(query, maxResults);
 }
@@ -25,6 +25,9 @@
 #define GEONKICK_API_H
 
 #include "globals.h"
+#include "sample_ref.h"
+#include "sample_loader.h"
+#include "state_changes.h"
 
 #include <RkRealPoint.h>
 
@@ -33,6 +36,9 @@ class PercussionState;
 class KitState;
 class RkEventQueue;
 class PresetFolder;
+class PresetRegistry;
+class PresetAudition;
+class Preset;
 
 class GeonkickApi : public RkObject {
 
@@ -100,9 +106,11 @@ class GeonkickApi : public RkObject {
   int oscillatorSeed(int oscillatorIndex) const;
   void setOscillatorSample(const std::string &file,
                            int oscillatorIndex);
-  void setOscillatorSample(const std::vector<float> &sample,
+  void setOscillatorSample(const SampleRef &sample,
                            int oscillatorIndex);
-  std::vector<float> getOscillatorSample(int oscillatorIndex) const;
+  SampleRef getOscillatorSample(int oscillatorIndex) const;
+  /* Memory used by the distinct samples of the kit in bytes. */
+  size_t samplesMemoryUsage() const;
   double kickMaxLength(void) const;
   double kickLength(void) const;
   double kickAmplitude() const;
@@ -157,6 +165,9 @@ class GeonkickApi : public RkObject {
   static std::shared_ptr<PercussionState> getDefaultPercussionState();
   // This function is called only from the audio thread.
   gkick_real getAudioFrame(int channel) const;
+  // Blocks until the pending updates are rendered (timeout in ms).
+  // This function is called only from the audio thread in offline mode.
+  bool waitRender(int timeout = 5000) const;
   // This function is called only from the audio thread.
   void setKeyPressed(bool b, int note, int velocity);
   std::shared_ptr<PercussionState> getPercussionState(size_t id) const;
@@ -197,6 +208,9 @@ class GeonkickApi : public RkObject {
   void setKickEnvelopePoints(EnvelopeType envelope,
                              const std::vector<RkRealPoint> &points);
   void playKick(int id = -1);
+  /* Plays the preset through the preview voice without loading it. */
+  void auditionPreset(const Preset *preset);
+  void playPreview(const SampleRef &sample);
   void enableCompressor(bool enable);
   void setCompressorAttack(double attack);
   void setCompressorRelease(double release);
@@ -208,8 +222,11 @@ class GeonkickApi : public RkObject {
   void setDistortionVolume(double volume);
   void setDistortionInLimiter(double limit);
   void setDistortionDrive(double drive);
-  std::vector<gkick_real> getKickBuffer() const;
+  /* The rendered kick, shared without copying. */
+  SampleRef getKickBuffer() const;
   void triggerSynthesis();
+  /* Faster, lower quality synthesis while the parameters are edited. */
+  void enableDraftSynthesis(bool b);
   void setLayer(Layer layer);
   Layer layer() const;
   void setLayerAmplitude(Layer layer, double amplitude);
@@ -267,55 +284,56 @@ class GeonkickApi : public RkObject {
               currentPlayingFrameVal(double val),
               RK_ARG_TYPE(double),
               RK_ARG_VAL(val));
-  RK_DECL_ACT(stateChanged,
-              stateChanged(),
+  RK_DECL_ACT(stateUpdated,
+              stateUpdated(const StateChanges &changes),
+              RK_ARG_TYPE(const StateChanges &),
+              RK_ARG_VAL(changes));
+  RK_DECL_ACT(presetsUpdated,
+              presetsUpdated(),
               RK_ARG_TYPE(),
               RK_ARG_VAL());
-  RK_DECL_ACT(kitUpdated,
-              kitUpdated(),
-              RK_ARG_TYPE(),
-              RK_ARG_VAL());
-    RK_DECL_ACT(percussionUpdated,
-              percussionUpdated(int id),
-              RK_ARG_TYPE(int),
-              RK_ARG_VAL(id));
 
   void setSettings(const std::string &key, const std::string &value);
   std::string getSettings(const std::string &key) const;
   void notifyUpdateGraph();
-  void notifyUpdateParameters();
-  void notifyUpdateGui();
-  void notifyPercussionUpdated(int id);
-  void notifyKitUpdated();
+
+  /**
+   * Posts the changes of the state to the GUI thread. The changes
+   * posted before the GUI thread handles them are merged and the
+   * widgets are notified one time.
+   */
+  void notifyStateChanges(const StateChanges &changes);
+  void notifyPresetsUpdated();
+
+  /**
+   * Returns the state of the current percussion for the current layer.
+   * While the state changes are notified the same snapshot is shared
+   * by all the widgets, the parameters are read only once.
+   */
+  std::shared_ptr<const PercussionState> percussionSnapshot() const;
   std::vector<int> ordredPercussionIds() const;
   void removeOrderedPercussionId(int id);
   void addOrderedPercussionId(int id);
   void clearOrderedPercussionIds();
   bool moveOrdrepedPercussionId(int index, int n);
-  PresetFolder* getPresetFolder(size_t index) const;
+  std::shared_ptr<PresetFolder> getPresetFolder(size_t index) const;
   size_t numberOfPresetFolders() const;
+  std::vector<std::shared_ptr<Preset>> searchPresets(const std::string &query, size_t maxResults) const;
 
 protected:
   void setupDataPaths();
+  void setupCachePath();
   void loadPresets();
-  void loadPresetsFolders(const std::filesystem::path &path);
   static void kickUpdatedCallback(void *arg,
                                   gkick_real *buff,
                                   size_t size,
                                   size_t id);
   static void limiterCallback(void *arg, gkick_real val);
-  void updateKickBuffer(const std::vector<gkick_real> &&buffer, size_t id);
-  void setOscillatorState(Layer layer,
-                          OscillatorType oscillator,
-                          const std::shared_ptr<PercussionState> &state);
-  void getOscillatorState(Layer layer,
-                          OscillatorType osc,
-                          const std::shared_ptr<PercussionState> &state) const;
+  void updateKickBuffer(SampleRef buffer, size_t id);
   void setLimiterVal(double val);
-  static std::vector<gkick_real> loadSample(const std::string &file,
-                                            double length = 4.0,
-                                            int sampleRate = 48000,
-                                            int channels = 1);
+  void sampleLoaded(const SampleLoader::Request &request,
+                    const SampleRef &sample);
+  void applyStateChanges();
 
 private:
   mutable struct geonkick *geonkickApi;
@@ -325,12 +343,14 @@ private:
   bool standaloneInstance;
   mutable std::mutex apiMutex;
   RkEventQueue *eventQueue;
-  std::vector<std::vector<gkick_real>> kickBuffers;
+  std::vector<SampleRef> kickBuffers;
   mutable Layer currentLayer;
   std::string kitName;
   std::string kitAuthor;
   std::string kitUrl;
   std::shared_ptr<PercussionState> clipboardPercussion;
+  StateChanges pendingChanges;
+  std::shared_ptr<const PercussionState> stateSnapshot;
 
   /**
    * Current working paths for entire application.
@@ -340,7 +360,9 @@ private:
   std::unordered_map<std::string, std::filesystem::path> workingPaths;
   std::unordered_map<std::string, std::string> apiSettings;
   std::vector<int> percussionIdList;
-  std::vector<std::unique_ptr<PresetFolder>> presetsFoldersList;
+  std::shared_ptr<PresetRegistry> presetRegistry;
+  std::unique_ptr<SampleLoader> sampleLoader;
+  std::unique_ptr<PresetAudition> presetAudition;
 };
 
 #endif // GEONKICK_API_H
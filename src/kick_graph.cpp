@@ -34,15 +34,20 @@ KickGraph::KickGraph(RkObject *parent, GeonkickApi *api, const RkSize &size)
         , graphSize{size}
         , isRunning{true}
         , updateGraph{true}
+        , columnPeaks(size.width())
 {
         RK_ACT_BIND(geonkickApi, kickUpdated, RK_ACT_ARGS(), this, updateGraphBuffer());
 }
 
 KickGraph::~KickGraph()
 {
-        isRunning = false;
+        {
+                std::unique_lock<std::mutex> lock(graphMutex);
+                isRunning = false;
+        }
         threadConditionVar.notify_one();
-        graphThread->join();
+        if (graphThread)
+                graphThread->join();
 }
 
 void KickGraph::start()
@@ -55,81 +60,92 @@ void KickGraph::updateGraphBuffer()
         if (!graphThread)
                 start();
         std::unique_lock<std::mutex> lock(graphMutex);
-        kickBuffer = geonkickApi->getKickBuffer();
         updateGraph = true;
-        if (kickBuffer.empty())
-                geonkickApi->triggerSynthesis();
         threadConditionVar.notify_one();
 }
 
 void KickGraph::drawKickGraph()
 {
+        // Limits the frame rate. The updates that come in the
+        // meantime are merged and only the last one is drawn.
+        constexpr auto frameInterval = std::chrono::milliseconds(16);
+        auto lastFrame = std::chrono::steady_clock::now() - frameInterval;
         while (isRunning) {
-                // Ignore too many updates. The last udpate will be processed.
-                std::this_thread::sleep_for(std::chrono::milliseconds(60));
                 std::unique_lock<std::mutex> lock(graphMutex);
-                if (!updateGraph)
-                        threadConditionVar.wait(lock);
+                threadConditionVar.wait(lock, [this]{ return !isRunning || updateGraph; });
+                threadConditionVar.wait_until(lock, lastFrame + frameInterval, [this]{ return !isRunning; });
                 if (!isRunning)
                         break;
 
+                updateGraph = false;
+                lock.unlock();
+
+                auto kickBuffer = geonkickApi->getKickBuffer();
                 if (kickBuffer.empty()) {
-                        updateGraph = false;
+                        geonkickApi->triggerSynthesis();
                         continue;
                 }
+                if (!peakPyramid || peakPyramid->sample().get() != kickBuffer.get())
+                        peakPyramid = std::make_unique<PeakPyramid>(kickBuffer);
 
-                auto graphImage = std::make_shared<RkImage>(graphSize.width(), graphSize.height());
-                RkPainter painter(graphImage.get());
-                RkPen pen(RkColor(59, 130, 4, 255));
-                painter.setPen(pen);
-
-                std::vector<RkPoint> graphPoints(kickBuffer.size());
-                gkick_real k = static_cast<gkick_real>(graphSize.width()) / kickBuffer.size();
-
-                /**
-                 * In this loop there is an implementation of an
-                 * antialiasing algorithm that reduces in most of
-                 * the cases antialiasing, and at the same time
-                 * reduces and normalizes the size of the buffer.
-                 */
-                int j = 0;
-                RkPoint prev;
-                for (decltype(kickBuffer.size()) i = 0; i < kickBuffer.size(); i++) {
-                        int x = k * i;
-                        int y = graphSize.height() * 0.5 * (1 - kickBuffer[i]);
-                        RkPoint p(k * i, graphSize.height() * 0.5 * (1 - kickBuffer[i]));
-                        if (p == prev)
-                                continue;
-                        else
-                                prev = p;
-                        graphPoints[j++] = p;
-
-                        int i0 = i;
-                        int ymin, ymax;
-                        ymin = ymax = y;
-                        while (++i < kickBuffer.size()) {
-                                if (x != static_cast<int>(k * i))
-                                        break;
-                                y = graphSize.height() * 0.5 * (1 - kickBuffer[i]);
-                                if (ymin > y)
-                                        ymin = y;
-                                if (ymax < y)
-                                        ymax = y;
-                        }
-
-                        if (i - i0 > 4) {
-                                graphPoints[j++] = {x, ymin};
-                                graphPoints[j++] = {x, ymax};
-                                graphPoints[j++] = {x, y};
-                        }
-                }
-                graphPoints.resize(j);
-                painter.drawPolyline(graphPoints);
+                auto graphImage = drawPeaks();
+                lastFrame = std::chrono::steady_clock::now();
                 if (eventQueue()) {
                         auto act = std::make_unique<RkAction>(this);
                         act->setCallback([this, graphImage](void){ graphUpdated(graphImage); });
                         eventQueue()->postAction(std::move(act));
                 }
-                updateGraph = false;
         }
 }
+
+std::shared_ptr<RkImage> KickGraph::drawPeaks()
+{
+        auto graphImage = getImage();
+        RkPainter painter(graphImage.get());
+        RkPen pen(RkColor(59, 130, 4, 255));
+        painter.setPen(pen);
+
+        /**
+         * One peak is taken for every column. When the peak spans
+         * more pixels the column is drawn as a vertical line
+         * that starts from the end closer to the previous point.
+         */
+        peakPyramid->columnPeaks(0.0, 1.0, columnPeaks);
+        graphPoints.clear();
+        auto h = graphSize.height();
+        int prevY = 0;
+        for (decltype(columnPeaks.size()) x = 0; x < columnPeaks.size(); x++) {
+                int yTop = h * 0.5 * (1 - columnPeaks[x].max);
+                int yBottom = h * 0.5 * (1 - columnPeaks[x].min);
+                if (yTop == yBottom) {
+                        graphPoints.emplace_back(x, yTop);
+                        prevY = yTop;
+                } else if (x > 0 && std::abs(prevY - yTop) > std::abs(prevY - yBottom)) {
+                        graphPoints.emplace_back(x, yBottom);
+                        graphPoints.emplace_back(x, yTop);
+                        prevY = yTop;
+                } else {
+                        graphPoints.emplace_back(x, yTop);
+                        graphPoints.emplace_back(x, yBottom);
+                        prevY = yBottom;
+                }
+        }
+        painter.drawPolyline(graphPoints);
+        return graphImage;
+}
+
+std::shared_ptr<RkImage> KickGraph::getImage()
+{
+        // An image is free when it is referenced only by the pool.
+        for (const auto &image : imagePool) {
+                if (image.use_count() == 1) {
+                        image->fill(RkColor(0, 0, 0, 0));
+                        return image;
+                }
+        }
+
+        auto image = std::make_shared<RkImage>(graphSize.width(), graphSize.height());
+        if (imagePool.size() < imagePoolSize)
+                imagePool.push_back(image);
+        return image;
+}
@@ -25,6 +25,7 @@
 #define GEONKICK_GRAPTH_H
 
 #include "geonkick_api.h"
+#include "peak_pyramid.h"
 
 #include <RkPainter.h>
 
@@ -47,16 +48,30 @@ public:
 
 protected:
      void drawKickGraph();
+     std::shared_ptr<RkImage> drawPeaks();
+     std::shared_ptr<RkImage> getImage();
 
 private:
      GeonkickApi *geonkickApi;
      std::unique_ptr<std::thread> graphThread;
      std::mutex  graphMutex;
      std::condition_variable threadConditionVar;
-     std::vector<gkick_real> kickBuffer;
      RkSize graphSize;
      std::atomic<bool> isRunning;
-     std::atomic<bool> updateGraph;
+     bool updateGraph;
+
+     /* Used only by the graph thread. */
+     std::unique_ptr<PeakPyramid> peakPyramid;
+     std::vector<PeakPyramid::Peak> columnPeaks;
+     std::vector<RkPoint> graphPoints;
+
+     /**
+      * The images are reused once the GUI released them.
+      * One is shown, one can wait in the event queue
+      * and one is drawn.
+      */
+     std::vector<std::shared_ptr<RkImage>> imagePool;
+     static constexpr size_t imagePoolSize = 3;
 };
 
 #endif // GEONKICK_GRAPH
@@ -39,8 +39,22 @@ KitModel::KitModel(RkObject *parent, GeonkickApi *api)
                    "A5", "A#5", "B5", "C6", "Any"}
 {
         loadModelData();
-        RK_ACT_BIND(geonkickApi, kitUpdated, RK_ACT_ARGS(), this, loadModelData());
-        RK_ACT_BIND(geonkickApi, percussionUpdated, RK_ACT_ARGS(size_t id), this, updatePercussion(getIndex(id)));
+        RK_ACT_BIND(geonkickApi, stateUpdated,
+                    RK_ACT_ARGS(const StateChanges &changes),
+                    this, updateModel(changes));
+}
+
+void KitModel::updateModel(const StateChanges &changes)
+{
+        if (changes.isKitChanged()) {
+                loadModelData();
+                return;
+        }
+
+        for (const auto &id : changes.percussions()) {
+                if (changes.contains(id, StateChanges::Parameter::Percussion))
+                        updatePercussion(getIndex(id));
+        }
 }
 
 void KitModel::updatePercussion(PercussionIndex index)
@@ -57,7 +71,8 @@ bool KitModel::isValidIndex(PercussionIndex index)
 void KitModel::selectPercussion(PercussionIndex index)
 {
         if (isValidIndex(index) && geonkickApi->setCurrentPercussion(percussionId(index))) {
-                geonkickApi->notifyUpdateGui();
+                geonkickApi->notifyStateChanges(StateChanges(percussionId(index),
+                                                             StateChanges::Parameter::All));
                 action percussionSelected();
         }
 }
@@ -90,7 +105,8 @@ bool KitModel::setPercussionChannel(PercussionIndex index, int channel)
 bool KitModel::setPercussionName(PercussionIndex index, const std::string &name)
 {
         if (geonkickApi->setPercussionName(percussionId(index), name)) {
-                geonkickApi->notifyUpdateGui();
+                geonkickApi->notifyStateChanges(StateChanges(percussionId(index),
+                                                             StateChanges::Parameter::Percussion));
                 return true;
         }
         return false;
@@ -209,9 +225,7 @@ bool KitModel::open(const std::string &file)
                 return false;
         } else {
                 geonkickApi->setCurrentWorkingPath("OpenKit", path);
-                loadModelData();
-                geonkickApi->notifyUpdateGui();
-                action modelUpdated();
+                geonkickApi->notifyStateChanges(StateChanges::kitChanges());
         }
         return true;
 }
@@ -29,6 +29,7 @@
 class GeonkickApi;
 class GeonkickState;
 class PercussionModel;
+class StateChanges;
 
 class KitModel : public RkObject {
  public:
@@ -94,6 +95,7 @@ class KitModel : public RkObject {
  protected:
         int percussionId(int index) const;
         void loadModelData();
+        void updateModel(const StateChanges &changes);
 
  private:
         GeonkickApi *geonkickApi;
@@ -23,6 +23,8 @@
 
 #include "percussion_state.h"
 #include "kit_state.h"
+#include "binary_state.h"
+#include "state_json_handler.h"
 
 
 KitState::KitState()
@@ -58,7 +60,7 @@ bool KitState::open(const std::string &fileName)
                              (std::istreambuf_iterator<char>()));
 
         sfile.close();
-        fromJson(fileData);
+        parseJson(fileData);
         return false;
 }
 
@@ -82,9 +84,9 @@ bool KitState::save(const std::string &fileName)
                 RK_LOG_ERROR("can't open file for saving: " << filePath);
                 return false;
         }
-        file << toJson();
+        auto json = toJson();
+        file.write(json.data(), json.size());
         file.close();
-        auto path = filePath.has_parent_path() ? filePath.parent_path() : filePath;
         return true;
 }
 
@@ -125,80 +127,95 @@ std::vector<std::shared_ptr<PercussionState>>& KitState::percussions()
 
 void KitState::fromJson(const std::string &jsonData)
 {
-        rapidjson::Document document;
-        document.Parse(jsonData.c_str());
-        if (!document.IsObject())
-                return;
-
-        bool backward = true;
-        for (const auto &m: document.GetObject()) {
-                if (m.name == "KitAppVersion" && m.value.IsInt()) {
-                        kitAppVersion = m.value.GetInt();
-                        backward = false;
-                        break;
-                }
-        }
+        std::string data = jsonData;
+        parseJson(data);
+}
 
-        if (backward) {
-                GEONKICK_LOG_INFO("KitAppVersion missing, old preset");
-                kitAppVersion = 0;
-        }
+bool KitState::parseJson(std::string &data)
+{
+        KitJsonHandler handler(this);
+        return parseStateJson(data, handler);
+}
 
-        if (kitAppVersion < 0x011000) {
-                // Compatibility with older versions.
-                for (int i = 0; i < 2; i++) {
-                        auto state = std::make_shared<PercussionState>();
-                        state->loadObject(document);
-                        state->setId(i);
-                        state->setChannel(i);
-                        addPercussion(state);
-                }
-        } else {
-                for (const auto &m: document.GetObject()) {
-                        if (m.name == "name" && m.value.IsString())
-                                setName(m.value.GetString());
-                        if (m.name == "author" && m.value.IsString())
-                                setAuthor(m.value.GetString());
-                        if (m.name == "url" && m.value.IsString())
-                                setUrl(m.value.GetString());
-                        if (m.name == "percussions" && m.value.IsArray())
-                                parsePercussions(m.value);
-                }
-        }
+std::string KitState::toJson() const
+{
+        size_t size = 1024;
+        for (const auto &per: percussionsList)
+                size += per->estimatedJsonSize();
+
+        rapidjson::StringBuffer buffer(nullptr, size);
+        PercussionState::JsonWriter writer(buffer);
+        writer.SetMaxDecimalPlaces(5);
+        writer.StartObject();
+        writer.Key("KitAppVersion");
+        writer.Int(GEONKICK_VERSION);
+        writer.Key("name");
+        writer.String(kitName.c_str(), kitName.size());
+        writer.Key("author");
+        writer.String(kitAuthor.c_str(), kitAuthor.size());
+        writer.Key("url");
+        writer.String(kitUrl.c_str(), kitUrl.size());
+        writer.Key("percussions");
+        writer.StartArray();
+        for (const auto &per: percussionsList)
+                per->writeJson(writer);
+        writer.EndArray();
+        writer.EndObject();
+        return std::string(buffer.GetString(), buffer.GetSize());
 }
 
-void KitState::parsePercussions(const rapidjson::Value &percussionsArray)
+std::string KitState::toBinary() const
 {
-        size_t i = 0;
-        for (const auto &per: percussionsArray.GetArray()) {
-                auto state = std::make_shared<PercussionState>();
-                state->setId(i++);
-                state->loadObject(per);
-                addPercussion(state);
+        BinaryStateWriter writer;
+        writer.shareSamples(true);
+        writer.compressSamples(true);
+        writer.beginChunk("KITI");
+        writer.writeUInt32(GEONKICK_VERSION);
+        writer.writeString(getName());
+        writer.writeString(getAuthor());
+        writer.writeString(getUrl());
+        writer.endChunk();
+
+        for (const auto &per: percussionsList) {
+                writer.beginChunk("PERC");
+                per->toBinary(writer);
+                writer.endChunk();
         }
+        return writer.takeData();
 }
 
-std::string KitState::toJson() const
+bool KitState::fromBinary(const std::string &data)
 {
-        std::ostringstream jsonStream;
-        jsonStream << "{" << std::endl;
-        jsonStream << "\"KitAppVersion\": " << GEONKICK_VERSION << "," << std::endl;
-        jsonStream << "\"name\": \"" << getName() << "\"," << std::endl;
-        jsonStream << "\"author\": \"" << getAuthor() << "\"," << std::endl;
-        jsonStream << "\"url\": \"" << getUrl() << "\"," << std::endl;
-        jsonStream <<  "\"percussions\": [" << std::endl;
+        BinaryStateReader reader(data.data(), data.size());
+        if (!reader.readHeader() || !reader.readSharedSamples())
+                return false;
 
-        size_t i = 0;
-        for (const auto &per: percussionsList) {
-                if (i < percussionsList.size() - 1)
-                        jsonStream << per->toJson() << "," << std::endl;
-                else
-                        jsonStream << per->toJson();
-                i++;
+        std::string tag;
+        BinaryStateReader chunk(nullptr, 0);
+        while (reader.nextChunk(tag, chunk)) {
+                if (tag == "KITI") {
+                        kitAppVersion = chunk.readUInt32();
+                        setName(chunk.readString());
+                        setAuthor(chunk.readString());
+                        setUrl(chunk.readString());
+                } else if (tag == "PERC") {
+                        auto state = std::make_shared<PercussionState>();
+                        if (!state->fromBinary(chunk)) {
+                                GEONKICK_LOG_ERROR("wrong percussion state");
+                                return false;
+                        }
+                        addPercussion(state);
+                }
         }
-        jsonStream <<  "]" << std::endl;
-        jsonStream << "}" << std::endl;
-        return jsonStream.str();
+        return reader.isValid();
+}
+
+bool KitState::fromData(const std::string &data)
+{
+        if (BinaryStateReader::isBinaryState(data))
+                return fromBinary(data);
+        fromJson(data);
+        return true;
 }
 
 void KitState::addPercussion(const std::shared_ptr<PercussionState> &percussion)
@@ -23,18 +23,18 @@
 
 #include "globals.h"
 
-#include <rapidjson/document.h>
-#include <rapidjson/writer.h>
-#include <rapidjson/stringbuffer.h>
-
 class PercussionState;
 
 class KitState {
+        friend class KitJsonHandler;
+
  public:
         KitState();
         bool open(const std::string &fileName);
         bool save(const std::string &fileName);
         void fromJson(const std::string &jsonData);
+        bool fromBinary(const std::string &data);
+        bool fromData(const std::string &data);
         void setName(const std::string &name);
         std::string getName() const;
         void setAuthor(const std::string &author);
@@ -42,12 +42,13 @@ class KitState {
         void setUrl(const std::string &url);
         std::string getUrl() const;
         std::string toJson() const;
+        std::string toBinary() const;
         void addPercussion(const std::shared_ptr<PercussionState> &percussion);
         std::shared_ptr<PercussionState> getPercussion(size_t id);
         std::vector<std::shared_ptr<PercussionState>>& percussions();
 
  protected:
-        void parsePercussions(const rapidjson::Value &percussionsArray);
+        bool parseJson(std::string &data);
 
  private:
         std::vector<std::shared_ptr<PercussionState>> percussionsList;
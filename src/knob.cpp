@@ -107,6 +107,7 @@ void Knob::mouseButtonPressEvent(RkMouseEvent *event)
                         isSelected = true;
                         lastPositionPoint.setX(event->x());
                         lastPositionPoint.setY(event->y());
+                        draggingChanged(true);
                 }
         }
 }
@@ -114,7 +115,10 @@ void Knob::mouseButtonPressEvent(RkMouseEvent *event)
 void Knob::mouseButtonReleaseEvent(RkMouseEvent *event)
 {
         RK_UNUSED(event);
-        isSelected = false;
+        if (isSelected) {
+                isSelected = false;
+                draggingChanged(false);
+        }
 }
 
 void Knob::mouseMoveEvent(RkMouseEvent *event)
@@ -54,6 +54,10 @@ public:
                valueUpdated(double v),
                RK_ARG_TYPE(double),
                RK_ARG_VAL(v));
+   RK_DECL_ACT(draggingChanged,
+               draggingChanged(bool b),
+               RK_ARG_TYPE(bool),
+               RK_ARG_VAL(b));
  protected:
    void paintWidget(RkPaintEvent *event) final;
    void mouseButtonPressEvent(RkMouseEvent *event) final;
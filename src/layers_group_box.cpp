@@ -25,6 +25,7 @@
 #include "geonkick_slider.h"
 #include "geonkick_button.h"
 #include "geonkick_api.h"
+#include "percussion_state.h"
 
 #include <RkLabel.h>
 
@@ -53,6 +54,9 @@ LayersGroupBox::LayersGroupBox(GeonkickApi *api, GeonkickWidget *parent)
         }
         show();
         updateGui();
+        RK_ACT_BIND(geonkickApi, stateUpdated,
+                    RK_ACT_ARGS(const StateChanges &changes),
+                    this, updateGui(changes));
 }
 
 void LayersGroupBox::setLayerAmplitude(int layer, int val)
@@ -64,8 +68,9 @@ void LayersGroupBox::setLayerAmplitude(int layer, int val)
 
 void LayersGroupBox::updateGui()
 {
+        auto state = geonkickApi->percussionSnapshot();
         for (auto i = 0; i < 3; i++) {
-                double amplitude = geonkickApi->getLayerAmplitude(static_cast<GeonkickApi::Layer>(i));
+                double amplitude = state->getLayerAmplitude(static_cast<GeonkickApi::Layer>(i));
                 double logVal;
                 if (amplitude > 0)
                         logVal = 20 * log10(amplitude);
@@ -74,3 +79,10 @@ void LayersGroupBox::updateGui()
                 layerSliders[i]->onSetValue(100 * (60 - fabs(logVal)) / 60);
         }
 }
+
+void LayersGroupBox::updateGui(const StateChanges &changes)
+{
+        auto id = geonkickApi->percussionSnapshot()->getId();
+        if (changes.contains(id, StateChanges::Parameter::Layers))
+                updateGui();
+}
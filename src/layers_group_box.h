@@ -30,12 +30,14 @@ class GeonkickSlider;
 class GeonkickCheckbox;
 class GeonkickApi;
 class GeonkickButton;
+class StateChanges;
 
 class LayersGroupBox: public GeonkickGroupBox
 {
  public:
         LayersGroupBox(GeonkickApi *api, GeonkickWidget *parent);
         void updateGui();
+        void updateGui(const StateChanges &changes);
 
  protected:
         void setLayerAmplitude(int layer, int val);
@@ -24,6 +24,7 @@
 #include "limiter.h"
 #include "geonkick_slider.h"
 #include "geonkick_api.h"
+#include "percussion_state.h"
 
 #include <RkTimer.h>
 
@@ -37,6 +38,7 @@ Limiter::Limiter(GeonkickApi *api, GeonkickWidget *parent)
         , meterTimer{new RkTimer(this, 30)}
         , levelerValueTimer{new RkTimer(this, 40)}
         , scaleImage{40, 329, RK_IMAGE_RC(meter_scale)}
+        , paintedMeterPixels{-1}
 {
         setFixedSize(65, scaleImage.height());
         faderSlider->setPosition(0, 0);
@@ -45,6 +47,9 @@ Limiter::Limiter(GeonkickApi *api, GeonkickWidget *parent)
         RK_ACT_BIND(levelerValueTimer, timeout, RK_ACT_ARGS(), this, onUpdateMeter());
         RK_ACT_BIND(meterTimer, timeout, RK_ACT_ARGS(), this, onUpdateMeterTimeout());
         onUpdateLimiter();
+        RK_ACT_BIND(geonkickApi, stateUpdated,
+                    RK_ACT_ARGS(const StateChanges &changes),
+                    this, onUpdateLimiter(changes));
         meterTimer->start();
         levelerValueTimer->start();
 }
@@ -52,22 +57,40 @@ Limiter::Limiter(GeonkickApi *api, GeonkickWidget *parent)
 void Limiter::paintWidget(RkPaintEvent *event)
 {
         RK_UNUSED(event);
-        RkImage img(width(), height());
-        RkPainter painter(&img);
-        painter.fillRect(rect(), background());
-        int x = faderSlider->width() + 10;
-        int meterWidth   = 7;
+        if (scaleLayer.width() != width() || scaleLayer.height() != height()) {
+                RkImage layer(width(), height());
+                RkPainter painter(&layer);
+                painter.fillRect(rect(), background());
+                painter.drawImage(scaleImage, 25, 0);
+                scaleLayer = layer;
+                RkImage im(width(), height());
+                meterImage = im;
+                paintedMeterPixels = -1;
+        }
+
+        auto pixels = meterPixels(meterValue);
+        if (pixels != paintedMeterPixels) {
+                int x = faderSlider->width() + 10;
+                int meterWidth   = 7;
+                int meterPadding = 2;
+                int meterInnerW  = meterWidth - 2 * meterPadding;
+                RkPainter painter(&meterImage);
+                painter.drawImage(scaleLayer, 0, 0);
+                painter.fillRect(RkRect(x + 2, meterPadding + 325 - pixels,
+                                        meterInnerW, pixels), RkColor(125, 200, 125));
+                paintedMeterPixels = pixels;
+        }
+
+        RkPainter paint(this);
+        paint.drawImage(meterImage, 0, 0);
+}
+
+int Limiter::meterPixels(int val) const
+{
         int meterHeight  = scaleImage.height() - 4;
         int meterPadding = 2;
-        int meterInnerW  = meterWidth - 2 * meterPadding;
         int meterInnerH  = meterHeight - 2 * meterPadding;
-
-        int meterPixels = meterInnerH * (static_cast<double>(meterValue) / 100);
-        painter.drawImage(scaleImage, 25, 0);
-        painter.fillRect(RkRect(x + 2, meterPadding + 325 - meterPixels,
-                                meterInnerW, meterPixels), RkColor(125, 200, 125));
-        RkPainter paint(this);
-        paint.drawImage(img, 0, 0);
+        return meterInnerH * (static_cast<double>(val) / 100);
 }
 
 void Limiter::onUpdateMeterTimeout()
@@ -101,8 +124,10 @@ void Limiter::onUpdateMeter()
 
 void Limiter::onSetMeterValue(int val)
 {
+        auto pixels = meterPixels(meterValue);
         meterValue = val;
-        update();
+        if (meterPixels(meterValue) != pixels)
+                update();
 }
 
 void Limiter::onUpdateLimiter()
@@ -114,6 +139,13 @@ void Limiter::onUpdateLimiter()
                 onSetFaderValue(toMeterValue(val));
 }
 
+void Limiter::onUpdateLimiter(const StateChanges &changes)
+{
+        auto state = geonkickApi->percussionSnapshot();
+        if (changes.contains(state->getId(), StateChanges::Parameter::Percussion))
+                onUpdateLimiter();
+}
+
 int Limiter::toMeterValue(double val) const
 {
         if (val < 1e-3)
@@ -32,6 +32,7 @@ class GeonkickSlider;
 class GeonkickLevel;
 class GeonkickApi;
 class RkTimer;
+class StateChanges;
 
 class Limiter: public GeonkickWidget
 {
@@ -45,6 +46,7 @@ class Limiter: public GeonkickWidget
                     RK_ARG_TYPE(int),
                     RK_ARG_VAL(val));
         void onUpdateLimiter();
+        void onUpdateLimiter(const StateChanges &changes);
         void onSetLimiterValue(int val);
 
  protected:
@@ -53,6 +55,7 @@ class Limiter: public GeonkickWidget
         void onUpdateMeterTimeout();
         void onSetFaderValue(int val);
         void onSetMeterValue(int val);
+        int meterPixels(int val) const;
 
  private:
         void paintWidget(RkPaintEvent *event) final;
@@ -62,6 +65,15 @@ class Limiter: public GeonkickWidget
         RkTimer *meterTimer;
         RkTimer *levelerValueTimer;
         RkImage scaleImage;
+
+        /**
+         * The background and the scale are rendered once into the scale
+         * layer, on the meter ticks only the meter bar is drawn over it.
+         * The widget is repainted only when the bar height changes.
+         */
+        RkImage scaleLayer;
+        RkImage meterImage;
+        int paintedMeterPixels;
 };
 
 #endif // GEONKICK_LIMITER_H
@@ -57,7 +57,6 @@ MainWindow::MainWindow(RkMain *app, GeonkickApi *api, const std::string &preset)
         setFixedSize(950, 760);
         setTitle(GEONKICK_NAME);
         geonkickApi->registerCallbacks(true);
-	RK_ACT_BIND(geonkickApi, stateChanged, RK_ACT_ARGS(), this, updateGui());
         createShortcuts();
         show();
 }
@@ -74,7 +73,6 @@ MainWindow::MainWindow(RkMain *app, GeonkickApi *api, const RkNativeWindowInfo &
         setFixedSize(950, 760);
         setTitle(GEONKICK_NAME);
         geonkickApi->registerCallbacks(true);
-        RK_ACT_BIND(geonkickApi, stateChanged, RK_ACT_ARGS(), this, updateGui());
         createShortcuts();
         show();
 }
@@ -143,7 +141,6 @@ bool MainWindow::init(void)
         topBar = new TopBar(this, geonkickApi);
         topBar->setX(10);
         topBar->show();
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), topBar, updateGui());
         RK_ACT_BIND(topBar, openFile, RK_ACT_ARGS(),
                     this, openFileDialog(FileDialog::Type::Open));
         RK_ACT_BIND(topBar, saveFile, RK_ACT_ARGS(),
@@ -162,19 +159,15 @@ bool MainWindow::init(void)
         envelopeWidget->setY(topBar->y() + topBar->height());
         envelopeWidget->setFixedSize(850, 340);
         envelopeWidget->show();
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), envelopeWidget, updateGui());
-        RK_ACT_BIND(envelopeWidget, requestUpdateGui, RK_ACT_ARGS(), this, updateGui());
         limiterWidget = new Limiter(geonkickApi, this);
         limiterWidget->setPosition(envelopeWidget->x() + envelopeWidget->width() + 8,
                                    envelopeWidget->y());
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), limiterWidget, onUpdateLimiter());
         limiterWidget->show();
 
         controlAreaWidget = new ControlArea(this, geonkickApi, oscillators);
         controlAreaWidget->setEnvelopeWidget(envelopeWidget);
         controlAreaWidget->setPosition(10, envelopeWidget->y() + envelopeWidget->height() + 3);
         controlAreaWidget->show();
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), controlAreaWidget, updateGui());
 
         kitModel = controlAreaWidget->getKitModel();
         RK_ACT_BIND(kitModel,
@@ -189,14 +182,12 @@ bool MainWindow::init(void)
         rightBar->setPosition(width() - rightBar->width(), 0);
         rightBar->show();
 
-        RK_ACT_BIND(this, updateGui, RK_ACT_ARGS(), controlAreaWidget, updateGui());
         RK_ACT_BIND(rightBar, showControls, RK_ACT_ARGS(), controlAreaWidget, showControls());
         RK_ACT_BIND(rightBar, showKit, RK_ACT_ARGS(), controlAreaWidget, showKit());
         RK_ACT_BIND(rightBar, showPresets, RK_ACT_ARGS(), controlAreaWidget, showPresets());
         if (geonkickApi->isStandalone() && !presetName.empty())
                 openPreset(presetName);
         topBar->setPresetName(geonkickApi->getPercussionName(geonkickApi->currentPercussion()));
-        updateGui();
         return true;
 }
 
@@ -248,11 +239,10 @@ void MainWindow::openPreset(const std::string &fileName)
         state->loadData(fileData);
         state->setId(geonkickApi->currentPercussion());
         geonkickApi->setPercussionState(state);
-        action geonkickApi->percussionUpdated(state->getId());
+        geonkickApi->notifyStateChanges(StateChanges(state->getId(), StateChanges::Parameter::All));
         file.close();
         geonkickApi->setCurrentWorkingPath("OpenPreset",
                                            filePath.has_parent_path() ? filePath.parent_path() : filePath);
-        updateGui();
 }
 
 void MainWindow::openFileDialog(FileDialog::Type type)
@@ -295,7 +285,7 @@ void MainWindow::keyPressEvent(RkKeyEvent *event)
                 state->setPlayingKey(geonkickApi->getPercussionPlayingKey(currId));
                 state->setChannel(geonkickApi->getPercussionChannel(currId));
                 geonkickApi->setPercussionState(state);
-                updateGui();
+                geonkickApi->notifyStateChanges(StateChanges(currId, StateChanges::Parameter::All));
         } else if (event->modifiers() & static_cast<int>(Rk::KeyModifiers::Control)
                    && (event->key() == Rk::Key::Key_h || event->key() == Rk::Key::Key_H)) {
                 envelopeWidget->hideEnvelope(true);
@@ -317,7 +307,8 @@ void MainWindow::keyPressEvent(RkKeyEvent *event)
         } else if ((event->modifiers() & static_cast<int>(Rk::KeyModifiers::Control))
                     && (event->key() == Rk::Key::Key_v || event->key() == Rk::Key::Key_V)) {
                 geonkickApi->pasteFromClipboard();
-                updateGui();
+                geonkickApi->notifyStateChanges(StateChanges(geonkickApi->currentPercussion(),
+                                                             StateChanges::Parameter::All));
         }
 }
 
@@ -23,6 +23,7 @@
 
 #include "oscillator_group_box.h"
 #include "oscillator.h"
+#include "percussion_state.h"
 #include "geonkick_widget.h"
 #include "geonkick_button.h"
 #include "knob.h"
@@ -62,8 +63,9 @@ RK_DECLARE_IMAGE_RC(noise_type_brownian);
 RK_DECLARE_IMAGE_RC(noise_type_brownian_active);
 RK_DECLARE_IMAGE_RC(knob_bk_image);
 
-OscillatorGroupBox::OscillatorGroupBox(GeonkickWidget *parent, Oscillator *osc)
+OscillatorGroupBox::OscillatorGroupBox(GeonkickWidget *parent, GeonkickApi *api, Oscillator *osc)
           : GeonkickGroupBox{parent}
+           , geonkickApi{api}
            , oscillator{osc}
            , oscillatorCheckbox{nullptr}
            , fmCheckbox{nullptr}
@@ -121,6 +123,9 @@ OscillatorGroupBox::OscillatorGroupBox(GeonkickWidget *parent, Oscillator *osc)
         createEvelopeGroupBox();
         createFilterGroupBox();
         updateGui();
+        RK_ACT_BIND(geonkickApi, stateUpdated,
+                    RK_ACT_ARGS(const StateChanges &changes),
+                    this, updateGui(changes));
 }
 
 void OscillatorGroupBox::createWaveFunctionGroupBox()
@@ -224,6 +229,8 @@ void OscillatorGroupBox::createEvelopeGroupBox()
                     RK_ACT_ARGS(double val),
                     oscillator,
                     setAmplitude(val));
+        RK_ACT_BIND(envelopeAmplitudeKnob, draggingChanged, RK_ACT_ARGS(bool b),
+                    oscillator, enableDraftSynthesis(b));
 
         if (oscillator->type() == Oscillator::Type::Noise) {
                 noiseWhiteButton = new GeonkickButton(amplitudeEnvelopeBox);
@@ -271,6 +278,8 @@ void OscillatorGroupBox::createEvelopeGroupBox()
                             RK_ACT_ARGS(double val),
                             oscillator,
                             setFrequency(val));
+                RK_ACT_BIND(frequencyAmplitudeKnob, draggingChanged, RK_ACT_ARGS(bool b),
+                            oscillator, enableDraftSynthesis(b));
                 frequencyAmplitudeKnob->show();
         }
 }
@@ -290,6 +299,8 @@ void OscillatorGroupBox::createFilterGroupBox()
                     oscillator, setFilterFrequency(val));
         RK_ACT_BIND(filterBox, resonanceChanged, RK_ACT_ARGS(double val),
                     oscillator, setFilterQFactor(val));
+        RK_ACT_BIND(filterBox, draggingChanged, RK_ACT_ARGS(bool b),
+                    oscillator, enableDraftSynthesis(b));
         RK_ACT_BIND(filterBox, typeChanged, RK_ACT_ARGS(GeonkickApi::FilterType type),
                     oscillator, setFilterType(type));
 }
@@ -384,35 +395,46 @@ void OscillatorGroupBox::groupBoxLabelUpdated(bool state)
 
 void OscillatorGroupBox::updateGui()
 {
-        oscillatorCheckbox->setPressed(oscillator->isEnabled());
+        auto state = geonkickApi->percussionSnapshot();
+        auto index = static_cast<int>(oscillator->type());
+        auto function = state->oscillatorFunction(index);
+        oscillatorCheckbox->setPressed(state->isOscillatorEnabled(index));
         if (oscillator->type() == Oscillator::Type::Noise) {
                 noiseWhiteButton->setPressed(false);
                 noiseBrownianButton->setPressed(false);
-                if (oscillator->function() == Oscillator::FunctionType::NoiseWhite)
+                if (function == Oscillator::FunctionType::NoiseWhite)
                         noiseWhiteButton->setPressed(true);
                 else
                         noiseBrownianButton->setPressed(true);
-                seedSlider->onSetValue(oscillator->getSeed() / 10);
+                seedSlider->onSetValue(state->oscillatorSeed(index) / 10);
         } else {
-                sineButton->setPressed(oscillator->function() == Oscillator::FunctionType::Sine);
-                squareButton->setPressed(oscillator->function() == Oscillator::FunctionType::Square);
-                triangleButton->setPressed(oscillator->function() == Oscillator::FunctionType::Triangle);
-                sawtoothButton->setPressed(oscillator->function() == Oscillator::FunctionType::Sawtooth);
-                sampleButton->setPressed(oscillator->function() == Oscillator::FunctionType::Sample);
-                phaseSlider->onSetValue(oscillator->getPhase());
+                sineButton->setPressed(function == Oscillator::FunctionType::Sine);
+                squareButton->setPressed(function == Oscillator::FunctionType::Square);
+                triangleButton->setPressed(function == Oscillator::FunctionType::Triangle);
+                sawtoothButton->setPressed(function == Oscillator::FunctionType::Sawtooth);
+                sampleButton->setPressed(function == Oscillator::FunctionType::Sample);
+                phaseSlider->onSetValue(state->oscillatorPhase(index));
         }
 
-        envelopeAmplitudeKnob->setCurrentValue(oscillator->amplitude());
+        envelopeAmplitudeKnob->setCurrentValue(state->oscillatorAmplitue(index));
         if (oscillator->type() != Oscillator::Type::Noise)
-                frequencyAmplitudeKnob->setCurrentValue(oscillator->frequency());
+                frequencyAmplitudeKnob->setCurrentValue(state->oscillatorFrequency(index));
 
         if (oscillator->type() == Oscillator::Type::Oscillator1)
-                fmCheckbox->setPressed(oscillator->isFm());
+                fmCheckbox->setPressed(state->isOscillatorAsFm(index));
 
-        filterBox->enable(oscillator->isFilterEnabled());
-        filterBox->setResonance(oscillator->filterQFactor());
-        filterBox->setCutOff(oscillator->filterFrequency());
-        filterBox->setType(oscillator->filter());
+        filterBox->enable(state->isOscillatorFilterEnabled(index));
+        filterBox->setResonance(state->oscillatorFilterFactor(index));
+        filterBox->setCutOff(state->oscillatorFilterCutOffFreq(index));
+        filterBox->setType(state->oscillatorFilterType(index));
+}
+
+void OscillatorGroupBox::updateGui(const StateChanges &changes)
+{
+        auto id = geonkickApi->percussionSnapshot()->getId();
+        auto index = static_cast<int>(oscillator->type());
+        if (changes.contains(id, StateChanges::oscillator(index)))
+                updateGui();
 }
 
 void OscillatorGroupBox::browseSample()
@@ -34,12 +34,14 @@ class GeonkickCheckbox;
 class Knob;
 class GeonkickSlider;
 class Filter;
+class StateChanges;
 
 class OscillatorGroupBox: public GeonkickGroupBox
 {
  public:
-        OscillatorGroupBox(GeonkickWidget *parent, Oscillator *osc);
+        OscillatorGroupBox(GeonkickWidget *parent, GeonkickApi *api, Oscillator *osc);
         void updateGui();
+        void updateGui(const StateChanges &changes);
         RK_DECL_ACT(oscillatorFunctionChanged,
                     oscillatorFunctionChanged(int index),
                     RK_ARG_TYPE(int),
@@ -62,6 +64,7 @@ class OscillatorGroupBox: public GeonkickGroupBox
         void browseSample();
 
  private:
+        GeonkickApi *geonkickApi;
         Oscillator *oscillator;
         GeonkickButton *oscillatorCheckbox;
         GeonkickButton *fmCheckbox;
@@ -0,0 +1,126 @@
+/**
+ * File name: peak_pyramid.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "peak_pyramid.h"
+
+PeakPyramid::PeakPyramid(const SampleRef &sample)
+        : samplesBuffer{sample}
+{
+        auto n = samplesBuffer.size();
+        if (n < 2)
+                return;
+
+        const auto *samples = samplesBuffer.data();
+        std::vector<Peak> level((n + 1) / 2);
+        for (decltype(level.size()) i = 0; i < level.size(); i++) {
+                auto a = samples[2 * i];
+                auto b = 2 * i + 1 < n ? samples[2 * i + 1] : a;
+                level[i] = {std::min(a, b), std::max(a, b)};
+        }
+        peakLevels.push_back(std::move(level));
+
+        while (peakLevels.back().size() > 1) {
+                const auto &prev = peakLevels.back();
+                std::vector<Peak> next((prev.size() + 1) / 2);
+                for (decltype(next.size()) i = 0; i < next.size(); i++) {
+                        next[i] = prev[2 * i];
+                        if (2 * i + 1 < prev.size()) {
+                                next[i].min = std::min(next[i].min, prev[2 * i + 1].min);
+                                next[i].max = std::max(next[i].max, prev[2 * i + 1].max);
+                        }
+                }
+                peakLevels.push_back(std::move(next));
+        }
+}
+
+const SampleRef& PeakPyramid::sample() const
+{
+        return samplesBuffer;
+}
+
+size_t PeakPyramid::size() const
+{
+        return samplesBuffer.size();
+}
+
+bool PeakPyramid::empty() const
+{
+        return samplesBuffer.empty();
+}
+
+PeakPyramid::Peak PeakPyramid::peak(size_t start, size_t end) const
+{
+        end = std::min(end, samplesBuffer.size());
+        if (start >= end)
+                return {0, 0};
+
+        const auto *samples = samplesBuffer.data();
+        Peak res = {samples[start], samples[start]};
+        auto addPeak = [&res](const Peak &p) {
+                res.min = std::min(res.min, p.min);
+                res.max = std::max(res.max, p.max);
+        };
+
+        // The range is reduced level by level. The unpaired blocks
+        // at the ends are taken from the current level.
+        if (start & 1)
+                addPeak({samples[start], samples[start]});
+        if (end & 1)
+                addPeak({samples[end - 1], samples[end - 1]});
+        start = (start + 1) / 2;
+        end /= 2;
+
+        for (const auto &level : peakLevels) {
+                if (start >= end)
+                        break;
+                if (start & 1)
+                        addPeak(level[start++]);
+                if (end & 1)
+                        addPeak(level[--end]);
+                start /= 2;
+                end /= 2;
+        }
+
+        return res;
+}
+
+void PeakPyramid::columnPeaks(double start, double end, std::vector<Peak> &columns) const
+{
+        if (columns.empty())
+                return;
+
+        if (samplesBuffer.empty()) {
+                std::fill(columns.begin(), columns.end(), Peak{0, 0});
+                return;
+        }
+
+        auto n = samplesBuffer.size();
+        auto k = (end - start) * n / columns.size();
+        auto offset = start * n;
+        for (decltype(columns.size()) i = 0; i < columns.size(); i++) {
+                auto a = static_cast<size_t>(std::clamp(offset + k * i, 0.0, static_cast<double>(n - 1)));
+                auto b = static_cast<size_t>(std::clamp(offset + k * (i + 1), 0.0, static_cast<double>(n)));
+                columns[i] = peak(a, std::max(b, a + 1));
+        }
+}
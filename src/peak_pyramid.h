@@ -0,0 +1,65 @@
+/**
+ * File name: peak_pyramid.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GEONKICK_PEAK_PYRAMID_H
+#define GEONKICK_PEAK_PYRAMID_H
+
+#include "globals.h"
+#include "sample_ref.h"
+
+/**
+ * Min/max peaks of a buffer at multiple resolutions.
+ *
+ * Each level halves the previous one, the first level being
+ * the samples of the shared sample itself. The peak of any
+ * range of samples is found in O(log n) by combining the blocks
+ * of the levels that cover the range, so the waveform can be
+ * drawn in O(width) at any zoom.
+ */
+class PeakPyramid {
+ public:
+        struct Peak {
+                gkick_real min;
+                gkick_real max;
+        };
+
+        explicit PeakPyramid(const SampleRef &sample);
+        const SampleRef& sample() const;
+        size_t size() const;
+        bool empty() const;
+        Peak peak(size_t start, size_t end) const;
+
+        /**
+         * Fills the peaks of the columns the range [start, end)
+         * of the buffer is divided into. The range is given as
+         * fractions of the buffer size.
+         */
+        void columnPeaks(double start, double end, std::vector<Peak> &columns) const;
+
+ private:
+        SampleRef samplesBuffer;
+        std::vector<std::vector<Peak>> peakLevels;
+};
+
+#endif // GEONKICK_PEAK_PYRAMID_H
@@ -0,0 +1,109 @@
+/**
+ * File name: percussion_params.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "percussion_params.h"
+#include "percussion_state.h"
+
+PercussionParams::PercussionParams(PercussionState &state)
+{
+        envelopesData.reserve(GKICK_SYNTH_ENVELOPES_NUMBER + GKICK_OSC_NUMBER * GKICK_OSC_ENVELOPES_NUMBER);
+        oscillatorsSamples.reserve(GKICK_OSC_NUMBER);
+        memset(&synthParams, 0, sizeof(synthParams));
+
+        auto name = state.getName();
+        strncpy(synthParams.name, name.c_str(), sizeof(synthParams.name) - 1);
+        synthParams.length = state.getKickLength() / 1000;
+        synthParams.amplitude = state.getKickAmplitude();
+        for (auto i = 0; i < GKICK_OSC_GROUPS_NUMBER; i++) {
+                synthParams.layers[i] = state.isLayerEnabled(static_cast<GeonkickApi::Layer>(i));
+                synthParams.layers_amplitude[i] = state.getLayerAmplitude(static_cast<GeonkickApi::Layer>(i));
+        }
+        synthParams.filter_enabled = state.isKickFilterEnabled();
+        synthParams.filter_type = static_cast<enum gkick_filter_type>(state.getKickFilterType());
+        synthParams.filter_cutoff = state.getKickFilterFrequency();
+        synthParams.filter_factor = state.getKickFilterQFactor();
+        for (auto envelope : {GeonkickApi::EnvelopeType::Amplitude, GeonkickApi::EnvelopeType::FilterCutOff,
+                              GeonkickApi::EnvelopeType::DistortionDrive, GeonkickApi::EnvelopeType::DistortionVolume}) {
+                setEnvelope(synthParams.envelopes[static_cast<int>(envelope)],
+                            state.getKickEnvelopePoints(envelope));
+        }
+        synthParams.compressor_enabled = state.isCompressorEnabled();
+        synthParams.compressor_attack = state.getCompressorAttack();
+        synthParams.compressor_release = state.getCompressorRelease();
+        synthParams.compressor_threshold = state.getCompressorThreshold();
+        synthParams.compressor_ratio = state.getCompressorRatio();
+        synthParams.compressor_knee = state.getCompressorKnee();
+        synthParams.compressor_makeup = state.getCompressorMakeup();
+        synthParams.distortion_enabled = state.isDistortionEnabled();
+        synthParams.distortion_in_limiter = state.getDistortionInLimiter();
+        synthParams.distortion_volume = state.getDistortionVolume();
+        synthParams.distortion_drive = state.getDistortionDrive();
+
+        for (auto i = 0; i < GKICK_OSC_GROUPS_NUMBER; i++) {
+                state.setCurrentLayer(static_cast<GeonkickApi::Layer>(i));
+                for (auto osc = 0; osc < GKICK_OSC_GROUP_SIZE; osc++) {
+                        auto &oscParams = synthParams.oscillators[i * GKICK_OSC_GROUP_SIZE + osc];
+                        bool isNoise = osc == static_cast<int>(GeonkickApi::OscillatorType::Noise);
+                        oscParams.enabled = state.isOscillatorEnabled(osc);
+                        oscParams.function = static_cast<enum geonkick_osc_func_type>(state.oscillatorFunction(osc));
+                        oscParams.phase = state.oscillatorPhase(osc);
+                        oscParams.seed = state.oscillatorSeed(osc);
+                        oscParams.amplitude = state.oscillatorAmplitue(osc);
+                        oscParams.frequency = state.oscillatorFrequency(osc);
+                        oscParams.is_fm = state.isOscillatorAsFm(osc);
+                        oscParams.filter_enabled = state.isOscillatorFilterEnabled(osc);
+                        oscParams.filter_type = static_cast<enum gkick_filter_type>(state.oscillatorFilterType(osc));
+                        oscParams.filter_cutoff = state.oscillatorFilterCutOffFreq(osc);
+                        oscParams.filter_factor = state.oscillatorFilterFactor(osc);
+                        setEnvelope(oscParams.envelopes[static_cast<int>(GeonkickApi::EnvelopeType::Amplitude)],
+                                    state.oscillatorEnvelopePoints(osc, GeonkickApi::EnvelopeType::Amplitude));
+                        if (!isNoise) {
+                                setEnvelope(oscParams.envelopes[static_cast<int>(GeonkickApi::EnvelopeType::Frequency)],
+                                            state.oscillatorEnvelopePoints(osc, GeonkickApi::EnvelopeType::Frequency));
+                        }
+                        setEnvelope(oscParams.envelopes[static_cast<int>(GeonkickApi::EnvelopeType::FilterCutOff)],
+                                    state.oscillatorEnvelopePoints(osc, GeonkickApi::EnvelopeType::FilterCutOff));
+                        oscillatorsSamples.push_back(state.getOscillatorSample(osc));
+                        oscParams.sample = oscillatorsSamples.back().get();
+                }
+        }
+}
+
+const struct gkick_synth_params* PercussionParams::get() const
+{
+        return &synthParams;
+}
+
+void PercussionParams::setEnvelope(struct gkick_envelope_params &envelope,
+                                   const std::vector<RkRealPoint> &points)
+{
+        std::vector<gkick_real> buff;
+        for (const auto &point: points) {
+                buff.push_back(point.x());
+                buff.push_back(point.y());
+        }
+        envelopesData.push_back(std::move(buff));
+        envelope.points = envelopesData.back().data();
+        envelope.npoints = points.size();
+}
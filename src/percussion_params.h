@@ -0,0 +1,58 @@
+/**
+ * File name: percussion_params.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GEONKICK_PERCUSSION_PARAMS_H
+#define GEONKICK_PERCUSSION_PARAMS_H
+
+#include "globals.h"
+#include "sample_ref.h"
+
+#include <RkRealPoint.h>
+
+class PercussionState;
+
+/**
+ * Synthesis parameters of a percussion state in the format of the
+ * DSP API. Owns the envelopes points the parameters point to and
+ * the references of the oscillators samples, which are shared with
+ * the synthesizer without copying.
+ */
+class PercussionParams {
+ public:
+        explicit PercussionParams(PercussionState &state);
+        PercussionParams(const PercussionParams &other) = delete;
+        PercussionParams& operator=(const PercussionParams &other) = delete;
+        const struct gkick_synth_params* get() const;
+
+ protected:
+        void setEnvelope(struct gkick_envelope_params &envelope,
+                         const std::vector<RkRealPoint> &points);
+
+ private:
+        struct gkick_synth_params synthParams;
+        std::vector<std::vector<gkick_real>> envelopesData;
+        std::vector<SampleRef> oscillatorsSamples;
+};
+
+#endif // GEONKICK_PERCUSSION_PARAMS_H
@@ -0,0 +1,84 @@
+/**
+ * File name: percussion_renderer.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "percussion_renderer.h"
+#include "percussion_state.h"
+#include "percussion_params.h"
+
+PercussionRenderer::PercussionRenderer()
+        : renderContext{nullptr}
+        , renderSampleRate{0}
+{
+        if (geonkick_render_context_new(&renderContext) != GEONKICK_OK) {
+                GEONKICK_LOG_ERROR("can't create render context");
+                renderContext = nullptr;
+        }
+        geonkick_get_sample_rate(nullptr, &renderSampleRate);
+}
+
+PercussionRenderer::~PercussionRenderer()
+{
+        if (renderContext)
+                geonkick_render_context_free(&renderContext);
+}
+
+bool PercussionRenderer::isValid() const
+{
+        return renderContext != nullptr;
+}
+
+int PercussionRenderer::sampleRate() const
+{
+        return renderSampleRate;
+}
+
+bool PercussionRenderer::render(PercussionState &state, std::vector<gkick_real> &data)
+{
+        if (!renderContext)
+                return false;
+
+        PercussionParams params(state);
+        size_t length = 0;
+        if (geonkick_render_context_set_params(renderContext, params.get()) != GEONKICK_OK
+            || geonkick_render_context_get_length(renderContext, &length) != GEONKICK_OK) {
+                return false;
+        }
+
+        data.resize(length);
+        if (geonkick_render_context_render(renderContext,
+                                           data.data(),
+                                           data.size(),
+                                           &length) != GEONKICK_OK) {
+                return false;
+        }
+        data.resize(length);
+        return true;
+}
+
+bool PercussionRenderer::render(const std::string &state, std::vector<gkick_real> &data)
+{
+        PercussionState percussionState;
+        percussionState.loadData(state);
+        return render(percussionState, data);
+}
@@ -0,0 +1,55 @@
+/**
+ * File name: percussion_renderer.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GEONKICK_PERCUSSION_RENDERER_H
+#define GEONKICK_PERCUSSION_RENDERER_H
+
+#include "globals.h"
+
+class PercussionState;
+
+/**
+ * Renders percussions offline in a detached render context, without
+ * loading them into the instance synthesizers. A renderer must be used
+ * by one thread at a time, many renderers can run in parallel.
+ */
+class PercussionRenderer {
+ public:
+        PercussionRenderer();
+        ~PercussionRenderer();
+        PercussionRenderer(const PercussionRenderer &other) = delete;
+        PercussionRenderer& operator=(const PercussionRenderer &other) = delete;
+        bool isValid() const;
+        int sampleRate() const;
+        bool render(PercussionState &state, std::vector<gkick_real> &data);
+
+        /* Renders the percussion from the JSON state data. */
+        bool render(const std::string &state, std::vector<gkick_real> &data);
+
+ private:
+        struct gkick_render_context *renderContext;
+        int renderSampleRate;
+};
+
+#endif // GEONKICK_PERCUSSION_RENDERER_H
@@ -22,10 +22,10 @@
  */
 
 #include "percussion_state.h"
+#include "binary_state.h"
+#include "state_json_handler.h"
 #include "base64.h"
 
-#include <iomanip>
-
 PercussionState::PercussionState()
         : appVersion{GEONKICK_VERSION}
         , kickId{0}
@@ -76,49 +76,20 @@ bool PercussionState::loadFile(const std::string &file)
 
         std::string fileData((std::istreambuf_iterator<char>(sfile)),
                              (std::istreambuf_iterator<char>()));
-        loadData(fileData);
-        return true;
+        sfile.close();
+        return parseJson(fileData);
 }
 
 void PercussionState::loadData(const std::string &data)
 {
-        rapidjson::Document document;
-        document.Parse(data.c_str());
-        loadObject(document);
+        std::string jsonData = data;
+        parseJson(jsonData);
 }
 
-void PercussionState::loadObject(const rapidjson::Value &obj)
+bool PercussionState::parseJson(std::string &data)
 {
-        if (!obj.IsObject())
-                return;
-
-        bool kickParsed = false;
-        for (const auto &m: obj.GetObject()) {
-                if (m.name == "kick" && m.value.IsObject()) {
-                        parseKickObject(m.value);
-                        kickParsed = true;
-                        break;
-                }
-        }
-
-        if (!kickParsed)
-                return;
-
-        for (const auto &m: obj.GetObject()) {
-                for (decltype(layers.size()) i = 0; i < layers.size(); i++) {
-                        setCurrentLayer(static_cast<GeonkickApi::Layer>(i));
-                        if (m.name == ("osc" + std::to_string(0 + i * GKICK_OSC_GROUP_SIZE)).c_str()) {
-                                parseOscillatorObject(0, m.value);
-                                break;
-                        } else if (m.name == ("osc" + std::to_string(1 + i * GKICK_OSC_GROUP_SIZE)).c_str()) {
-                                parseOscillatorObject(1, m.value);
-                                break;
-                        } else if (m.name == ("osc" + std::to_string(2 + i * GKICK_OSC_GROUP_SIZE)).c_str()) {
-                                parseOscillatorObject(2, m.value);
-                                break;
-                        }
-                }
-        }
+        PercussionJsonHandler handler(this);
+        return parseStateJson(data, handler);
 }
 
 size_t PercussionState::getId() const
@@ -206,212 +177,6 @@ void PercussionState::initOscillators()
         }
 }
 
-void PercussionState::parseKickObject(const rapidjson::Value &kick)
-{
-        if (kick.IsNull() || !kick.IsObject())
-                return;
-
-        bool backward = true;
-        for (const auto &e: kick.GetObject()) {
-                if (e.name == "PercussionAppVersion" && e.value.IsInt()) {
-                        appVersion = e.value.GetInt();
-                        backward = false;
-                        break;
-                }
-        }
-
-        if (backward) {
-                GEONKICK_LOG_INFO("PercussionAppVersion missing, old preset");
-                appVersion = 0;
-        }
-
-        for (const auto &m: kick.GetObject()) {
-                if (m.name == "name" && m.value.IsString())
-                        setName(m.value.GetString());
-		if (m.name == "id" && m.value.IsInt())
-                        setId(m.value.GetInt());
-                if (m.name == "channel" && m.value.IsInt())
-                        setChannel(m.value.GetInt());
-                if (m.name == "mute" && m.value.IsBool())
-                        setMute(m.value.GetBool());
-                if (m.name == "solo" && m.value.IsBool())
-                        setSolo(m.value.GetBool());
-                if (m.name == "playing_key" && m.value.IsInt())
-                        setPlayingKey(m.value.GetInt());
-                if (m.name == "limiter" && m.value.IsDouble())
-                        setLimiterValue(m.value.GetDouble());
-
-                if (m.name == "tuned_output" && m.value.IsBool())
-                        tuneOutput(m.value.GetBool());
-
-                if (m.name == "layers" && m.value.IsArray()) {
-                        layers = {false, false, false};
-                        for (const auto &el: m.value.GetArray())
-                                if (el.IsInt())
-                                        setLayerEnabled(static_cast<GeonkickApi::Layer>(el.GetInt()), true);
-                }
-
-                if (m.name == "layers_amplitude" && m.value.IsArray()) {
-                        layersAmplitude = {1.0, 1.0, 1.0};
-                        int i = 0;
-                        for (const auto &el: m.value.GetArray()) {
-                                if (el.IsDouble())
-                                        setLayerAmplitude(static_cast<GeonkickApi::Layer>(i), el.GetDouble());
-                                i++;
-                        }
-                }
-
-                if (m.name == "ampl_env" && m.value.IsObject()) {
-                        for (const auto &el: m.value.GetObject()) {
-                                if (el.name == "length" && el.value.IsDouble())
-                                        setKickLength(el.value.GetDouble());
-                                if (el.name == "amplitude" && el.value.IsDouble())
-                                        setKickAmplitude(el.value.GetDouble());
-                                if (el.name == "points" && el.value.IsArray()) {
-                                        setKickEnvelopePoints(GeonkickApi::EnvelopeType::Amplitude,
-                                                              parseEnvelopeArray(el.value));
-                                }
-                        }
-                }
-
-                if (m.name == "filter" && m.value.IsObject()) {
-                        for (const auto &el: m.value.GetObject()) {
-                                if (el.name == "enabled" && el.value.IsBool())
-                                        enableKickFilter(el.value.GetBool());
-                                if (el.name == "cutoff" && el.value.IsDouble())
-                                        setKickFilterFrequency(el.value.GetDouble());
-                                if (el.name == "factor" && el.value.IsDouble()) {
-                                        double val = el.value.GetDouble();
-                                        if (appVersion < 0x011000 && val > 0.00001f)
-                                                val = 10.0 / val;
-                                        setKickFilterQFactor(val);
-                                }
-                                if (el.name == "type" && el.value.IsInt())
-                                        setKickFilterType(static_cast<GeonkickApi::FilterType>(el.value.GetInt()));
-                                if (el.name == "cutoff_env" && el.value.IsArray()) {
-                                        setKickEnvelopePoints(GeonkickApi::EnvelopeType::FilterCutOff,
-                                                              parseEnvelopeArray(el.value));
-                                }
-                        }
-                }
-
-                if (m.name == "compressor" && m.value.IsObject()) {
-                        for (const auto &el: m.value.GetObject()) {
-                                if (el.name == "enabled" && el.value.IsBool())
-                                        enableCompressor(el.value.GetBool());
-                                if (el.name == "attack" && el.value.IsDouble())
-                                        setCompressorAttack(el.value.GetDouble());
-                                if (el.name == "release" && el.value.IsDouble())
-                                        setCompressorRelease(el.value.GetDouble());
-                                if (el.name == "threshold" && el.value.IsDouble())
-                                        setCompressorThreshold(el.value.GetDouble());
-                                if (el.name == "ratio" && el.value.IsDouble())
-                                        setCompressorRatio(el.value.GetDouble());
-                                if (el.name == "knee" && el.value.IsDouble())
-                                        setCompressorKnee(el.value.GetDouble());
-                                if (el.name == "makeup" && el.value.IsDouble())
-                                        setCompressorMakeup(el.value.GetDouble());
-
-                        }
-                }
-
-                if (m.name == "distortion" && m.value.IsObject()) {
-                        for (const auto &el: m.value.GetObject()) {
-                                if (el.name == "enabled" && el.value.IsBool())
-                                        enableDistortion(el.value.GetBool());
-                                if (el.name == "in_limiter" && el.value.IsDouble())
-                                        setDistortionInLimiter(el.value.GetDouble());
-                                if (el.name == "volume" && el.value.IsDouble())
-                                        setDistortionVolume(el.value.GetDouble());
-                                if (el.name == "drive" && el.value.IsDouble())
-                                        setDistortionDrive(el.value.GetDouble());
-				if (el.name == "drive_env" && el.value.IsArray())
-					setKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionDrive,
-							      parseEnvelopeArray(el.value));
-                                if (el.name == "volume_env" && el.value.IsArray())
-					setKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionVolume,
-							      parseEnvelopeArray(el.value));
-
-                        }
-                }
-        }
-}
-
-void PercussionState::parseOscillatorObject(int index,  const rapidjson::Value &osc)
-{
-        if (osc.IsNull() || !osc.IsObject())
-                return;
-
-        for (const auto &m: osc.GetObject()) {
-                if (m.name == "enabled" && m.value.IsBool())
-                        setOscillatorEnabled(index, m.value.GetBool());
-                if (m.name == "is_fm" && m.value.IsBool())
-                        setOscillatorAsFm(index, m.value.GetBool());
-                if (m.name == "sample" && m.value.IsString())
-                        setOscillatorSample(index, fromBase64F(std::string(m.value.GetString())));
-                if (m.name == "function" && m.value.IsInt())
-                        setOscillatorFunction(index, static_cast<GeonkickApi::FunctionType>(m.value.GetInt()));
-                if (m.name == "phase" && m.value.IsDouble())
-                        setOscillatorPhase(index, m.value.GetDouble());
-                if (m.name == "seed" && m.value.IsInt())
-                        setOscillatorSeed(index, m.value.GetInt());
-                if (m.name == "ampl_env" && m.value.IsObject()) {
-                        for (const auto &el: m.value.GetObject()) {
-                                if (el.name == "amplitude" && el.value.IsDouble())
-                                        setOscillatorAmplitue(index, el.value.GetDouble());
-                                if (el.name == "points" && el.value.IsArray())
-                                        setOscillatorEnvelopePoints(index, parseEnvelopeArray(el.value),
-                                                                    GeonkickApi::EnvelopeType::Amplitude);
-                        }
-                }
-
-                if (static_cast<GeonkickApi::OscillatorType>(index) != GeonkickApi::OscillatorType::Noise) {
-                        if (m.name == "freq_env" && m.value.IsObject()) {
-                                for (const auto &el: m.value.GetObject()) {
-                                        if (el.name == "amplitude" && el.value.IsDouble())
-                                                setOscillatorFrequency(index, el.value.GetDouble());
-                                        if (el.name == "points" && el.value.IsArray())
-                                                setOscillatorEnvelopePoints(index, parseEnvelopeArray(el.value),
-                                                                            GeonkickApi::EnvelopeType::Frequency);
-                                }
-                        }
-                }
-
-                if (m.name == "filter" && m.value.IsObject()) {
-                        for (const auto &el: m.value.GetObject()) {
-                                if (el.name == "enabled" && el.value.IsBool())
-                                        setOscillatorFilterEnabled(index, el.value.GetBool());
-                                if (el.name == "cutoff" && el.value.IsDouble())
-                                        setOscillatorFilterCutOffFreq(index, el.value.GetDouble());
-                                if (el.name == "factor" && el.value.IsDouble()) {
-                                        double val = el.value.GetDouble();
-                                        if (appVersion < 0x011000)
-                                                val *= 10;
-                                        setOscillatorFilterFactor(index, val);
-                                }
-                                if (el.name == "type" && el.value.IsInt())
-                                        setOscillatorFilterType(index, static_cast<GeonkickApi::FilterType>(el.value.GetInt()));
-                                if (el.name == "cutoff_env" && el.value.IsArray()) {
-                                        setOscillatorEnvelopePoints(index, parseEnvelopeArray(el.value),
-                                                                    GeonkickApi::EnvelopeType::FilterCutOff);
-                                }
-
-                        }
-                }
-        }
-}
-
-std::vector<RkRealPoint> PercussionState::parseEnvelopeArray(const rapidjson::Value &envelopeArray)
-{
-        std::vector<RkRealPoint> points;
-        for (const auto &el: envelopeArray.GetArray())
-                if (el.IsArray() && el.GetArray().Size() == 2)
-                        points.emplace_back(RkRealPoint(el.GetArray()[0].GetDouble(),
-                                                        el.GetArray()[1].GetDouble()));
-
-        return points;
-}
-
 void PercussionState::setLimiterValue(double val)
 {
         limiterValue = val;
@@ -833,205 +598,358 @@ double PercussionState::getDistortionDrive() const
 
 std::string PercussionState::toJson() const
 {
-        std::ostringstream jsonStream;
-        jsonStream << "{" << std::endl;
-        oscJson(jsonStream);
-        kickJson(jsonStream);
-        jsonStream << "}" << std::endl;
-        return jsonStream.str();
+        rapidjson::StringBuffer buffer(nullptr, estimatedJsonSize());
+        JsonWriter writer(buffer);
+        writer.SetMaxDecimalPlaces(5);
+        writeJson(writer);
+        return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+void PercussionState::writeJson(JsonWriter &writer) const
+{
+        writer.StartObject();
+        oscJson(writer);
+        kickJson(writer);
+        writer.EndObject();
 }
 
-void PercussionState::oscJson(std::ostringstream &jsonStream) const
+size_t PercussionState::estimatedJsonSize() const
 {
+        // Approximate size of the fixed fields and of an envelope point.
+        constexpr size_t kickSize = 2048;
+        constexpr size_t oscillatorSize = 512;
+        constexpr size_t pointSize = 24;
+
+        size_t size = kickSize;
+        size += pointSize * (kickEnvelopePoints.size()
+                             + kickFilterCutOffEnvelope.size()
+                             + kickDistortionDriveEnvelope.size()
+                             + kickDistortionVolumeEnvelope.size());
         for (const auto& val: oscillators) {
-                jsonStream << "\"osc" << val.first << "\": {" << std::endl;
-                jsonStream << "\"enabled\": " << (val.second->isEnabled ? "true" : "false") << ", " << std::endl;
-                jsonStream << "\"is_fm\": " << (val.second->isFm ? "true" : "false") << ", " << std::endl;
-                if (val.second->function == GeonkickApi::FunctionType::Sample && !val.second->sample.empty())
-                        jsonStream <<  "\"sample\": \"" << toBase64F(val.second->sample) << "\"," << std::endl;
-                jsonStream <<  "\"function\": " << static_cast<int>(val.second->function) << "," << std::endl;
-                jsonStream <<  "\"phase\": " << std::fixed << std::setprecision(5)
-                           << val.second->phase << ", " << std::endl;
-                jsonStream <<  "\"seed\": " << val.second->seed << ", " << std::endl;
-                jsonStream << "\"ampl_env\": {" << std::endl;
-                jsonStream << "\"amplitude\": "  << std::fixed << std::setprecision(5)
-                           << val.second->amplitude << ", " << std::endl;
-                jsonStream << "\"points\": [" << std::endl;
-                bool first = true;
-                for (const auto &point: val.second->amplitudeEnvelope) {
-                        if (first)
-                                first = false;
-                        else
-                                jsonStream << ", ";
-                        jsonStream << "[ " << std::fixed << std::setprecision(5) << point.x()
-                                   << " , " << std::fixed << std::setprecision(5) << point.y() << "]";
-                }
-                jsonStream << "]" << std::endl; // points
-                jsonStream << "}," << std::endl; // ampl_env
-
-                jsonStream << "\"freq_env\": {" << std::endl;
-                jsonStream << "\"amplitude\": " << val.second->frequency << ", " << std::endl;
-                jsonStream << "\"points\": [" << std::endl;
-                first = true;
-                for (const auto &point: val.second->frequencyEnvelope) {
-                        if (first)
-                                first = false;
-                        else
-                                jsonStream << ", ";
-                        jsonStream << "[ " << std::fixed << std::setprecision(5) << point.x()
-                                   << " , " << std::fixed << std::setprecision(5) << point.y() << "]";
-                }
-                jsonStream << "]" << std::endl; // points
-                jsonStream << "}," << std::endl; // freq_env
-                jsonStream << "\"filter\": {" << std::endl;
-                jsonStream << "\"enabled\": " << (val.second->isFilterEnabled ? "true" : "false");
-                jsonStream << ", " << std::endl;
-                jsonStream << "\"type\": " << static_cast<int>(val.second->filterType) << ", " << std::endl;
-                jsonStream << "\"cutoff\": " << std::fixed << std::setprecision(5)
-                           << val.second->filterFrequency << ", " << std::endl;
-                jsonStream << "\"cutoff_env\": [";
-                first = true;
-                for (const auto &point: val.second->filterCutOffEnvelope) {
-                        if (first)
-                                first = false;
-                        else
-                                jsonStream << ", ";
-                        jsonStream << "[ " << std::fixed << std::setprecision(5) << point.x()
-                                   << " , " << std::fixed << std::setprecision(5) << point.y() << "]";
-                }
-                jsonStream << "], " << std::endl;
-                jsonStream << "\"factor\": " << std::fixed << std::setprecision(5)
-                           << val.second->filterFactor << std::endl;
-                jsonStream << "}" << std::endl;  // filter;
-                jsonStream << "}" << std::endl;  // osc;
-                jsonStream << "," << std::endl;
+                size += oscillatorSize;
+                size += pointSize * (val.second->amplitudeEnvelope.size()
+                                     + val.second->frequencyEnvelope.size()
+                                     + val.second->filterCutOffEnvelope.size());
+                if (val.second->function == GeonkickApi::FunctionType::Sample)
+                        size += base64_encoded_size(val.second->sample.size() * sizeof(float));
         }
+        return size;
 }
 
-void PercussionState::kickJson(std::ostringstream &jsonStream) const
+void PercussionState::pointsJson(JsonWriter &writer, const std::vector<RkRealPoint> &points)
 {
-        jsonStream << "\"kick\": {" << std::endl;
-        jsonStream << "\"PercussionAppVersion\": " << GEONKICK_VERSION << "," << std::endl;
-	jsonStream << "\"id\": " << getId() << "," << std::endl;
-        jsonStream << "\"channel\": " << getChannel() << "," << std::endl;
-        jsonStream << "\"mute\": " << (isMuted() ? "true" : "false") << "," << std::endl;
-        jsonStream << "\"solo\": " << (isSolo() ? "true" : "false") << "," << std::endl;
-        jsonStream << "\"name\": \"" << getName() << "\"," << std::endl;
-        jsonStream << "\"playing_key\": " << static_cast<int>(getPlayingKey()) << "," << std::endl;
-        jsonStream << "\"layers\": [";
-        bool first = true;
-        for (decltype(layers.size()) i = 0; i < layers.size(); i++) {
-                if (layers[i]) {
-                        if (first)
-                                first = false;
-                        else
-                                jsonStream << ", ";
-                        jsonStream << i;
+        writer.StartArray();
+        for (const auto &point: points) {
+                writer.StartArray();
+                writer.Double(point.x());
+                writer.Double(point.y());
+                writer.EndArray();
+        }
+        writer.EndArray();
+}
+
+void PercussionState::sampleJson(JsonWriter &writer, const SampleRef &sample)
+{
+        // Encode the sample as float32 values directly into a quoted
+        // JSON string, the base64 alphabet doesn't need escaping.
+        auto n = sample.size() * sizeof(float);
+        std::string json(base64_encoded_size(n) + 2, '"');
+#ifdef GEONKICK_RAW_SAMPLES_COPY
+        auto bytes = reinterpret_cast<const unsigned char*>(sample.data());
+#else
+        std::vector<unsigned char> float32(n);
+        sample.toFloat32(float32.data());
+        auto bytes = float32.data();
+#endif // GEONKICK_RAW_SAMPLES_COPY
+        auto len = base64_encode_to(bytes, n, reinterpret_cast<unsigned char*>(&json[1]));
+        writer.RawValue(json.data(), len + 2, rapidjson::kStringType);
+}
+
+void PercussionState::oscJson(JsonWriter &writer) const
+{
+        for (const auto& val: oscillators) {
+                writer.Key(("osc" + std::to_string(val.first)).c_str());
+                writer.StartObject();
+                writer.Key("enabled");
+                writer.Bool(val.second->isEnabled);
+                writer.Key("is_fm");
+                writer.Bool(val.second->isFm);
+                if (val.second->function == GeonkickApi::FunctionType::Sample && !val.second->sample.empty()) {
+                        writer.Key("sample");
+                        sampleJson(writer, val.second->sample);
                 }
+                writer.Key("function");
+                writer.Int(static_cast<int>(val.second->function));
+                writer.Key("phase");
+                writer.Double(val.second->phase);
+                writer.Key("seed");
+                writer.Int(val.second->seed);
+
+                writer.Key("ampl_env");
+                writer.StartObject();
+                writer.Key("amplitude");
+                writer.Double(val.second->amplitude);
+                writer.Key("points");
+                pointsJson(writer, val.second->amplitudeEnvelope);
+                writer.EndObject(); // ampl_env
+
+                writer.Key("freq_env");
+                writer.StartObject();
+                writer.Key("amplitude");
+                writer.Double(val.second->frequency);
+                writer.Key("points");
+                pointsJson(writer, val.second->frequencyEnvelope);
+                writer.EndObject(); // freq_env
+
+                writer.Key("filter");
+                writer.StartObject();
+                writer.Key("enabled");
+                writer.Bool(val.second->isFilterEnabled);
+                writer.Key("type");
+                writer.Int(static_cast<int>(val.second->filterType));
+                writer.Key("cutoff");
+                writer.Double(val.second->filterFrequency);
+                writer.Key("cutoff_env");
+                pointsJson(writer, val.second->filterCutOffEnvelope);
+                writer.Key("factor");
+                writer.Double(val.second->filterFactor);
+                writer.EndObject(); // filter
+                writer.EndObject(); // osc
         }
-        jsonStream << "]," << std::endl;
-
-        jsonStream << "\"layers_amplitude\": [";
-        first = true;
-        for (decltype(layersAmplitude.size()) i = 0; i < layersAmplitude.size(); i++) {
-                        if (first)
-                                first = false;
-                        else
-                                jsonStream << ", ";
-                        jsonStream << std::fixed << std::setprecision(5) << layersAmplitude[i];
+}
+
+void PercussionState::kickJson(JsonWriter &writer) const
+{
+        writer.Key("kick");
+        writer.StartObject();
+        writer.Key("PercussionAppVersion");
+        writer.Int(GEONKICK_VERSION);
+        writer.Key("id");
+        writer.Uint64(getId());
+        writer.Key("channel");
+        writer.Uint64(getChannel());
+        writer.Key("mute");
+        writer.Bool(isMuted());
+        writer.Key("solo");
+        writer.Bool(isSolo());
+        writer.Key("name");
+        writer.String(kickName.c_str(), kickName.size());
+        writer.Key("playing_key");
+        writer.Int(static_cast<int>(getPlayingKey()));
+        writer.Key("layers");
+        writer.StartArray();
+        for (decltype(layers.size()) i = 0; i < layers.size(); i++) {
+                if (layers[i])
+                        writer.Uint64(i);
         }
-        jsonStream << "]," << std::endl;
-        jsonStream << "\"limiter\": " << std::fixed << std::setprecision(5)
-                   << getLimiterValue() << ", " << std::endl;
-        jsonStream << "\"tuned_output\": " << (isOutputTuned() ? "true" : "false") << ", " << std::endl;
-        jsonStream << "\"ampl_env\": {" << std::endl;
-        jsonStream << "\"amplitude\": " << static_cast<double>(getKickAmplitude()) << ", " << std::endl;
-        jsonStream << "\"length\": " << static_cast<double>(getKickLength()) << ", " << std::endl;
-        auto points = getKickEnvelopePoints(GeonkickApi::EnvelopeType::Amplitude);
-        jsonStream << "\"points\": [";
-        first = true;
-        for (const auto &point: points) {
-                if (first)
-                        first = false;
-                else
-                        jsonStream << ", ";
-                jsonStream << "[ " << std::fixed << std::setprecision(5) << point.x()
-                           << " , " << std::fixed << std::setprecision(5) << point.y() << "]";
+        writer.EndArray();
+        writer.Key("layers_amplitude");
+        writer.StartArray();
+        for (const auto &amplitude: layersAmplitude)
+                writer.Double(amplitude);
+        writer.EndArray();
+        writer.Key("limiter");
+        writer.Double(getLimiterValue());
+        writer.Key("tuned_output");
+        writer.Bool(isOutputTuned());
+
+        writer.Key("ampl_env");
+        writer.StartObject();
+        writer.Key("amplitude");
+        writer.Double(getKickAmplitude());
+        writer.Key("length");
+        writer.Double(getKickLength());
+        writer.Key("points");
+        pointsJson(writer, kickEnvelopePoints);
+        writer.EndObject(); // ampl_env
+
+        writer.Key("filter");
+        writer.StartObject();
+        writer.Key("enabled");
+        writer.Bool(isKickFilterEnabled());
+        writer.Key("type");
+        writer.Int(static_cast<int>(getKickFilterType()));
+        writer.Key("cutoff");
+        writer.Double(getKickFilterFrequency());
+        writer.Key("factor");
+        writer.Double(getKickFilterQFactor());
+        writer.Key("cutoff_env");
+        pointsJson(writer, kickFilterCutOffEnvelope);
+        writer.EndObject(); // filter
+
+        writer.Key("compressor");
+        writer.StartObject();
+        writer.Key("enabled");
+        writer.Bool(isCompressorEnabled());
+        writer.Key("attack");
+        writer.Double(getCompressorAttack());
+        writer.Key("release");
+        writer.Double(getCompressorRelease());
+        writer.Key("threshold");
+        writer.Double(getCompressorThreshold());
+        writer.Key("ratio");
+        writer.Double(getCompressorRatio());
+        writer.Key("knee");
+        writer.Double(getCompressorKnee());
+        writer.Key("makeup");
+        writer.Double(getCompressorMakeup());
+        writer.EndObject(); // compressor
+
+        writer.Key("distortion");
+        writer.StartObject();
+        writer.Key("enabled");
+        writer.Bool(isDistortionEnabled());
+        writer.Key("in_limiter");
+        writer.Double(getDistortionInLimiter());
+        writer.Key("volume");
+        writer.Double(getDistortionVolume());
+        writer.Key("drive");
+        writer.Double(getDistortionDrive());
+        writer.Key("drive_env");
+        pointsJson(writer, kickDistortionDriveEnvelope);
+        writer.Key("volume_env");
+        pointsJson(writer, kickDistortionVolumeEnvelope);
+        writer.EndObject(); // distortion
+        writer.EndObject(); // kick
+}
+void PercussionState::toBinary(BinaryStateWriter &writer) const
+{
+        writer.writeUInt32(getId());
+        writer.writeString(getName());
+        writer.writeBool(isEnabled());
+        writer.writeUInt32(getChannel());
+        writer.writeInt32(getPlayingKey());
+        writer.writeBool(isMuted());
+        writer.writeBool(isSolo());
+        writer.writeDouble(getLimiterValue());
+        writer.writeBool(isOutputTuned());
+        writer.writeDouble(getKickLength());
+        writer.writeDouble(getKickAmplitude());
+        writer.writeUInt32(layers.size());
+        for (decltype(layers.size()) i = 0; i < layers.size(); i++) {
+                writer.writeBool(layers[i]);
+                writer.writeDouble(layersAmplitude[i]);
         }
 
-        jsonStream << "]}, " << std::endl;
-
-        jsonStream << "\"filter\": {" << std::endl;
-        jsonStream << "\"enabled\": " << (isKickFilterEnabled() ? "true" : "false");
-        jsonStream << ", " << std::endl;
-        jsonStream << "\"type\": " << static_cast<int>(getKickFilterType()) << ", " << std::endl;
-        jsonStream << "\"cutoff\": " << std::fixed << std::setprecision(2)
-                   << getKickFilterFrequency() << ", " << std::endl;
-        jsonStream << "\"factor\": " << std::fixed << std::setprecision(2)
-                   << getKickFilterQFactor() << ", " << std::endl;
-        points = getKickEnvelopePoints(GeonkickApi::EnvelopeType::FilterCutOff);
-        jsonStream << "\"cutoff_env\": [";
-        first = true;
-        for (const auto &point: points) {
-                if (first)
-                        first = false;
+        writer.writeBool(isKickFilterEnabled());
+        writer.writeUInt32(static_cast<uint32_t>(getKickFilterType()));
+        writer.writeDouble(getKickFilterFrequency());
+        writer.writeDouble(getKickFilterQFactor());
+        writer.writePoints(kickEnvelopePoints);
+        writer.writePoints(kickFilterCutOffEnvelope);
+        writer.writePoints(kickDistortionDriveEnvelope);
+        writer.writePoints(kickDistortionVolumeEnvelope);
+
+        writer.writeBool(compressor.enabled);
+        writer.writeDouble(compressor.attack);
+        writer.writeDouble(compressor.release);
+        writer.writeDouble(compressor.threshold);
+        writer.writeDouble(compressor.ratio);
+        writer.writeDouble(compressor.knee);
+        writer.writeDouble(compressor.makeup);
+
+        writer.writeBool(distortion.enabled);
+        writer.writeDouble(distortion.in_limiter);
+        writer.writeDouble(distortion.volume);
+        writer.writeDouble(distortion.drive);
+
+        writer.writeUInt32(oscillators.size());
+        for (const auto& val: oscillators) {
+                const auto &osc = val.second;
+                writer.writeUInt32(val.first);
+                writer.writeBool(osc->isEnabled);
+                writer.writeBool(osc->isFm);
+                writer.writeUInt32(static_cast<uint32_t>(osc->function));
+                writer.writeDouble(osc->phase);
+                writer.writeInt32(osc->seed);
+                writer.writeDouble(osc->amplitude);
+                writer.writeDouble(osc->frequency);
+                writer.writeBool(osc->isFilterEnabled);
+                writer.writeUInt32(static_cast<uint32_t>(osc->filterType));
+                writer.writeDouble(osc->filterFrequency);
+                writer.writeDouble(osc->filterFactor);
+                writer.writePoints(osc->amplitudeEnvelope);
+                writer.writePoints(osc->frequencyEnvelope);
+                writer.writePoints(osc->filterCutOffEnvelope);
+                if (osc->function == GeonkickApi::FunctionType::Sample)
+                        writer.writeSamples(osc->sample);
                 else
-                        jsonStream << ", ";
-                jsonStream << "[ " << std::fixed << std::setprecision(5) << point.x()
-                           << " , " << std::fixed << std::setprecision(5) << point.y() << "]";
+                        writer.writeSamples(SampleRef());
         }
-        jsonStream << "]" << std::endl; // points
-        jsonStream << "}, " << std::endl;  // filter;
-        jsonStream << "\"compressor\": {" << std::endl;
-        jsonStream << "\"enabled\": " << (isCompressorEnabled() ? "true" : "false") << ", " << std::endl;
-        jsonStream << "\"attack\": " << std::fixed << std::setprecision(5)
-                   << getCompressorAttack() << ", " << std::endl;
-        jsonStream << "\"release\": " << std::fixed << std::setprecision(5)
-                   << getCompressorRelease() << ", " << std::endl;
-        jsonStream << "\"threshold\": " << std::fixed << std::setprecision(5)
-                   << getCompressorThreshold() << ", " << std::endl;
-        jsonStream << "\"ratio\": " << std::fixed << std::setprecision(5)
-                   << getCompressorRatio() << ", " << std::endl;
-        jsonStream << "\"knee\": " << std::fixed << std::setprecision(5)
-                   << getCompressorKnee() << ", " << std::endl;
-        jsonStream << "\"makeup\": " << std::fixed << std::setprecision(5)
-                   << getCompressorMakeup() << std::endl;
-        jsonStream << "}, " << std::endl;
-
-        jsonStream << "\"distortion\": {" << std::endl;
-        jsonStream << "\"enabled\": " << (isDistortionEnabled() ? "true" : "false") << ", " << std::endl;
-        jsonStream << "\"in_limiter\": " << std::fixed << std::setprecision(5)
-                   << getDistortionInLimiter()  << ", " << std::endl;
-        jsonStream << "\"volume\": " << std::fixed << std::setprecision(5)
-                   << getDistortionVolume()  << ", " << std::endl;
-        jsonStream << "\"drive\": " << std::fixed << std::setprecision(5)
-                   << getDistortionDrive() << ", " << std::endl;
-	jsonStream << "\"drive_env\": [" << std::endl;
-	points = getKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionDrive);
-        first = true;
-        for (const auto &point: points) {
-                if (first)
-                        first = false;
-                else
-                        jsonStream << ", ";
-                jsonStream << "[ " << std::fixed << std::setprecision(5) << point.x()
-                           << " , " << std::fixed << std::setprecision(5) << point.y() << "]";
+}
+
+bool PercussionState::fromBinary(BinaryStateReader &reader)
+{
+        setId(reader.readUInt32());
+        setName(reader.readString());
+        enable(reader.readBool());
+        setChannel(reader.readUInt32());
+        setPlayingKey(reader.readInt32());
+        setMute(reader.readBool());
+        setSolo(reader.readBool());
+        setLimiterValue(reader.readDouble());
+        tuneOutput(reader.readBool());
+        setKickLength(reader.readDouble());
+        setKickAmplitude(reader.readDouble());
+        auto layersNumber = reader.readUInt32();
+        for (decltype(layersNumber) i = 0; i < layersNumber && reader.isValid(); i++) {
+                auto enabled = reader.readBool();
+                auto amplitude = reader.readDouble();
+                if (i < layers.size()) {
+                        layers[i] = enabled;
+                        layersAmplitude[i] = amplitude;
+                }
         }
-        jsonStream << "], " << std::endl;
-        jsonStream << "\"volume_env\": [" << std::endl;
-	points = getKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionVolume);
-        first = true;
-        for (const auto &point: points) {
-                if (first)
-                        first = false;
-                else
-                        jsonStream << ", ";
-                jsonStream << "[ " << std::fixed << std::setprecision(5) << point.x()
-                           << " , " << std::fixed << std::setprecision(5) << point.y() << "]";
+
+        enableKickFilter(reader.readBool());
+        setKickFilterType(static_cast<GeonkickApi::FilterType>(reader.readUInt32()));
+        setKickFilterFrequency(reader.readDouble());
+        setKickFilterQFactor(reader.readDouble());
+        kickEnvelopePoints = reader.readPoints();
+        kickFilterCutOffEnvelope = reader.readPoints();
+        kickDistortionDriveEnvelope = reader.readPoints();
+        kickDistortionVolumeEnvelope = reader.readPoints();
+
+        compressor.enabled = reader.readBool();
+        compressor.attack = reader.readDouble();
+        compressor.release = reader.readDouble();
+        compressor.threshold = reader.readDouble();
+        compressor.ratio = reader.readDouble();
+        compressor.knee = reader.readDouble();
+        compressor.makeup = reader.readDouble();
+
+        distortion.enabled = reader.readBool();
+        distortion.in_limiter = reader.readDouble();
+        distortion.volume = reader.readDouble();
+        distortion.drive = reader.readDouble();
+
+        auto oscillatorsNumber = reader.readUInt32();
+        for (decltype(oscillatorsNumber) i = 0; i < oscillatorsNumber && reader.isValid(); i++) {
+                auto osc = std::make_shared<OscillatorInfo>();
+                auto index = reader.readUInt32();
+                osc->isEnabled = reader.readBool();
+                osc->isFm = reader.readBool();
+                osc->function = static_cast<GeonkickApi::FunctionType>(reader.readUInt32());
+                osc->phase = reader.readDouble();
+                osc->seed = reader.readInt32();
+                osc->amplitude = reader.readDouble();
+                osc->frequency = reader.readDouble();
+                osc->isFilterEnabled = reader.readBool();
+                osc->filterType = static_cast<GeonkickApi::FilterType>(reader.readUInt32());
+                osc->filterFrequency = reader.readDouble();
+                osc->filterFactor = reader.readDouble();
+                osc->amplitudeEnvelope = reader.readPoints();
+                osc->frequencyEnvelope = reader.readPoints();
+                osc->filterCutOffEnvelope = reader.readPoints();
+                osc->sample = reader.readSamples();
+                auto it = oscillators.find(index);
+                if (it != oscillators.end()) {
+                        osc->type = it->second->type;
+                        it->second = osc;
+                }
         }
-	jsonStream << "]" << std::endl;
-        jsonStream << "}" << std::endl; // distortion
-        jsonStream << "}" << std::endl; // kick
+
+        return reader.isValid();
 }
 
 void PercussionState::setLayerEnabled(GeonkickApi::Layer layer, bool b)
@@ -1080,35 +998,6 @@ bool PercussionState::isOutputTuned() const
         return tunedOutput;
 }
 
-std::vector<float> PercussionState::fromBase64F(const std::string &str)
-{
-        size_t len;
-        auto data_str = base64_decode(reinterpret_cast<const unsigned char*>(str.c_str()),
-                                      str.size(),
-                                      &len);
-        if (data_str && len > sizeof(float)) {
-                std::vector<float> data(reinterpret_cast<float*>(data_str),
-                                        reinterpret_cast<float*>(data_str) + len / sizeof(float));
-                free(data_str);
-                return data;
-        }
-        return {};
-}
-
-std::string PercussionState::toBase64F(const std::vector<float> &data)
-{
-        size_t len;
-        auto base64 = base64_encode(reinterpret_cast<const unsigned char*>(data.data()),
-                                    data.size() * sizeof(float), &len);
-        if (base64  && len > 0) {
-                std::string str(reinterpret_cast<const char*>(base64), len);
-                free(base64);
-                str.erase(std::remove(str.begin(), str.end(), '\n'), str.end());
-                return str;
-        }
-        return {};
-}
-
 bool PercussionState::save(const std::string &fileName)
 {
         if (fileName.size() < 7) {
@@ -1128,20 +1017,26 @@ bool PercussionState::save(const std::string &fileName)
                 GEONKICK_LOG_ERROR("can't open file for saving: " << filePath);
                 return false;
         }
-        file << toJson();
+        rapidjson::StringBuffer buffer(nullptr, estimatedJsonSize());
+        JsonWriter writer(buffer);
+        writer.SetMaxDecimalPlaces(5);
+        writeJson(writer);
+        file.write(buffer.GetString(), buffer.GetSize());
         file.close();
         return true;
 }
 
-void PercussionState::setOscillatorSample(int oscillatorIndex, const std::vector<float> &sample)
+void PercussionState::setOscillatorSample(int oscillatorIndex, const SampleRef &sample)
 {
         auto oscillator = getOscillator(oscillatorIndex);
         if (oscillator)
                 oscillator->sample = sample;
 }
 
-std::vector<float> PercussionState::getOscillatorSample(int oscillatorIndex) const
+SampleRef PercussionState::getOscillatorSample(int oscillatorIndex) const
 {
         auto oscillator = getOscillator(oscillatorIndex);
-        return oscillator->sample;
+        if (oscillator)
+                return oscillator->sample;
+        return SampleRef();
 }
@@ -25,20 +25,25 @@
 #define GEONKICK_STATE_H
 
 #include "geonkick_api.h"
+#include "sample_ref.h"
 
-#include <rapidjson/document.h>
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
 #include <unordered_map>
 
+class BinaryStateWriter;
+class BinaryStateReader;
+
 class PercussionState
 {
+        friend class PercussionJsonHandler;
+
  public:
+        using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
         PercussionState();
         bool loadFile(const std::string &file);
         void loadData(const std::string &data);
-        void loadObject(const rapidjson::Value &obj);
         size_t getId() const;
         void setId(size_t id);
         void setChannel(size_t channel);
@@ -97,8 +102,8 @@ class PercussionState
         double oscillatorFilterFactor(int index) const;
         std::vector<RkRealPoint> oscillatorEnvelopePoints(int index, GeonkickApi::EnvelopeType type) const;
         void setOscillatorSample(int oscillatorIndex,
-                                 const std::vector<float> &sample);
-        std::vector<float> getOscillatorSample(int oscillatorIndex) const;
+                                 const SampleRef &sample);
+        SampleRef getOscillatorSample(int oscillatorIndex) const;
         void enableCompressor(bool enable);
         bool isCompressorEnabled() const;
         void setCompressorAttack(double attack);
@@ -122,6 +127,10 @@ class PercussionState
         double getDistortionVolume() const;
         double getDistortionDrive() const;
         std::string toJson() const;
+        void writeJson(JsonWriter &writer) const;
+        size_t estimatedJsonSize() const;
+        void toBinary(BinaryStateWriter &writer) const;
+        bool fromBinary(BinaryStateReader &reader);
         void setLayerEnabled(GeonkickApi::Layer layer, bool b);
         bool isLayerEnabled(GeonkickApi::Layer layer) const;
         void setCurrentLayer(GeonkickApi::Layer layer);
@@ -129,16 +138,14 @@ class PercussionState
         double getLayerAmplitude(GeonkickApi::Layer layer) const;
         void tuneOutput(bool tune);
         bool isOutputTuned() const;
-        static std::vector<float> fromBase64F(const std::string &str);
-        static std::string toBase64F(const std::vector<float> &data);
         bool save(const std::string &fileName);
 
  protected:
-        void parseKickObject(const rapidjson::Value &kick);
-        void parseOscillatorObject(int index,  const rapidjson::Value &osc);
-        static std::vector<RkRealPoint> parseEnvelopeArray(const rapidjson::Value &envelopeArray);
-        void oscJson(std::ostringstream &jsonStream) const;
-        void kickJson(std::ostringstream &jsonStream) const;
+        bool parseJson(std::string &data);
+        void oscJson(JsonWriter &writer) const;
+        void kickJson(JsonWriter &writer) const;
+        static void pointsJson(JsonWriter &writer, const std::vector<RkRealPoint> &points);
+        static void sampleJson(JsonWriter &writer, const SampleRef &sample);
 
 private:
         void initOscillators();
@@ -157,7 +164,7 @@ private:
                 , filterFrequency{200}
                 , filterFactor{1.0} {}
                 GeonkickApi::OscillatorType type;
-                std::vector<float> sample;
+                SampleRef sample;
                 bool isEnabled;
                 bool isFm;
                 GeonkickApi::FunctionType function;
@@ -55,3 +55,13 @@ void Preset::setPath(const std::filesystem::path &path)
 {
         presetPath = path;
 }
+
+std::shared_ptr<const PresetAnalysis> Preset::analysis() const
+{
+        return std::atomic_load(&presetAnalysis);
+}
+
+void Preset::setAnalysis(const std::shared_ptr<const PresetAnalysis> &analysis)
+{
+        std::atomic_store(&presetAnalysis, analysis);
+}
@@ -26,6 +26,8 @@
 
 #include "globals.h"
 
+struct PresetAnalysis;
+
 class Preset {
  public:
         enum class PresetType: int {
@@ -40,9 +42,17 @@ class Preset {
         std::filesystem::path path() const;
         void setPath(const std::filesystem::path& path);
 
+        /**
+         * The analysis is set by the presets registry thread
+         * while the presets are browsed.
+         */
+        std::shared_ptr<const PresetAnalysis> analysis() const;
+        void setAnalysis(const std::shared_ptr<const PresetAnalysis> &analysis);
+
  private:
         std::string presetName;
         std::filesystem::path presetPath;
+        std::shared_ptr<const PresetAnalysis> presetAnalysis;
 };
 
 #endif // PRESET_H
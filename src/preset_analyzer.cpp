@@ -0,0 +1,164 @@
+/**
+ * File name: preset_analyzer.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "preset_analyzer.h"
+#include "percussion_state.h"
+#include "kit_state.h"
+
+#include <cmath>
+
+std::shared_ptr<PresetAnalysis> PresetAnalyzer::analyze(const std::filesystem::path &path,
+                                                        Preset::PresetType type)
+{
+        if (!percussionRenderer.isValid())
+                return nullptr;
+
+        std::vector<std::shared_ptr<PercussionState>> states;
+        std::vector<std::string> tags;
+        if (type == Preset::PresetType::PercussionKit) {
+                KitState kit;
+                kit.open(path);
+                states = kit.percussions();
+                for (const auto &tag: {kit.getName(), kit.getAuthor()}) {
+                        if (!tag.empty())
+                                tags.push_back(tag);
+                }
+        } else {
+                auto state = std::make_shared<PercussionState>();
+                if (state->loadFile(path))
+                        states.push_back(state);
+        }
+
+        if (states.empty()) {
+                GEONKICK_LOG_ERROR("can't analyze preset " << path);
+                return nullptr;
+        }
+
+        auto analysis = std::make_shared<PresetAnalysis>();
+        analysis->tags = std::move(tags);
+        for (const auto &state: states) {
+                PercussionFeatures features;
+                if (!analyzePercussion(*state, features))
+                        return nullptr;
+                analysis->percussions.push_back(std::move(features));
+        }
+        return analysis;
+}
+
+bool PresetAnalyzer::analyzePercussion(PercussionState &state, PercussionFeatures &features)
+{
+        if (!percussionRenderer.render(state, renderBuffer))
+                return false;
+
+        auto size = renderBuffer.size();
+        auto sampleRate = percussionRenderer.sampleRate();
+        features.name = state.getName();
+        features.peak = 0;
+        double sum = 0;
+        for (decltype(size) i = 0; i < size; i++) {
+                features.peak = std::max(features.peak, std::fabs(renderBuffer[i]));
+                sum += renderBuffer[i] * renderBuffer[i];
+        }
+        features.rms = size ? std::sqrt(sum / size) : 0;
+
+        // The audible part ends when the signal falls below -60dB of the peak.
+        size_t audibleSize = size;
+        while (audibleSize > 0 && std::fabs(renderBuffer[audibleSize - 1]) < 0.001f * features.peak)
+                audibleSize--;
+        features.length = 1000.0f * audibleSize / sampleRate;
+
+        features.peaks.assign(2 * thumbnailSize, 0.0f);
+        for (size_t i = 0; i < thumbnailSize && size > 0; i++) {
+                auto start = i * size / thumbnailSize;
+                auto end = std::max((i + 1) * size / thumbnailSize, start + 1);
+                auto minmax = std::minmax_element(renderBuffer.begin() + start,
+                                                  renderBuffer.begin() + std::min(end, size));
+                features.peaks[2 * i] = *minmax.first;
+                features.peaks[2 * i + 1] = *minmax.second;
+        }
+
+        features.fundamental = estimateFundamental(renderBuffer, audibleSize, sampleRate);
+        return true;
+}
+
+/**
+ * Estimates the fundamental frequency from the autocorrelation of
+ * the body of the percussion, after the attack. Returns zero for the
+ * sounds without a clear period, like noise.
+ */
+float PresetAnalyzer::estimateFundamental(const std::vector<gkick_real> &data,
+                                          size_t size,
+                                          int sampleRate)
+{
+        constexpr size_t windowSize = 2048;
+        constexpr float minFrequency = 20;
+        constexpr float maxFrequency = 2000;
+        size_t start = sampleRate / 100;
+        if (size < start + windowSize)
+                start = 0;
+        if (size < start + windowSize)
+                return 0;
+
+        auto maxLag = std::min(static_cast<size_t>(sampleRate / minFrequency),
+                               size - start - windowSize);
+        auto minLag = static_cast<size_t>(sampleRate / maxFrequency);
+        const auto *x = data.data() + start;
+        double energy = 0;
+        for (size_t i = 0; i < windowSize; i++)
+                energy += x[i] * x[i];
+        if (energy <= 0)
+                return 0;
+
+        std::vector<double> correlations(maxLag + 1, 0);
+        for (auto lag = minLag; lag <= maxLag; lag++) {
+                double correlation = 0;
+                double lagEnergy = 0;
+                for (size_t i = 0; i < windowSize; i++) {
+                        correlation += x[i] * x[i + lag];
+                        lagEnergy += x[i + lag] * x[i + lag];
+                }
+                if (lagEnergy > 0)
+                        correlations[lag] = correlation / std::sqrt(energy * lagEnergy);
+        }
+
+        // Skip the main lobe around the zero lag.
+        auto firstLag = minLag;
+        while (firstLag <= maxLag && correlations[firstLag] > 0)
+                firstLag++;
+
+        double bestCorrelation = 0;
+        for (auto lag = firstLag; lag <= maxLag; lag++)
+                bestCorrelation = std::max(bestCorrelation, correlations[lag]);
+        if (bestCorrelation < 0.5)
+                return 0;
+
+        // The multiples of the period correlate as well, take the first peak.
+        size_t bestLag = 0;
+        for (auto lag = firstLag; lag <= maxLag && !bestLag; lag++) {
+                if (correlations[lag] >= 0.9 * bestCorrelation
+                    && (lag == maxLag || correlations[lag] >= correlations[lag + 1]))
+                        bestLag = lag;
+        }
+        return static_cast<float>(sampleRate) / bestLag;
+}
@@ -0,0 +1,76 @@
+/**
+ * File name: preset_analyzer.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GEONKICK_PRESET_ANALYZER_H
+#define GEONKICK_PRESET_ANALYZER_H
+
+#include "globals.h"
+#include "preset.h"
+#include "percussion_renderer.h"
+
+class PercussionState;
+
+struct PercussionFeatures {
+        std::string name;
+        /* Waveform thumbnail, the minimum and maximum of every column interleaved. */
+        std::vector<float> peaks;
+        float peak;
+        float rms;
+        /* Length of the audible part in milliseconds. */
+        float length;
+        /* Estimated fundamental frequency in Hz, zero if not found. */
+        float fundamental;
+};
+
+struct PresetAnalysis {
+        /* The kit name and author, used for searching. */
+        std::vector<std::string> tags;
+        std::vector<PercussionFeatures> percussions;
+};
+
+/**
+ * Renders the presets in a detached render context, independently
+ * of the instances synthesizers, and extracts the waveform thumbnail
+ * and the audio features of every percussion. An analyzer must be
+ * used by one thread at a time.
+ */
+class PresetAnalyzer {
+ public:
+        static constexpr size_t thumbnailSize = 64;
+        PresetAnalyzer() = default;
+        std::shared_ptr<PresetAnalysis> analyze(const std::filesystem::path &path,
+                                                Preset::PresetType type);
+
+ protected:
+        bool analyzePercussion(PercussionState &state, PercussionFeatures &features);
+        static float estimateFundamental(const std::vector<gkick_real> &data,
+                                         size_t size,
+                                         int sampleRate);
+
+ private:
+        PercussionRenderer percussionRenderer;
+        std::vector<gkick_real> renderBuffer;
+};
+
+#endif // GEONKICK_PRESET_ANALYZER_H
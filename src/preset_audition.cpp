@@ -0,0 +1,153 @@
+/**
+ * File name: preset_audition.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "preset_audition.h"
+#include "preset_registry.h"
+#include "percussion_renderer.h"
+#include "percussion_state.h"
+#include "kit_state.h"
+
+#include <sstream>
+
+PresetAudition::PresetAudition(const std::shared_ptr<PresetRegistry> &registry,
+                               const Callback &callback)
+        : presetRegistry{registry}
+        , renderedCallback{callback}
+        , auditionThread{nullptr}
+        , pendingRequest{nullptr}
+        , requestsNumber{0}
+        , isRunning{true}
+{
+}
+
+PresetAudition::~PresetAudition()
+{
+        {
+                std::lock_guard<std::mutex> lock(auditionMutex);
+                isRunning = false;
+                pendingRequest = nullptr;
+        }
+        threadConditionVar.notify_one();
+        if (auditionThread)
+                auditionThread->join();
+}
+
+void PresetAudition::start()
+{
+        auditionThread = std::make_unique<std::thread>(&PresetAudition::run, this);
+}
+
+std::string PresetAudition::cacheKey(const std::filesystem::path &path)
+{
+        std::ostringstream key;
+        key << "audition:" << path.string();
+        try {
+                key << ":" << std::filesystem::last_write_time(path).time_since_epoch().count();
+        } catch (...) {
+        }
+        return key.str();
+}
+
+void PresetAudition::audition(const std::filesystem::path &path, Preset::PresetType type)
+{
+        auto key = cacheKey(path);
+        auto sample = presetRegistry->getSample(key);
+        std::lock_guard<std::mutex> lock(auditionMutex);
+        auto serial = ++requestsNumber;
+        if (!sample.empty()) {
+                pendingRequest = nullptr;
+                renderedCallback(sample);
+                return;
+        }
+
+        pendingRequest = std::make_unique<Request>(Request{path, type, key, serial});
+        if (!auditionThread)
+                start();
+        threadConditionVar.notify_one();
+}
+
+void PresetAudition::run()
+{
+        PercussionRenderer renderer;
+        std::unique_lock<std::mutex> lock(auditionMutex);
+        while (isRunning) {
+                if (!pendingRequest) {
+                        threadConditionVar.wait(lock);
+                        continue;
+                }
+
+                auto request = std::move(pendingRequest);
+                lock.unlock();
+                auto sample = presetRegistry->getSample(request->key);
+                if (sample.empty()) {
+                        sample = render(renderer, *request);
+                        presetRegistry->addSample(request->key, sample);
+                }
+                lock.lock();
+
+                /* Skip the preview if a newer preset was requested meanwhile. */
+                if (isRunning && !sample.empty() && requestsNumber == request->serial)
+                        renderedCallback(sample);
+        }
+}
+
+SampleRef PresetAudition::render(PercussionRenderer &renderer, const Request &request)
+{
+        if (!renderer.isValid())
+                return SampleRef();
+
+        // The kits are auditioned by the first enabled percussion.
+        std::shared_ptr<PercussionState> state;
+        if (request.type == Preset::PresetType::PercussionKit) {
+                KitState kit;
+                kit.open(request.path);
+                for (const auto &percussion: kit.percussions()) {
+                        if (percussion->isEnabled()) {
+                                state = percussion;
+                                break;
+                        }
+                }
+        } else {
+                state = std::make_shared<PercussionState>();
+                if (!state->loadFile(request.path))
+                        state = nullptr;
+        }
+
+        std::vector<gkick_real> data;
+        if (!state || !renderer.render(*state, data) || data.empty()) {
+                GEONKICK_LOG_ERROR("can't render preset " << request.path);
+                return SampleRef();
+        }
+
+        /**
+         * The preview is not published into the samples store,
+         * it is private to the audition and never written
+         * into the samples cache files.
+         */
+        struct gkick_sample *sample = nullptr;
+        if (geonkick_sample_create(data.size(), &sample) != GEONKICK_OK)
+                return SampleRef();
+        std::copy(data.begin(), data.end(), geonkick_sample_buffer(sample));
+        return SampleRef::adopt(sample);
+}
@@ -0,0 +1,87 @@
+/**
+ * File name: preset_audition.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GEONKICK_PRESET_AUDITION_H
+#define GEONKICK_PRESET_AUDITION_H
+
+#include "globals.h"
+#include "preset.h"
+#include "sample_ref.h"
+
+#include <condition_variable>
+#include <functional>
+#include <thread>
+
+class PresetRegistry;
+class PercussionRenderer;
+
+/**
+ * Renders the presets for audition in a background thread, in a
+ * detached render context, without changing the instance percussions.
+ * The rendered previews are cached in the preset registry by the preset
+ * path and modification time, so auditioning again the same preset
+ * only reads the cached buffer.
+ */
+class PresetAudition {
+ public:
+        using Callback = std::function<void(const SampleRef &sample)>;
+
+        /**
+         * The callback is called from the audition thread or from
+         * the caller thread when the preview is in the cache.
+         * Only the preview of the last requested preset is
+         * passed to the callback.
+         */
+        PresetAudition(const std::shared_ptr<PresetRegistry> &registry,
+                       const Callback &callback);
+        ~PresetAudition();
+
+        /* Replaces the pending audition request. */
+        void audition(const std::filesystem::path &path, Preset::PresetType type);
+
+ protected:
+        struct Request {
+                std::filesystem::path path;
+                Preset::PresetType type;
+                std::string key;
+                uint64_t serial;
+        };
+
+        void start();
+        void run();
+        SampleRef render(PercussionRenderer &renderer, const Request &request);
+        static std::string cacheKey(const std::filesystem::path &path);
+
+ private:
+        std::shared_ptr<PresetRegistry> presetRegistry;
+        Callback renderedCallback;
+        std::unique_ptr<std::thread> auditionThread;
+        std::mutex auditionMutex;
+        std::condition_variable threadConditionVar;
+        std::unique_ptr<Request> pendingRequest;
+        uint64_t requestsNumber;
+        bool isRunning;
+};
+
+#endif // GEONKICK_PRESET_AUDITION_H
@@ -37,7 +37,37 @@ PresetBrowserModel::PresetBrowserModel(RkObject *parent, GeonkickApi *api)
         , rowsPerColumn{12}
         , selectedFolder{geonkickApi->getPresetFolder(0)}
         , selectedPreset{nullptr}
+        , searchResultsLimit{1000}
 {
+        RK_ACT_BIND(geonkickApi, presetsUpdated, RK_ACT_ARGS(), this, presetsUpdated());
+}
+
+void PresetBrowserModel::presetsUpdated()
+{
+        // The presets folders are added while they are loaded in background
+        // and removed when the folders are removed from the disk.
+        bool isFolderRegistered = false;
+        for (size_t i = 0; i < geonkickApi->numberOfPresetFolders(); i++) {
+                if (geonkickApi->getPresetFolder(i) == selectedFolder) {
+                        isFolderRegistered = true;
+                        break;
+                }
+        }
+
+        if (!isFolderRegistered) {
+                selectedFolder = geonkickApi->getPresetFolder(0);
+                selectedPreset = nullptr;
+                presetPageIndex = 0;
+        }
+
+        if (isSearching())
+                updateSearchResults();
+
+        if (folderPageIndex >= folderPages())
+                folderPageIndex = folderPages() > 0 ? folderPages() - 1 : 0;
+        if (presetPageIndex >= presetPages())
+                presetPageIndex = presetPages() > 0 ? presetPages() - 1 : 0;
+        action presetsChanged();
 }
 
 std::string PresetBrowserModel::presetName(int row, int column) const
@@ -60,14 +90,26 @@ bool PresetBrowserModel::isKit(int row, int column) const
         return preset && preset->type() == Preset::PresetType::PercussionKit;
 }
 
-PresetFolder* PresetBrowserModel::getPresetFolder(int row) const
+std::shared_ptr<const PresetAnalysis> PresetBrowserModel::presetAnalysis(int row, int column) const
+{
+        auto preset = getPreset(row, column);
+        if (preset)
+                return preset->analysis();
+        return nullptr;
+}
+
+std::shared_ptr<PresetFolder> PresetBrowserModel::getPresetFolder(int row) const
 {
         return geonkickApi->getPresetFolder(folderPage() * rowsPerColumn + row);
 }
 
-Preset* PresetBrowserModel::getPreset(int row, int column) const
+std::shared_ptr<Preset> PresetBrowserModel::getPreset(int row, int column) const
 {
-        if (column > 0 && selectedFolder) {
+        if (column > 0 && isSearching()) {
+                size_t index = presetPage() * numberOfPresetColumns * rowsPerColumn
+                        + (column - 1) * rowsPerColumn + row;
+                return index < searchResults.size() ? searchResults[index] : nullptr;
+        } else if (column > 0 && selectedFolder) {
                 return selectedFolder->preset(presetPage() * numberOfPresetColumns * rowsPerColumn
                                               + (column - 1) * rowsPerColumn + row);
         } else {
@@ -109,8 +151,11 @@ void PresetBrowserModel::setFolderPage(size_t index)
 
 size_t PresetBrowserModel::presetPages() const
 {
-        if (selectedFolder) {
-                auto presetsPerPage = numberOfPresetColumns * rowsPerColumn;
+        auto presetsPerPage = numberOfPresetColumns * rowsPerColumn;
+        if (isSearching()) {
+                return searchResults.size() / presetsPerPage
+                        + ((searchResults.size() % presetsPerPage) ? 1 : 0);
+        } else if (selectedFolder) {
                 return selectedFolder->numberOfPresets() / presetsPerPage
                         + ((selectedFolder->numberOfPresets() % presetsPerPage) ? 1 : 0);
         }
@@ -160,27 +205,41 @@ void PresetBrowserModel::select(size_t row, size_t column)
                         selectedFolder = getPresetFolder(row);
                         selectedPreset = nullptr;
                         presetPageIndex = 0;
+                        if (isSearching()) {
+                                presetsSearchQuery.clear();
+                                searchResults.clear();
+                                action searchCleared();
+                        }
                         if (selectedFolder)
-                                action folderSelected(selectedFolder);
-                } if (column > 0 && selectedFolder) {
+                                action folderSelected(selectedFolder.get());
+                } if (column > 0) {
                         selectedPreset = getPreset(row, column);
-                        if (selectedPreset && setPreset(selectedPreset))
-                                action presetSelected(selectedPreset);
+                        if (selectedPreset)
+                                geonkickApi->auditionPreset(selectedPreset.get());
                 }
         }
 }
 
+void PresetBrowserModel::load(size_t row, size_t column)
+{
+        if (row < rows() && column > 0 && column < columns()) {
+                selectedPreset = getPreset(row, column);
+                if (selectedPreset && setPreset(selectedPreset))
+                        action presetSelected(selectedPreset.get());
+        }
+}
+
 bool PresetBrowserModel::isSelected(size_t row, size_t column) const
 {
         if (column == 0)
-                return getPresetFolder(row) == selectedFolder;
+                return !isSearching() && getPresetFolder(row) == selectedFolder;
         else if (column > 0)
                 return getPreset(row, column) == selectedPreset;
         else
                 return false;
 }
 
-bool PresetBrowserModel::setPreset(Preset* preset)
+bool PresetBrowserModel::setPreset(const std::shared_ptr<Preset> &preset)
 {
         if (preset->type() == Preset::PresetType::Percussion) {
                 GEONKICK_LOG_DEBUG("path:" << preset->path());
@@ -191,8 +250,8 @@ bool PresetBrowserModel::setPreset(Preset* preset)
                 } else {
                         state->setId(geonkickApi->currentPercussion());
                         geonkickApi->setPercussionState(state);
-                        geonkickApi->notifyUpdateGui();
-                        geonkickApi->notifyPercussionUpdated(state->getId());
+                        geonkickApi->notifyStateChanges(StateChanges(state->getId(),
+                                                                     StateChanges::Parameter::All));
                         return true;
                 }
         } else if (preset->type() == Preset::PresetType::PercussionKit) {
@@ -201,10 +260,35 @@ bool PresetBrowserModel::setPreset(Preset* preset)
                         GEONKICK_LOG_ERROR("can't open kit");
                         return false;
                 } else if (geonkickApi->setKitState(kit)) {
-                        geonkickApi->notifyKitUpdated();
-                        geonkickApi->notifyUpdateGui();
+                        geonkickApi->notifyStateChanges(StateChanges::kitChanges());
                         return true;
                 }
         }
         return false;
 }
+
+void PresetBrowserModel::setSearchQuery(const std::string &query)
+{
+        presetsSearchQuery = query;
+        presetPageIndex = 0;
+        updateSearchResults();
+        action presetsChanged();
+}
+
+std::string PresetBrowserModel::searchQuery() const
+{
+        return presetsSearchQuery;
+}
+
+bool PresetBrowserModel::isSearching() const
+{
+        return !presetsSearchQuery.empty();
+}
+
+void PresetBrowserModel::updateSearchResults()
+{
+        if (isSearching())
+                searchResults = geonkickApi->searchPresets(presetsSearchQuery, searchResultsLimit);
+        else
+                searchResults.clear();
+}
@@ -31,6 +31,7 @@
 class GeonkickApi;
 class PresetFolder;
 class Preset;
+struct PresetAnalysis;
 
 class PresetBrowserModel : public RkObject {
  public:
@@ -48,9 +49,22 @@ class PresetBrowserModel : public RkObject {
         void setPresetPage(size_t index);
         size_t columns() const;
         size_t rows() const;
+        /* Selects the folder or selects and auditions the preset. */
         void select(size_t row, size_t column);
+        /* Loads the preset into the current percussion or kit. */
+        void load(size_t row, size_t column);
         bool isSelected(size_t row, size_t column) const;
         bool isKit(int row, int column) const;
+        std::shared_ptr<const PresetAnalysis> presetAnalysis(int row, int column) const;
+
+        /**
+         * Shows the presets matching the query, ordered by relevance,
+         * instead of the presets of the selected folder. The search
+         * is cleared by an empty query or by selecting a folder.
+         */
+        void setSearchQuery(const std::string &query);
+        std::string searchQuery() const;
+        bool isSearching() const;
         RK_DECL_ACT(folderSelected,
                     folderSelected(PresetFolder* folder),
                     RK_ARG_TYPE(PresetFolder*),
@@ -67,10 +81,20 @@ class PresetBrowserModel : public RkObject {
                     presetPageChanged(),
                     RK_ARG_TYPE(),
                     RK_ARG_VAL());
+        RK_DECL_ACT(presetsChanged,
+                    presetsChanged(),
+                    RK_ARG_TYPE(),
+                    RK_ARG_VAL());
+        RK_DECL_ACT(searchCleared,
+                    searchCleared(),
+                    RK_ARG_TYPE(),
+                    RK_ARG_VAL());
  protected:
-        PresetFolder* getPresetFolder(int row) const;
-        Preset* getPreset(int row, int column) const;
-        bool setPreset(Preset* preset);
+        std::shared_ptr<PresetFolder> getPresetFolder(int row) const;
+        std::shared_ptr<Preset> getPreset(int row, int column) const;
+        bool setPreset(const std::shared_ptr<Preset> &preset);
+        void presetsUpdated();
+        void updateSearchResults();
 
 
  private:
@@ -79,8 +103,11 @@ class PresetBrowserModel : public RkObject {
         size_t presetPageIndex;
         size_t numberOfPresetColumns;
         size_t rowsPerColumn;
-        PresetFolder* selectedFolder;
-        Preset* selectedPreset;
+        std::shared_ptr<PresetFolder> selectedFolder;
+        std::shared_ptr<Preset> selectedPreset;
+        std::string presetsSearchQuery;
+        std::vector<std::shared_ptr<Preset>> searchResults;
+        size_t searchResultsLimit;
 };
 
 #endif // PRESET_BROWSER_MODEL_H
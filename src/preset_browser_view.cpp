@@ -23,12 +23,14 @@
 
 #include "preset_browser_view.h"
 #include "preset_browser_model.h"
+#include "preset_analyzer.h"
 
 #include <RkPainter.h>
 #include <RkImage.h>
 #include <RkEvent.h>
 #include <RkButton.h>
 #include <RkContainer.h>
+#include <RkLineEdit.h>
 
 RK_DECLARE_IMAGE_RC(next_page);
 RK_DECLARE_IMAGE_RC(next_page_hover);
@@ -51,6 +53,7 @@ PresetBrowserView::PresetBrowserView(GeonkickWidget *parent,
         , prevPresetPageButton{nullptr}
         , nextFolderPageButton{nullptr}
         , prevFolderPageButton{nullptr}
+        , searchEdit{nullptr}
         , bottomContainer{nullptr}
 {
         setSize(620, 290);
@@ -60,6 +63,7 @@ PresetBrowserView::PresetBrowserView(GeonkickWidget *parent,
         RK_ACT_BIND(browserModel, folderPageChanged, RK_ACT_ARGS(), this, updatePageButtons());
         RK_ACT_BIND(browserModel, folderSelected, RK_ACT_ARGS(PresetFolder*), this, updatePageButtons());
         RK_ACT_BIND(browserModel, presetSelected, RK_ACT_ARGS(Preset*), this, updatePageButtons());
+        RK_ACT_BIND(browserModel, presetsChanged, RK_ACT_ARGS(), this, updatePageButtons());
 
         bottomContainer = new RkContainer(this);
         bottomContainer->setSize({width(), 24});
@@ -92,6 +96,16 @@ PresetBrowserView::PresetBrowserView(GeonkickWidget *parent,
         bottomContainer->addSpace(5);
         bottomContainer->addWidget(nextFolderPageButton);
 
+        bottomContainer->addSpace(15);
+        searchEdit = new RkLineEdit(this);
+        searchEdit->setFont(font());
+        searchEdit->setTitle("searchEdit");
+        searchEdit->setSize(200, 22);
+        searchEdit->show();
+        RK_ACT_BIND(searchEdit, textEdited, RK_ACT_ARGS(const std::string& text), browserModel, setSearchQuery(text));
+        RK_ACT_BIND(browserModel, searchCleared, RK_ACT_ARGS(), searchEdit, setText(std::string()));
+        bottomContainer->addWidget(searchEdit);
+
         bottomContainer->addSpace(10, Rk::Alignment::AlignRight);
         nextPresetPageButton = new RkButton(this);
         nextPresetPageButton->setType(RkButton::ButtonType::ButtonPush);
@@ -140,6 +154,11 @@ void PresetBrowserView::paintWidget(RkPaintEvent *event)
                                 auto presetName = browserModel->presetName(row, col);
                                 if (browserModel->isKit(row, col))
                                         presetName = "KIT: " + presetName;
+                                auto analysis = browserModel->presetAnalysis(row, col);
+                                if (analysis && !analysis->percussions.empty())
+                                        drawThumbnail(painter,
+                                                      analysis->percussions.front(),
+                                                      RkRect(xColumn + 10, yRow, columnWidth - 20, rowHeight));
                                 auto font = painter.font();
                                 RkRect textRect(xColumn + 15, yRow, columnWidth, rowHeight);
                                 painter.setPen(RkColor(60, 60, 60));
@@ -168,10 +187,35 @@ void PresetBrowserView::paintWidget(RkPaintEvent *event)
         paint.drawImage(img, 0, 0);
 }
 
+void PresetBrowserView::drawThumbnail(RkPainter &painter,
+                                      const PercussionFeatures &features,
+                                      const RkRect &rect)
+{
+        auto n = features.peaks.size() / 2;
+        if (n < 1)
+                return;
+
+        painter.setPen(RkColor(90, 90, 90));
+        int yCenter = rect.top() + rect.height() / 2;
+        for (decltype(n) i = 0; i < n; i++) {
+                int x = rect.left() + i * rect.width() / n;
+                int yMin = yCenter - features.peaks[2 * i] * rect.height() / 2;
+                int yMax = yCenter - features.peaks[2 * i + 1] * rect.height() / 2;
+                painter.drawLine({x, yMin}, {x, yMax});
+        }
+}
+
 void PresetBrowserView::mouseButtonPressEvent(RkMouseEvent *event)
 {
         browserModel->select((event->y() - topPadding) / rowHeight,
                              (event->x() - leftPadding) / columnWidth);
+        update();
+}
+
+void PresetBrowserView::mouseDoubleClickEvent(RkMouseEvent *event)
+{
+        browserModel->load((event->y() - topPadding) / rowHeight,
+                           (event->x() - leftPadding) / columnWidth);
 }
 
 void PresetBrowserView::mouseMoveEvent(RkMouseEvent *event)
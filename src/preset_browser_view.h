@@ -30,6 +30,9 @@
 class PresetBrowserModel;
 class RkButton;
 class RkContainer;
+class RkLineEdit;
+class RkPainter;
+struct PercussionFeatures;
 
 class PresetBrowserView: public GeonkickWidget {
  public:
@@ -37,9 +40,13 @@ class PresetBrowserView: public GeonkickWidget {
 
  protected:
         void mouseButtonPressEvent(RkMouseEvent *event) override;
+        void mouseDoubleClickEvent(RkMouseEvent *event) override;
         void mouseMoveEvent(RkMouseEvent *event) override;
         void paintWidget(RkPaintEvent *event) override;
         void updatePageButtons();
+        void drawThumbnail(RkPainter &painter,
+                           const PercussionFeatures &features,
+                           const RkRect &rect);
 
  private:
         PresetBrowserModel *browserModel;
@@ -53,6 +60,7 @@ class PresetBrowserView: public GeonkickWidget {
         RkButton* prevPresetPageButton;
         RkButton* nextFolderPageButton;
         RkButton* prevFolderPageButton;
+        RkLineEdit *searchEdit;
         RkContainer *bottomContainer;
 };
 
@@ -23,6 +23,7 @@
 
 #include "preset_folder.h"
 #include "preset.h"
+#include "preset_index.h"
 
 PresetFolder::PresetFolder(const std::filesystem::path &path)
         : folderPath{path}
@@ -44,14 +45,14 @@ void PresetFolder::setPath(const std::filesystem::path &path)
         folderPath = path;
 }
 
-bool PresetFolder::loadPresets()
+bool PresetFolder::loadPresets(PresetIndex &index)
 {
         try {
                 for (const auto &entry : std::filesystem::directory_iterator(folderPath)) {
                         if (!entry.path().empty() && std::filesystem::is_regular_file(entry.path())
-                            && (entry.path().extension() == ".gkick" || entry.path().extension() == ".gkit")) {
+                            && isPresetFile(entry.path())) {
                                 GEONKICK_LOG_DEBUG("preset: " << entry.path());
-                                presetList.push_back(std::make_unique<Preset>(entry.path()));
+                                addPreset(createPreset(entry, index));
                         }
                 }
         } catch(...) {
@@ -61,14 +62,77 @@ bool PresetFolder::loadPresets()
         return true;
 }
 
-Preset* PresetFolder::preset(size_t index) const
+std::shared_ptr<Preset> PresetFolder::createPreset(const std::filesystem::directory_entry &file,
+                                                   PresetIndex &index)
 {
+        auto indexEntry = index.entry(file);
+        if (!indexEntry)
+                indexEntry = &index.addEntry(PresetIndex::createEntry(file));
+        index.markVisited(file.path());
+        auto preset = std::make_shared<Preset>(file.path());
+        preset->setName(indexEntry->name);
+        preset->setAnalysis(indexEntry->analysis);
+        return preset;
+}
+
+bool PresetFolder::isPresetFile(const std::filesystem::path &path)
+{
+        return path.extension() == ".gkick" || path.extension() == ".gkit";
+}
+
+std::shared_ptr<Preset> PresetFolder::preset(size_t index) const
+{
+        std::lock_guard<std::mutex> lock(folderMutex);
         if (index < presetList.size())
-                return presetList[index].get();
+                return presetList[index];
         return nullptr;
 }
 
 size_t PresetFolder::numberOfPresets() const
 {
+        std::lock_guard<std::mutex> lock(folderMutex);
         return presetList.size();
 }
+
+bool PresetFolder::hasPreset(const std::filesystem::path &path) const
+{
+        std::lock_guard<std::mutex> lock(folderMutex);
+        for (const auto &preset: presetList) {
+                if (preset->path() == path)
+                        return true;
+        }
+        return false;
+}
+
+void PresetFolder::addPreset(const std::shared_ptr<Preset> &preset)
+{
+        std::lock_guard<std::mutex> lock(folderMutex);
+        for (auto &item: presetList) {
+                if (item->path() == preset->path()) {
+                        item = preset;
+                        return;
+                }
+        }
+        presetList.push_back(preset);
+}
+
+bool PresetFolder::removePreset(const std::filesystem::path &path)
+{
+        std::lock_guard<std::mutex> lock(folderMutex);
+        for (auto it = presetList.begin(); it != presetList.end(); ++it) {
+                if ((*it)->path() == path) {
+                        presetList.erase(it);
+                        return true;
+                }
+        }
+        return false;
+}
+
+std::vector<std::filesystem::path> PresetFolder::presetsPaths() const
+{
+        std::lock_guard<std::mutex> lock(folderMutex);
+        std::vector<std::filesystem::path> paths;
+        for (const auto &preset: presetList)
+                paths.push_back(preset->path());
+        return paths;
+}
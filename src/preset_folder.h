@@ -27,20 +27,36 @@
 #include "globals.h"
 
 class Preset;
+class PresetIndex;
 
+/**
+ * The presets list is updated by the presets registry thread
+ * while the presets are browsed. The presets are shared with the
+ * browsers, a removed preset is freed by its last holder.
+ */
 class PresetFolder {
  public:
         explicit PresetFolder(const std::filesystem::path &path);
         std::string name() const;
         std::filesystem::path path() const;
         void setPath(const std::filesystem::path &path);
-        bool loadPresets();
-        Preset* preset(size_t index) const;
+        bool loadPresets(PresetIndex &index);
+        std::shared_ptr<Preset> preset(size_t index) const;
         size_t numberOfPresets() const;
+        bool hasPreset(const std::filesystem::path &path) const;
+
+        /* Adds the preset or replaces the preset with the same path. */
+        void addPreset(const std::shared_ptr<Preset> &preset);
+        bool removePreset(const std::filesystem::path &path);
+        std::vector<std::filesystem::path> presetsPaths() const;
+        static bool isPresetFile(const std::filesystem::path &path);
+        static std::shared_ptr<Preset> createPreset(const std::filesystem::directory_entry &file,
+                                                    PresetIndex &index);
 
  private:
         std::filesystem::path folderPath;
-        std::vector<std::unique_ptr<Preset>> presetList;
+        mutable std::mutex folderMutex;
+        std::vector<std::shared_ptr<Preset>> presetList;
 };
 
 #endif // PRESET_FOLDER_H
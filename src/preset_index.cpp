@@ -0,0 +1,287 @@
+/**
+ * File name: preset_index.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "preset_index.h"
+#include "binary_state.h"
+#include "preset_analyzer.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PresetIndex::PresetIndex(const std::filesystem::path &file)
+        : indexFile{file}
+        , isModified{false}
+{
+}
+
+bool PresetIndex::load()
+{
+        std::ifstream file;
+        file.open(indexFile, std::ios::binary);
+        if (!file.is_open())
+                return false;
+
+        std::string data((std::istreambuf_iterator<char>(file)),
+                         (std::istreambuf_iterator<char>()));
+        file.close();
+
+        BinaryStateReader reader(data.data(), data.size());
+        if (!reader.readHeader())
+                return false;
+
+        bool isDropped = false;
+        std::string tag;
+        BinaryStateReader chunk(nullptr, 0);
+        while (reader.nextChunk(tag, chunk)) {
+                if (tag != "PRST")
+                        continue;
+                Entry entry;
+                entry.path = chunk.readString();
+                entry.modified = static_cast<int64_t>(chunk.readUInt64());
+                entry.size = chunk.readUInt64();
+                entry.type = static_cast<Preset::PresetType>(chunk.readUInt8());
+                entry.name = chunk.readString();
+                auto n = chunk.readUInt32();
+                for (decltype(n) i = 0; i < n && chunk.isValid(); i++)
+                        entry.tags.push_back(chunk.readString());
+                if (chunk.isValid() && !chunk.atEnd() && chunk.readBool()) {
+                        auto analysis = readAnalysis(chunk);
+                        if (analysis && chunk.isValid()) {
+                                analysis->tags = entry.tags;
+                                entry.analysis = analysis;
+                        } else {
+                                GEONKICK_LOG_ERROR("wrong preset analysis in the index: "
+                                                   << entry.path);
+                                isDropped = true;
+                                continue;
+                        }
+                }
+
+                if (chunk.isValid())
+                        indexEntries.insert({entry.path.string(), std::move(entry)});
+                else
+                        isDropped = true;
+        }
+
+        // The dropped entries are removed from the file on the next save.
+        isModified = isDropped || !reader.isValid();
+        return reader.isValid();
+}
+
+bool PresetIndex::save()
+{
+        if (!isModified)
+                return true;
+
+        BinaryStateWriter writer;
+        for (const auto &val: indexEntries) {
+                const auto &entry = val.second;
+                writer.beginChunk("PRST");
+                writer.writeString(entry.path.string());
+                writer.writeUInt64(static_cast<uint64_t>(entry.modified));
+                writer.writeUInt64(entry.size);
+                writer.writeUInt8(static_cast<uint8_t>(entry.type));
+                writer.writeString(entry.name);
+                writer.writeUInt32(entry.tags.size());
+                for (const auto &tag: entry.tags)
+                        writer.writeString(tag);
+                writer.writeBool(entry.analysis != nullptr);
+                if (entry.analysis)
+                        writeAnalysis(writer, *entry.analysis);
+                writer.endChunk();
+        }
+
+        /**
+         * Other instances may read or save the index at the same time,
+         * the index is written into a unique temporary file and renamed.
+         */
+        auto tmpPath = indexFile.string() + ".XXXXXX";
+        int fd = mkstemp(tmpPath.data());
+        if (fd < 0) {
+                GEONKICK_LOG_ERROR("can't create file for saving: " << tmpPath);
+                return false;
+        }
+        fchmod(fd, 0644);
+        close(fd);
+
+        std::filesystem::path tmpFile(tmpPath);
+        std::error_code error;
+        std::ofstream file;
+        file.open(tmpFile, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+                GEONKICK_LOG_ERROR("can't open file for saving: " << tmpFile);
+                std::filesystem::remove(tmpFile, error);
+                return false;
+        }
+        auto data = writer.takeData();
+        file.write(data.data(), data.size());
+        file.close();
+        if (!file) {
+                GEONKICK_LOG_ERROR("can't save presets index: " << tmpFile);
+                std::filesystem::remove(tmpFile, error);
+                return false;
+        }
+
+        std::filesystem::rename(tmpFile, indexFile, error);
+        if (error) {
+                GEONKICK_LOG_ERROR("can't save presets index: " << error.message());
+                std::filesystem::remove(tmpFile, error);
+                return false;
+        }
+        isModified = false;
+        return true;
+}
+
+const PresetIndex::Entry* PresetIndex::entry(const std::filesystem::directory_entry &file) const
+{
+        auto res = indexEntries.find(file.path().string());
+        if (res == indexEntries.end())
+                return nullptr;
+
+        std::error_code error;
+        auto modified = std::filesystem::last_write_time(file.path(), error);
+        if (error || res->second.modified != modified.time_since_epoch().count())
+                return nullptr;
+        auto size = std::filesystem::file_size(file.path(), error);
+        if (error || res->second.size != size)
+                return nullptr;
+        return &res->second;
+}
+
+const PresetIndex::Entry& PresetIndex::addEntry(Entry entry)
+{
+        auto key = entry.path.string();
+        isModified = true;
+        return indexEntries[key] = std::move(entry);
+}
+
+void PresetIndex::removeEntry(const std::filesystem::path &path)
+{
+        if (indexEntries.erase(path.string()))
+                isModified = true;
+}
+
+void PresetIndex::renameEntry(const std::filesystem::path &path,
+                              const std::filesystem::path &newPath)
+{
+        auto res = indexEntries.find(path.string());
+        if (res == indexEntries.end())
+                return;
+
+        auto entry = std::move(res->second);
+        indexEntries.erase(res);
+        Preset preset(newPath);
+        entry.path = newPath;
+        entry.type = preset.type();
+        entry.name = preset.name();
+        indexEntries[newPath.string()] = std::move(entry);
+        isModified = true;
+}
+
+void PresetIndex::setAnalysis(const std::filesystem::path &path,
+                              const std::shared_ptr<const PresetAnalysis> &analysis)
+{
+        auto res = indexEntries.find(path.string());
+        if (res != indexEntries.end()) {
+                res->second.analysis = analysis;
+                // The tags are found while the preset is analyzed.
+                res->second.tags = analysis ? analysis->tags : std::vector<std::string>();
+                isModified = true;
+        }
+}
+
+void PresetIndex::markVisited(const std::filesystem::path &path)
+{
+        visitedEntries.insert(path.string());
+}
+
+void PresetIndex::removeNotVisited()
+{
+        for (auto it = indexEntries.begin(); it != indexEntries.end();) {
+                if (visitedEntries.find(it->first) == visitedEntries.end()) {
+                        it = indexEntries.erase(it);
+                        isModified = true;
+                } else {
+                        ++it;
+                }
+        }
+        visitedEntries.clear();
+}
+
+PresetIndex::Entry PresetIndex::createEntry(const std::filesystem::directory_entry &file)
+{
+        Entry entry;
+        entry.path = file.path();
+        std::error_code error;
+        entry.modified = std::filesystem::last_write_time(file.path(), error).time_since_epoch().count();
+        entry.size = std::filesystem::file_size(file.path(), error);
+        if (error)
+                entry.size = 0;
+        Preset preset(file.path());
+        entry.type = preset.type();
+        entry.name = preset.name();
+        return entry;
+}
+
+/**
+ * The thumbnail values are quantized to 8 bits, the features
+ * are saved as double.
+ */
+void PresetIndex::writeAnalysis(BinaryStateWriter &writer, const PresetAnalysis &analysis)
+{
+        writer.writeUInt32(analysis.percussions.size());
+        for (const auto &features: analysis.percussions) {
+                writer.writeString(features.name);
+                writer.writeUInt32(features.peaks.size());
+                for (const auto &val: features.peaks) {
+                        auto q = std::lround(127.5f * (std::clamp(val, -1.0f, 1.0f) + 1.0f));
+                        writer.writeUInt8(static_cast<uint8_t>(q));
+                }
+                writer.writeDouble(features.peak);
+                writer.writeDouble(features.rms);
+                writer.writeDouble(features.length);
+                writer.writeDouble(features.fundamental);
+        }
+}
+
+std::shared_ptr<PresetAnalysis> PresetIndex::readAnalysis(BinaryStateReader &reader)
+{
+        auto analysis = std::make_shared<PresetAnalysis>();
+        auto n = reader.readUInt32();
+        for (decltype(n) i = 0; i < n && reader.isValid(); i++) {
+                PercussionFeatures features;
+                features.name = reader.readString();
+                auto size = reader.readUInt32();
+                for (decltype(size) j = 0; j < size && reader.isValid(); j++)
+                        features.peaks.push_back(reader.readUInt8() / 127.5f - 1.0f);
+                features.peak = reader.readDouble();
+                features.rms = reader.readDouble();
+                features.length = reader.readDouble();
+                features.fundamental = reader.readDouble();
+                analysis->percussions.push_back(std::move(features));
+        }
+        return reader.isValid() ? analysis : nullptr;
+}
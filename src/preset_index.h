@@ -0,0 +1,84 @@
+/**
+ * File name: preset_index.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef PRESET_INDEX_H
+#define PRESET_INDEX_H
+
+#include "globals.h"
+#include "preset.h"
+
+#include <unordered_set>
+
+struct PresetAnalysis;
+class BinaryStateWriter;
+class BinaryStateReader;
+
+/**
+ * Persistent index of the presets files.
+ *
+ * Keeps the metadata of every preset file found in the presets
+ * folders, so the presets are listed without reading the files.
+ * An entry is valid while the file modification time and size
+ * are unchanged, including the analysis of the preset. The index is
+ * saved in the binary state format, one "PRST" chunk per entry.
+ */
+class PresetIndex {
+ public:
+        struct Entry {
+                std::filesystem::path path;
+                int64_t modified;
+                uint64_t size;
+                Preset::PresetType type;
+                std::string name;
+                std::vector<std::string> tags;
+                std::shared_ptr<const PresetAnalysis> analysis;
+        };
+
+        explicit PresetIndex(const std::filesystem::path &file);
+        bool load();
+        bool save();
+        const Entry* entry(const std::filesystem::directory_entry &file) const;
+        const Entry& addEntry(Entry entry);
+        void removeEntry(const std::filesystem::path &path);
+        /* Moves the entry to the new path of the renamed file. */
+        void renameEntry(const std::filesystem::path &path,
+                         const std::filesystem::path &newPath);
+        void setAnalysis(const std::filesystem::path &path,
+                         const std::shared_ptr<const PresetAnalysis> &analysis);
+        void markVisited(const std::filesystem::path &path);
+        void removeNotVisited();
+        static Entry createEntry(const std::filesystem::directory_entry &file);
+
+ protected:
+        static void writeAnalysis(BinaryStateWriter &writer, const PresetAnalysis &analysis);
+        static std::shared_ptr<PresetAnalysis> readAnalysis(BinaryStateReader &reader);
+
+ private:
+        std::filesystem::path indexFile;
+        std::unordered_map<std::string, Entry> indexEntries;
+        std::unordered_set<std::string> visitedEntries;
+        bool isModified;
+};
+
+#endif // PRESET_INDEX_H
@@ -0,0 +1,476 @@
+/**
+ * File name: preset_registry.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "preset_registry.h"
+#include "preset_folder.h"
+#include "preset.h"
+#include "preset_index.h"
+#include "preset_analyzer.h"
+#include "preset_search_index.h"
+
+std::shared_ptr<PresetRegistry> PresetRegistry::instance()
+{
+        static std::mutex instanceMutex;
+        static std::weak_ptr<PresetRegistry> registryInstance;
+        std::lock_guard<std::mutex> lock(instanceMutex);
+        auto registry = registryInstance.lock();
+        if (!registry) {
+                registry = std::shared_ptr<PresetRegistry>(new PresetRegistry);
+                registryInstance = registry;
+        }
+        return registry;
+}
+
+PresetRegistry::PresetRegistry()
+        : presetsLoaded{false}
+        , stopScan{false}
+        , samplesSize{0}
+{
+}
+
+PresetRegistry::~PresetRegistry()
+{
+        stopScan = true;
+        if (scanThread.joinable())
+                scanThread.join();
+}
+
+void PresetRegistry::loadPresets(const std::vector<std::filesystem::path> &paths,
+                                 const std::filesystem::path &indexFile)
+{
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (presetsLoaded)
+                return;
+
+        scanThread = std::thread(&PresetRegistry::scanPresets, this, paths, indexFile);
+        presetsLoaded = true;
+}
+
+void PresetRegistry::scanPresets(const std::vector<std::filesystem::path> &paths,
+                                 const std::filesystem::path &indexFile)
+{
+        PresetIndex index(indexFile);
+        if (!indexFile.empty())
+                index.load();
+
+        // The watches are added before the scan to not miss the changes during the scan.
+        PresetWatcher watcher;
+        presetsRoots = paths;
+        for (const auto &path: paths) {
+                if (stopScan)
+                        return;
+                try {
+                        if (std::filesystem::exists(path)) {
+                                watcher.addWatch(path);
+                                loadPresetsFolders(path, index, watcher);
+                        }
+                } catch(const std::exception& e) {
+                        GEONKICK_LOG_ERROR("error on reading path: " << path << ": " << e.what());
+                }
+        }
+
+        if (stopScan)
+                return;
+
+        index.removeNotVisited();
+        if (!indexFile.empty())
+                index.save();
+        updateSearchIndex();
+        notifyListeners();
+
+        analyzePresets(index);
+        if (!indexFile.empty())
+                index.save();
+
+        watchPresets(watcher, index, indexFile);
+}
+
+void PresetRegistry::watchPresets(PresetWatcher &watcher,
+                                  PresetIndex &index,
+                                  const std::filesystem::path &indexFile)
+{
+        // The timeout is the longest wait for the registry to stop.
+        constexpr int watchTimeout = 250;
+        while (!stopScan && watcher.isValid()) {
+                auto events = watcher.readEvents(watchTimeout);
+                if (events.empty())
+                        continue;
+
+                for (const auto &event: events) {
+                        if (stopScan)
+                                return;
+                        applyEvent(event, watcher, index);
+                }
+                updateSearchIndex();
+                notifyListeners();
+
+                analyzePresets(index);
+                if (!indexFile.empty())
+                        index.save();
+        }
+}
+
+void PresetRegistry::applyEvent(const PresetWatcher::Event &event,
+                                PresetWatcher &watcher,
+                                PresetIndex &index)
+{
+        using Type = PresetWatcher::Event::Type;
+        auto isRoot = [this](const std::filesystem::path &path) {
+                return std::find(presetsRoots.begin(), presetsRoots.end(), path) != presetsRoots.end();
+        };
+
+        switch (event.type) {
+        case Type::Created:
+                if (!event.isDirectory)
+                        updatePreset(event.path, index);
+                else if (isRoot(event.path.parent_path()))
+                        addFolder(event.path, index, watcher);
+                break;
+        case Type::Removed:
+                if (event.isDirectory)
+                        removeFolder(event.path, index, watcher);
+                else
+                        removePreset(event.path, index);
+                break;
+        case Type::Renamed:
+                if (!event.isDirectory) {
+                        renamePreset(event.path, event.newPath, index);
+                } else {
+                        removeFolder(event.path, index, watcher);
+                        if (isRoot(event.newPath.parent_path()))
+                                addFolder(event.newPath, index, watcher);
+                }
+                break;
+        case Type::Overflow:
+                rescanPresets(index, watcher);
+                break;
+        default:
+                break;
+        }
+}
+
+std::shared_ptr<PresetFolder> PresetRegistry::findFolder(const std::filesystem::path &path) const
+{
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto &folder: presetsFoldersList) {
+                if (folder->path() == path)
+                        return folder;
+        }
+        return nullptr;
+}
+
+void PresetRegistry::addFolder(const std::filesystem::path &path,
+                               PresetIndex &index,
+                               PresetWatcher &watcher)
+{
+        if (findFolder(path))
+                return;
+
+        watcher.addWatch(path);
+        auto presetFolder = std::make_shared<PresetFolder>(path);
+        if (!presetFolder->loadPresets(index)) {
+                GEONKICK_LOG_ERROR("can't load preset from folder " << path);
+                return;
+        }
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        presetsFoldersList.push_back(std::move(presetFolder));
+}
+
+void PresetRegistry::removeFolder(const std::filesystem::path &path,
+                                  PresetIndex &index,
+                                  PresetWatcher &watcher)
+{
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto it = presetsFoldersList.begin(); it != presetsFoldersList.end(); ++it) {
+                if ((*it)->path() == path) {
+                        watcher.removeWatch(path);
+                        for (const auto &presetPath: (*it)->presetsPaths())
+                                index.removeEntry(presetPath);
+                        presetsFoldersList.erase(it);
+                        return;
+                }
+        }
+}
+
+void PresetRegistry::updatePreset(const std::filesystem::path &path, PresetIndex &index)
+{
+        auto folder = findFolder(path.parent_path());
+        if (!folder || !PresetFolder::isPresetFile(path))
+                return;
+
+        std::error_code error;
+        std::filesystem::directory_entry file(path, error);
+        if (error || !file.is_regular_file(error))
+                return;
+
+        // The preset is unchanged if the index entry is still valid.
+        if (index.entry(file) && folder->hasPreset(path))
+                return;
+
+        GEONKICK_LOG_DEBUG("preset updated: " << path);
+        folder->addPreset(PresetFolder::createPreset(file, index));
+}
+
+void PresetRegistry::removePreset(const std::filesystem::path &path, PresetIndex &index)
+{
+        auto folder = findFolder(path.parent_path());
+        if (!folder)
+                return;
+
+        GEONKICK_LOG_DEBUG("preset removed: " << path);
+        index.removeEntry(path);
+        folder->removePreset(path);
+}
+
+/**
+ * The index entry of the renamed preset is kept,
+ * so the preset is not analyzed again.
+ */
+void PresetRegistry::renamePreset(const std::filesystem::path &path,
+                                  const std::filesystem::path &newPath,
+                                  PresetIndex &index)
+{
+        if (PresetFolder::isPresetFile(newPath) && findFolder(newPath.parent_path()))
+                index.renameEntry(path, newPath);
+        removePreset(path, index);
+        updatePreset(newPath, index);
+}
+
+/**
+ * Called when the watch events were lost. The folders and the presets
+ * are synchronized with the files, the unchanged presets are kept.
+ */
+void PresetRegistry::rescanPresets(PresetIndex &index, PresetWatcher &watcher)
+{
+        std::vector<std::filesystem::path> folders;
+        {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                for (const auto &folder: presetsFoldersList)
+                        folders.push_back(folder->path());
+        }
+
+        for (const auto &path: folders) {
+                std::error_code error;
+                if (!std::filesystem::is_directory(path, error)) {
+                        removeFolder(path, index, watcher);
+                        continue;
+                }
+
+                auto folder = findFolder(path);
+                if (!folder)
+                        continue;
+                for (const auto &presetPath: folder->presetsPaths()) {
+                        if (!std::filesystem::exists(presetPath, error))
+                                removePreset(presetPath, index);
+                }
+
+                for (const auto &entry: std::filesystem::directory_iterator(path, error)) {
+                        if (entry.is_regular_file(error))
+                                updatePreset(entry.path(), index);
+                }
+        }
+
+        for (const auto &root: presetsRoots) {
+                std::error_code error;
+                for (const auto &entry: std::filesystem::directory_iterator(root, error)) {
+                        if (entry.is_directory(error))
+                                addFolder(entry.path(), index, watcher);
+                }
+        }
+}
+
+void PresetRegistry::analyzePresets(PresetIndex &index)
+{
+        std::vector<std::shared_ptr<Preset>> presets;
+        {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                for (const auto &folder: presetsFoldersList) {
+                        for (size_t i = 0; i < folder->numberOfPresets(); i++) {
+                                auto preset = folder->preset(i);
+                                if (preset && !preset->analysis())
+                                        presets.push_back(preset);
+                        }
+                }
+        }
+
+        if (presets.empty())
+                return;
+
+        /**
+         * Every thread renders with its own analyzer. One core is
+         * left for the audio and the GUI threads.
+         */
+        auto threadsNumber = std::thread::hardware_concurrency();
+        threadsNumber = threadsNumber > 1 ? threadsNumber - 1 : 1;
+        threadsNumber = std::min(threadsNumber, static_cast<decltype(threadsNumber)>(presets.size()));
+        std::atomic<size_t> nextPreset{0};
+        std::mutex indexMutex;
+        size_t analyzedPresets = 0;
+        constexpr size_t notifyInterval = 16;
+        auto analyze = [&](void) {
+                PresetAnalyzer analyzer;
+                size_t i;
+                while (!stopScan && (i = nextPreset++) < presets.size()) {
+                        auto preset = presets[i];
+                        // The presets that can't be rendered get an empty analysis.
+                        std::shared_ptr<const PresetAnalysis> analysis = analyzer.analyze(preset->path(),
+                                                                                          preset->type());
+                        if (!analysis)
+                                analysis = std::make_shared<PresetAnalysis>();
+                        preset->setAnalysis(analysis);
+                        std::lock_guard<std::mutex> lock(indexMutex);
+                        index.setAnalysis(preset->path(), analysis);
+                        if (++analyzedPresets % notifyInterval == 0)
+                                notifyListeners();
+                }
+        };
+
+        std::vector<std::thread> threads;
+        for (decltype(threadsNumber) i = 1; i < threadsNumber; i++)
+                threads.emplace_back(analyze);
+        analyze();
+        for (auto &thread: threads)
+                thread.join();
+        updateSearchIndex();
+        notifyListeners();
+}
+
+void PresetRegistry::loadPresetsFolders(const std::filesystem::path &path,
+                                        PresetIndex &index,
+                                        PresetWatcher &watcher)
+{
+        try {
+                for (const auto &entry : std::filesystem::directory_iterator(path)) {
+                        if (stopScan)
+                                return;
+                        if (!entry.path().empty() && std::filesystem::is_directory(entry.path())) {
+                                auto presetFolder = std::make_shared<PresetFolder>(entry.path());
+                                GEONKICK_LOG_DEBUG("preset folder " << presetFolder->path());
+                                watcher.addWatch(entry.path());
+                                if (!presetFolder->loadPresets(index)) {
+                                        GEONKICK_LOG_ERROR("can't load preset from folder " << presetFolder->path());
+                                } else {
+                                        {
+                                                std::lock_guard<std::mutex> lock(registryMutex);
+                                                presetsFoldersList.push_back(std::move(presetFolder));
+                                        }
+                                        notifyListeners();
+                                }
+                        }
+                }
+        } catch(...) {
+                GEONKICK_LOG_ERROR("error on reading path: " << path);
+        }
+}
+
+void PresetRegistry::addListener(void *listener, const PresetsCallback &callback)
+{
+        std::lock_guard<std::mutex> lock(listenersMutex);
+        presetsListeners[listener] = callback;
+}
+
+void PresetRegistry::removeListener(void *listener)
+{
+        std::lock_guard<std::mutex> lock(listenersMutex);
+        presetsListeners.erase(listener);
+}
+
+void PresetRegistry::notifyListeners()
+{
+        std::lock_guard<std::mutex> lock(listenersMutex);
+        for (const auto &listener: presetsListeners)
+                listener.second();
+}
+
+std::vector<std::shared_ptr<Preset>> PresetRegistry::searchPresets(const std::string &query, size_t maxResults)
+{
+        std::vector<std::shared_ptr<Preset>> presets;
+        auto index = std::atomic_load(&searchIndex);
+        if (index) {
+                for (const auto &result: index->search(query, maxResults))
+                        presets.push_back(result.preset);
+        }
+        return presets;
+}
+
+void PresetRegistry::updateSearchIndex()
+{
+        auto index = std::make_shared<PresetSearchIndex>();
+        {
+                std::lock_guard<std::mutex> lock(registryMutex);
+                for (const auto &folder: presetsFoldersList) {
+                        for (size_t i = 0; i < folder->numberOfPresets(); i++) {
+                                auto preset = folder->preset(i);
+                                if (preset)
+                                        index->addPreset(preset, folder);
+                        }
+                }
+        }
+        std::atomic_store(&searchIndex, std::shared_ptr<const PresetSearchIndex>(index));
+}
+
+std::shared_ptr<PresetFolder> PresetRegistry::getPresetFolder(size_t index) const
+{
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (index < presetsFoldersList.size())
+                return presetsFoldersList[index];
+        return nullptr;
+}
+
+size_t PresetRegistry::numberOfPresetFolders() const
+{
+        std::lock_guard<std::mutex> lock(registryMutex);
+        return presetsFoldersList.size();
+}
+
+SampleRef PresetRegistry::getSample(const std::string &key)
+{
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto res = samplesMap.find(key);
+        if (res == samplesMap.end())
+                return SampleRef();
+
+        samplesList.splice(samplesList.end(), samplesList, res->second);
+        return res->second->second;
+}
+
+void PresetRegistry::addSample(const std::string &key, const SampleRef &sample)
+{
+        if (sample.empty() || sample.size() * sizeof(gkick_real) > samplesBudget)
+                return;
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (samplesMap.find(key) != samplesMap.end())
+                return;
+
+        size_t bytes = sample.size() * sizeof(gkick_real);
+        while (samplesSize + bytes > samplesBudget && !samplesList.empty()) {
+                samplesSize -= samplesList.front().second.size() * sizeof(gkick_real);
+                samplesMap.erase(samplesList.front().first);
+                samplesList.pop_front();
+        }
+
+        samplesMap.insert({key, samplesList.insert(samplesList.end(), {key, sample})});
+        samplesSize += bytes;
+}
@@ -0,0 +1,126 @@
+/**
+ * File name: preset_registry.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef PRESET_REGISTRY_H
+#define PRESET_REGISTRY_H
+
+#include "globals.h"
+#include "sample_ref.h"
+#include "preset_watcher.h"
+
+#include <list>
+#include <functional>
+#include <thread>
+
+class PresetFolder;
+class PresetIndex;
+class Preset;
+class PresetSearchIndex;
+
+/**
+ * Preset folders and loaded samples shared by all
+ * the Geonkick instances of the process. The least recently
+ * used samples are removed when the memory budget is exceeded. The registry lives
+ * as long as there is at least one instance holding it.
+ *
+ * The folders and the presets are shared with the browsers, the removed
+ * ones are freed when the browsers and the search index release them.
+ */
+class PresetRegistry {
+ public:
+        using PresetsCallback = std::function<void(void)>;
+        static std::shared_ptr<PresetRegistry> instance();
+        ~PresetRegistry();
+
+        /**
+         * Starts scanning the presets folders in background.
+         * The folders are added as they are loaded and the
+         * listeners are notified after each folder. After the
+         * scan the presets without analysis are analyzed and the
+         * folders are watched, the changes of the presets files
+         * are applied to the folders and the index as they happen.
+         */
+        void loadPresets(const std::vector<std::filesystem::path> &paths,
+                         const std::filesystem::path &indexFile);
+        void addListener(void *listener, const PresetsCallback &callback);
+        void removeListener(void *listener);
+        std::shared_ptr<PresetFolder> getPresetFolder(size_t index) const;
+        size_t numberOfPresetFolders() const;
+        /**
+         * Returns the presets matching the query ordered by relevance.
+         * The search index is rebuilt by the registry thread after
+         * the presets are changed.
+         */
+        std::vector<std::shared_ptr<Preset>> searchPresets(const std::string &query, size_t maxResults);
+        SampleRef getSample(const std::string &key);
+        void addSample(const std::string &key, const SampleRef &sample);
+
+ protected:
+        PresetRegistry();
+        void scanPresets(const std::vector<std::filesystem::path> &paths,
+                         const std::filesystem::path &indexFile);
+        void loadPresetsFolders(const std::filesystem::path &path,
+                                PresetIndex &index,
+                                PresetWatcher &watcher);
+        void analyzePresets(PresetIndex &index);
+        void watchPresets(PresetWatcher &watcher,
+                          PresetIndex &index,
+                          const std::filesystem::path &indexFile);
+        void applyEvent(const PresetWatcher::Event &event,
+                        PresetWatcher &watcher,
+                        PresetIndex &index);
+        void addFolder(const std::filesystem::path &path,
+                       PresetIndex &index,
+                       PresetWatcher &watcher);
+        void removeFolder(const std::filesystem::path &path,
+                          PresetIndex &index,
+                          PresetWatcher &watcher);
+        void updatePreset(const std::filesystem::path &path, PresetIndex &index);
+        void removePreset(const std::filesystem::path &path, PresetIndex &index);
+        void renamePreset(const std::filesystem::path &path,
+                          const std::filesystem::path &newPath,
+                          PresetIndex &index);
+        void rescanPresets(PresetIndex &index, PresetWatcher &watcher);
+        std::shared_ptr<PresetFolder> findFolder(const std::filesystem::path &path) const;
+        void updateSearchIndex();
+        void notifyListeners();
+
+ private:
+        /* Memory budget for the loaded samples in bytes. */
+        static constexpr size_t samplesBudget = 64 * 1024 * 1024;
+        mutable std::mutex registryMutex;
+        bool presetsLoaded;
+        std::vector<std::shared_ptr<PresetFolder>> presetsFoldersList;
+        std::vector<std::filesystem::path> presetsRoots;
+        std::thread scanThread;
+        std::atomic<bool> stopScan;
+        std::shared_ptr<const PresetSearchIndex> searchIndex;
+        std::mutex listenersMutex;
+        std::unordered_map<void*, PresetsCallback> presetsListeners;
+        /* The loaded samples ordered from the least recently used. */
+        std::list<std::pair<std::string, SampleRef>> samplesList;
+        std::unordered_map<std::string, decltype(samplesList)::iterator> samplesMap;
+        size_t samplesSize;
+};
+
+#endif // PRESET_REGISTRY_H
@@ -0,0 +1,315 @@
+/**
+ * File name: preset_search_index.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "preset_search_index.h"
+#include "preset.h"
+#include "preset_folder.h"
+#include "preset_analyzer.h"
+
+#include <numeric>
+
+size_t PresetSearchIndex::size() const
+{
+        return documents.size();
+}
+
+/**
+ * The text is lowercased and the ASCII punctuation is replaced
+ * by spaces. The UTF-8 sequences are kept unchanged.
+ */
+std::string PresetSearchIndex::normalize(const std::string &text)
+{
+        std::string normalized;
+        normalized.reserve(text.size());
+        for (unsigned char c: text) {
+                if (c >= 0x80 || std::isalnum(c))
+                        normalized.push_back(std::tolower(c));
+                else if (!normalized.empty() && normalized.back() != ' ')
+                        normalized.push_back(' ');
+        }
+        if (!normalized.empty() && normalized.back() == ' ')
+                normalized.pop_back();
+        return normalized;
+}
+
+std::vector<std::string> PresetSearchIndex::words(const std::string &text)
+{
+        std::vector<std::string> result;
+        size_t start = 0;
+        while (start < text.size()) {
+                auto end = text.find(' ', start);
+                if (end == std::string::npos)
+                        end = text.size();
+                if (end > start)
+                        result.push_back(text.substr(start, end - start));
+                start = end + 1;
+        }
+        return result;
+}
+
+PresetSearchIndex::Key PresetSearchIndex::ngramKey(const char *ngram, size_t n)
+{
+        Key key = static_cast<Key>(n) << 24;
+        for (size_t i = 0; i < n; i++)
+                key |= static_cast<Key>(static_cast<unsigned char>(ngram[i])) << (8 * (2 - i));
+        return key;
+}
+
+/**
+ * Adds the trigrams of the word padded with spaces
+ * and the bigram of the word start.
+ */
+void PresetSearchIndex::addWordKeys(const std::string &word, std::vector<Key> &keys)
+{
+        if (word.empty())
+                return;
+
+        char start[3] = {' ', word[0], word.size() > 1 ? word[1] : ' '};
+        keys.push_back(ngramKey(start, 2));
+        keys.push_back(ngramKey(start, 3));
+        for (size_t i = 0; i + 2 < word.size(); i++)
+                keys.push_back(ngramKey(&word[i], 3));
+        if (word.size() > 1) {
+                char end[3] = {word[word.size() - 2], word.back(), ' '};
+                keys.push_back(ngramKey(end, 3));
+        }
+}
+
+/**
+ * Returns the n-grams that every text containing the word has:
+ * the trigrams of the word or the start of a word for the words
+ * shorter than three characters.
+ */
+std::vector<PresetSearchIndex::Key> PresetSearchIndex::queryKeys(const std::string &word)
+{
+        std::vector<Key> keys;
+        if (word.size() < 3) {
+                char start[3] = {' ', word[0], word.size() > 1 ? word[1] : ' '};
+                keys.push_back(ngramKey(start, word.size() + 1));
+        } else {
+                for (size_t i = 0; i + 2 < word.size(); i++)
+                        keys.push_back(ngramKey(&word[i], 3));
+        }
+        return keys;
+}
+
+void PresetSearchIndex::addPreset(const std::shared_ptr<Preset> &preset,
+                                  const std::shared_ptr<PresetFolder> &folder)
+{
+        Document document;
+        document.preset = preset;
+        document.folder = folder;
+        document.name = normalize(preset->name());
+        document.text = document.name;
+        if (folder)
+                document.text += " " + normalize(folder->name());
+        auto analysis = preset->analysis();
+        if (analysis) {
+                for (const auto &percussion: analysis->percussions)
+                        document.text += " " + normalize(percussion.name);
+                for (const auto &tag: analysis->tags)
+                        document.text += " " + normalize(tag);
+        }
+
+        std::vector<Key> keys;
+        for (const auto &word: words(document.name))
+                addWordKeys(word, keys);
+        // The name trigrams are added also flagged, for ranking the fuzzy matches.
+        auto nameKeys = keys.size();
+        for (size_t i = 0; i < nameKeys; i++) {
+                if ((keys[i] >> 24) == 3)
+                        keys.push_back(keys[i] | nameKeyFlag);
+        }
+        for (const auto &word: words(document.text.substr(document.name.size())))
+                addWordKeys(word, keys);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        auto id = static_cast<uint32_t>(documents.size());
+        for (auto key: keys)
+                postingLists[key].push_back(id);
+        documents.push_back(std::move(document));
+}
+
+const PresetSearchIndex::PostingList* PresetSearchIndex::postingList(Key key) const
+{
+        auto res = postingLists.find(key);
+        if (res == postingLists.end())
+                return nullptr;
+        return &res->second;
+}
+
+/**
+ * Keeps the candidates found in the list. The much longer lists
+ * are searched instead of merged.
+ */
+void PresetSearchIndex::intersect(PostingList &candidates, const PostingList &list)
+{
+        if (list.size() > 16 * candidates.size()) {
+                auto it = list.begin();
+                candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                                [&](uint32_t id) {
+                                                        it = std::lower_bound(it, list.end(), id);
+                                                        return it == list.end() || *it != id;
+                                                }), candidates.end());
+        } else {
+                PostingList intersection;
+                std::set_intersection(candidates.begin(), candidates.end(),
+                                      list.begin(), list.end(),
+                                      std::back_inserter(intersection));
+                candidates = std::move(intersection);
+        }
+}
+
+float PresetSearchIndex::matchScore(const Document &document, const std::string &word)
+{
+        for (auto pos = document.name.find(word); pos != std::string::npos;
+             pos = document.name.find(word, pos + 1)) {
+                if (pos == 0)
+                        return 4.0f;
+                if (document.name[pos - 1] == ' ')
+                        return 3.0f;
+                if (word.size() > 2)
+                        return 2.0f;
+        }
+
+        for (auto pos = document.text.find(word, document.name.size()); pos != std::string::npos;
+             pos = document.text.find(word, pos + 1)) {
+                if (document.text[pos - 1] == ' ')
+                        return 1.5f;
+                if (word.size() > 2)
+                        return 1.0f;
+        }
+        return 0.0f;
+}
+
+std::vector<PresetSearchIndex::Result>
+PresetSearchIndex::search(const std::string &query, size_t maxResults) const
+{
+        auto queryWords = words(normalize(query));
+        if (queryWords.empty() || documents.empty())
+                return {};
+
+        std::vector<const PostingList*> lists;
+        for (const auto &word: queryWords) {
+                for (auto key: queryKeys(word)) {
+                        auto list = postingList(key);
+                        if (!list) {
+                                lists.clear();
+                                break;
+                        }
+                        lists.push_back(list);
+                }
+                if (lists.empty())
+                        break;
+        }
+
+        // Intersect starting from the shortest posting list.
+        std::sort(lists.begin(), lists.end(), [](const auto *a, const auto *b) {
+                return a->size() < b->size();
+        });
+        PostingList candidates;
+        if (!lists.empty())
+                candidates = *lists.front();
+        for (size_t i = 1; i < lists.size() && !candidates.empty(); i++)
+                intersect(candidates, *lists[i]);
+
+        std::vector<std::pair<float, uint32_t>> scores;
+        for (auto id: candidates) {
+                float score = 0;
+                for (const auto &word: queryWords) {
+                        auto wordScore = matchScore(documents[id], word);
+                        if (wordScore == 0) {
+                                score = 0;
+                                break;
+                        }
+                        score += wordScore;
+                }
+                if (score > 0)
+                        scores.emplace_back(score, id);
+        }
+
+        if (scores.empty())
+                scores = fuzzySearch(queryWords);
+
+        auto n = std::min(maxResults, scores.size());
+        std::partial_sort(scores.begin(), scores.begin() + n, scores.end(),
+                          [this](const auto &a, const auto &b) {
+                                  if (a.first != b.first)
+                                          return a.first > b.first;
+                                  return documents[a.second].name < documents[b.second].name;
+                          });
+
+        std::vector<Result> results;
+        results.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+                const auto &document = documents[scores[i].second];
+                results.push_back({document.preset, document.folder, scores[i].first});
+        }
+        return results;
+}
+
+/**
+ * Returns the documents sharing at least half of the query trigrams.
+ * The score is the shared trigrams ratio, the trigrams shared by
+ * the preset name count twice.
+ */
+std::vector<std::pair<float, uint32_t>>
+PresetSearchIndex::fuzzySearch(const std::vector<std::string> &queryWords) const
+{
+        std::vector<Key> keys;
+        for (const auto &word: queryWords)
+                addWordKeys(word, keys);
+        keys.erase(std::remove_if(keys.begin(), keys.end(),
+                                  [](Key key) { return (key >> 24) != 3; }),
+                   keys.end());
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        if (keys.empty())
+                return {};
+
+        // The shared trigrams of the text and of the name of every document.
+        std::vector<std::pair<uint16_t, uint16_t>> sharedTrigrams(documents.size(), {0, 0});
+        for (auto key: keys) {
+                if (auto list = postingList(key)) {
+                        for (auto id: *list)
+                                sharedTrigrams[id].first++;
+                }
+                if (auto list = postingList(key | nameKeyFlag)) {
+                        for (auto id: *list)
+                                sharedTrigrams[id].second++;
+                }
+        }
+
+        std::vector<std::pair<float, uint32_t>> scores;
+        auto minShared = (keys.size() + 1) / 2;
+        for (size_t id = 0; id < sharedTrigrams.size(); id++) {
+                const auto &shared = sharedTrigrams[id];
+                if (shared.first >= minShared) {
+                        float score = static_cast<float>(shared.first + shared.second) / (2 * keys.size());
+                        scores.emplace_back(score, id);
+                }
+        }
+        return scores;
+}
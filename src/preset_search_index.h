@@ -0,0 +1,93 @@
+/**
+ * File name: preset_search_index.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef PRESET_SEARCH_INDEX_H
+#define PRESET_SEARCH_INDEX_H
+
+#include "globals.h"
+
+class Preset;
+class PresetFolder;
+
+/**
+ * In-memory trigram index of the presets text: the preset name,
+ * the folder name, the kit percussions names and the tags.
+ *
+ * Every query word must be a substring of the preset text, the words
+ * shorter than three characters must start a word. The candidates are
+ * found by intersecting the posting lists of the words n-grams,
+ * starting from the shortest list, and verified while scored. If
+ * nothing matches, the presets sharing most of the query trigrams,
+ * including the words boundaries, are returned as fuzzy matches,
+ * so the misspelled words are found. The index is not changed
+ * after it is built.
+ */
+class PresetSearchIndex {
+ public:
+        struct Result {
+                std::shared_ptr<Preset> preset;
+                std::shared_ptr<PresetFolder> folder;
+                float score;
+        };
+
+        PresetSearchIndex() = default;
+        void addPreset(const std::shared_ptr<Preset> &preset,
+                       const std::shared_ptr<PresetFolder> &folder);
+        size_t size() const;
+        std::vector<Result> search(const std::string &query, size_t maxResults) const;
+        static std::string normalize(const std::string &text);
+
+ protected:
+        struct Document {
+                std::shared_ptr<Preset> preset;
+                std::shared_ptr<PresetFolder> folder;
+                /* Normalized preset name. */
+                std::string name;
+                /* Normalized name, folder name, percussions names and tags. */
+                std::string text;
+        };
+
+        /**
+         * The n-gram bytes, the length and the flag of the
+         * n-grams of the preset name in the highest byte.
+         */
+        using Key = uint32_t;
+        static constexpr Key nameKeyFlag = 0x80000000;
+        using PostingList = std::vector<uint32_t>;
+        static Key ngramKey(const char *ngram, size_t n);
+        static void addWordKeys(const std::string &word, std::vector<Key> &keys);
+        static std::vector<Key> queryKeys(const std::string &word);
+        static std::vector<std::string> words(const std::string &text);
+        const PostingList* postingList(Key key) const;
+        static void intersect(PostingList &candidates, const PostingList &list);
+        std::vector<std::pair<float, uint32_t>> fuzzySearch(const std::vector<std::string> &queryWords) const;
+        static float matchScore(const Document &document, const std::string &word);
+
+ private:
+        std::vector<Document> documents;
+        /* The documents containing the n-gram, in ascending order. */
+        std::unordered_map<Key, PostingList> postingLists;
+};
+
+#endif // PRESET_SEARCH_INDEX_H
@@ -0,0 +1,136 @@
+/**
+ * File name: preset_watcher.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "preset_watcher.h"
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+PresetWatcher::PresetWatcher()
+        : inotifyFd{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)}
+{
+        if (inotifyFd < 0)
+                GEONKICK_LOG_ERROR("can't initialize inotify");
+}
+
+PresetWatcher::~PresetWatcher()
+{
+        if (inotifyFd > -1)
+                close(inotifyFd);
+}
+
+bool PresetWatcher::isValid() const
+{
+        return inotifyFd > -1;
+}
+
+bool PresetWatcher::addWatch(const std::filesystem::path &path)
+{
+        if (inotifyFd < 0)
+                return false;
+
+        auto wd = inotify_add_watch(inotifyFd, path.c_str(),
+                                    IN_CREATE | IN_CLOSE_WRITE | IN_DELETE
+                                    | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+        if (wd < 0) {
+                GEONKICK_LOG_ERROR("can't watch path " << path);
+                return false;
+        }
+        watchedPaths[wd] = path;
+        return true;
+}
+
+void PresetWatcher::removeWatch(const std::filesystem::path &path)
+{
+        for (auto it = watchedPaths.begin(); it != watchedPaths.end(); ++it) {
+                if (it->second == path) {
+                        inotify_rm_watch(inotifyFd, it->first);
+                        watchedPaths.erase(it);
+                        return;
+                }
+        }
+}
+
+std::vector<PresetWatcher::Event> PresetWatcher::readEvents(int timeout)
+{
+        std::vector<Event> events;
+        if (inotifyFd < 0)
+                return events;
+
+        struct pollfd fd = {inotifyFd, POLLIN, 0};
+        if (poll(&fd, 1, timeout) < 1)
+                return events;
+
+        /**
+         * The moved entries are paired by the cookie, the moves
+         * without the pair in the read events are removals.
+         */
+        std::unordered_map<uint32_t, size_t> movedEntries;
+        alignas(struct inotify_event) char buffer[16 * 1024];
+        ssize_t n;
+        while ((n = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+                for (char *ptr = buffer; ptr < buffer + n;) {
+                        auto event = reinterpret_cast<const struct inotify_event*>(ptr);
+                        ptr += sizeof(struct inotify_event) + event->len;
+                        if (event->mask & IN_Q_OVERFLOW) {
+                                events.push_back({Event::Type::Overflow, false, {}, {}});
+                                continue;
+                        }
+
+                        auto res = watchedPaths.find(event->wd);
+                        if (event->mask & IN_IGNORED) {
+                                if (res != watchedPaths.end())
+                                        watchedPaths.erase(res);
+                                continue;
+                        }
+
+                        if (res == watchedPaths.end() || event->len < 1)
+                                continue;
+
+                        bool isDirectory = event->mask & IN_ISDIR;
+                        auto path = res->second / event->name;
+                        if (event->mask & IN_MOVED_FROM) {
+                                movedEntries[event->cookie] = events.size();
+                                events.push_back({Event::Type::Removed, isDirectory, path, {}});
+                        } else if (event->mask & IN_MOVED_TO) {
+                                auto moved = movedEntries.find(event->cookie);
+                                if (moved != movedEntries.end()) {
+                                        events[moved->second].type = Event::Type::Renamed;
+                                        events[moved->second].newPath = path;
+                                        movedEntries.erase(moved);
+                                } else {
+                                        events.push_back({Event::Type::Created, isDirectory, path, {}});
+                                }
+                        } else if (event->mask & IN_DELETE) {
+                                events.push_back({Event::Type::Removed, isDirectory, path, {}});
+                        } else if ((event->mask & IN_CLOSE_WRITE)
+                                   || (isDirectory && (event->mask & IN_CREATE))) {
+                                // The files are reported when written, not when created.
+                                events.push_back({Event::Type::Created, isDirectory, path, {}});
+                        }
+                }
+        }
+        return events;
+}
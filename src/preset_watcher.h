@@ -0,0 +1,73 @@
+/**
+ * File name: preset_watcher.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef PRESET_WATCHER_H
+#define PRESET_WATCHER_H
+
+#include "globals.h"
+
+/**
+ * Watches the presets directories with inotify. The events of a
+ * watched directory are reported for its direct entries. The moves
+ * inside the watched directories are reported as renames.
+ */
+class PresetWatcher {
+ public:
+        struct Event {
+                enum class Type : int {
+                        /* The file was written or moved into the directory. */
+                        Created,
+                        Removed,
+                        Renamed,
+                        /* Events were lost, the directories must be rescanned. */
+                        Overflow
+                };
+
+                Type type;
+                bool isDirectory;
+                std::filesystem::path path;
+                /* The new path of the renamed entry. */
+                std::filesystem::path newPath;
+        };
+
+        PresetWatcher();
+        ~PresetWatcher();
+        PresetWatcher(const PresetWatcher &other) = delete;
+        PresetWatcher& operator=(const PresetWatcher &other) = delete;
+        bool isValid() const;
+        bool addWatch(const std::filesystem::path &path);
+        void removeWatch(const std::filesystem::path &path);
+
+        /**
+         * Waits at most timeout milliseconds for events and returns
+         * the read events, empty if there are no events.
+         */
+        std::vector<Event> readEvents(int timeout);
+
+ private:
+        int inotifyFd;
+        std::unordered_map<int, std::filesystem::path> watchedPaths;
+};
+
+#endif // PRESET_WATCHER_H
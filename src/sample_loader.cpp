@@ -0,0 +1,203 @@
+/**
+ * File name: sample_loader.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "sample_loader.h"
+#include "preset_registry.h"
+
+#include <sndfile.h>
+
+#include <sstream>
+
+/* Number of frames decoded at once. */
+static constexpr sf_count_t sampleLoaderChunkFrames = 8192;
+
+SampleLoader::SampleLoader(const std::shared_ptr<PresetRegistry> &registry,
+                           const Callback &callback)
+        : presetRegistry{registry}
+        , loadedCallback{callback}
+        , loaderThread{nullptr}
+        , requestsNumber{0}
+        , isRunning{true}
+{
+}
+
+SampleLoader::~SampleLoader()
+{
+        {
+                std::lock_guard<std::mutex> lock(loaderMutex);
+                isRunning = false;
+                pendingRequests.clear();
+        }
+        threadConditionVar.notify_one();
+        if (loaderThread)
+                loaderThread->join();
+}
+
+void SampleLoader::start()
+{
+        loaderThread = std::make_unique<std::thread>(&SampleLoader::run, this);
+}
+
+std::string SampleLoader::cacheKey(const Request &request)
+{
+        std::ostringstream key;
+        key << request.file << ":" << request.sampleRate << ":" << request.length;
+        try {
+                key << ":" << std::filesystem::last_write_time(request.file).time_since_epoch().count();
+        } catch (...) {
+        }
+        return key.str();
+}
+
+size_t SampleLoader::oscillatorKey(const Request &request)
+{
+        return request.percussionId * GKICK_OSC_NUMBER + request.oscillatorIndex;
+}
+
+void SampleLoader::load(const Request &request)
+{
+        /* The same sample is loaded only once by all instances. */
+        auto sample = presetRegistry->getSample(cacheKey(request));
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        auto newRequest = request;
+        newRequest.serial = ++requestsNumber;
+        lastRequests[oscillatorKey(newRequest)] = newRequest.serial;
+        auto it = std::find_if(pendingRequests.begin(), pendingRequests.end(),
+                               [&newRequest](const Request &pending) {
+                                       return oscillatorKey(pending) == oscillatorKey(newRequest);
+                               });
+        if (it != pendingRequests.end())
+                pendingRequests.erase(it);
+
+        if (!sample.empty()) {
+                loadedCallback(newRequest, sample);
+                return;
+        }
+
+        pendingRequests.push_back(newRequest);
+        if (!loaderThread)
+                start();
+        threadConditionVar.notify_one();
+}
+
+void SampleLoader::run()
+{
+        std::unique_lock<std::mutex> lock(loaderMutex);
+        while (isRunning) {
+                if (pendingRequests.empty()) {
+                        threadConditionVar.wait(lock);
+                        continue;
+                }
+
+                auto request = pendingRequests.front();
+                pendingRequests.pop_front();
+                lock.unlock();
+                auto key = cacheKey(request);
+                auto sample = presetRegistry->getSample(key);
+                if (sample.empty()) {
+                        sample = loadSample(request.file, request.length, request.sampleRate);
+                        presetRegistry->addSample(key, sample);
+                }
+                lock.lock();
+
+                /* Skip the result if a newer sample was requested meanwhile. */
+                if (isRunning && !sample.empty()
+                    && lastRequests[oscillatorKey(request)] == request.serial)
+                        loadedCallback(request, sample);
+        }
+}
+
+SampleRef SampleLoader::loadSample(const std::string &file,
+                                   double length,
+                                   int sampleRate)
+{
+        SF_INFO sndinfo;
+        memset(&sndinfo, 0, sizeof(sndinfo));
+        SNDFILE *sndFile = sf_open(file.c_str(), SFM_READ, &sndinfo);
+        if (!sndFile) {
+                GEONKICK_LOG_ERROR("can't open sample file");
+                return SampleRef();
+        }
+
+        if (sndinfo.format != (SF_FORMAT_FLAC | SF_FORMAT_PCM_16)
+            && sndinfo.format != (SF_FORMAT_FLAC | SF_FORMAT_PCM_24)
+            && sndinfo.format != (SF_FORMAT_WAV | SF_FORMAT_PCM_16)
+            && sndinfo.format != (SF_FORMAT_WAV | SF_FORMAT_PCM_24)
+            && sndinfo.format != (SF_FORMAT_WAV | SF_FORMAT_PCM_32)
+            && sndinfo.format != (SF_FORMAT_WAVEX | SF_FORMAT_PCM_16)
+            && sndinfo.format != (SF_FORMAT_WAVEX | SF_FORMAT_PCM_24)
+            && sndinfo.format != (SF_FORMAT_WAVEX | SF_FORMAT_PCM_32)
+            && sndinfo.format != (SF_FORMAT_OGG | SF_FORMAT_VORBIS)) {
+                GEONKICK_LOG_ERROR("unsupported audio format");
+                sf_close(sndFile);
+                return SampleRef();
+        }
+
+        /**
+         * Decode the file in chunks keeping only the first channel,
+         * the interleaved data of the entire file is never in memory.
+         */
+        auto frames = static_cast<sf_count_t>(sndinfo.samplerate * length);
+        if (sndinfo.frames > 0 && sndinfo.frames < frames)
+                frames = sndinfo.frames;
+        std::vector<gkick_real> data;
+        data.reserve(frames);
+        std::vector<float> chunk(sampleLoaderChunkFrames * sndinfo.channels);
+        while (static_cast<sf_count_t>(data.size()) < frames) {
+                auto n = sf_readf_float(sndFile, chunk.data(),
+                                        std::min(sampleLoaderChunkFrames,
+                                                 frames - static_cast<sf_count_t>(data.size())));
+                if (n < 1)
+                        break;
+                for (decltype(n) i = 0; i < n; i++)
+                        data.push_back(chunk[i * sndinfo.channels]);
+        }
+        sf_close(sndFile);
+
+        if (data.empty()) {
+                GEONKICK_LOG_ERROR("error on reading samples");
+                return SampleRef();
+        }
+
+        if (sampleRate == sndinfo.samplerate)
+                return SampleRef::fromData(data);
+
+        /* Resample directly into the shared sample. */
+        GEONKICK_LOG_DEBUG("different sample rate " << sndinfo.samplerate
+                           << ", resample to " << sampleRate);
+        auto sample = SampleRef::create(geonkick_resample_size(data.size(),
+                                                               sndinfo.samplerate,
+                                                               sampleRate),
+                                        [&](gkick_real *out, size_t size) {
+                                                if (geonkick_resample(data.data(), data.size(),
+                                                                      sndinfo.samplerate,
+                                                                      out, &size, sampleRate,
+                                                                      GEONKICK_RESAMPLER_HIGH) != GEONKICK_OK)
+                                                        return static_cast<size_t>(0);
+                                                return size;
+                                        });
+        if (sample.empty())
+                GEONKICK_LOG_ERROR("error on resampling");
+        return sample;
+}
@@ -0,0 +1,92 @@
+/**
+ * File name: sample_loader.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GEONKICK_SAMPLE_LOADER_H
+#define GEONKICK_SAMPLE_LOADER_H
+
+#include "globals.h"
+#include "sample_ref.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
+
+class PresetRegistry;
+
+/**
+ * Loads the oscillators samples in a background thread.
+ * The files are decoded in chunks and the loaded samples
+ * are cached in the preset registry, so the same file is
+ * decoded once while it is in the cache.
+ */
+class SampleLoader {
+ public:
+        struct Request {
+                std::string file;
+                size_t percussionId;
+                size_t oscillatorIndex;
+                int sampleRate;
+                double length;
+                uint64_t serial;
+        };
+
+        using Callback = std::function<void(const Request &request, const SampleRef &sample)>;
+
+        /**
+         * The callback is called from the loader thread or from
+         * the caller thread when the sample is in the cache.
+         * Only the last requested sample of an oscillator is
+         * passed to the callback.
+         */
+        SampleLoader(const std::shared_ptr<PresetRegistry> &registry,
+                     const Callback &callback);
+        ~SampleLoader();
+
+        /* Replaces the pending request for the same oscillator. */
+        void load(const Request &request);
+        static SampleRef loadSample(const std::string &file,
+                                    double length,
+                                    int sampleRate);
+
+ protected:
+        void start();
+        void run();
+        static std::string cacheKey(const Request &request);
+        static size_t oscillatorKey(const Request &request);
+
+ private:
+        std::shared_ptr<PresetRegistry> presetRegistry;
+        Callback loadedCallback;
+        std::unique_ptr<std::thread> loaderThread;
+        std::mutex loaderMutex;
+        std::condition_variable threadConditionVar;
+        std::deque<Request> pendingRequests;
+        /* The last request serial for every oscillator. */
+        std::unordered_map<size_t, uint64_t> lastRequests;
+        uint64_t requestsNumber;
+        bool isRunning;
+};
+
+#endif // GEONKICK_SAMPLE_LOADER_H
@@ -0,0 +1,168 @@
+/**
+ * File name: sample_ref.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "sample_ref.h"
+
+#include <cstring>
+
+SampleRef::SampleRef()
+        : sampleRef{nullptr}
+{
+}
+
+SampleRef::~SampleRef()
+{
+        geonkick_sample_unref(sampleRef);
+}
+
+SampleRef::SampleRef(const SampleRef &other)
+        : sampleRef{geonkick_sample_ref(other.sampleRef)}
+{
+}
+
+SampleRef::SampleRef(SampleRef &&other) noexcept
+        : sampleRef{other.sampleRef}
+{
+        other.sampleRef = nullptr;
+}
+
+SampleRef& SampleRef::operator=(const SampleRef &other)
+{
+        if (sampleRef != other.sampleRef) {
+                geonkick_sample_unref(sampleRef);
+                sampleRef = geonkick_sample_ref(other.sampleRef);
+        }
+        return *this;
+}
+
+SampleRef& SampleRef::operator=(SampleRef &&other) noexcept
+{
+        if (this != &other) {
+                geonkick_sample_unref(sampleRef);
+                sampleRef = other.sampleRef;
+                other.sampleRef = nullptr;
+        }
+        return *this;
+}
+
+bool SampleRef::operator==(const SampleRef &other) const
+{
+        /* The published samples are unique by content. */
+        return sampleRef == other.sampleRef;
+}
+
+bool SampleRef::operator!=(const SampleRef &other) const
+{
+        return !(*this == other);
+}
+
+SampleRef SampleRef::adopt(struct gkick_sample *sample)
+{
+        SampleRef ref;
+        ref.sampleRef = sample;
+        return ref;
+}
+
+SampleRef SampleRef::fromData(const gkick_real *data, size_t size)
+{
+        struct gkick_sample *sample = nullptr;
+        if (data == nullptr || size < 1
+            || geonkick_sample_new(data, size, &sample) != GEONKICK_OK)
+                return SampleRef();
+        return adopt(sample);
+}
+
+SampleRef SampleRef::fromData(const std::vector<gkick_real> &data)
+{
+        return fromData(data.data(), data.size());
+}
+
+struct gkick_sample* SampleRef::get() const
+{
+        return sampleRef;
+}
+
+bool SampleRef::empty() const
+{
+        return geonkick_sample_size(sampleRef) == 0;
+}
+
+const gkick_real* SampleRef::data() const
+{
+        return geonkick_sample_data(sampleRef);
+}
+
+size_t SampleRef::size() const
+{
+        return geonkick_sample_size(sampleRef);
+}
+
+uint64_t SampleRef::hash() const
+{
+        return geonkick_sample_hash(sampleRef);
+}
+
+std::vector<gkick_real> SampleRef::toVector() const
+{
+        if (empty())
+                return {};
+        return std::vector<gkick_real>(data(), data() + size());
+}
+
+void SampleRef::reset()
+{
+        geonkick_sample_unref(sampleRef);
+        sampleRef = nullptr;
+}
+
+SampleRef SampleRef::fromFloat32(const unsigned char *data, size_t size)
+{
+        if (data == nullptr)
+                return SampleRef();
+
+        return create(size, [data](gkick_real *buffer, size_t n) {
+                        for (size_t i = 0; i < n; i++) {
+                                const unsigned char *bytes = data + i * sizeof(float);
+                                uint32_t bits = static_cast<uint32_t>(bytes[0])
+                                        | static_cast<uint32_t>(bytes[1]) << 8
+                                        | static_cast<uint32_t>(bytes[2]) << 16
+                                        | static_cast<uint32_t>(bytes[3]) << 24;
+                                float val;
+                                std::memcpy(&val, &bits, sizeof(val));
+                                buffer[i] = val;
+                        }
+                        return n;
+                });
+}
+
+void SampleRef::toFloat32(unsigned char *out) const
+{
+        for (size_t i = 0; i < size(); i++) {
+                auto val = static_cast<float>(data()[i]);
+                uint32_t bits;
+                std::memcpy(&bits, &val, sizeof(bits));
+                for (size_t k = 0; k < sizeof(bits); k++)
+                        *out++ = static_cast<unsigned char>((bits >> (8 * k)) & 0xff);
+        }
+}
@@ -0,0 +1,101 @@
+/**
+ * File name: sample_ref.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GEONKICK_SAMPLE_REF_H
+#define GEONKICK_SAMPLE_REF_H
+
+#include "globals.h"
+
+/**
+ * The samples are saved as little endian float32 whatever the precision
+ * of gkick_real is, the data is copied as it is only if the memory
+ * has the same layout.
+ */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ \
+    && !defined(GEONKICK_DOUBLE_PRECISION)
+#define GEONKICK_RAW_SAMPLES_COPY
+#endif
+
+/**
+ * Reference to an immutable sample of the process sample store.
+ * Copying the reference doesn't copy the sample data, the same
+ * sample content is kept in memory only once.
+ */
+class SampleRef {
+ public:
+        SampleRef();
+        ~SampleRef();
+        SampleRef(const SampleRef &other);
+        SampleRef(SampleRef &&other) noexcept;
+        SampleRef& operator=(const SampleRef &other);
+        SampleRef& operator=(SampleRef &&other) noexcept;
+        bool operator==(const SampleRef &other) const;
+        bool operator!=(const SampleRef &other) const;
+
+        /* Takes the ownership of the reference. */
+        static SampleRef adopt(struct gkick_sample *sample);
+        static SampleRef fromData(const gkick_real *data, size_t size);
+        static SampleRef fromData(const std::vector<gkick_real> &data);
+
+        /* Creates a sample from little endian float32 values. */
+        static SampleRef fromFloat32(const unsigned char *data, size_t size);
+
+        /**
+         * Creates a sample of at most the given size, calls the function
+         * to fill the sample buffer and publishes the sample. The function
+         * returns the number of written values, the sample is dropped if
+         * nothing was written.
+         */
+        template<class Fill>
+        static SampleRef create(size_t size, const Fill &fill)
+        {
+                struct gkick_sample *sample = nullptr;
+                if (size < 1 || geonkick_sample_create(size, &sample) != GEONKICK_OK)
+                        return SampleRef();
+                size_t n = fill(geonkick_sample_buffer(sample), size);
+                if (n < 1 || n > size
+                    || geonkick_sample_shrink(sample, n) != GEONKICK_OK
+                    || geonkick_sample_publish(&sample) != GEONKICK_OK) {
+                        geonkick_sample_unref(sample);
+                        return SampleRef();
+                }
+                return adopt(sample);
+        }
+
+        struct gkick_sample* get() const;
+        bool empty() const;
+        const gkick_real* data() const;
+        size_t size() const;
+        uint64_t hash() const;
+        std::vector<gkick_real> toVector() const;
+
+        /* Writes the sample as little endian float32 values. */
+        void toFloat32(unsigned char *out) const;
+        void reset();
+
+ private:
+        struct gkick_sample *sampleRef;
+};
+
+#endif // GEONKICK_SAMPLE_REF_H
@@ -0,0 +1,105 @@
+/**
+ * File name: state_changes.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#include "state_changes.h"
+
+StateChanges::StateChanges()
+        : kitChanged{false}
+{
+}
+
+StateChanges::StateChanges(size_t id, Parameter parameters)
+        : kitChanged{false}
+{
+        add(id, parameters);
+}
+
+StateChanges StateChanges::kitChanges()
+{
+        StateChanges changes;
+        changes.kitChanged = true;
+        return changes;
+}
+
+StateChanges::Parameter StateChanges::oscillator(int index)
+{
+        return static_cast<Parameter>(static_cast<uint32_t>(Parameter::Oscillator1) << index);
+}
+
+void StateChanges::add(size_t id, Parameter parameters)
+{
+        if (parameters == Parameter::None)
+                return;
+
+        for (auto &changed : changedParameters) {
+                if (changed.first == id) {
+                        changed.second = changed.second | parameters;
+                        return;
+                }
+        }
+        changedParameters.emplace_back(id, parameters);
+}
+
+void StateChanges::merge(const StateChanges &changes)
+{
+        kitChanged = kitChanged || changes.kitChanged;
+        for (const auto &changed : changes.changedParameters)
+                add(changed.first, changed.second);
+}
+
+bool StateChanges::contains(size_t id, Parameter parameters) const
+{
+        if (kitChanged)
+                return true;
+
+        for (const auto &changed : changedParameters) {
+                if (changed.first == id)
+                        return (changed.second & parameters) != Parameter::None;
+        }
+        return false;
+}
+
+bool StateChanges::isKitChanged() const
+{
+        return kitChanged;
+}
+
+bool StateChanges::empty() const
+{
+        return !kitChanged && changedParameters.empty();
+}
+
+std::vector<size_t> StateChanges::percussions() const
+{
+        std::vector<size_t> ids;
+        for (const auto &changed : changedParameters)
+                ids.push_back(changed.first);
+        return ids;
+}
+
+void StateChanges::clear()
+{
+        changedParameters.clear();
+        kitChanged = false;
+}
@@ -0,0 +1,95 @@
+/**
+ * File name: state_changes.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+
+#ifndef GEONKICK_STATE_CHANGES_H
+#define GEONKICK_STATE_CHANGES_H
+
+#include "globals.h"
+
+/**
+ * The set of the parameters changed by an operation on the
+ * percussions state. The GUI widgets are notified with the changes
+ * and refresh only the controls showing the changed parameters.
+ */
+class StateChanges {
+ public:
+        /**
+         * Groups of parameters of a percussion. The oscillators
+         * are the oscillators of the current layer.
+         */
+        enum class Parameter : uint32_t {
+                None           = 0,
+                /* Name, key, channel, mute, solo, limiter and output tuning. */
+                Percussion     = 1 << 0,
+                /* Length, amplitude and filter. */
+                Kick           = 1 << 1,
+                /* Kick amplitude, filter and distortion envelopes. */
+                KickEnvelopes  = 1 << 2,
+                Oscillator1    = 1 << 3,
+                Oscillator2    = 1 << 4,
+                Noise          = 1 << 5,
+                Oscillators    = Oscillator1 | Oscillator2 | Noise,
+                Layers         = 1 << 6,
+                Compressor     = 1 << 7,
+                Distortion     = 1 << 8,
+                All            = (1 << 9) - 1
+        };
+
+        StateChanges();
+        StateChanges(size_t id, Parameter parameters);
+
+        /* Changes of the entire kit: all the percussions and their order. */
+        static StateChanges kitChanges();
+
+        /* The parameters of the oscillator with the index in the current layer. */
+        static Parameter oscillator(int index);
+
+        void add(size_t id, Parameter parameters);
+        void merge(const StateChanges &changes);
+        bool contains(size_t id, Parameter parameters) const;
+        bool isKitChanged() const;
+        bool empty() const;
+        std::vector<size_t> percussions() const;
+        void clear();
+
+ private:
+        std::vector<std::pair<size_t, Parameter>> changedParameters;
+        bool kitChanged;
+};
+
+inline StateChanges::Parameter operator|(StateChanges::Parameter a,
+                                         StateChanges::Parameter b)
+{
+        return static_cast<StateChanges::Parameter>(static_cast<uint32_t>(a)
+                                                    | static_cast<uint32_t>(b));
+}
+
+inline StateChanges::Parameter operator&(StateChanges::Parameter a,
+                                         StateChanges::Parameter b)
+{
+        return static_cast<StateChanges::Parameter>(static_cast<uint32_t>(a)
+                                                    & static_cast<uint32_t>(b));
+}
+
+#endif // GEONKICK_STATE_CHANGES_H
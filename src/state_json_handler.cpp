@@ -0,0 +1,620 @@
+/**
+ * File name: state_json_handler.cpp
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "state_json_handler.h"
+#include "percussion_state.h"
+#include "kit_state.h"
+#include "base64.h"
+
+PercussionJsonHandler::PercussionJsonHandler(PercussionState *state)
+        : percussionState{state}
+        , objectDepth{0}
+        , arrayDepth{0}
+        , isAppVersionParsed{false}
+        , isKickParsed{false}
+        , isKickFactorParsed{false}
+        , kickFilterFactor{1.0}
+        , parsingFinished{false}
+{
+}
+
+bool PercussionJsonHandler::isFinished() const
+{
+        return parsingFinished;
+}
+
+bool PercussionJsonHandler::Null()
+{
+        return true;
+}
+
+bool PercussionJsonHandler::Bool(bool b)
+{
+        if (arrayDepth == 0)
+                setBool(b);
+        return true;
+}
+
+bool PercussionJsonHandler::Int(int i)
+{
+        setNumber(i, true);
+        return true;
+}
+
+bool PercussionJsonHandler::Uint(unsigned u)
+{
+        setNumber(u, true);
+        return true;
+}
+
+bool PercussionJsonHandler::Int64(int64_t i)
+{
+        setNumber(i, true);
+        return true;
+}
+
+bool PercussionJsonHandler::Uint64(uint64_t u)
+{
+        setNumber(u, true);
+        return true;
+}
+
+bool PercussionJsonHandler::Double(double d)
+{
+        setNumber(d, false);
+        return true;
+}
+
+bool PercussionJsonHandler::String(const char *str, rapidjson::SizeType length, bool copy)
+{
+        RK_UNUSED(copy);
+        if (arrayDepth == 0)
+                setString(str, length);
+        return true;
+}
+
+bool PercussionJsonHandler::StartObject()
+{
+        objectDepth++;
+        if (objectDepth == 2 && keysPath.size() == 1 && isKey(0, "kick"))
+                isKickParsed = true;
+        return true;
+}
+
+bool PercussionJsonHandler::Key(const char *str, rapidjson::SizeType length, bool copy)
+{
+        RK_UNUSED(copy);
+        keysPath.resize(objectDepth - 1);
+        keysPath.emplace_back(str, length);
+        return true;
+}
+
+bool PercussionJsonHandler::EndObject(rapidjson::SizeType memberCount)
+{
+        RK_UNUSED(memberCount);
+        objectDepth--;
+        keysPath.resize(objectDepth);
+        if (objectDepth == 0) {
+                finish();
+                parsingFinished = true;
+        }
+        return true;
+}
+
+bool PercussionJsonHandler::StartArray()
+{
+        arrayDepth++;
+        if (arrayDepth == 1) {
+                arrayValues.clear();
+                envelopePoints.clear();
+        } else if (arrayDepth == 2) {
+                pointValues.clear();
+        }
+        return true;
+}
+
+bool PercussionJsonHandler::EndArray(rapidjson::SizeType elementCount)
+{
+        RK_UNUSED(elementCount);
+        if (arrayDepth == 2 && pointValues.size() == 2)
+                envelopePoints.emplace_back(pointValues[0], pointValues[1]);
+        else if (arrayDepth == 1)
+                setArray();
+        arrayDepth--;
+        return true;
+}
+
+bool PercussionJsonHandler::isKey(size_t depth, const char *key) const
+{
+        return depth < keysPath.size() && keysPath[depth] == key;
+}
+
+int PercussionJsonHandler::oscillatorIndex() const
+{
+        if (keysPath.empty() || keysPath[0].compare(0, 3, "osc") != 0)
+                return -1;
+        char *end = nullptr;
+        auto index = std::strtol(keysPath[0].c_str() + 3, &end, 10);
+        if (end == keysPath[0].c_str() + 3 || *end != '\0')
+                return -1;
+        return index;
+}
+
+PercussionState::OscillatorInfo* PercussionJsonHandler::oscillator(int index)
+{
+        auto it = parsedOscillators.find(index);
+        if (it != parsedOscillators.end())
+                return it->second.get();
+
+        auto res = percussionState->oscillators.find(index);
+        if (res == percussionState->oscillators.end())
+                return nullptr;
+
+        auto osc = std::make_shared<PercussionState::OscillatorInfo>(*res->second);
+        parsedOscillators.emplace(index, osc);
+        return osc.get();
+}
+
+void PercussionJsonHandler::setNumber(double val, bool isInteger)
+{
+        if (arrayDepth == 2) {
+                pointValues.push_back(val);
+                return;
+        } else if (arrayDepth == 1) {
+                arrayValues.push_back(val);
+                return;
+        }
+
+        if (isKey(0, "kick")) {
+                if (keysPath.size() == 2) {
+                        if (isKey(1, "PercussionAppVersion") && isInteger) {
+                                percussionState->appVersion = static_cast<int>(val);
+                                isAppVersionParsed = true;
+                        } else if (isKey(1, "id") && isInteger) {
+                                percussionState->setId(static_cast<size_t>(val));
+                        } else if (isKey(1, "channel") && isInteger) {
+                                percussionState->setChannel(static_cast<size_t>(val));
+                        } else if (isKey(1, "playing_key") && isInteger) {
+                                percussionState->setPlayingKey(static_cast<char>(val));
+                        } else if (isKey(1, "limiter")) {
+                                percussionState->setLimiterValue(val);
+                        }
+                } else if (keysPath.size() == 3 && isKey(1, "ampl_env")) {
+                        if (isKey(2, "length"))
+                                percussionState->setKickLength(val);
+                        else if (isKey(2, "amplitude"))
+                                percussionState->setKickAmplitude(val);
+                } else if (keysPath.size() == 3 && isKey(1, "filter")) {
+                        if (isKey(2, "cutoff")) {
+                                percussionState->setKickFilterFrequency(val);
+                        } else if (isKey(2, "factor")) {
+                                kickFilterFactor = val;
+                                isKickFactorParsed = true;
+                        } else if (isKey(2, "type") && isInteger) {
+                                percussionState->setKickFilterType(static_cast<GeonkickApi::FilterType>(val));
+                        }
+                } else if (keysPath.size() == 3 && isKey(1, "compressor")) {
+                        if (isKey(2, "attack"))
+                                percussionState->setCompressorAttack(val);
+                        else if (isKey(2, "release"))
+                                percussionState->setCompressorRelease(val);
+                        else if (isKey(2, "threshold"))
+                                percussionState->setCompressorThreshold(val);
+                        else if (isKey(2, "ratio"))
+                                percussionState->setCompressorRatio(val);
+                        else if (isKey(2, "knee"))
+                                percussionState->setCompressorKnee(val);
+                        else if (isKey(2, "makeup"))
+                                percussionState->setCompressorMakeup(val);
+                } else if (keysPath.size() == 3 && isKey(1, "distortion")) {
+                        if (isKey(2, "in_limiter"))
+                                percussionState->setDistortionInLimiter(val);
+                        else if (isKey(2, "volume"))
+                                percussionState->setDistortionVolume(val);
+                        else if (isKey(2, "drive"))
+                                percussionState->setDistortionDrive(val);
+                }
+                return;
+        }
+
+        auto index = oscillatorIndex();
+        auto osc = oscillator(index);
+        if (osc == nullptr)
+                return;
+
+        if (keysPath.size() == 2) {
+                if (isKey(1, "function") && isInteger)
+                        osc->function = static_cast<GeonkickApi::FunctionType>(val);
+                else if (isKey(1, "phase"))
+                        osc->phase = val;
+                else if (isKey(1, "seed") && isInteger)
+                        osc->seed = static_cast<int>(val);
+        } else if (keysPath.size() == 3) {
+                if (isKey(1, "ampl_env") && isKey(2, "amplitude")) {
+                        osc->amplitude = val;
+                } else if (isKey(1, "freq_env") && isKey(2, "amplitude")) {
+                        if (static_cast<GeonkickApi::OscillatorType>(index % GKICK_OSC_GROUP_SIZE)
+                            != GeonkickApi::OscillatorType::Noise)
+                                osc->frequency = val;
+                } else if (isKey(1, "filter")) {
+                        if (isKey(2, "cutoff"))
+                                osc->filterFrequency = val;
+                        else if (isKey(2, "factor"))
+                                oscillatorsFilterFactor.emplace_back(index, val);
+                        else if (isKey(2, "type") && isInteger)
+                                osc->filterType = static_cast<GeonkickApi::FilterType>(val);
+                }
+        }
+}
+
+void PercussionJsonHandler::setBool(bool b)
+{
+        if (isKey(0, "kick")) {
+                if (keysPath.size() == 2) {
+                        if (isKey(1, "mute"))
+                                percussionState->setMute(b);
+                        else if (isKey(1, "solo"))
+                                percussionState->setSolo(b);
+                        else if (isKey(1, "tuned_output"))
+                                percussionState->tuneOutput(b);
+                } else if (keysPath.size() == 3 && isKey(2, "enabled")) {
+                        if (isKey(1, "filter"))
+                                percussionState->enableKickFilter(b);
+                        else if (isKey(1, "compressor"))
+                                percussionState->enableCompressor(b);
+                        else if (isKey(1, "distortion"))
+                                percussionState->enableDistortion(b);
+                }
+                return;
+        }
+
+        auto osc = oscillator(oscillatorIndex());
+        if (osc == nullptr)
+                return;
+
+        if (keysPath.size() == 2) {
+                if (isKey(1, "enabled"))
+                        osc->isEnabled = b;
+                else if (isKey(1, "is_fm"))
+                        osc->isFm = b;
+        } else if (keysPath.size() == 3 && isKey(1, "filter") && isKey(2, "enabled")) {
+                osc->isFilterEnabled = b;
+        }
+}
+
+void PercussionJsonHandler::setString(const char *str, size_t length)
+{
+        if (keysPath.size() != 2)
+                return;
+
+        if (isKey(0, "kick")) {
+                if (isKey(1, "name"))
+                        percussionState->setName(std::string(str, length));
+                return;
+        }
+
+        if (!isKey(1, "sample"))
+                return;
+
+        auto osc = oscillator(oscillatorIndex());
+        if (osc == nullptr)
+                return;
+
+        // The sample is base64 encoded little endian float32 values.
+#ifdef GEONKICK_RAW_SAMPLES_COPY
+        // Decode directly into a new sample of the sample store.
+        auto size = (base64_decoded_size(length) + sizeof(float) - 1) / sizeof(float);
+        osc->sample = SampleRef::create(size, [str, length](gkick_real *data, size_t) {
+                        size_t len = 0;
+                        if (base64_decode_to(reinterpret_cast<const unsigned char*>(str), length,
+                                             reinterpret_cast<unsigned char*>(data), &len) != 0
+                            || len < sizeof(float) || len % sizeof(float) != 0)
+                                return static_cast<size_t>(0);
+                        return len / sizeof(float);
+                });
+#else
+        std::vector<unsigned char> bytes(base64_decoded_size(length));
+        size_t len = 0;
+        if (base64_decode_to(reinterpret_cast<const unsigned char*>(str), length,
+                             bytes.data(), &len) != 0
+            || len < sizeof(float) || len % sizeof(float) != 0) {
+                osc->sample.reset();
+                return;
+        }
+        osc->sample = SampleRef::fromFloat32(bytes.data(), len / sizeof(float));
+#endif // GEONKICK_RAW_SAMPLES_COPY
+}
+
+void PercussionJsonHandler::setArray()
+{
+        if (isKey(0, "kick")) {
+                if (keysPath.size() == 2) {
+                        if (isKey(1, "layers")) {
+                                percussionState->layers = {false, false, false};
+                                for (const auto &val: arrayValues)
+                                        percussionState->setLayerEnabled(static_cast<GeonkickApi::Layer>(val), true);
+                        } else if (isKey(1, "layers_amplitude")) {
+                                percussionState->layersAmplitude = {1.0, 1.0, 1.0};
+                                for (decltype(arrayValues.size()) i = 0; i < arrayValues.size(); i++)
+                                        percussionState->setLayerAmplitude(static_cast<GeonkickApi::Layer>(i),
+                                                                           arrayValues[i]);
+                        }
+                } else if (keysPath.size() == 3) {
+                        if (isKey(1, "ampl_env") && isKey(2, "points"))
+                                percussionState->setKickEnvelopePoints(GeonkickApi::EnvelopeType::Amplitude,
+                                                                       envelopePoints);
+                        else if (isKey(1, "filter") && isKey(2, "cutoff_env"))
+                                percussionState->setKickEnvelopePoints(GeonkickApi::EnvelopeType::FilterCutOff,
+                                                                       envelopePoints);
+                        else if (isKey(1, "distortion") && isKey(2, "drive_env"))
+                                percussionState->setKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionDrive,
+                                                                       envelopePoints);
+                        else if (isKey(1, "distortion") && isKey(2, "volume_env"))
+                                percussionState->setKickEnvelopePoints(GeonkickApi::EnvelopeType::DistortionVolume,
+                                                                       envelopePoints);
+                }
+                return;
+        }
+
+        if (keysPath.size() != 3)
+                return;
+
+        auto index = oscillatorIndex();
+        auto osc = oscillator(index);
+        if (osc == nullptr)
+                return;
+
+        if (isKey(1, "ampl_env") && isKey(2, "points")) {
+                osc->amplitudeEnvelope = std::move(envelopePoints);
+        } else if (isKey(1, "freq_env") && isKey(2, "points")) {
+                if (static_cast<GeonkickApi::OscillatorType>(index % GKICK_OSC_GROUP_SIZE)
+                    != GeonkickApi::OscillatorType::Noise)
+                        osc->frequencyEnvelope = std::move(envelopePoints);
+        } else if (isKey(1, "filter") && isKey(2, "cutoff_env")) {
+                osc->filterCutOffEnvelope = std::move(envelopePoints);
+        }
+        envelopePoints.clear();
+}
+
+void PercussionJsonHandler::finish()
+{
+        if (!isAppVersionParsed) {
+                GEONKICK_LOG_INFO("PercussionAppVersion missing, old preset");
+                percussionState->appVersion = 0;
+        }
+
+        // The filter factor scale was changed in version 1.10.
+        auto appVersion = percussionState->appVersion;
+        if (isKickFactorParsed) {
+                if (appVersion < 0x011000 && kickFilterFactor > 0.00001f)
+                        kickFilterFactor = 10.0 / kickFilterFactor;
+                percussionState->setKickFilterQFactor(kickFilterFactor);
+        }
+
+        if (!isKickParsed) {
+                GEONKICK_LOG_ERROR("kick object missing, the oscillators are not set");
+                return;
+        }
+
+        for (const auto &factor: oscillatorsFilterFactor) {
+                auto val = factor.second;
+                if (appVersion < 0x011000)
+                        val *= 10;
+                oscillator(factor.first)->filterFactor = val;
+        }
+
+        for (const auto &osc: parsedOscillators)
+                *percussionState->oscillators[osc.first] = *osc.second;
+}
+
+KitJsonHandler::KitJsonHandler(KitState *kit)
+        : kitState{kit}
+        , depth{0}
+        , isPercussionsArray{false}
+        , isAppVersionParsed{false}
+        , percussionIndex{0}
+{
+        for (size_t i = 0; i < 2; i++) {
+                auto state = std::make_shared<PercussionState>();
+                oldPercussionHandlers.push_back(std::make_unique<PercussionJsonHandler>(state.get()));
+                oldPercussions.push_back(std::move(state));
+        }
+}
+
+bool KitJsonHandler::isOldKit() const
+{
+        return !isAppVersionParsed || kitState->kitAppVersion < 0x011000;
+}
+
+template<class Event>
+bool KitJsonHandler::forward(const Event &event)
+{
+        if (percussionHandler) {
+                event(*percussionHandler);
+                if (percussionHandler->isFinished()) {
+                        kitState->addPercussion(percussion);
+                        percussionHandler.reset();
+                        percussion.reset();
+                }
+                return true;
+        }
+
+        if (!isPercussionsArray && isOldKit()) {
+                for (auto &handler: oldPercussionHandlers)
+                        event(*handler);
+        }
+        return false;
+}
+
+bool KitJsonHandler::Null()
+{
+        forward([](PercussionJsonHandler &h) { return h.Null(); });
+        return true;
+}
+
+bool KitJsonHandler::Bool(bool b)
+{
+        forward([b](PercussionJsonHandler &h) { return h.Bool(b); });
+        return true;
+}
+
+bool KitJsonHandler::Int(int i)
+{
+        if (forward([i](PercussionJsonHandler &h) { return h.Int(i); }))
+                return true;
+
+        if (depth == 1 && currentKey == "KitAppVersion") {
+                kitState->kitAppVersion = i;
+                isAppVersionParsed = true;
+        }
+        return true;
+}
+
+bool KitJsonHandler::Uint(unsigned u)
+{
+        if (forward([u](PercussionJsonHandler &h) { return h.Uint(u); }))
+                return true;
+
+        if (depth == 1 && currentKey == "KitAppVersion") {
+                kitState->kitAppVersion = static_cast<int>(u);
+                isAppVersionParsed = true;
+        }
+        return true;
+}
+
+bool KitJsonHandler::Int64(int64_t i)
+{
+        forward([i](PercussionJsonHandler &h) { return h.Int64(i); });
+        return true;
+}
+
+bool KitJsonHandler::Uint64(uint64_t u)
+{
+        forward([u](PercussionJsonHandler &h) { return h.Uint64(u); });
+        return true;
+}
+
+bool KitJsonHandler::Double(double d)
+{
+        forward([d](PercussionJsonHandler &h) { return h.Double(d); });
+        return true;
+}
+
+bool KitJsonHandler::String(const char *str, rapidjson::SizeType length, bool copy)
+{
+        if (forward([&](PercussionJsonHandler &h) { return h.String(str, length, copy); }))
+                return true;
+
+        if (depth == 1) {
+                if (currentKey == "name")
+                        kitState->setName(std::string(str, length));
+                else if (currentKey == "author")
+                        kitState->setAuthor(std::string(str, length));
+                else if (currentKey == "url")
+                        kitState->setUrl(std::string(str, length));
+        }
+        return true;
+}
+
+bool KitJsonHandler::StartObject()
+{
+        if (!percussionHandler && isPercussionsArray && depth == 2) {
+                percussion = std::make_shared<PercussionState>();
+                percussion->setId(percussionIndex++);
+                percussionHandler = std::make_unique<PercussionJsonHandler>(percussion.get());
+                return percussionHandler->StartObject();
+        }
+
+        if (forward([](PercussionJsonHandler &h) { return h.StartObject(); }))
+                return true;
+        depth++;
+        return true;
+}
+
+bool KitJsonHandler::Key(const char *str, rapidjson::SizeType length, bool copy)
+{
+        if (forward([&](PercussionJsonHandler &h) { return h.Key(str, length, copy); }))
+                return true;
+
+        if (depth == 1)
+                currentKey.assign(str, length);
+        return true;
+}
+
+bool KitJsonHandler::EndObject(rapidjson::SizeType memberCount)
+{
+        if (forward([memberCount](PercussionJsonHandler &h) { return h.EndObject(memberCount); }))
+                return true;
+
+        depth--;
+        if (depth == 0)
+                finish();
+        return true;
+}
+
+bool KitJsonHandler::StartArray()
+{
+        if (!percussionHandler && depth == 1 && currentKey == "percussions") {
+                isPercussionsArray = true;
+                depth++;
+                return true;
+        }
+
+        if (forward([](PercussionJsonHandler &h) { return h.StartArray(); }))
+                return true;
+        depth++;
+        return true;
+}
+
+bool KitJsonHandler::EndArray(rapidjson::SizeType elementCount)
+{
+        if (!percussionHandler && isPercussionsArray && depth == 2) {
+                isPercussionsArray = false;
+                depth--;
+                return true;
+        }
+
+        if (forward([elementCount](PercussionJsonHandler &h) { return h.EndArray(elementCount); }))
+                return true;
+        depth--;
+        return true;
+}
+
+void KitJsonHandler::finish()
+{
+        if (!isAppVersionParsed) {
+                GEONKICK_LOG_INFO("KitAppVersion missing, old preset");
+                kitState->kitAppVersion = 0;
+        }
+
+        if (kitState->kitAppVersion < 0x011000) {
+                // Compatibility with older versions.
+                for (decltype(oldPercussions.size()) i = 0; i < oldPercussions.size(); i++) {
+                        oldPercussions[i]->setId(i);
+                        oldPercussions[i]->setChannel(i);
+                        kitState->addPercussion(oldPercussions[i]);
+                }
+        }
+        oldPercussions.clear();
+        oldPercussionHandlers.clear();
+}
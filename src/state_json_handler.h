@@ -0,0 +1,153 @@
+/**
+ * File name: state_json_handler.h
+ * Project: Geonkick (A percussion synthesizer)
+ *
+ * Copyright (C) 2020 Iurie Nistor <http://iuriepage.wordpress.com>
+ *
+ * This file is part of Geonkick.
+ *
+ * GeonKick is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef GEONKICK_STATE_JSON_HANDLER_H
+#define GEONKICK_STATE_JSON_HANDLER_H
+
+#include "globals.h"
+#include "percussion_state.h"
+
+#include <RkRealPoint.h>
+
+#include <rapidjson/reader.h>
+#include <rapidjson/error/en.h>
+
+class KitState;
+
+/**
+ * Parses the JSON data with the given handler.
+ * The data is parsed in place, so the content is modified.
+ */
+template<class Handler>
+bool parseStateJson(std::string &data, Handler &handler)
+{
+        rapidjson::InsituStringStream stream(&data[0]);
+        rapidjson::Reader reader;
+        if (!reader.Parse<rapidjson::kParseInsituFlag>(stream, handler)) {
+                GEONKICK_LOG_ERROR("can't parse JSON data: "
+                                   << rapidjson::GetParseError_En(reader.GetParseErrorCode())
+                                   << " at offset " << reader.GetErrorOffset());
+                return false;
+        }
+        return true;
+}
+
+/**
+ * Streaming (SAX) parsers of the percussion and kit JSON data.
+ * The values are set into the state while parsing, without
+ * building the document in memory. The samples are decoded
+ * directly into the oscillators samples.
+ */
+class PercussionJsonHandler
+        : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, PercussionJsonHandler> {
+ public:
+        explicit PercussionJsonHandler(PercussionState *state);
+        bool Null();
+        bool Bool(bool b);
+        bool Int(int i);
+        bool Uint(unsigned u);
+        bool Int64(int64_t i);
+        bool Uint64(uint64_t u);
+        bool Double(double d);
+        bool String(const char *str, rapidjson::SizeType length, bool copy);
+        bool StartObject();
+        bool Key(const char *str, rapidjson::SizeType length, bool copy);
+        bool EndObject(rapidjson::SizeType memberCount);
+        bool StartArray();
+        bool EndArray(rapidjson::SizeType elementCount);
+        bool isFinished() const;
+
+ protected:
+        void setNumber(double val, bool isInteger);
+        void setBool(bool b);
+        void setString(const char *str, size_t length);
+        void setArray();
+        void finish();
+        int oscillatorIndex() const;
+        PercussionState::OscillatorInfo* oscillator(int index);
+        bool isKey(size_t depth, const char *key) const;
+
+ private:
+        PercussionState *percussionState;
+        std::vector<std::string> keysPath;
+        size_t objectDepth;
+        size_t arrayDepth;
+        std::vector<double> arrayValues;
+        std::vector<double> pointValues;
+        std::vector<RkRealPoint> envelopePoints;
+        bool isAppVersionParsed;
+        bool isKickParsed;
+        bool isKickFactorParsed;
+        double kickFilterFactor;
+        std::vector<std::pair<int, double>> oscillatorsFilterFactor;
+
+        /**
+         * The oscillators are set only if the "kick" object is found,
+         * it may come after the oscillators objects.
+         */
+        std::unordered_map<int, std::shared_ptr<PercussionState::OscillatorInfo>> parsedOscillators;
+        bool parsingFinished;
+};
+
+class KitJsonHandler
+        : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, KitJsonHandler> {
+ public:
+        explicit KitJsonHandler(KitState *kit);
+        bool Null();
+        bool Bool(bool b);
+        bool Int(int i);
+        bool Uint(unsigned u);
+        bool Int64(int64_t i);
+        bool Uint64(uint64_t u);
+        bool Double(double d);
+        bool String(const char *str, rapidjson::SizeType length, bool copy);
+        bool StartObject();
+        bool Key(const char *str, rapidjson::SizeType length, bool copy);
+        bool EndObject(rapidjson::SizeType memberCount);
+        bool StartArray();
+        bool EndArray(rapidjson::SizeType elementCount);
+
+ protected:
+        template<class Event> bool forward(const Event &event);
+        bool isOldKit() const;
+        void finish();
+
+ private:
+        KitState *kitState;
+        size_t depth;
+        std::string currentKey;
+        bool isPercussionsArray;
+        bool isAppVersionParsed;
+        size_t percussionIndex;
+        std::shared_ptr<PercussionState> percussion;
+        std::unique_ptr<PercussionJsonHandler> percussionHandler;
+
+        /**
+         * The kits of the versions older than 1.10 are single
+         * percussion objects loaded as two percussions.
+         */
+        std::vector<std::shared_ptr<PercussionState>> oldPercussions;
+        std::vector<std::unique_ptr<PercussionJsonHandler>> oldPercussionHandlers;
+};
+
+#endif // GEONKICK_STATE_JSON_HANDLER_H
@@ -23,6 +23,7 @@
 
 #include "top_bar.h"
 #include "geonkick_button.h"
+#include "percussion_state.h"
 #include "preset_browser_model.h"
 #include "preset_browser_view.h"
 
@@ -139,6 +140,9 @@ TopBar::TopBar(GeonkickWidget *parent, GeonkickApi *api)
 		    tuneAudioOutput(geonkickApi->currentPercussion(), b));
 
         updateGui();
+        RK_ACT_BIND(geonkickApi, stateUpdated,
+                    RK_ACT_ARGS(const StateChanges &changes),
+                    this, updateGui(changes));
 }
 
 void TopBar::createLyersButtons()
@@ -191,9 +195,18 @@ void TopBar::setPresetName(const std::string &name)
 
 void TopBar::updateGui()
 {
-        layer1Button->setPressed(geonkickApi->isLayerEnabled(GeonkickApi::Layer::Layer1));
-        layer2Button->setPressed(geonkickApi->isLayerEnabled(GeonkickApi::Layer::Layer2));
-        layer3Button->setPressed(geonkickApi->isLayerEnabled(GeonkickApi::Layer::Layer3));
-        tuneCheckbox->setPressed(geonkickApi->isAudioOutputTuned(geonkickApi->currentPercussion()));
-        setPresetName(geonkickApi->getPercussionName(geonkickApi->currentPercussion()));
+        auto state = geonkickApi->percussionSnapshot();
+        layer1Button->setPressed(state->isLayerEnabled(GeonkickApi::Layer::Layer1));
+        layer2Button->setPressed(state->isLayerEnabled(GeonkickApi::Layer::Layer2));
+        layer3Button->setPressed(state->isLayerEnabled(GeonkickApi::Layer::Layer3));
+        tuneCheckbox->setPressed(state->isOutputTuned());
+        setPresetName(state->getName());
+}
+
+void TopBar::updateGui(const StateChanges &changes)
+{
+        auto id = geonkickApi->percussionSnapshot()->getId();
+        if (changes.contains(id, StateChanges::Parameter::Percussion
+                             | StateChanges::Parameter::Layers))
+                updateGui();
 }
@@ -29,6 +29,7 @@
 
 class RkLabel;
 class GeonkickButton;
+class StateChanges;
 
 class TopBar : public GeonkickWidget
 {
@@ -44,6 +45,7 @@ class TopBar : public GeonkickWidget
                     RK_ARG_TYPE(GeonkickApi::Layer, bool),
                     RK_ARG_VAL(layer, b));
         void updateGui();
+        void updateGui(const StateChanges &changes);
 
  protected:
         void createLyersButtons();
@@ -9,11 +9,62 @@
 #include <stdint.h>
 #include "base64.h"
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BASE64_X86_SIMD
+#include <immintrin.h>
+#endif
+
 static const unsigned char base64_table[65] =
 	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 static const unsigned char base64_url_table[65] =
 	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 
+struct base64_dtable {
+	explicit base64_dtable(const unsigned char *table)
+	{
+		memset(values, 0x80, sizeof(values));
+		for (size_t i = 0; i < 64; i++)
+			values[table[i]] = (unsigned char) i;
+		values[0x3d] = 0;
+	}
+	unsigned char values[256];
+};
+
+/* The decode tables are built once instead of on every call. */
+static const base64_dtable base64_decode_table(base64_table);
+static const base64_dtable base64_url_decode_table(base64_url_table);
+
+static base64_simd_level
+base64_detect_simd(void)
+{
+#ifdef BASE64_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return BASE64_SIMD_AVX2;
+	if (__builtin_cpu_supports("sse4.1"))
+		return BASE64_SIMD_SSE41;
+#endif /* BASE64_X86_SIMD */
+	return BASE64_SIMD_NONE;
+}
+
+static const base64_simd_level base64_simd_supported = base64_detect_simd();
+static base64_simd_level base64_simd = base64_simd_supported;
+
+base64_simd_level
+base64_get_simd_level(void)
+{
+	return base64_simd;
+}
+
+int
+base64_set_simd_level(base64_simd_level level)
+{
+	if (level < BASE64_SIMD_NONE || level > base64_simd_supported)
+		return -1;
+	base64_simd = level;
+	return 0;
+}
+
 
 static unsigned char*
 base64_gen_encode(const unsigned char *src, size_t len,
@@ -81,36 +132,33 @@ base64_gen_encode(const unsigned char *src, size_t len,
 }
 
 
-static unsigned char*
-base64_gen_decode(const unsigned char *src, size_t len,
-                  size_t *out_len,
-                  const unsigned char *table)
+/*
+ * Returns 0 on success, 1 if there is nothing to decode
+ * and -1 on invalid padding.
+ */
+static int
+base64_gen_decode_to(const unsigned char *src, size_t len,
+                     unsigned char *out, size_t *out_len,
+                     const unsigned char *dtable)
 {
-	unsigned char dtable[256], *out, *pos, block[4], tmp;
-	size_t i, count, olen;
+	unsigned char *pos, block[4], tmp;
+	size_t i, count;
 	int pad = 0;
 	size_t extra_pad;
 
-	memset(dtable, 0x80, 256);
-	for (i = 0; i < sizeof(base64_table) - 1; i++)
-		dtable[table[i]] = (unsigned char) i;
-	dtable[0x3d] = 0;
-
 	count = 0;
 	for (i = 0; i < len; i++) {
 		if (dtable[src[i]] != 0x80)
 			count++;
 	}
 
-	if (count == 0)
-		return NULL;
+	if (count == 0) {
+		*out_len = 0;
+		return 1;
+	}
 	extra_pad = (4 - count % 4) % 4;
 
-	olen = (count + extra_pad) / 4 * 3;
-	pos = out = (unsigned char*)malloc(olen);
-	if (out == NULL)
-		return NULL;
-
+	pos = out;
 	count = 0;
 	for (i = 0; i < len + extra_pad; i++) {
 		unsigned char val;
@@ -139,8 +187,7 @@ base64_gen_decode(const unsigned char *src, size_t len,
 					pos -= 2;
 				else {
 					/* Invalid padding */
-					free(out);
-					return NULL;
+					return -1;
 				}
 				break;
 			}
@@ -148,6 +195,28 @@ base64_gen_decode(const unsigned char *src, size_t len,
 	}
 
 	*out_len = pos - out;
+	return 0;
+}
+
+
+static unsigned char*
+base64_gen_decode(const unsigned char *src, size_t len,
+                  size_t *out_len,
+                  const unsigned char *dtable)
+{
+	unsigned char *out;
+	size_t olen = base64_decoded_size(len);
+	if (olen == 0)
+		return NULL;
+
+	out = (unsigned char*)malloc(olen);
+	if (out == NULL)
+		return NULL;
+
+	if (base64_gen_decode_to(src, len, out, out_len, dtable) != 0) {
+		free(out);
+		return NULL;
+	}
 	return out;
 }
 
@@ -198,7 +267,7 @@ base64_decode(const unsigned char *src,
                               size_t len,
 			      size_t *out_len)
 {
-	return base64_gen_decode(src, len, out_len, base64_table);
+	return base64_gen_decode(src, len, out_len, base64_decode_table.values);
 }
 
 
@@ -207,5 +276,294 @@ base64_url_decode(const unsigned char *src,
                   size_t len,
                   size_t *out_len)
 {
-	return base64_gen_decode(src, len, out_len, base64_url_table);
+	return base64_gen_decode(src, len, out_len, base64_url_decode_table.values);
+}
+
+
+#ifdef BASE64_X86_SIMD
+/*
+ * Vectorized codec for the standard alphabet, based on the
+ * SSE/AVX2 algorithms by Wojciech Muła and Daniel Lemire.
+ * The kernels process only the full blocks and return the number
+ * of input bytes consumed, the rest is handled by the scalar code.
+ */
+
+__attribute__((target("sse4.1"))) static inline __m128i
+base64_enc_reshuffle_sse(__m128i in)
+{
+	in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+					       4, 5, 3, 4, 1, 2, 0, 1));
+	const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+	const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+	const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+	return _mm_or_si128(t1, t3);
+}
+
+__attribute__((target("sse4.1"))) static inline __m128i
+base64_enc_translate_sse(__m128i indices)
+{
+	const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+						'0' - 52, '0' - 52, '0' - 52, '0' - 52,
+						'0' - 52, '0' - 52, '0' - 52, '+' - 62,
+						'/' - 63, 'A', 0, 0);
+	__m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+	result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+	result = _mm_shuffle_epi8(shift_lut, result);
+	return _mm_add_epi8(result, indices);
+}
+
+__attribute__((target("sse4.1"))) static size_t
+base64_encode_sse(const unsigned char *src, size_t len, unsigned char *out)
+{
+	size_t i = 0;
+	/* 12 input bytes are used from each 16 bytes load. */
+	for (; len - i >= 16; i += 12, out += 16) {
+		__m128i in = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i chars = base64_enc_translate_sse(base64_enc_reshuffle_sse(in));
+		_mm_storeu_si128((__m128i*)out, chars);
+	}
+	return i;
+}
+
+__attribute__((target("avx2"))) static size_t
+base64_encode_avx2(const unsigned char *src, size_t len, unsigned char *out)
+{
+	const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7,
+						4, 5, 3, 4, 1, 2, 0, 1,
+						10, 11, 9, 10, 7, 8, 6, 7,
+						4, 5, 3, 4, 1, 2, 0, 1);
+	const __m256i shift_lut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+						   '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+						   '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+						   '/' - 63, 'A', 0, 0,
+						   'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+						   '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+						   '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+						   '/' - 63, 'A', 0, 0);
+	size_t i = 0;
+	/* Each lane takes 12 input bytes, the second load reads up to i + 28. */
+	for (; len - i >= 28; i += 24, out += 32) {
+		__m256i in = _mm256_inserti128_si256(
+			_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(src + i))),
+			_mm_loadu_si128((const __m128i*)(src + i + 12)), 1);
+		in = _mm256_shuffle_epi8(in, shuffle);
+		const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+		const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+		const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+		const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+		const __m256i indices = _mm256_or_si256(t1, t3);
+
+		__m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+		const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+		result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+		result = _mm256_shuffle_epi8(shift_lut, result);
+		result = _mm256_add_epi8(result, indices);
+		_mm256_storeu_si256((__m256i*)out, result);
+	}
+	return i;
+}
+
+/*
+ * Decodes 16 characters into 12 bytes, stored as the first
+ * 12 bytes of the result. Returns 0 if the block contains
+ * characters outside the alphabet (padding, line feeds).
+ */
+__attribute__((target("sse4.1"))) static inline int
+base64_dec_block_sse(__m128i in, __m128i *decoded)
+{
+	const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+					     0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+	const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+					     0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+					       0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0f));
+	const __m128i lo_nibbles = _mm_and_si128(in, _mm_set1_epi8(0x0f));
+	const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+	const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+	if (!_mm_testz_si128(lo, hi))
+		return 0;
+
+	const __m128i eq_2f = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2f));
+	const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+	const __m128i values = _mm_add_epi8(in, roll);
+	const __m128i merge_ab_bc = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+	const __m128i merged = _mm_madd_epi16(merge_ab_bc, _mm_set1_epi32(0x00011000));
+	*decoded = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+							  8, 14, 13, 12, -1, -1, -1, -1));
+	return 1;
+}
+
+__attribute__((target("sse4.1"))) static size_t
+base64_decode_sse(const unsigned char *src, size_t len,
+		  unsigned char *out, size_t *out_len)
+{
+	size_t i = 0;
+	*out_len = 0;
+	/*
+	 * The store writes 16 bytes for 12 decoded, keep enough input
+	 * left so that the output buffer has room for it.
+	 */
+	for (; len - i >= 24; i += 16) {
+		__m128i decoded;
+		__m128i in = _mm_loadu_si128((const __m128i*)(src + i));
+		if (!base64_dec_block_sse(in, &decoded))
+			break;
+		_mm_storeu_si128((__m128i*)(out + *out_len), decoded);
+		*out_len += 12;
+	}
+	return i;
+}
+
+__attribute__((target("avx2"))) static size_t
+base64_decode_avx2(const unsigned char *src, size_t len,
+		   unsigned char *out, size_t *out_len)
+{
+	const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+						0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+						0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+						0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+	const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+						0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+						0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+						0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+						  0, 0, 0, 0, 0, 0, 0, 0,
+						  0, 16, 19, 4, -65, -65, -71, -71,
+						  0, 0, 0, 0, 0, 0, 0, 0);
+	const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+					      8, 14, 13, 12, -1, -1, -1, -1,
+					      2, 1, 0, 6, 5, 4, 10, 9,
+					      8, 14, 13, 12, -1, -1, -1, -1);
+	size_t i = 0;
+	*out_len = 0;
+	/* The store writes 32 bytes for 24 decoded. */
+	for (; len - i >= 48; i += 32) {
+		__m256i in = _mm256_loadu_si256((const __m256i*)(src + i));
+		const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4),
+							    _mm256_set1_epi8(0x0f));
+		const __m256i lo_nibbles = _mm256_and_si256(in, _mm256_set1_epi8(0x0f));
+		const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+		const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+		if (!_mm256_testz_si256(lo, hi))
+			break;
+
+		const __m256i eq_2f = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(0x2f));
+		const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+		const __m256i values = _mm256_add_epi8(in, roll);
+		const __m256i merge_ab_bc = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		__m256i merged = _mm256_madd_epi16(merge_ab_bc, _mm256_set1_epi32(0x00011000));
+		merged = _mm256_shuffle_epi8(merged, pack);
+		merged = _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+		_mm256_storeu_si256((__m256i*)(out + *out_len), merged);
+		*out_len += 24;
+	}
+	return i;
+}
+#endif /* BASE64_X86_SIMD */
+
+
+size_t
+base64_encoded_size(size_t len)
+{
+	return (len + 2) / 3 * 4;
+}
+
+
+/**
+ * base64_encode_to - Base64 encode into the caller's buffer
+ * @src: Data to be encoded
+ * @len: Length of the data to be encoded
+ * @out: Buffer of at least base64_encoded_size(len) bytes
+ * Returns: Number of bytes written
+ *
+ * The output is padded, without line feeds and not nul terminated.
+ */
+size_t
+base64_encode_to(const unsigned char *src,
+                 size_t len,
+                 unsigned char *out)
+{
+	const unsigned char *end = src + len;
+	const unsigned char *in = src;
+	unsigned char *pos = out;
+
+#ifdef BASE64_X86_SIMD
+	size_t n = 0;
+	if (base64_simd == BASE64_SIMD_AVX2)
+		n = base64_encode_avx2(in, len, pos);
+	else if (base64_simd == BASE64_SIMD_SSE41)
+		n = base64_encode_sse(in, len, pos);
+	in += n;
+	pos += n / 3 * 4;
+#endif /* BASE64_X86_SIMD */
+
+	while (end - in >= 3) {
+		*pos++ = base64_table[(in[0] >> 2) & 0x3f];
+		*pos++ = base64_table[(((in[0] & 0x03) << 4) | (in[1] >> 4)) & 0x3f];
+		*pos++ = base64_table[(((in[1] & 0x0f) << 2) | (in[2] >> 6)) & 0x3f];
+		*pos++ = base64_table[in[2] & 0x3f];
+		in += 3;
+	}
+
+	if (end - in) {
+		*pos++ = base64_table[(in[0] >> 2) & 0x3f];
+		if (end - in == 1) {
+			*pos++ = base64_table[((in[0] & 0x03) << 4) & 0x3f];
+			*pos++ = '=';
+		} else {
+			*pos++ = base64_table[(((in[0] & 0x03) << 4) |
+					       (in[1] >> 4)) & 0x3f];
+			*pos++ = base64_table[((in[1] & 0x0f) << 2) & 0x3f];
+		}
+		*pos++ = '=';
+	}
+
+	return pos - out;
+}
+
+
+size_t
+base64_decoded_size(size_t len)
+{
+	return (len + 3) / 4 * 3;
+}
+
+
+/**
+ * base64_decode_to - Base64 decode into the caller's buffer
+ * @src: Data to be decoded
+ * @len: Length of the data to be decoded
+ * @out: Buffer of at least base64_decoded_size(len) bytes
+ * @out_len: Pointer to output length variable
+ * Returns: 0 on success, -1 on failure
+ */
+int
+base64_decode_to(const unsigned char *src,
+                 size_t len,
+                 unsigned char *out,
+                 size_t *out_len)
+{
+	size_t n = 0;
+	size_t decoded = 0;
+	size_t rest_len;
+	int res;
+
+#ifdef BASE64_X86_SIMD
+	if (base64_simd == BASE64_SIMD_AVX2)
+		n = base64_decode_avx2(src, len, out, &decoded);
+	else if (base64_simd == BASE64_SIMD_SSE41)
+		n = base64_decode_sse(src, len, out, &decoded);
+#endif /* BASE64_X86_SIMD */
+
+	/* The vectorized code stops at the padding or line feeds. */
+	res = base64_gen_decode_to(src + n, len - n, out + decoded, &rest_len,
+				   base64_decode_table.values);
+	if (res < 0 || (res > 0 && n == 0))
+		return -1;
+
+	*out_len = decoded + rest_len;
+	return 0;
 }
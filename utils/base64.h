@@ -11,6 +11,12 @@
 
 #include "globals.h"
 
+enum base64_simd_level {
+	BASE64_SIMD_NONE = 0,
+	BASE64_SIMD_SSE41,
+	BASE64_SIMD_AVX2
+};
+
 unsigned char*
 base64_encode(const unsigned char *src,
               size_t len,
@@ -28,5 +34,28 @@ unsigned char*
 base64_url_decode(const unsigned char *src,
                   size_t len,
 		  size_t *out_len);
+size_t
+base64_encoded_size(size_t len);
+size_t
+base64_encode_to(const unsigned char *src,
+                 size_t len,
+                 unsigned char *out);
+size_t
+base64_decoded_size(size_t len);
+int
+base64_decode_to(const unsigned char *src,
+                 size_t len,
+                 unsigned char *out,
+                 size_t *out_len);
+
+/*
+ * The fastest code path supported by the CPU is used by default.
+ * Setting it is not thread safe, it is meant for the benchmarks.
+ * Returns 0 on success, -1 if the CPU doesn't support the level.
+ */
+base64_simd_level
+base64_get_simd_level(void);
+int
+base64_set_simd_level(base64_simd_level level);
 
 #endif /* BASE64_H */